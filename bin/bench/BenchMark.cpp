@@ -21,6 +21,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <BitArray.h>
 #include "BenchMark.h"
 
 BenchMark::BenchMark(int argc, char **argv)
@@ -59,6 +60,14 @@ BenchMark::Result BenchMark::exec()
     t2 = timestamp();
     printf("SystemCall (Schedule) Ticks: %u\r\n", t2 - t1);
 
+    // Reset scheduling priority, which moves the process within the run queue
+    t1 = timestamp();
+    ProcessCtl(SELF, SetPriority, Process::DefaultPriority);
+    ProcessCtl(SELF, SetPriority, Process::DefaultPriority);
+    t2 = timestamp();
+    printf("SystemCall (SetPriority) Ticks: %u (%u AVG)\r\n",
+            (u32)(t2 - t1), (u32)(t2 - t1) / 2);
+
     // Translate virtual memory address to physical memory address
     range.virt = 0x80000000;
     range.size = PAGESIZE;    
@@ -89,6 +98,94 @@ BenchMark::Result BenchMark::exec()
     printf("release() Ticks: %u (%u AVG)\r\n",
             (u32)(t2 - t1), (u32)(t2 - t1) / 128);
 
+    // Allocate and release heap memory of various object sizes
+    for (Size size = 8; size <= KiloByte(16); size *= 2)
+    {
+        u64 allocTicks = 0, releaseTicks = 0;
+
+        t1 = timestamp();
+        for (int i = 0; i < 128; i++)
+            foo[i] = new char[size];
+        t2 = timestamp();
+        allocTicks = t2 - t1;
+
+        t1 = timestamp();
+        for (int i = 0; i < 128; i++)
+            delete[] foo[i];
+        t2 = timestamp();
+        releaseTicks = t2 - t1;
+
+        printf("allocate/release(%u) Ticks: %u/%u AVG\r\n",
+                size, (u32) allocTicks / 128, (u32) releaseTicks / 128);
+    }
+
+    // Search free ranges in a fragmented bitmap of 1M bits
+    BitArray bits(1024 * 1024);
+    Size bit, found = 0;
+
+    for (Size i = 0; i < bits.size(); i += 96)
+        bits.setRange(i, i + (i % 61));
+
+    t1 = timestamp();
+    for (Size last = 0; bits.setNext(&bit, 32, last, 8) == BitArray::Success; last = bit)
+        found++;
+    t2 = timestamp();
+    printf("BitArray::setNext() Ticks: %u (%u AVG)\r\n",
+            (u32)(t2 - t1), found ? (u32)(t2 - t1) / found : 0);
+
+    // Copy virtual memory between two buffers with the kernel
+    const Size copyMax = MegaByte(1);
+    u8 *copySrc = new u8[copyMax];
+    u8 *copyDst = new u8[copyMax];
+
+    for (Size i = 0; i < copyMax; i++)
+        copySrc[i] = copyDst[i] = i;
+
+    for (Size size = KiloByte(4); size <= copyMax; size *= 16)
+    {
+        t1 = timestamp();
+        VMCopy(SELF, API::Write, (Address) copySrc, (Address) copyDst, size);
+        t2 = timestamp();
+        printf("SystemCall (VMCopy %u) Ticks: %u (%u AVG per KB)\r\n",
+                size, (u32)(t2 - t1), (u32)(t2 - t1) / (size / 1024));
+    }
+    delete[] copySrc;
+    delete[] copyDst;
+
+    // Read a large file sequentially, with bulk sized and small buffers
+    static u8 fileBuf[KiloByte(64)];
+    const Size fileSize = KiloByte(512);
+    int fd = -1;
+
+    if (creat("/tmp/bench.dat", S_IRUSR | S_IWUSR) == 0)
+        fd = open("/tmp/bench.dat", O_RDWR);
+
+    if (fd < 0)
+    {
+        printf("failed to create /tmp/bench.dat\r\n");
+    }
+    else
+    {
+        for (Size i = 0; i < fileSize; i += sizeof(fileBuf))
+            write(fd, fileBuf, sizeof(fileBuf));
+
+        for (Size chunk = 512; chunk <= sizeof(fileBuf); chunk *= 8)
+        {
+            Size total = 0;
+            ssize_t n;
+
+            lseek(fd, 0, SEEK_SET);
+            t1 = timestamp();
+            while ((n = read(fd, fileBuf, chunk)) > 0)
+                total += n;
+            t2 = timestamp();
+            printf("read(%u) Ticks: %u (%u AVG per KB)\r\n",
+                    chunk, (u32)(t2 - t1), total >= 1024 ? (u32)(t2 - t1) / (total / 1024) : 0);
+        }
+        close(fd);
+        unlink("/tmp/bench.dat");
+    }
+
     // Done
     return Success;
 }
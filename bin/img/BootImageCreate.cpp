@@ -263,7 +263,7 @@ BootImageCreate::Result BootImageCreate::exec()
             symbols[i].segmentsTotalSize += segments[segCount].size;
 
             // Increment data pointer. Align on memory page boundary
-            dataOffset += segments[i].size;
+            dataOffset += segments[segCount].size;
             lastDataOffset = dataOffset;
             dataOffset += PageSize - (dataOffset % PageSize);
             segCount++;
@@ -297,7 +297,7 @@ BootImageCreate::Result BootImageCreate::exec()
         for (Size j = 0; j < input[i]->numRegions; j++)
         {
             // Adjust file pointer
-            if (fseek(fp, segments[symbols[i].segmentsOffset].offset,
+            if (fseek(fp, segments[symbols[i].segmentsOffset + j].offset,
                       SEEK_SET) == -1)
             {
                 fprintf(stderr, "%s: failed to seek to BootSegment contents in `%s': %s\r\n",
@@ -306,13 +306,25 @@ BootImageCreate::Result BootImageCreate::exec()
             }
 
             // Write segment contents
-            if (fwrite(input[i]->data + input[i]->regions[j].dataOffset,
-                       input[i]->regions[j].memorySize, 1, fp) <= 0)
+            if (input[i]->regions[j].dataSize > 0 &&
+                fwrite(input[i]->data + input[i]->regions[j].dataOffset,
+                       input[i]->regions[j].dataSize, 1, fp) <= 0)
             {
                 fprintf(stderr, "%s: failed to write BootSegment contents to `%s': %s\r\n",
                         prog, out_file, strerror(errno));
                 return IOError;
             }
+
+            // Fill the remaining memory of the segment with zeroes
+            for (Size k = input[i]->regions[j].dataSize; k < input[i]->regions[j].memorySize; k++)
+            {
+                if (fputc(0, fp) == EOF)
+                {
+                    fprintf(stderr, "%s: failed to write BootSegment contents to `%s': %s\r\n",
+                            prog, out_file, strerror(errno));
+                    return IOError;
+                }
+            }
         }
     }
     // Close file
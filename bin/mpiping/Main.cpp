@@ -17,8 +17,106 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
 #include <mpi.h>
 
+/** Largest message size used by the benchmark, in bytes */
+#define BENCH_MAX_SIZE (256 * 1024)
+
+/** Number of bytes transferred in each direction per message size */
+#define BENCH_VOLUME (4 * 1024 * 1024)
+
+/**
+ * Get the current time in microseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return ((u64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+/**
+ * Measure latency and bandwidth between rank 0 and 1 for increasing message sizes.
+ *
+ * Rank 0 sends each message and rank 1 sends it back.
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+static int bench(const char *prog, const int id)
+{
+    static char buf[BENCH_MAX_SIZE];
+    MPI_Status status;
+    int cores, count;
+
+    if (MPI_Comm_size(MPI_COMM_WORLD, &cores) != MPI_SUCCESS)
+    {
+        printf("%s: failed to lookup MPI core count\r\n", prog);
+        return EXIT_FAILURE;
+    }
+
+    // Only the first two ranks take part
+    if (cores < 2)
+    {
+        printf("%s: benchmark requires at least 2 cores, skipped\r\n", prog);
+        return EXIT_SUCCESS;
+    }
+    if (id > 1)
+        return EXIT_SUCCESS;
+
+    if (id == 0)
+        printf("%s: %8s %10s %12s %10s\r\n", prog, "size", "iterations", "latency(us)", "MB/s");
+
+    for (Size size = 1; size <= BENCH_MAX_SIZE; size *= 4)
+    {
+        const Size iterations = size < (BENCH_VOLUME / 1024) ? 1024 : (BENCH_VOLUME / size);
+        const u64 t1 = benchTime();
+
+        for (Size i = 0; i < iterations; i++)
+        {
+            if (id == 0)
+            {
+                buf[0] = i;
+
+                if (MPI_Send(buf, size, MPI_BYTE, 1, 0, MPI_COMM_WORLD) != MPI_SUCCESS ||
+                    MPI_Recv(buf, size, MPI_BYTE, 1, 0, MPI_COMM_WORLD, &status) != MPI_SUCCESS)
+                {
+                    printf("%s: failed to exchange %u bytes with core1\r\n", prog, size);
+                    return EXIT_FAILURE;
+                }
+
+                if (MPI_Get_count(&status, MPI_BYTE, &count) != MPI_SUCCESS ||
+                    count != (int) size || buf[0] != (char) i)
+                {
+                    printf("%s: invalid reply of %d bytes from core1\r\n", prog, count);
+                    return EXIT_FAILURE;
+                }
+            }
+            else
+            {
+                if (MPI_Recv(buf, size, MPI_BYTE, 0, 0, MPI_COMM_WORLD, &status) != MPI_SUCCESS ||
+                    MPI_Send(buf, size, MPI_BYTE, 0, 0, MPI_COMM_WORLD) != MPI_SUCCESS)
+                {
+                    printf("%s: failed to exchange %u bytes with core0\r\n", prog, size);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+
+        if (id == 0)
+        {
+            const u64 usec = benchTime() - t1;
+            const u64 bytes = (u64) size * iterations * 2;
+
+            printf("%s: %8u %10u %12u %10u\r\n", prog, size, iterations,
+                   (uint) (usec / (iterations * 2)),
+                   usec ? (uint) (bytes / usec) : 0);
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char **argv)
 {
     int id, buf, cores;
@@ -37,6 +135,13 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
+    if (argc > 1 && strcmp(argv[1], "bench") == 0)
+    {
+        const int result = bench(argv[0], id);
+        MPI_Finalize();
+        return result;
+    }
+
     if (id == 0)
     {
         if (MPI_Comm_size(MPI_COMM_WORLD, &cores) != MPI_SUCCESS)
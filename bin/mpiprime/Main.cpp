@@ -34,33 +34,13 @@ static char name[64];
 
 void collect(int n, unsigned *map)
 {
-    int i, j, sqrt_of_n = sqrt(n), z;
-    MPI_Status status;
-    unsigned *mybuf = (unsigned *) malloc(sizeof(unsigned) * PERNODE(rank, total, sqrt_of_n, n));
+    int sqrt_of_n = sqrt(n);
 
-    // Every worker sends it's results to the master
-    if (rank != 0)
-    {
-        // Send mybuf to the master
-        MPI_Send(&map[START(rank, total, sqrt_of_n, n)], PERNODE(rank, total, sqrt_of_n, n), MPI_INT, 0, 0, MPI_COMM_WORLD);
-    }
-    // The master gathers the parts of the list from every worker
-    else
-    {
-        for (i = 1; i < total; i++)
-        {
-            // Receive from worker
-            MPI_Recv(mybuf, PERNODE(rank, total, sqrt_of_n, n), MPI_INT, i, 0, MPI_COMM_WORLD, &status);
-
-            // Copy inside our buffer
-            for (j = START(i, total, sqrt_of_n, n), z = 0; j < END(i, total, sqrt_of_n, n); j++)
-            {
-                map[j] = mybuf[z++];
-            }
-        }
-    }
-    // Cleanup
-    free(mybuf);
+    // The master gathers the parts of the list from every worker.
+    // Parts are adjacent, so they are received in place in the map.
+    MPI_Gather(&map[START(rank, total, sqrt_of_n, n)], PERNODE(rank, total, sqrt_of_n, n), MPI_UNSIGNED,
+               &map[START(0, total, sqrt_of_n, n)], PERNODE(rank, total, sqrt_of_n, n), MPI_UNSIGNED,
+               0, MPI_COMM_WORLD);
 }
 
 void search_sequential(int k, int n, unsigned *map, int argc, char **argv)
@@ -158,6 +138,7 @@ int main(int argc, char **argv)
     String output;
     struct timeval t1, t2;
     struct timezone tz;
+    ulong elapsed, wall;
 
     // Initialize MPI
     gettimeofday(&t1, &tz);
@@ -207,6 +188,7 @@ int main(int argc, char **argv)
     }
 
     // Search for primes until done
+    MPI_Barrier(MPI_COMM_WORLD);
     gettimeofday(&t1, &tz);
     search_parallel(k, n, map, argc, argv);
     gettimeofday(&t2, &tz);
@@ -215,6 +197,13 @@ int main(int argc, char **argv)
     printtimediff(&t1, &t2);
     printf("\r\n");
 
+    // Wall time is the time of the slowest worker
+    elapsed = ((t2.tv_sec - t1.tv_sec) * 1000000) + t2.tv_usec - t1.tv_usec;
+    MPI_Reduce(&elapsed, &wall, 1, MPI_UNSIGNED_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank == 0)
+        printf("Wall time on %d cores: %u usec\r\n", total, (uint) wall);
+
     gettimeofday(&t1, &tz);
 
     // Only the master reports the results.
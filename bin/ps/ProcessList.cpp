@@ -51,7 +51,7 @@ ProcessList::Result ProcessList::exec()
     pid_t pid = getpid();
 
     // Print header
-    out << "ID  PARENT  USER GROUP STATUS     CMD\r\n";
+    out << "ID  PARENT  USER GROUP PRIO STATUS     CMD\r\n";
     memset(&cmd, 0, sizeof(cmd));
 
     // Loop processes
@@ -67,8 +67,8 @@ ProcessList::Result ProcessList::exec()
 
             // Output a line
             snprintf(line, sizeof(line),
-                    "%3d %7d %4d %5d %10s %32s\r\n",
-                     i, info.parent, 0, 0, i == pid ? "Running" : ProcessStates[info.state], cmd);
+                    "%3d %7d %4d %5d %4u %10s %32s\r\n",
+                     i, info.parent, 0, 0, info.priority, i == pid ? "Running" : ProcessStates[info.state], cmd);
             out << line;
         }
     }
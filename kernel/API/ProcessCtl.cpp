@@ -102,6 +102,23 @@ API::Result ProcessCtlHandler(ProcessID procID,
         }
         break;
 
+    case SetPriority:
+        // Unprivileged processes may only lower their own priority or that of their children
+        if (!procs->current()->isPrivileged() &&
+           ((proc != procs->current() && proc->getParent() != procs->current()->getID()) ||
+             addr > procs->current()->getPriority()))
+        {
+            ERROR("PID " << procs->current()->getID() << " may not set priority " <<
+                  addr << " for PID " << proc->getID());
+            return API::AccessViolation;
+        }
+        if (procs->setPriority(proc, addr) != ProcessManager::Success)
+        {
+            ERROR("failed to set priority of PID " << proc->getID());
+            return API::InvalidArgument;
+        }
+        break;
+
     case Wakeup:
         // increment wakeup counter and set process ready
         if (procs->wakeup(proc) != ProcessManager::Success)
@@ -135,6 +152,7 @@ API::Result ProcessCtlHandler(ProcessID procID,
         info->id    = proc->getID();
         info->state = proc->getState();
         info->parent = proc->getParent();
+        info->priority = proc->getPriority();
         break;
 
     case WaitPID:
@@ -195,6 +213,7 @@ Log & operator << (Log &log, ProcessOperation op)
         case EnterSleep: log.append("EnterSleep"); break;
         case Schedule:  log.append("Schedule"); break;
         case Wakeup:    log.append("Wakeup"); break;
+        case SetPriority: log.append("SetPriority"); break;
         default:        log.append("???"); break;
     }
     return log;
@@ -53,7 +53,8 @@ typedef enum ProcessOperation
     Wakeup,
     Stop,
     Resume,
-    Reset
+    Reset,
+    SetPriority
 }
 ProcessOperation;
 
@@ -70,6 +71,9 @@ typedef struct ProcessInfo
 
     /** Defines the current state of the Process. */
     Process::State state;
+
+    /** Scheduling priority of the Process. */
+    uint priority;
 }
 ProcessInfo;
 
@@ -82,7 +86,9 @@ Log & operator << (Log &log, ProcessOperation op);
  * @param proc Target Process' ID.
  * @param op The operation to perform.
  * @param addr Input argument address, used for program entry point for Spawn,
- *             ProcessInfo pointer for Info.
+ *             ProcessInfo pointer for Info, priority level for SetPriority.
+ *             Unprivileged processes may only apply SetPriority to themselves
+ *             or their children, and not above their own priority.
  * @param output Output argument address (optional).
  *
  * @return API::Success on success and other API::ErrorCode on failure.
@@ -21,14 +21,20 @@
 #include <SplitAllocator.h>
 #include "VMCopy.h"
 
+/** Largest kernel window reserved for copying memory without a direct mapping. */
+#define VMCOPY_WINDOW_SIZE MegaByte(1)
+
 API::Result VMCopyHandler(ProcessID procID, API::Operation how, Address ours,
                           Address theirs, Size sz)
 {
     ProcessManager *procs = Kernel::instance()->getProcessManager();
+    SplitAllocator *alloc = Kernel::instance()->getAllocator();
     Process *proc;
-    Address paddr, vaddr;
-    Size bytes = 0, pageOff, total = 0;
+    Address paddr, next, vaddr;
+    Size bytes = 0, pageOff, total = 0, windowUsed = 0;
+    Memory::Range window, run;
     MemoryContext::Result memResult = MemoryContext::Success;
+    API::Result result = API::Success;
 
     DEBUG("");
 
@@ -41,32 +47,85 @@ API::Result VMCopyHandler(ProcessID procID, API::Operation how, Address ours,
     MemoryContext *local  = procs->current()->getMemoryContext();
     MemoryContext *remote = proc->getMemoryContext();
 
+    window.virt = 0;
+    window.phys = 0;
+    window.size = 0;
+    window.access = Memory::Readable | Memory::Writable;
+
     // Keep on going until all memory is processed
     while (total < sz)
     {
         // Update variables
         if (how == API::ReadPhys)
             paddr = theirs & PAGEMASK;
-        else if (remote->lookup(theirs, &paddr) != MemoryContext::Success)
-            return API::AccessViolation;
+        else if (remote->touch(theirs, &paddr) != MemoryContext::Success)
+        {
+            result = API::AccessViolation;
+            break;
+        }
 
         assert(!(paddr & ~PAGEMASK));
         pageOff = theirs & ~PAGEMASK;
-        bytes   = (PAGESIZE - pageOff) < (sz - total) ?
-                  (PAGESIZE - pageOff) : (sz - total);
 
         // Valid address?
         if (!paddr) break;
 
-        // Map their address into our local address space
-        if (local->findFree(PAGESIZE, MemoryMap::KernelPrivate, &vaddr) != MemoryContext::Success)
-            return API::RangeError;
+        // Extend the run over the physically contiguous pages which follow
+        bytes = PAGESIZE - pageOff;
+        while (bytes < sz - total && pageOff + bytes < VMCOPY_WINDOW_SIZE)
+        {
+            if (how != API::ReadPhys &&
+               (remote->lookup(theirs + bytes, &next) != MemoryContext::Success ||
+                next != paddr + pageOff + bytes))
+                break;
 
-        if ((memResult = local->map(vaddr, paddr,
-                                    Memory::Readable | Memory::Writable)) != MemoryContext::Success)
+            bytes += PAGESIZE;
+        }
+        if (bytes > sz - total)
+            bytes = sz - total;
+
+        // Copy straight through the kernel direct mapping, if it covers the run
+        if (alloc->isMapped(paddr, pageOff + bytes))
         {
-            ERROR("failed to map physical address " << (void *)paddr << ": " << (int)memResult);
-            return API::IOError;
+            vaddr = alloc->toVirtual(paddr);
+        }
+        else
+        {
+            run.virt   = 0;
+            run.phys   = paddr;
+            run.size   = (pageOff + bytes + PAGESIZE - 1) & PAGEMASK;
+            run.access = window.access;
+
+            // Reserve one kernel window for the remainder of the transfer
+            if (!window.size)
+            {
+                window.size = (pageOff + sz - total + PAGESIZE - 1) & PAGEMASK;
+                if (window.size > VMCOPY_WINDOW_SIZE)
+                    window.size = VMCOPY_WINDOW_SIZE;
+
+                if (local->findFree(window.size, MemoryMap::KernelPrivate, &window.virt) != MemoryContext::Success)
+                    return API::RangeError;
+            }
+            // Start over at the beginning of the window when it is full
+            else if (windowUsed + run.size > window.size)
+            {
+                Memory::Range used = window;
+                used.size = windowUsed;
+                memResult = local->unmapRange(&used);
+                assert(memResult == MemoryContext::Success);
+                windowUsed = 0;
+            }
+
+            // Map their pages into our local address space
+            run.virt = window.virt + windowUsed;
+            if ((memResult = local->mapRangeContiguous(&run)) != MemoryContext::Success)
+            {
+                ERROR("failed to map physical address " << (void *)paddr << ": " << (int)memResult);
+                result = API::IOError;
+                break;
+            }
+            windowUsed += run.size;
+            vaddr = run.virt;
         }
 
         // Process the action appropriately
@@ -85,14 +144,19 @@ API::Result VMCopyHandler(ProcessID procID, API::Operation how, Address ours,
                 ;
         }
 
-        // Unmap, which must always succeed
-        memResult = local->unmap(vaddr);
-        assert(memResult == MemoryContext::Success);
-
         // Update counters
         ours   += bytes;
         theirs += bytes;
         total  += bytes;
     }
-    return total;
+
+    // Unmap the window at once, which must always succeed
+    if (windowUsed)
+    {
+        window.size = windowUsed;
+        memResult = local->unmapRange(&window);
+        assert(memResult == MemoryContext::Success);
+    }
+
+    return result == API::Success ? total : result;
 }
@@ -17,6 +17,8 @@
 
 #include <FreeNOS/System.h>
 #include <FreeNOS/ProcessManager.h>
+#include <FreeNOS/ExecutableCache.h>
+#include <MemoryBlock.h>
 #include <SplitAllocator.h>
 #include "VMCtl.h"
 #include "ProcessID.h"
@@ -46,7 +48,7 @@ API::Result VMCtlHandler(ProcessID procID, MemoryOperation op, Memory::Range *ra
     {
         case LookupVirtual:
             // Translate virtual address to physical address (page boundary)
-            memResult = mem->lookup(range->virt, &range->phys);
+            memResult = mem->touch(range->virt, &range->phys);
             if (memResult != MemoryContext::Success)
             {
                 ERROR("failed to lookup virtual address " << (void *) range->virt <<
@@ -77,6 +79,16 @@ API::Result VMCtlHandler(ProcessID procID, MemoryOperation op, Memory::Range *ra
             else
                 memResult = mem->mapRangeSparse(range);
 
+            // Retry once after freeing unused program pages
+            if (memResult == MemoryContext::OutOfMemory &&
+                Kernel::instance()->getExecutableCache()->evict() > 0)
+            {
+                if (op == MapContiguous)
+                    memResult = mem->mapRangeContiguous(range);
+                else
+                    memResult = mem->mapRangeSparse(range);
+            }
+
             if (memResult != MemoryContext::Success)
             {
                 ERROR("failed to map memory range " << (void *)range->virt << "->" <<
@@ -85,6 +97,16 @@ API::Result VMCtlHandler(ProcessID procID, MemoryOperation op, Memory::Range *ra
             }
             break;
 
+        case MapLazy:
+            memResult = mem->mapRangeLazy(range);
+            if (memResult != MemoryContext::Success)
+            {
+                ERROR("failed to reserve memory range " << (void *)range->virt << ": " <<
+                      (int) memResult);
+                return API::IOError;
+            }
+            break;
+
         case UnMap:
             memResult = mem->unmapRange(range);
             if (memResult != MemoryContext::Success)
@@ -96,6 +118,7 @@ API::Result VMCtlHandler(ProcessID procID, MemoryOperation op, Memory::Range *ra
             break;
 
         case Release:
+            Kernel::instance()->getExecutableCache()->release(mem, range);
             memResult = mem->releaseRange(range);
             if (memResult != MemoryContext::Success)
             {
@@ -105,6 +128,47 @@ API::Result VMCtlHandler(ProcessID procID, MemoryOperation op, Memory::Range *ra
             }
             break;
 
+        case MapImage:
+        case InsertImage:
+        case RemoveImage: {
+            ExecutableCache *cache = Kernel::instance()->getExecutableCache();
+            ImageKey key;
+
+            if (!range->phys)
+                return API::InvalidArgument;
+
+            MemoryBlock::copy(&key, (const void *) range->phys, sizeof(key));
+            key.path[sizeof(key.path) - 1] = ZERO;
+
+            if (op == MapImage)
+            {
+                if (cache->map(mem, &key, range) != ExecutableCache::Success)
+                    return API::NotFound;
+                break;
+            }
+
+            // The kernel cannot verify the key, so only trusted processes may change the cache
+            if (!procs->current()->isPrivileged())
+            {
+                ERROR("PID " << procs->current()->getID() << " may not change the executable cache");
+                return API::AccessViolation;
+            }
+
+            if (op == RemoveImage)
+            {
+                cache->remove(&key);
+            }
+            // Only the parent may pass pages of a child which did not run yet
+            else if (proc->getParent() != procs->current()->getID() ||
+                     proc->getState() != Process::Stopped)
+            {
+                return API::AccessViolation;
+            }
+            else if (cache->insert(mem, &key, range) != ExecutableCache::Success)
+                return API::IOError;
+            break;
+        }
+
         case CacheClean: {
             Arch::Cache cache;
             cache.cleanData(range->virt);
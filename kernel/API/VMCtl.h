@@ -43,10 +43,36 @@ typedef enum MemoryOperation
     ReserveMem,
     AddMem,
     CacheClean,
-    CacheCleanInvalidate
+    CacheCleanInvalidate,
+    MapImage,       /**< Map a cached program region. Pointer to the ImageKey in range->phys */
+    InsertImage,    /**< Pass loaded program pages to the cache. Pointer to the ImageKey in range->phys. Privileged only */
+    RemoveImage,    /**< Drop cached regions of a program file. Pointer to the ImageKey in range->phys. Privileged only */
+    MapLazy         /**< Reserve pages which are allocated and zeroed on first access */
 }
 MemoryOperation;
 
+/**
+ * Identity of a program file for sharing its read-only regions.
+ */
+typedef struct ImageKey
+{
+    /** Full path of the file. */
+    char path[64];
+
+    /** File system process which serves the file. */
+    ProcessID server;
+
+    /** Number of the file, unique within its file system process. */
+    u32 inode;
+
+    /** Modification stamp of the file, which changes on every write. */
+    u32 modified;
+
+    /** Size of the file in bytes. */
+    Size size;
+}
+ImageKey;
+
 /**
  * Prototype for user applications. Examines and modifies virtual memory pages.
  *
@@ -65,7 +65,19 @@ API::Result VMShareHandler(ProcessID procID, API::Operation op, ProcessShares::M
             break;
 
         case API::Delete:
-            if (procs->current()->getShares().removeShares(procID) != ProcessShares::Success)
+            if (share)
+            {
+                // Only remove the share with the given tag
+                share->pid = procID;
+
+                switch (procs->current()->getShares().removeShare(share))
+                {
+                    case ProcessShares::Success:  break;
+                    case ProcessShares::NotFound: ret = API::NotFound; break;
+                    default:                      ret = API::IOError; break;
+                }
+            }
+            else if (procs->current()->getShares().removeShares(procID) != ProcessShares::Success)
                 ret = API::IOError;
             break;
 
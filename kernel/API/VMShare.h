@@ -32,6 +32,9 @@
 /**
  * Prototype for user applications. Creates and removes shared virtual memory mappings.
  *
+ * With API::Delete all shares with the process are removed, or only
+ * the share matching the core and tag of the share argument if given.
+ *
  * @param op Determines which operation to perform.
  * @param pid Remote process.
  * @param parameter Parameter for the operation.
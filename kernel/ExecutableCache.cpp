@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <MemoryBlock.h>
+#include <MemoryContext.h>
+#include <SplitAllocator.h>
+#include "ExecutableCache.h"
+
+ExecutableCache::ExecutableCache(SplitAllocator *alloc)
+    : m_alloc(alloc)
+    , m_clock(0)
+{
+    MemoryBlock::set(m_entries, 0, sizeof(m_entries));
+}
+
+ExecutableCache::Result ExecutableCache::map(MemoryContext *mem,
+                                             const ImageKey *key,
+                                             Memory::Range *range)
+{
+    Entry *entry = find(key, range->virt, range->size);
+    if (!entry)
+        return NotFound;
+
+    // Shared pages are never writable
+    Memory::Range shared = entry->range;
+    shared.access = (Memory::Access) (range->access & ~Memory::Writable);
+
+    if (mem->mapRangeContiguous(&shared) != MemoryContext::Success)
+    {
+        ERROR("failed to map cached region at " << (void *) shared.virt);
+        mem->unmapRange(&shared);
+        return MemoryMapError;
+    }
+
+    entry->references++;
+    entry->lastUsed = ++m_clock;
+    range->phys = shared.phys;
+    return Success;
+}
+
+ExecutableCache::Result ExecutableCache::insert(MemoryContext *mem,
+                                                const ImageKey *key,
+                                                const Memory::Range *range)
+{
+    Entry *entry = ZERO;
+    Address base, phys;
+    Memory::Access access;
+
+    if (!range->size || (range->virt & ~PAGEMASK))
+        return InvalidArgument;
+
+    if (find(key, range->virt, range->size))
+        return AlreadyExists;
+
+    // The region must be mapped read-only to contiguous physical pages
+    if (mem->lookup(range->virt, &base) != MemoryContext::Success)
+        return InvalidArgument;
+
+    for (Size i = 0; i < range->size; i += PAGESIZE)
+    {
+        if (mem->lookup(range->virt + i, &phys) != MemoryContext::Success ||
+            mem->access(range->virt + i, &access) != MemoryContext::Success ||
+            phys != base + i || (access & Memory::Writable) || isCached(phys))
+            return InvalidArgument;
+    }
+
+    // Drop regions of older versions of the file
+    invalidate(key, true);
+
+    // Use a free entry, or replace the least recently used unreferenced entry
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        Entry *e = &m_entries[i];
+
+        if (!e->valid)
+        {
+            entry = e;
+            break;
+        }
+        else if (e->references == 0 && (!entry || e->lastUsed < entry->lastUsed))
+        {
+            entry = e;
+        }
+    }
+
+    if (!entry)
+        return OutOfMemory;
+    else if (entry->valid)
+        free(entry);
+
+    entry->key        = *key;
+    entry->range.virt = range->virt;
+    entry->range.phys = base;
+    entry->range.size = range->size;
+    entry->references = 1;
+    entry->lastUsed   = ++m_clock;
+    entry->valid      = true;
+    entry->stale      = false;
+    return Success;
+}
+
+void ExecutableCache::remove(const ImageKey *key)
+{
+    invalidate(key, false);
+}
+
+void ExecutableCache::release(MemoryContext *mem, const Memory::Range *range)
+{
+    Address phys;
+
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        Entry *entry = &m_entries[i];
+
+        if (range && (entry->range.virt < range->virt ||
+                      entry->range.virt >= range->virt + range->size))
+            continue;
+
+        // Unmap the pages, such that the MemoryContext does not free them
+        if (entry->valid && entry->references > 0 &&
+            mem->lookup(entry->range.virt, &phys) == MemoryContext::Success &&
+            phys == entry->range.phys)
+        {
+            Memory::Range shared = entry->range;
+            mem->unmapRange(&shared);
+            entry->references--;
+
+            if (entry->stale && entry->references == 0)
+                free(entry);
+        }
+    }
+}
+
+Size ExecutableCache::evict()
+{
+    Size bytes = 0;
+
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        Entry *entry = &m_entries[i];
+
+        if (entry->valid && entry->references == 0)
+        {
+            bytes += entry->range.size;
+            free(entry);
+        }
+    }
+
+    return bytes;
+}
+
+ExecutableCache::Entry * ExecutableCache::find(const ImageKey *key,
+                                               const Address virt,
+                                               const Size size)
+{
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        Entry *entry = &m_entries[i];
+
+        if (entry->valid && !entry->stale &&
+            entry->key.server   == key->server &&
+            entry->key.inode    == key->inode &&
+            entry->key.modified == key->modified &&
+            entry->key.size     == key->size &&
+            MemoryBlock::compare(entry->key.path, key->path) &&
+            entry->range.virt == virt && entry->range.size == size)
+            return entry;
+    }
+
+    return ZERO;
+}
+
+void ExecutableCache::invalidate(const ImageKey *key, const bool keepCurrent)
+{
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        Entry *entry = &m_entries[i];
+
+        if (!entry->valid || entry->key.server != key->server ||
+            !MemoryBlock::compare(entry->key.path, key->path))
+            continue;
+
+        if (keepCurrent &&
+            entry->key.inode    == key->inode &&
+            entry->key.modified == key->modified &&
+            entry->key.size     == key->size)
+            continue;
+
+        if (entry->references == 0)
+            free(entry);
+        else
+            entry->stale = true;
+    }
+}
+
+bool ExecutableCache::isCached(const Address phys) const
+{
+    for (Size i = 0; i < MaximumEntries; i++)
+    {
+        const Entry *entry = &m_entries[i];
+
+        if (entry->valid && phys >= entry->range.phys &&
+            phys < entry->range.phys + entry->range.size)
+            return true;
+    }
+
+    return false;
+}
+
+void ExecutableCache::free(Entry *entry)
+{
+    assert(entry->references == 0);
+
+    for (Size i = 0; i < entry->range.size; i += PAGESIZE)
+        m_alloc->release(entry->range.phys + i);
+
+    entry->valid = false;
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_EXECUTABLECACHE_H
+#define __KERNEL_EXECUTABLECACHE_H
+
+#include <Types.h>
+#include <Macros.h>
+#include <Memory.h>
+#include "API/VMCtl.h"
+
+/** Forward declarations. */
+class MemoryContext;
+class SplitAllocator;
+
+/**
+ * @addtogroup kernel
+ * @{
+ */
+
+/**
+ * Keeps read-only program regions resident for sharing between processes.
+ *
+ * A region is inserted after its pages were loaded by the first process
+ * which runs the program. From then on, the cache owns the physical pages.
+ * Processes which run the same program map the pages instead of loading them.
+ * Entries are identified by the path and the identity of the file, which
+ * userspace retrieves from the file system. Since the kernel cannot verify
+ * the identity, only privileged processes may insert and remove entries.
+ * A changed or removed file invalidates its entries: unreferenced entries
+ * are freed immediately, referenced entries once the last process releases them.
+ * Unreferenced entries are evicted in least recently used order.
+ */
+class ExecutableCache
+{
+  private:
+
+    /** Maximum number of cached regions. */
+    static const Size MaximumEntries = 32u;
+
+  public:
+
+    /**
+     * Result code
+     */
+    enum Result
+    {
+        Success,
+        InvalidArgument,
+        NotFound,
+        AlreadyExists,
+        OutOfMemory,
+        MemoryMapError
+    };
+
+    /**
+     * Cached program region.
+     */
+    struct Entry
+    {
+        /** Identity of the program file. */
+        ImageKey key;
+
+        /** Virtual address, size and physical pages of the region. */
+        Memory::Range range;
+
+        /** Number of processes which map the region. */
+        Size references;
+
+        /** Value of the use counter at the last insert or map. */
+        Size lastUsed;
+
+        /** True if the entry is in use. */
+        bool valid;
+
+        /** True if the file changed. The entry is freed when unreferenced. */
+        bool stale;
+    };
+
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param alloc Physical memory allocator
+     */
+    ExecutableCache(SplitAllocator *alloc);
+
+    /**
+     * Map a cached region.
+     *
+     * @param mem MemoryContext to map the region into
+     * @param key Identity of the program file
+     * @param range Virtual address, size and access of the region.
+     *              On success, the physical address is filled in.
+     *
+     * @return Result code
+     */
+    Result map(MemoryContext *mem, const ImageKey *key, Memory::Range *range);
+
+    /**
+     * Take over a loaded region.
+     *
+     * The region must be mapped read-only to contiguous physical
+     * pages which are not yet owned by the cache. Entries of
+     * an older version of the same file are invalidated.
+     *
+     * @param mem MemoryContext which maps the loaded region
+     * @param key Identity of the program file
+     * @param range Virtual address and size of the region.
+     *
+     * @return Result code
+     */
+    Result insert(MemoryContext *mem, const ImageKey *key, const Memory::Range *range);
+
+    /**
+     * Invalidate all regions of a program file.
+     *
+     * @param key Identity of the program file. Only the path and server are used.
+     */
+    void remove(const ImageKey *key);
+
+    /**
+     * Remove cached regions from a MemoryContext.
+     *
+     * Must be called before the MemoryContext releases its pages.
+     *
+     * @param mem MemoryContext which maps cached regions
+     * @param range Only remove regions inside this range, or ZERO for all regions
+     */
+    void release(MemoryContext *mem, const Memory::Range *range = ZERO);
+
+    /**
+     * Free the pages of all unreferenced regions.
+     *
+     * @return Number of bytes freed
+     */
+    Size evict();
+
+  private:
+
+    /**
+     * Find a cached region.
+     *
+     * @return Entry pointer or ZERO if not found
+     */
+    Entry * find(const ImageKey *key, const Address virt, const Size size);
+
+    /**
+     * Invalidate regions of a program file.
+     *
+     * @param key Identity of the program file
+     * @param keepCurrent True to keep the regions of the same file version
+     */
+    void invalidate(const ImageKey *key, const bool keepCurrent);
+
+    /**
+     * Check if a physical page is owned by the cache.
+     *
+     * @param phys Physical address of the page
+     *
+     * @return True if owned by a cached region
+     */
+    bool isCached(const Address phys) const;
+
+    /**
+     * Free the pages of an unreferenced entry.
+     *
+     * @param entry Entry to free
+     */
+    void free(Entry *entry);
+
+  private:
+
+    /** Cached regions. */
+    Entry m_entries[MaximumEntries];
+
+    /** Physical memory allocator. */
+    SplitAllocator *m_alloc;
+
+    /** Incremented on every insert and map. */
+    Size m_clock;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_EXECUTABLECACHE_H */
@@ -26,6 +26,7 @@
 #include <BootImageStorage.h>
 #include <CoreInfo.h>
 #include "Kernel.h"
+#include "ExecutableCache.h"
 #include "Memory.h"
 #include "Process.h"
 #include "ProcessManager.h"
@@ -51,6 +52,7 @@ Kernel::Kernel(CoreInfo *info)
     // Initialize other class members
     m_procs  = new ProcessManager();
     m_api    = new API();
+    m_executableCache = new ExecutableCache(m_alloc);
     m_coreInfo   = info;
     m_intControl = ZERO;
     m_timer      = ZERO;
@@ -109,6 +111,11 @@ ProcessManager * Kernel::getProcessManager()
     return m_procs;
 }
 
+ExecutableCache * Kernel::getExecutableCache()
+{
+    return m_executableCache;
+}
+
 API * Kernel::getAPI()
 {
     return m_api;
@@ -30,6 +30,7 @@
 /** Forward declarations. */
 class API;
 class BootImageStorage;
+class ExecutableCache;
 class MemoryContext;
 class Process;
 class ProcessManager;
@@ -137,6 +138,13 @@ class Kernel : public WeakSingleton<Kernel>
      */
     ProcessManager * getProcessManager();
 
+    /**
+     * Get executable cache.
+     *
+     * @return Kernel ExecutableCache object pointer.
+     */
+    ExecutableCache * getExecutableCache();
+
     /**
      * Get API.
      *
@@ -229,6 +237,9 @@ class Kernel : public WeakSingleton<Kernel>
     /** Process Manager */
     ProcessManager *m_procs;
 
+    /** Shared read-only program regions */
+    ExecutableCache *m_executableCache;
+
     /** API handlers object */
     API *m_api;
 
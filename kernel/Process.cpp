@@ -20,6 +20,7 @@
 #include <MemoryBlock.h>
 #include <MemoryChannel.h>
 #include <SplitAllocator.h>
+#include "ExecutableCache.h"
 #include "Process.h"
 #include "ProcessEvent.h"
 
@@ -27,6 +28,11 @@ Process::Process(ProcessID id, Address entry, bool privileged, const MemoryMap &
     : m_id(id), m_map(map), m_shares(id)
 {
     m_state         = Stopped;
+    m_priority      = DefaultPriority;
+    m_level         = DefaultPriority;
+    m_schedulePrev  = ZERO;
+    m_scheduleNext  = ZERO;
+    m_scheduled     = false;
     m_parent        = 0;
     m_waitId        = 0;
     m_waitResult    = 0;
@@ -47,6 +53,9 @@ Process::~Process()
 
     if (m_memoryContext)
     {
+        // Shared program pages stay in the cache
+        Kernel::instance()->getExecutableCache()->release(m_memoryContext);
+
         m_memoryContext->releaseRegion(MemoryMap::UserData);
         m_memoryContext->releaseRegion(MemoryMap::UserHeap);
         m_memoryContext->releaseRegion(MemoryMap::UserStack);
@@ -92,6 +101,11 @@ const Timer::Info & Process::getSleepTimer() const
     return m_sleepTimer;
 }
 
+uint Process::getPriority() const
+{
+    return m_priority;
+}
+
 MemoryContext * Process::getMemoryContext()
 {
     return m_memoryContext;
@@ -32,6 +32,8 @@ class MemoryChannel;
 struct ProcessEvent;
 class ProcessManager;
 class Scheduler;
+template <class T, Size Levels> class RunQueue;
+template <class T, Size N> class SleepQueue;
 
 /**
  * @addtogroup kernel
@@ -45,6 +47,8 @@ class Process
 {
   friend class ProcessManager;
   friend class Scheduler;
+  template <class T, Size Levels> friend class RunQueue;
+  template <class T, Size N> friend class SleepQueue;
 
   public:
 
@@ -71,6 +75,21 @@ class Process
         Stopped
     };
 
+    /**
+     * Scheduling priority levels.
+     *
+     * A Ready Process with a higher priority runs before a Ready
+     * Process with a lower priority. Processes with an equal priority
+     * are scheduled in round-robin order. A Process which does not block
+     * drops one level for each time slice it uses.
+     */
+    enum Priority
+    {
+        MinimumPriority = 0,
+        DefaultPriority = 3,
+        MaximumPriority = 7
+    };
+
   public:
 
     /**
@@ -125,6 +144,13 @@ class Process
      */
     State getState() const;
 
+    /**
+     * Retrieve the scheduling priority.
+     *
+     * @return Priority level of the Process.
+     */
+    uint getPriority() const;
+
     /**
      * Get MMU memory context.
      *
@@ -251,6 +277,21 @@ class Process
     /** Current process status. */
     State m_state;
 
+    /** Scheduling priority level. */
+    uint m_priority;
+
+    /** Current run queue level, lowered for each used time slice. */
+    uint m_level;
+
+    /** Previous Process on the same Scheduler run queue, or ZERO. */
+    Process *m_schedulePrev;
+
+    /** Next Process on the same Scheduler run queue, or ZERO. */
+    Process *m_scheduleNext;
+
+    /** True if the Process is currently on a Scheduler run queue. */
+    bool m_scheduled;
+
     /** Waits for exit of this Process. */
     ProcessID m_waitId;
 
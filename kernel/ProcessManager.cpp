@@ -144,9 +144,7 @@ void ProcessManager::remove(Process *proc, const uint exitStatus)
         }
     }
 
-    const Size countRemoved = m_sleepTimerQueue.remove(proc);
-    assert(countRemoved <= 1U);
-    (void) countRemoved;
+    m_sleepTimerQueue.remove(proc);
 
     // Free the process memory
     delete proc;
@@ -155,7 +153,6 @@ void ProcessManager::remove(Process *proc, const uint exitStatus)
 ProcessManager::Result ProcessManager::schedule()
 {
     const Timer *timer = Kernel::instance()->getTimer();
-    const Size sleepTimerCount = m_sleepTimerQueue.count();
 
     // Let the scheduler select a new process
     Process *proc = m_scheduler->select();
@@ -169,23 +166,15 @@ ProcessManager::Result ProcessManager::schedule()
         FATAL("no process found to run!");
     }
 
-    // Try to wakeup processes that are waiting for a timer to expire
-    for (Size i = 0; i < sleepTimerCount; i++)
+    // Wakeup processes that are waiting for a timer to expire.
+    // The queue is ordered by deadline, thus stop at the first unexpired timer.
+    Process *p;
+    while ((p = m_sleepTimerQueue.expire(timer)) != ZERO)
     {
-        Process *p = m_sleepTimerQueue.pop();
-        const Timer::Info & procTimer = p->getSleepTimer();
-
-        if (timer->isExpired(procTimer))
-        {
-            const Result result = wakeup(p);
-            if (result != Success)
-            {
-                FATAL("failed to wakeup PID " << p->getID());
-            }
-        }
-        else
+        const Result result = wakeup(p);
+        if (result != Success)
         {
-            m_sleepTimerQueue.push(p);
+            FATAL("failed to wakeup PID " << p->getID());
         }
     }
 
@@ -271,6 +260,17 @@ ProcessManager::Result ProcessManager::reset(Process *proc, const Address entry)
     return Success;
 }
 
+ProcessManager::Result ProcessManager::setPriority(Process *proc, const uint priority)
+{
+    if (m_scheduler->setPriority(proc, priority) != Scheduler::Success)
+    {
+        ERROR("failed to set priority of PID " << proc->getID() << " to " << priority);
+        return InvalidArgument;
+    }
+
+    return Success;
+}
+
 ProcessManager::Result ProcessManager::sleep(const Timer::Info *timer, const bool ignoreWakeups)
 {
     const Process::Result result = m_current->sleep(timer, ignoreWakeups);
@@ -286,10 +286,10 @@ ProcessManager::Result ProcessManager::sleep(const Timer::Info *timer, const boo
                 FATAL("failed to dequeue PID " << m_current->getID());
             }
 
-            if (timer)
+            if (timer && timer->frequency)
             {
                 assert(!m_sleepTimerQueue.contains(m_current));
-                m_sleepTimerQueue.push(m_current);
+                m_sleepTimerQueue.insert(m_current);
             }
             break;
         }
@@ -404,10 +404,7 @@ ProcessManager::Result ProcessManager::enqueueProcess(Process *proc, const bool
         return IOError;
     }
 
-    const Size countRemoved = m_sleepTimerQueue.remove(proc);
-    assert(countRemoved <= 1U);
-    (void) countRemoved;
-
+    m_sleepTimerQueue.remove(proc);
     return Success;
 }
 
@@ -22,8 +22,8 @@
 #include <MemoryMap.h>
 #include <Vector.h>
 #include <List.h>
-#include <Queue.h>
 #include "Process.h"
+#include "SleepQueue.h"
 
 /* Forward declarations */
 class Scheduler;
@@ -142,6 +142,16 @@ class ProcessManager
      */
     Result reset(Process *proc, const Address entry);
 
+    /**
+     * Change the scheduling priority of a Process.
+     *
+     * @param proc Process pointer
+     * @param priority New priority level
+     *
+     * @return Result code
+     */
+    Result setPriority(Process *proc, const uint priority);
+
     /**
      * Let current Process sleep until a timer expires or wakeup occurs.
      *
@@ -247,8 +257,8 @@ class ProcessManager
     /** Idle process */
     Process *m_idle;
 
-    /** Queue with sleeping processes waiting for a Timer to expire. */
-    Queue<Process *, MAX_PROCS> m_sleepTimerQueue;
+    /** Sleeping processes waiting for a Timer to expire, ordered by deadline. */
+    SleepQueue<Process, MAX_PROCS> m_sleepTimerQueue;
 
     /** Interrupt notification list */
     Vector<List<Process *> *> m_interruptNotifyList;
@@ -269,6 +269,22 @@ ProcessShares::Result ProcessShares::removeShares(ProcessID pid)
     return Success;
 }
 
+ProcessShares::Result ProcessShares::removeShare(const MemoryShare *share)
+{
+    const Size size = m_shares.size();
+    MemoryShare *s = 0;
+
+    for (Size i = 0; i < size; i++)
+    {
+        if ((s = m_shares.get(i)) != ZERO &&
+             s->pid == share->pid && s->coreId == share->coreId && s->tagId == share->tagId)
+        {
+            return releaseShare(s, i);
+        }
+    }
+    return NotFound;
+}
+
 ProcessShares::Result ProcessShares::releaseShare(MemoryShare *s, Size idx)
 {
     assert(s->coreId == coreInfo.coreId);
@@ -288,7 +304,7 @@ ProcessShares::Result ProcessShares::releaseShare(MemoryShare *s, Size idx)
             ProcessShares & shares = proc->getShares();
             const Size size = shares.m_shares.size();
 
-            // Mark all process shares detached in the other process
+            // Mark the matching share detached in the other process
             for (Size i = 0; i < size; i++)
             {
                 MemoryShare *otherShare = shares.m_shares.get(i);
@@ -296,7 +312,8 @@ ProcessShares::Result ProcessShares::releaseShare(MemoryShare *s, Size idx)
                 {
                     assert(otherShare->coreId == coreInfo.coreId);
 
-                    if (otherShare->pid == m_pid && otherShare->coreId == s->coreId)
+                    if (otherShare->pid == m_pid && otherShare->coreId == s->coreId &&
+                        otherShare->tagId == s->tagId)
                     {
                         otherShare->attached = false;
                     }
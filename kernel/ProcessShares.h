@@ -146,6 +146,15 @@ class ProcessShares
      */
     Result removeShares(ProcessID pid);
 
+    /**
+     * Remove one share by Process, Core and Tag IDs.
+     *
+     * @param share MemoryShare buffer with the IDs to match
+     *
+     * @return Result code
+     */
+    Result removeShare(const MemoryShare *share);
+
   private:
 
     /**
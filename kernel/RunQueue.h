@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_RUNQUEUE_H
+#define __KERNEL_RUNQUEUE_H
+#ifndef __ASSEMBLER__
+
+#include <Types.h>
+#include <Macros.h>
+
+/**
+ * @addtogroup kernel
+ * @{
+ */
+
+/**
+ * Multi-level run queue with time slice demotion and aging.
+ *
+ * Each priority level has a doubly linked list formed by links embedded
+ * inside the queued objects, and a bitmap has one bit per non-empty level.
+ * All operations are constant time, regardless of the number of objects.
+ *
+ * Every time an object is selected to run it drops one level below its
+ * priority, such that a busy object cannot starve lower priority objects.
+ * Removing the object (e.g. when it blocks) restores its level to its priority.
+ * Additionally, every AgingPeriod selections the longest waiting object at
+ * the lowest level is raised to the highest non-empty level.
+ *
+ * The queued type T must provide the members m_priority, m_level,
+ * m_schedulePrev, m_scheduleNext and m_scheduled.
+ *
+ * @param T Type of the queued objects.
+ * @param Levels Number of priority levels, at most 32.
+ */
+template <class T, Size Levels> class RunQueue
+{
+  public:
+
+    /** Number of selections after which a waiting object is raised. */
+    static const Size AgingPeriod = 16;
+
+  public:
+
+    /**
+     * Constructor.
+     */
+    RunQueue()
+        : m_levels(0)
+        , m_count(0)
+        , m_selects(0)
+    {
+        for (Size i = 0; i < Levels; i++)
+        {
+            m_head[i] = ZERO;
+            m_tail[i] = ZERO;
+        }
+    }
+
+    /**
+     * Get number of queued objects.
+     *
+     * @return Number of queued objects.
+     */
+    Size count() const
+    {
+        return m_count;
+    }
+
+    /**
+     * Add an object to the tail of its current level.
+     *
+     * @param obj Object pointer, which must not be queued.
+     */
+    void insert(T *obj)
+    {
+        link(obj);
+    }
+
+    /**
+     * Remove an object and restore its level to its priority.
+     *
+     * @param obj Object pointer, which must be queued.
+     */
+    void remove(T *obj)
+    {
+        unlink(obj);
+        obj->m_level = obj->m_priority;
+    }
+
+    /**
+     * Select the next object to run.
+     *
+     * The selected object is moved to the tail of the level below,
+     * or of the lowest level if it is already there.
+     *
+     * @return Object pointer or ZERO if the queue is empty.
+     */
+    T * select()
+    {
+        if (m_levels == 0)
+            return ZERO;
+
+        // Periodically raise the object waiting at the lowest level
+        if (++m_selects >= AgingPeriod)
+        {
+            const uint lowest = __builtin_ctz(m_levels);
+            const uint highest = 31U - __builtin_clz(m_levels);
+            T *waiting = m_head[lowest];
+
+            m_selects = 0;
+
+            if (lowest != highest)
+            {
+                unlink(waiting);
+                waiting->m_level = highest;
+                link(waiting);
+            }
+        }
+
+        // Pick the head of the highest level
+        T *obj = m_head[31U - __builtin_clz(m_levels)];
+
+        // Demote it for using a time slice. This also gives round-robin within a level.
+        unlink(obj);
+        if (obj->m_level > 0)
+            obj->m_level--;
+        link(obj);
+
+        return obj;
+    }
+
+    /**
+     * Change the priority of an object.
+     *
+     * If the object is queued, it is moved to the tail of the new level.
+     *
+     * @param obj Object pointer.
+     * @param priority New priority level, less than Levels.
+     */
+    void setPriority(T *obj, const uint priority)
+    {
+        const bool queued = obj->m_scheduled;
+
+        if (queued)
+            unlink(obj);
+
+        obj->m_priority = priority;
+        obj->m_level    = priority;
+
+        if (queued)
+            link(obj);
+    }
+
+  private:
+
+    /**
+     * Append an object to the tail of its current level.
+     *
+     * @param obj Object pointer.
+     */
+    void link(T *obj)
+    {
+        const uint level = obj->m_level;
+
+        obj->m_schedulePrev = m_tail[level];
+        obj->m_scheduleNext = ZERO;
+        obj->m_scheduled    = true;
+
+        if (m_tail[level] != ZERO)
+            m_tail[level]->m_scheduleNext = obj;
+        else
+            m_head[level] = obj;
+
+        m_tail[level] = obj;
+        m_levels |= (1U << level);
+        m_count++;
+    }
+
+    /**
+     * Remove an object from its current level.
+     *
+     * @param obj Object pointer.
+     */
+    void unlink(T *obj)
+    {
+        const uint level = obj->m_level;
+
+        if (obj->m_schedulePrev != ZERO)
+            obj->m_schedulePrev->m_scheduleNext = obj->m_scheduleNext;
+        else
+            m_head[level] = obj->m_scheduleNext;
+
+        if (obj->m_scheduleNext != ZERO)
+            obj->m_scheduleNext->m_schedulePrev = obj->m_schedulePrev;
+        else
+            m_tail[level] = obj->m_schedulePrev;
+
+        if (m_head[level] == ZERO)
+            m_levels &= ~(1U << level);
+
+        obj->m_schedulePrev = ZERO;
+        obj->m_scheduleNext = ZERO;
+        obj->m_scheduled    = false;
+        m_count--;
+    }
+
+  private:
+
+    /** First object in each level */
+    T *m_head[Levels];
+
+    /** Last object in each level */
+    T *m_tail[Levels];
+
+    /** Contains one bit for each non-empty level */
+    u32 m_levels;
+
+    /** Number of queued objects */
+    Size m_count;
+
+    /** Number of selections since the last aging */
+    Size m_selects;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __ASSEMBLER__ */
+#endif /* __KERNEL_RUNQUEUE_H */
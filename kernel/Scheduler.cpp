@@ -37,7 +37,13 @@ Scheduler::Result Scheduler::enqueue(Process *proc, bool ignoreState)
         return InvalidArgument;
     }
 
-    m_queue.push(proc);
+    if (proc->m_scheduled)
+    {
+        ERROR("process ID " << proc->getID() << " is already in the schedule");
+        return InvalidArgument;
+    }
+
+    m_queue.insert(proc);
     return Success;
 }
 
@@ -49,32 +55,29 @@ Scheduler::Result Scheduler::dequeue(Process *proc, bool ignoreState)
         return InvalidArgument;
     }
 
-    Size count = m_queue.count();
-
-    // Traverse the Queue to remove the Process
-    for (Size i = 0; i < count; i++)
+    if (!proc->m_scheduled)
     {
-        Process *p = m_queue.pop();
-
-        if (p == proc)
-            return Success;
-        else
-            m_queue.push(p);
+        FATAL("process ID " << proc->getID() << " is not in the schedule");
+        return InvalidArgument;
     }
 
-    FATAL("process ID " << proc->getID() << " is not in the schedule");
-    return InvalidArgument;
+    m_queue.remove(proc);
+    return Success;
 }
 
 Process * Scheduler::select()
 {
-    if (m_queue.count() > 0)
-    {
-        Process *p = m_queue.pop();
-        m_queue.push(p);
+    return m_queue.select();
+}
 
-        return p;
+Scheduler::Result Scheduler::setPriority(Process *proc, const uint priority)
+{
+    if (priority > Process::MaximumPriority)
+    {
+        ERROR("process ID " << proc->getID() << " has invalid priority: " << priority);
+        return InvalidArgument;
     }
 
-    return (Process *) NULL;
+    m_queue.setPriority(proc, priority);
+    return Success;
 }
@@ -19,19 +19,29 @@
 #define __KERNEL_SCHEDULER_H
 #ifndef __ASSEMBLER__
 
-#include <Vector.h>
+#include <Types.h>
 #include <Macros.h>
-#include <Queue.h>
 #include "Process.h"
-#include "ProcessManager.h"
+#include "RunQueue.h"
 
 /**
  * @addtogroup kernel
  * @{
  */
 
+/**
+ * Number of priority levels known to the Scheduler.
+ */
+#define SCHEDULER_PRIORITY_LEVELS (Process::MaximumPriority + 1)
+
 /**
  * Responsible for deciding which Process may execute on the local Core.
+ *
+ * The Scheduler keeps Ready processes in a multi-level RunQueue, which
+ * finds the highest priority Process in constant time. A Process which keeps
+ * running drops in priority with every time slice, until it blocks.
+ *
+ * @see RunQueue
  */
 class Scheduler
 {
@@ -87,10 +97,24 @@ class Scheduler
      */
     Process * select();
 
+    /**
+     * Change the scheduling priority of a Process.
+     *
+     * If the Process is on the run schedule, it is moved to
+     * the tail of the run queue for the new priority level.
+     * This also resets any demotion for used time slices.
+     *
+     * @param proc Process pointer
+     * @param priority New priority level
+     *
+     * @return Result code
+     */
+    Result setPriority(Process *proc, const uint priority);
+
   private:
 
-    /** Contains processes ready to run */
-    Queue<Process *, MAX_PROCS> m_queue;
+    /** Run queue with all Ready processes */
+    RunQueue<Process, SCHEDULER_PRIORITY_LEVELS> m_queue;
 };
 
 /**
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_SLEEPQUEUE_H
+#define __KERNEL_SLEEPQUEUE_H
+#ifndef __ASSEMBLER__
+
+#include <Types.h>
+#include <Macros.h>
+#include <IndexHeap.h>
+#include <Timer.h>
+
+/**
+ * @addtogroup kernel
+ * @{
+ */
+
+/**
+ * Objects sleeping until their Timer expires, ordered by deadline.
+ *
+ * The objects are kept in an IndexHeap on the timer ticks of their
+ * deadline. Finding the expired objects only looks at the earliest
+ * deadlines, thus the cost per timer tick does not depend on the
+ * number of sleeping objects. Insert and remove take logarithmic time.
+ *
+ * The queued type T must provide getID() with a value below N and
+ * getSleepTimer() with the Timer::Info of its deadline.
+ *
+ * @param T Type of the queued objects.
+ * @param N Maximum number of objects.
+ */
+template <class T, Size N> class SleepQueue
+{
+  public:
+
+    /**
+     * Constructor.
+     */
+    SleepQueue()
+    {
+        for (Size i = 0; i < N; i++)
+        {
+            m_objects[i] = ZERO;
+        }
+    }
+
+    /**
+     * Get number of sleeping objects.
+     *
+     * @return Number of sleeping objects.
+     */
+    Size count() const
+    {
+        return m_heap.count();
+    }
+
+    /**
+     * Check if an object is sleeping.
+     *
+     * @param obj Object to look for.
+     *
+     * @return True if sleeping, false otherwise.
+     */
+    bool contains(const T *obj) const
+    {
+        return m_heap.contains(obj->getID());
+    }
+
+    /**
+     * Insert an object, which wakes up on its sleep timer.
+     *
+     * @param obj Object to insert.
+     *
+     * @return True on success, false if already sleeping.
+     */
+    bool insert(T *obj)
+    {
+        if (!m_heap.insert(obj->getID(), obj->getSleepTimer().ticks))
+        {
+            return false;
+        }
+
+        m_objects[obj->getID()] = obj;
+        return true;
+    }
+
+    /**
+     * Remove an object, for example when it is woken up early.
+     *
+     * @param obj Object to remove.
+     *
+     * @return True if removed, false if it was not sleeping.
+     */
+    bool remove(const T *obj)
+    {
+        if (!m_heap.remove(obj->getID()))
+        {
+            return false;
+        }
+
+        m_objects[obj->getID()] = ZERO;
+        return true;
+    }
+
+    /**
+     * Remove the object with the earliest deadline, if it has expired.
+     *
+     * @param timer Timer to compare the deadline with.
+     *
+     * @return Expired object or ZERO if no object has expired.
+     */
+    T * expire(const Timer *timer)
+    {
+        if (m_heap.count() == 0)
+        {
+            return ZERO;
+        }
+
+        T *obj = m_objects[m_heap.top()];
+
+        if (!timer->isExpired(obj->getSleepTimer()))
+        {
+            return ZERO;
+        }
+
+        m_heap.pop();
+        m_objects[obj->getID()] = ZERO;
+        return obj;
+    }
+
+  private:
+
+    /** Index numbers of the sleeping objects, ordered by deadline ticks. */
+    IndexHeap<u32, N> m_heap;
+
+    /** Sleeping object for each index number. */
+    T *m_objects[N];
+};
+
+/**
+ * @}
+ */
+
+#endif /* __ASSEMBLER__ */
+#endif /* __KERNEL_SLEEPQUEUE_H */
@@ -98,6 +98,18 @@ void ARMKernel::prefetchAbort(CPUState state)
 void ARMKernel::dataAbort(CPUState state)
 {
     ARMCore core;
+    ARMControl ctrl;
+    MemoryContext *mem = Kernel::instance()->getProcessManager()->current()->getMemoryContext();
+    const Address addr = ctrl.read(ARMControl::DataFaultAddress);
+    Address phys;
+
+    // Map lazily reserved pages on first access and retry the instruction
+    if (mem->lookup(addr, &phys) == MemoryContext::InvalidAddress &&
+        mem->touch(addr, &phys) == MemoryContext::Success)
+    {
+        return;
+    }
+
     core.logException(&state);
 
     FATAL("core" << coreInfo.coreId << ": procId = " <<
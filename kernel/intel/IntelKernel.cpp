@@ -145,10 +145,31 @@ void IntelKernel::enableIRQ(u32 irq, bool enabled)
     Kernel::enableIRQ(irq, enabled);
 }
 
+Kernel::Result IntelKernel::sendIRQ(const uint coreId, const uint irq)
+{
+    if (m_apic.sendIPI(coreId, irq) != IntController::Success)
+    {
+        ERROR("failed to send IPI to core" << coreId);
+        return IOError;
+    }
+
+    return Success;
+}
+
 void IntelKernel::exception(CPUState *state, ulong param, ulong vector)
 {
     IntelCore core;
     ProcessManager *procs = Kernel::instance()->getProcessManager();
+    MemoryContext *mem = procs->current()->getMemoryContext();
+    Address phys;
+
+    // Map lazily reserved pages on first access and retry the instruction
+    if (state->vector == INTEL_PAGEFAULT &&
+        mem->lookup(core.readCR2(), &phys) == MemoryContext::InvalidAddress &&
+        mem->touch(core.readCR2(), &phys) == MemoryContext::Success)
+    {
+        return;
+    }
 
     core.logException(state);
     FATAL("core" << coreInfo.coreId << ": Exception in Process: " << procs->current()->getID());
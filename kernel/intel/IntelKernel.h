@@ -54,6 +54,19 @@ class IntelKernel : public Kernel
      */
     virtual void enableIRQ(u32 irq, bool enabled);
 
+    /**
+     * Send a inter-processor-interrupt (IPI) to another core.
+     *
+     * IPIs are always sent via the local APIC, also on core0
+     * which uses the PIC for hardware interrupts.
+     *
+     * @param coreId Target Core to deliver the interrupt to.
+     * @param irq Interrupt vector to deliver
+     *
+     * @return Result code
+     */
+    virtual Result sendIRQ(const uint coreId, const uint irq);
+
   private:
 
     /**
@@ -25,6 +25,8 @@ PoolAllocator::PoolAllocator(Allocator *parent)
     assert(parent != NULL);
     setParent(parent);
     MemoryBlock::set(m_pools, 0, sizeof(m_pools));
+    MemoryBlock::set(m_partial, 0, sizeof(m_partial));
+    MemoryBlock::set(m_poolCount, 0, sizeof(m_poolCount));
 }
 
 Size PoolAllocator::size() const
@@ -105,20 +107,21 @@ Allocator::Result PoolAllocator::allocate(Allocator::Range & args)
     // Attempt to allocate
     if (pool)
     {
-        Result result = static_cast<Allocator *>(pool)->allocate(args);
-        if (result == Success)
-        {
-            ObjectPrefix *prefix = (ObjectPrefix *) args.address;
-            prefix->signature = ObjectSignature;
-            prefix->pool = pool;
+        const Address addr = allocateObject(pool);
 
-            ObjectPostfix *postfix = (ObjectPostfix *) (args.address + sizeof(ObjectPrefix) + inputSize);
-            postfix->signature = ObjectSignature;
+        ObjectPrefix *prefix = (ObjectPrefix *) addr;
+        prefix->pool = pool;
 
-            args.address += sizeof(ObjectPrefix);
-        }
+#ifdef __ASSERT__
+        prefix->signature = ObjectSignature;
+        prefix->size = inputSize;
 
-        return result;
+        ObjectPostfix *postfix = (ObjectPostfix *) (addr + ObjectPrefixSize + inputSize);
+        postfix->signature = ObjectSignature;
+#endif /* __ASSERT__ */
+
+        args.address = addr + ObjectPrefixSize;
+        return Success;
     }
     else
     {
@@ -129,34 +132,27 @@ Allocator::Result PoolAllocator::allocate(Allocator::Range & args)
 
 Allocator::Result PoolAllocator::release(const Address addr)
 {
-    const Address actualAddr = addr - sizeof(ObjectPrefix);
+    const Address actualAddr = addr - ObjectPrefixSize;
     const ObjectPrefix *prefix = (const ObjectPrefix *) (actualAddr);
-    ObjectPostfix *postfix = ZERO;
+    Pool *pool = prefix->pool;
 
-    // Verify the object prefix signature
+#ifdef __ASSERT__
+    // Verify the object prefix and postfix signatures
+    const ObjectPostfix *postfix = (const ObjectPostfix *) (addr + prefix->size);
     assert(prefix->signature == ObjectSignature);
-    assert(prefix->pool != NULL);
-
-    // Do a reverse memory scan to find the object postfix.
-    for (Size i = prefix->pool->chunkSize() - sizeof(u32); i > sizeof(ObjectPrefix); i -= sizeof(u32))
-    {
-        postfix = (ObjectPostfix *)(actualAddr + i);
-        if (postfix->signature == ObjectSignature)
-            break;
-    }
-
-    // Verify the object postfix signature
-    assert(postfix != ZERO);
     assert(postfix->signature == ObjectSignature);
+#endif /* __ASSERT__ */
+
+    assert(pool != NULL);
 
     // Release the object
-    Result result = prefix->pool->release(actualAddr);
+    Result result = releaseObject(pool, actualAddr);
     assert(result == Success);
 
     // Also try to release the pool itself, if no longer used
-    if (prefix->pool->available() == prefix->pool->size())
+    if (pool->available() == pool->size())
     {
-        releasePool(prefix->pool);
+        releasePool(pool);
     }
 
     return result;
@@ -164,9 +160,8 @@ Allocator::Result PoolAllocator::release(const Address addr)
 
 PoolAllocator::Pool * PoolAllocator::retrievePool(const Size inputSize)
 {
-    const Size requestedSize = inputSize + sizeof(ObjectPrefix) + sizeof(ObjectPostfix);
-    Size index, nPools = 1, objectSize = 0;
-    Pool *pool = ZERO;
+    const Size requestedSize = inputSize + ObjectPrefixSize + ObjectPostfixSize;
+    Size index, objectSize = 0;
 
     // Find the correct pool index
     for (index = MinimumPoolSize; index <= MaximumPoolSize; index++)
@@ -183,30 +178,91 @@ PoolAllocator::Pool * PoolAllocator::retrievePool(const Size inputSize)
         return ZERO;
     }
 
-    // Do we need to allocate an initial pool?
-    if (!m_pools[index])
+    // Use a pool which has free objects, if any
+    if (m_partial[index])
     {
-        pool = m_pools[index] = allocatePool(index, calculateObjectCount(objectSize));
+        return m_partial[index];
+    }
+
+    // Allocate a new pool, which grows with the number of existing pools
+    const Size nPools = m_poolCount[index] ? m_poolCount[index] : 1;
+    return allocatePool(index, calculateObjectCount(objectSize) * nPools);
+}
+
+Address PoolAllocator::allocateObject(Pool *pool)
+{
+    Address addr;
+
+    assert(pool->available() > 0);
+
+    // Prefer recently released objects, otherwise take the next unused object
+    if (pool->freeList)
+    {
+        addr = pool->freeList;
+        pool->freeList = *(Address *) addr;
     }
-    // Search for existing pool with enough memory
     else
     {
-        for (pool = m_pools[index]; pool; pool = pool->next, nPools++)
+        assert(pool->unused < pool->size() / pool->chunkSize());
+        addr = pool->base() + (pool->unused * pool->chunkSize());
+        pool->unused++;
+    }
+
+    const Result result = pool->allocateAt(addr);
+    assert(result == Success);
+    (void) result;
+
+    // Full pools are not eligible for allocation
+    if (pool->available() == 0)
+    {
+        removePartial(pool);
+    }
+
+    return addr;
+}
+
+Allocator::Result PoolAllocator::releaseObject(Pool *pool, const Address addr)
+{
+    const bool wasFull = pool->available() == 0;
+    const Result result = pool->release(addr);
+
+    if (result == Success)
+    {
+        *(Address *) addr = pool->freeList;
+        pool->freeList = addr;
+
+        if (wasFull)
         {
-            // Use current pool or if out of space allocate another
-            if (pool->available())
-            {
-                break;
-            }
-            else if (!pool->next)
-            {
-                pool = allocatePool(index, calculateObjectCount(objectSize) * nPools);
-                break;
-            }
+            insertPartial(pool);
         }
     }
 
-    return pool;
+    return result;
+}
+
+void PoolAllocator::insertPartial(Pool *pool)
+{
+    pool->partialPrev = ZERO;
+    pool->partialNext = m_partial[pool->index];
+
+    if (pool->partialNext != NULL)
+        pool->partialNext->partialPrev = pool;
+
+    m_partial[pool->index] = pool;
+}
+
+void PoolAllocator::removePartial(Pool *pool)
+{
+    if (pool->partialPrev != NULL)
+        pool->partialPrev->partialNext = pool->partialNext;
+    else if (m_partial[pool->index] == pool)
+        m_partial[pool->index] = pool->partialNext;
+
+    if (pool->partialNext != NULL)
+        pool->partialNext->partialPrev = pool->partialPrev;
+
+    pool->partialPrev = ZERO;
+    pool->partialNext = ZERO;
 }
 
 PoolAllocator::Pool * PoolAllocator::allocatePool(const Size index, const Size objectCount)
@@ -214,7 +270,8 @@ PoolAllocator::Pool * PoolAllocator::allocatePool(const Size index, const Size o
     const Size objectSize = calculateObjectSize(index);
     const Size requestBitmapSize = objectCount;
     const Size requestPayloadSize = objectCount * objectSize;
-    const Size requestTotalSize = aligned(sizeof(Pool) + requestBitmapSize + requestPayloadSize, sizeof(u32));
+    const Size requestTotalSize = aligned(sizeof(Pool) + requestBitmapSize + requestPayloadSize +
+                                          ObjectAlignment, sizeof(u32));
     Pool *pool = 0;
     Allocator::Range alloc_args;
 
@@ -233,7 +290,7 @@ PoolAllocator::Pool * PoolAllocator::allocatePool(const Size index, const Size o
 
     // The parent might have returned more space than requested.
     // Calculate the optimum usage of the full space.
-    Size actualObjectCount = (alloc_args.size - sizeof(Pool) - requestBitmapSize) / objectSize;
+    Size actualObjectCount = (alloc_args.size - sizeof(Pool) - requestBitmapSize - ObjectAlignment) / objectSize;
     Size actualPayloadSize = 0;
     Size actualBitmapSize = 0;
     Size actualTotalSize = 0;
@@ -244,7 +301,7 @@ PoolAllocator::Pool * PoolAllocator::allocatePool(const Size index, const Size o
     {
         actualPayloadSize = actualObjectCount * objectSize;
         actualBitmapSize = aligned(actualObjectCount, sizeof(u32));
-        actualTotalSize = sizeof(Pool) + actualBitmapSize + actualPayloadSize;
+        actualTotalSize = sizeof(Pool) + actualBitmapSize + actualPayloadSize + ObjectAlignment;
 
         if (actualTotalSize <= alloc_args.size)
             break;
@@ -254,7 +311,8 @@ PoolAllocator::Pool * PoolAllocator::allocatePool(const Size index, const Size o
 
     // Calculate inputs for Pool object
     const Address bitmapAddr = alloc_args.address + sizeof(Pool);
-    const Allocator::Range range = { bitmapAddr + actualBitmapSize, actualPayloadSize, sizeof(u32) };
+    const Address payloadAddr = aligned(bitmapAddr + actualBitmapSize, ObjectAlignment);
+    const Allocator::Range range = { payloadAddr, actualPayloadSize, ObjectAlignment };
 
     // Instantiate the Pool object
     pool = new (alloc_args.address) Pool(range, objectSize, actualBitmapSize, (u8 *) bitmapAddr);
@@ -266,6 +324,9 @@ PoolAllocator::Pool * PoolAllocator::allocatePool(const Size index, const Size o
     if (pool->next != NULL)
         pool->next->prev = pool;
 
+    m_poolCount[index]++;
+    insertPartial(pool);
+
     return pool;
 }
 
@@ -274,6 +335,10 @@ Allocator::Result PoolAllocator::releasePool(Pool *pool)
     Pool *prevPool = pool->prev;
     Pool *nextPool = pool->next;
     const Size index = pool->index;
+
+    // An unused pool always has free objects, thus is on the partial list
+    removePartial(pool);
+
     const Result parentResult = parent()->release((Address) pool);
 
     // Only update Pool administration if memory was released at parent
@@ -293,6 +358,12 @@ Allocator::Result PoolAllocator::releasePool(Pool *pool)
         {
             m_pools[index] = nextPool;
         }
+
+        m_poolCount[index]--;
+    }
+    else
+    {
+        insertPartial(pool);
     }
 
     return parentResult;
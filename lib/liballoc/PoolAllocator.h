@@ -36,6 +36,13 @@
  *
  * Allocates memory from pools each having the size of a power of two.
  * Each pool is pre-allocated and has a bitmap representing free blocks.
+ * Released objects are kept on a free list inside each pool and pools
+ * with free objects are kept on a per-size list of partial pools, such that
+ * both allocating and releasing an object takes constant time.
+ *
+ * When compiled with __ASSERT__, each object is surrounded by a prefix and
+ * postfix signature which are verified on release to detect corruption.
+ * Returned objects are always aligned on ObjectAlignment.
  */
 class PoolAllocator : public Allocator
 {
@@ -50,6 +57,9 @@ class PoolAllocator : public Allocator
     /** Signature value is used to detect object corruption/overflows */
     static const u32 ObjectSignature = 0xF7312A56;
 
+    /** Alignment of returned objects, suitable for any fundamental type. */
+    static const Size ObjectAlignment = sizeof(Address) * 2;
+
     /**
      * Allocates same-sized objects from a contiguous block of memory.
      */
@@ -62,23 +72,34 @@ class PoolAllocator : public Allocator
         : BitAllocator(range, objectSize, bitmap)
         , prev(ZERO)
         , next(ZERO)
+        , partialPrev(ZERO)
+        , partialNext(ZERO)
         , index(0)
         , bitmapSize(bitmapSize)
+        , freeList(ZERO)
+        , unused(0)
         {
         }
 
         Pool *prev;            /**< Points to the previous pool of this size (if any). */
         Pool *next;            /**< Points to the next pool of this size (if any). */
+        Pool *partialPrev;     /**< Points to the previous pool of this size with free objects (if any). */
+        Pool *partialNext;     /**< Points to the next pool of this size with free objects (if any). */
         Size index;            /**< Index number in the m_pools array where this Pool is stored. */
         const Size bitmapSize; /**< Size in bytes of the bitmap array. */
+        Address freeList;      /**< Address of the first released object (if any). */
+        Size unused;           /**< Number of objects from the start of the pool that were ever allocated. */
     } Pool;
 
+#ifdef __ASSERT__
+
     /**
      * This data structure is prepended in memory before each object
      */
     typedef struct ObjectPrefix
     {
         u32 signature;  /**< Filled with a fixed value to detect corruption/overflows */
+        Size size;      /**< Size of the object in bytes, used to find the postfix */
         Pool *pool;     /**< Points to the Pool instance where this object belongs to */
     } ObjectPrefix;
 
@@ -90,6 +111,28 @@ class PoolAllocator : public Allocator
         u32 signature;  /**< Filled with a fixed value to detect corruption/overflows */
     } ObjectPostfix;
 
+    /** Number of bytes needed for the ObjectPostfix */
+    static const Size ObjectPostfixSize = sizeof(ObjectPostfix);
+
+#else
+
+    /**
+     * This data structure is prepended in memory before each object
+     */
+    typedef struct ObjectPrefix
+    {
+        Pool *pool;     /**< Points to the Pool instance where this object belongs to */
+    } ObjectPrefix;
+
+    /** Number of bytes needed for the ObjectPostfix */
+    static const Size ObjectPostfixSize = 0;
+
+#endif /* __ASSERT__ */
+
+    /** Number of bytes needed for the ObjectPrefix, padded to keep objects aligned */
+    static const Size ObjectPrefixSize = ((sizeof(ObjectPrefix) + ObjectAlignment - 1) /
+                                           ObjectAlignment) * ObjectAlignment;
+
   public:
 
     /**
@@ -171,6 +214,39 @@ class PoolAllocator : public Allocator
      */
     Pool * retrievePool(const Size inputSize);
 
+    /**
+     * Take a free object from a Pool.
+     *
+     * @param pool Pool object pointer which must have free objects.
+     *
+     * @return Address of the object
+     */
+    Address allocateObject(Pool *pool);
+
+    /**
+     * Put an object back in its Pool.
+     *
+     * @param pool Pool object pointer which owns the object.
+     * @param addr Address of the object
+     *
+     * @return Result value.
+     */
+    Result releaseObject(Pool *pool, const Address addr);
+
+    /**
+     * Add a Pool to the list of pools with free objects.
+     *
+     * @param pool Pool object pointer
+     */
+    void insertPartial(Pool *pool);
+
+    /**
+     * Remove a Pool from the list of pools with free objects.
+     *
+     * @param pool Pool object pointer
+     */
+    void removePartial(Pool *pool);
+
     /**
      * Creates a new Pool instance.
      *
@@ -194,6 +270,12 @@ class PoolAllocator : public Allocator
 
     /** Array of memory pools. Index represents the power of two. */
     Pool *m_pools[MaximumPoolSize + 1];
+
+    /** Array of memory pools with free objects. Index represents the power of two. */
+    Pool *m_partial[MaximumPoolSize + 1];
+
+    /** Number of memory pools for each power of two. */
+    Size m_poolCount[MaximumPoolSize + 1];
 };
 
 /**
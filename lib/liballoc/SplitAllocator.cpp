@@ -107,3 +107,12 @@ bool SplitAllocator::isAllocated(const Address page) const
 {
     return m_alloc.isAllocated(page);
 }
+
+bool SplitAllocator::isMapped(const Address phys, const Size bytes) const
+{
+    const Size mappedSize = size() < m_virtRange.size ? size() : m_virtRange.size;
+
+    return phys >= base() &&
+           phys - base() <= mappedSize &&
+           bytes <= mappedSize - (phys - base());
+}
@@ -135,6 +135,16 @@ class SplitAllocator : public Allocator
      */
     bool isAllocated(const Address page) const;
 
+    /**
+     * Check if a physical memory range is covered by the virtual mapping.
+     *
+     * @param phys Physical address of the range
+     * @param bytes Number of bytes in the range
+     *
+     * @return True if toVirtual() may be used for the whole range, false otherwise.
+     */
+    bool isMapped(const Address phys, const Size bytes) const;
+
   private:
 
     /** Physical memory allocator. */
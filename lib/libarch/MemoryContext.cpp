@@ -17,6 +17,7 @@
 
 #include <FreeNOS/System.h>
 #include <SplitAllocator.h>
+#include <MemoryBlock.h>
 #include "MemoryContext.h"
 
 MemoryContext * MemoryContext::m_current = 0;
@@ -28,10 +29,16 @@ MemoryContext::MemoryContext(MemoryMap *map, SplitAllocator *alloc)
     , m_savedRange(ZERO)
     , m_numSparsePages(ZERO)
 {
+    for (Size i = 0; i < MEMORYMAP_MAX_REGIONS; i++)
+        m_regionPages[i] = ZERO;
+
+    MemoryBlock::set(m_lazyRanges, 0, sizeof(m_lazyRanges));
 }
 
 MemoryContext::~MemoryContext()
 {
+    for (Size i = 0; i < MEMORYMAP_MAX_REGIONS; i++)
+        delete m_regionPages[i];
 }
 
 MemoryContext * MemoryContext::getCurrent()
@@ -88,6 +95,78 @@ MemoryContext::Result MemoryContext::mapRangeSparse(Memory::Range *range)
     return Success;
 }
 
+MemoryContext::Result MemoryContext::mapRangeLazy(const Memory::Range *range)
+{
+    Size slot = MaximumLazyRanges;
+
+    if (range->virt & ~PAGEMASK)
+        return InvalidAddress;
+
+    if (!range->size || (range->size & ~PAGEMASK))
+        return InvalidSize;
+
+    for (Size i = 0; i < MaximumLazyRanges; i++)
+    {
+        const Memory::Range & r = m_lazyRanges[i];
+
+        if (!r.size)
+        {
+            if (slot == MaximumLazyRanges)
+                slot = i;
+        }
+        else if (range->virt < r.virt + r.size && r.virt < range->virt + range->size)
+            return AlreadyExists;
+    }
+
+    if (slot == MaximumLazyRanges)
+        return OutOfMemory;
+
+    m_lazyRanges[slot] = *range;
+    return Success;
+}
+
+MemoryContext::Result MemoryContext::touch(Address virt, Address *phys)
+{
+    Allocator::Range allocPhys, allocVirt;
+    Result result = lookup(virt, phys);
+
+    if (result != InvalidAddress)
+        return result;
+
+    for (Size i = 0; i < MaximumLazyRanges; i++)
+    {
+        const Memory::Range & r = m_lazyRanges[i];
+
+        if (virt - r.virt >= r.size)
+            continue;
+
+        allocPhys.address = 0;
+        allocPhys.size = PAGESIZE;
+        allocPhys.alignment = PAGESIZE;
+
+        if (m_alloc->allocate(allocPhys, allocVirt) != Allocator::Success)
+            return OutOfMemory;
+
+        // The page is zeroed through the kernel mapping, which may not cover it
+        if (!m_alloc->isMapped(allocPhys.address, PAGESIZE))
+        {
+            m_alloc->release(allocPhys.address);
+            return OutOfMemory;
+        }
+        MemoryBlock::set((void *) allocVirt.address, 0, PAGESIZE);
+
+        if ((result = map(virt & PAGEMASK, allocPhys.address, r.access)) != Success)
+        {
+            m_alloc->release(allocPhys.address);
+            return result;
+        }
+
+        *phys = allocPhys.address;
+        return Success;
+    }
+    return InvalidAddress;
+}
+
 MemoryContext::Result MemoryContext::unmapRange(Memory::Range *range)
 {
     Result r = Success;
@@ -110,33 +189,136 @@ MemoryContext::Result MemoryContext::release(Address virt)
     return result;
 }
 
-MemoryContext::Result MemoryContext::findFree(Size size, MemoryMap::Region region, Address *virt) const
+MemoryContext::Result MemoryContext::findFree(Size size, MemoryMap::Region region, Address *virt)
 {
-    Memory::Range r = m_map->range(region);
-    Size currentSize = 0;
-    Address addr = r.virt, currentAddr = r.virt, tmp;
+    const Memory::Range r = m_map->range(region);
+    const Size count = (size + PAGESIZE - 1) / PAGESIZE;
+    const Size regionPages = r.size / PAGESIZE;
+    BitArray *pages = getRegionPages(region);
+    bool rescanned = false;
+    Size bit, from = 0, i;
+    Address tmp;
 
-    while (addr < r.virt+r.size && currentSize < size)
+    if (count == 0)
     {
-        if (lookup(addr, &tmp) == InvalidAddress)
+        *virt = r.virt;
+        return Success;
+    }
+
+    while (true)
+    {
+        // Find a candidate block in the administration
+        if (pages->findNext(&bit, count, from) != BitArray::Success)
+        {
+            // Cover more of the region before giving up
+            if (pages->size() < regionPages)
+            {
+                pages = growRegionPages(region, pages->size() + count);
+                continue;
+            }
+
+            // Pages may have been released without notice: rescan once
+            if (rescanned)
+                return OutOfMemory;
+
+            rescanRegion(region, pages);
+            rescanned = true;
+            from = 0;
+            continue;
+        }
+
+        // Verify the block is really unused
+        for (i = 0; i < count; i++)
         {
-            currentSize += PAGESIZE;
+            if (lookup(r.virt + ((bit + i) * PAGESIZE), &tmp) != InvalidAddress)
+            {
+                pages->set(bit + i);
+                break;
+            }
         }
-        else
+
+        if (i == count)
         {
-            currentSize = 0; 
-            currentAddr = addr + PAGESIZE;
+            *virt = r.virt + (bit * PAGESIZE);
+            return Success;
         }
-        addr += PAGESIZE;
+        from = bit + i + 1;
     }
+}
 
-    if (currentSize >= size)
+void MemoryContext::trackRange(const Address virt, const Size size, const bool mapped)
+{
+    for (Size i = 0; i < MEMORYMAP_MAX_REGIONS; i++)
     {
-        *virt = currentAddr;
-        return Success;
+        BitArray *pages = m_regionPages[i];
+        if (!pages)
+            continue;
+
+        const Memory::Range r = m_map->range((MemoryMap::Region) i);
+
+        for (Size j = 0; j < size; j += PAGESIZE)
+        {
+            const Address offset = virt + j - r.virt;
+
+            if (offset < r.size)
+                pages->set(offset / PAGESIZE, mapped);
+        }
     }
-    else
-        return OutOfMemory;
+}
+
+void MemoryContext::untrackRegion(MemoryMap::Region region)
+{
+    if (m_regionPages[region])
+        m_regionPages[region]->clear();
+}
+
+BitArray * MemoryContext::getRegionPages(MemoryMap::Region region)
+{
+    if (!m_regionPages[region])
+    {
+        const Size regionPages = m_map->range(region).size / PAGESIZE;
+
+        m_regionPages[region] = new BitArray(regionPages < MinimumRegionPages ?
+                                             regionPages : MinimumRegionPages);
+        assert(m_regionPages[region] != NULL);
+    }
+
+    return m_regionPages[region];
+}
+
+BitArray * MemoryContext::growRegionPages(MemoryMap::Region region, const Size count)
+{
+    const Size regionPages = m_map->range(region).size / PAGESIZE;
+    BitArray *pages = m_regionPages[region];
+    Size grownPages = pages->size() * 2;
+
+    if (grownPages < count)
+        grownPages = count;
+    if (grownPages > regionPages)
+        grownPages = regionPages;
+
+    BitArray *grown = new BitArray(grownPages);
+    assert(grown != NULL);
+
+    for (Size i = 0; i < pages->size(); i++)
+        if (pages->isSet(i))
+            grown->set(i);
+
+    delete pages;
+    m_regionPages[region] = grown;
+    return grown;
+}
+
+void MemoryContext::rescanRegion(MemoryMap::Region region, BitArray *pages)
+{
+    const Memory::Range r = m_map->range(region);
+    Address tmp;
+
+    pages->clear();
+
+    for (Size i = 0; i < pages->size(); i++)
+        if (lookup(r.virt + (i * PAGESIZE), &tmp) != InvalidAddress)
+            pages->set(i);
 }
 
 void MemoryContext::mapRangeSparseCallback(Address *phys)
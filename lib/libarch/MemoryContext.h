@@ -22,6 +22,7 @@
 #include <Macros.h>
 #include <BitOperations.h>
 #include <Callback.h>
+#include <BitArray.h>
 #include "Memory.h"
 #include "MemoryMap.h"
 
@@ -41,6 +42,14 @@ class SplitAllocator;
  */
 class MemoryContext
 {
+  private:
+
+    /** Number of pages initially covered by the administration of findFree(). */
+    static const Size MinimumRegionPages = 256U;
+
+    /** Maximum number of ranges reserved with mapRangeLazy(). */
+    static const Size MaximumLazyRanges = 4U;
+
   public:
 
     /**
@@ -146,6 +155,32 @@ class MemoryContext
      */
     virtual Result mapRangeSparse(Memory::Range *range);
 
+    /**
+     * Reserve a range of virtual memory which is mapped on first access.
+     *
+     * No physical memory is allocated up front. Each page of the
+     * range is allocated, zeroed and mapped by touch() when it is used.
+     *
+     * @param range Page aligned virtual addresses and access flags of the range.
+     *
+     * @return Result code.
+     */
+    virtual Result mapRangeLazy(const Memory::Range *range);
+
+    /**
+     * Make sure a virtual address is mapped.
+     *
+     * Called on a page fault and before the kernel accesses memory of a process.
+     * An unmapped page inside a range reserved with mapRangeLazy() is allocated,
+     * zeroed and mapped.
+     *
+     * @param virt Virtual address to access.
+     * @param phys Physical address of the page on output.
+     *
+     * @return Result code. InvalidAddress if the address is neither mapped nor reserved.
+     */
+    Result touch(Address virt, Address *phys);
+
     /**
      * Unmaps a range of virtual memory.
      *
@@ -192,13 +227,19 @@ class MemoryContext
      * of virtual memory which is unused and then returns
      * the virtual address of the first page in the block.
      *
+     * Each region searched keeps a bitmap of its mapped pages, which
+     * is updated on every map and unmap. The bitmap only covers the start
+     * of the region in use so far, and grows when no free block is found
+     * inside it. Candidate blocks are verified with lookup() in case pages
+     * were mapped behind our back or outside the bitmap.
+     *
      * @param region Memory region to search in.
      * @param size Number of bytes requested to be free.
      * @param virt Virtual memory address on output.
      *
      * @return Result code
      */
-    virtual Result findFree(Size size, MemoryMap::Region region, Address *virt) const;
+    virtual Result findFree(Size size, MemoryMap::Region region, Address *virt);
 
     /**
      * Callback to provide intermediate Range object during mapRangeSparse()
@@ -209,6 +250,56 @@ class MemoryContext
      */
     virtual void mapRangeSparseCallback(Address *phys);
 
+  protected:
+
+    /**
+     * Update the mapped pages administration used by findFree().
+     *
+     * Implementations must call this function for each change
+     * to the page tables done by map(), unmap() and release.
+     *
+     * @param virt Virtual address of the first page.
+     * @param size Number of bytes.
+     * @param mapped True if the pages are mapped, false if unmapped.
+     */
+    void trackRange(const Address virt, const Size size, const bool mapped);
+
+    /**
+     * Drop the mapped pages administration of a memory region.
+     *
+     * @param region Memory region which is completely unmapped.
+     */
+    void untrackRegion(MemoryMap::Region region);
+
+  private:
+
+    /**
+     * Get the mapped pages administration of a memory region.
+     *
+     * @param region Memory region.
+     *
+     * @return BitArray with one bit per page, created on first use.
+     */
+    BitArray * getRegionPages(MemoryMap::Region region);
+
+    /**
+     * Extend the mapped pages administration of a memory region.
+     *
+     * @param region Memory region.
+     * @param count Minimum number of pages to cover.
+     *
+     * @return BitArray covering at least count pages, or all pages of the region.
+     */
+    BitArray * growRegionPages(MemoryMap::Region region, const Size count);
+
+    /**
+     * Rebuild the mapped pages administration from the page tables.
+     *
+     * @param region Memory region.
+     * @param pages BitArray with one bit per page.
+     */
+    void rescanRegion(MemoryMap::Region region, BitArray *pages);
+
   protected:
 
     /** Physical memory allocator */
@@ -228,6 +319,14 @@ class MemoryContext
 
     /** Number of pages allocated via mapRangeSparse Callback. */
     Size m_numSparsePages;
+
+  private:
+
+    /** Mapped pages at the start of each memory region searched by findFree(). */
+    BitArray *m_regionPages[MEMORYMAP_MAX_REGIONS];
+
+    /** Ranges which are mapped on first access. Unused entries have a zero size. */
+    Memory::Range m_lazyRanges[MaximumLazyRanges];
 };
 
 /**
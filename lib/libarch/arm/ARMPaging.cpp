@@ -226,6 +226,8 @@ MemoryContext::Result ARMPaging::map(Address virt, Address phys, Memory::Access
 {
     // Modify page tables
     Result r = m_firstTable->map(virt, phys, acc, m_alloc);
+    if (r == Success)
+        trackRange(virt, PAGESIZE, true);
 
     // Flush the TLB to refresh the mapping
     if (m_current == this)
@@ -244,6 +246,8 @@ MemoryContext::Result ARMPaging::unmap(Address virt)
 
     // Modify page tables
     Result r = m_firstTable->unmap(virt, m_alloc);
+    if (r == Success)
+        trackRange(virt, PAGESIZE, false);
 
     // Flush TLB to refresh the mapping
     if (m_current == this)
@@ -266,10 +270,12 @@ MemoryContext::Result ARMPaging::access(Address virt, Memory::Access *access) co
 
 MemoryContext::Result ARMPaging::releaseRegion(MemoryMap::Region region, bool tablesOnly)
 {
+    untrackRegion(region);
     return m_firstTable->releaseRange(m_map->range(region), m_alloc, tablesOnly);
 }
 
 MemoryContext::Result ARMPaging::releaseRange(Memory::Range *range, bool tablesOnly)
 {
+    trackRange(range->virt, range->size, false);
     return m_firstTable->releaseRange(*range, m_alloc, tablesOnly);
 }
@@ -18,6 +18,7 @@
 #include <FreeNOS/ProcessEvent.h>
 #include <Assert.h>
 #include <HashIterator.h>
+#include <ListIterator.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -32,7 +33,7 @@
 
 static void signal_sharecreated(int sig, siginfo_t *siginfo, void *context)
 {
-    HostShareManager::instance()->notifyShareCreated(siginfo->si_pid);
+    HostShareManager::instance()->notifyShareCreated(siginfo->si_pid, siginfo->si_value.sival_int);
 }
 
 static void signal_terminate(int sig, siginfo_t *siginfo, void *context)
@@ -78,6 +79,8 @@ HostShareManager::Result HostShareManager::initialize()
 
     // Setup the kernel channel for this process
     ProcessShares::MemoryShare share;
+    share.tagId = 0;
+    share.range.size = PAGESIZE * 4;
     createShare(KERNEL_PID, &share, true, false);
     m_kernelChannel.setVirtual(share.range.virt, share.range.virt + PAGESIZE);
 
@@ -93,7 +96,7 @@ HostShareManager::Result HostShareManager::terminate()
     for (HashIterator<ProcessID, ProcessShares::MemoryShare *> i(m_shares); i.hasCurrent();)
     {
         ProcessShares::MemoryShare *share = i.current();
-        getChannelName(share->pid, name, sizeof(name));
+        getChannelName(share->pid, share->tagId, name, sizeof(name));
         shm_unlink(name);
         delete share;
         i.remove();
@@ -110,11 +113,11 @@ HostShareManager::Result HostShareManager::createShare(
     const bool notify)
 {
     char name[1024];
-    const Size sz = PAGESIZE * 4;
+    Size sz = share->range.size;
     int fd = -1;
 
     // Format the filename properly
-    getChannelName(pid, name, sizeof(name));
+    getChannelName(pid, share->tagId, name, sizeof(name));
 
     // Open the shared memory file
     fd = shm_open(name, O_CREAT | O_RDWR, 0600);
@@ -134,6 +137,19 @@ HostShareManager::Result HostShareManager::createShare(
             return EXIT_FAILURE;
         }
     }
+    // Otherwise the creator of the share has determined the size
+    else
+    {
+        struct stat st;
+
+        if (fstat(fd, &st) != 0)
+        {
+            perror("fstat");
+            close(fd);
+            return API::IOError;
+        }
+        sz = st.st_size;
+    }
 
     // Map it directly into memory
     u8 *ptr = (u8 *) mmap(0, sz, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
@@ -156,14 +172,20 @@ HostShareManager::Result HostShareManager::createShare(
     share->range.size = sz;
     share->range.phys = 0;
     share->range.access = Memory::Readable | Memory::Writable | Memory::User;
+    share->attached = true;
 
     // Add copy to internal administration
-    ProcessShares::MemoryShare *shareCopy = new ProcessShares::MemoryShare;
+    ProcessShares::MemoryShare *shareCopy = findShare(pid, share->tagId);
+    if (!shareCopy)
+    {
+        shareCopy = new ProcessShares::MemoryShare;
+        m_shares.append(pid, shareCopy);
+    }
     memcpy(shareCopy, share, sizeof(*shareCopy));
-    m_shares.insert(pid, shareCopy);
 
-    // Signal the remote process to raise kernel event here, if needed
-    if (notify)
+    // Signal the remote process to raise kernel event here, if needed.
+    // A share with ourselves has no remote process to notify.
+    if (notify && pid != (ProcessID) getpid())
     {
         // The other process must be ready to receive this signal
         for (Size i = 0; i < MaximumRetries; i++)
@@ -180,10 +202,13 @@ HostShareManager::Result HostShareManager::createShare(
             return API::IOError;
         }
 
-        int r = kill(pid, SIGUSR1);
+        union sigval value;
+        value.sival_int = share->tagId;
+
+        int r = sigqueue(pid, SIGUSR1, value);
         if (r != 0)
         {
-            perror("kill");
+            perror("sigqueue");
             munmap(ptr, sz);
             close(fd);
             shm_unlink(name);
@@ -199,23 +224,61 @@ HostShareManager::Result HostShareManager::readShare(
     const ProcessID pid,
     ProcessShares::MemoryShare *share)
 {
-    ProcessShares::MemoryShare * const * sh = m_shares.get(pid);
+    const ProcessShares::MemoryShare *sh = findShare(pid, share->tagId);
     if (!sh)
         return API::NotFound;
 
-    memcpy(share, (*sh), sizeof(*share));
+    memcpy(share, sh, sizeof(*share));
     return API::Success;
 }
 
 HostShareManager::Result HostShareManager::deleteShares(
-    const ProcessID pid)
+    const ProcessID pid,
+    const ProcessShares::MemoryShare *share)
+{
+    char name[1024];
+    Size removed = 0;
+
+    for (HashIterator<ProcessID, ProcessShares::MemoryShare *> i(m_shares); i.hasCurrent();)
+    {
+        ProcessShares::MemoryShare *sh = i.current();
+
+        if (sh->pid != pid || (share && sh->tagId != share->tagId))
+        {
+            i++;
+            continue;
+        }
+
+        getChannelName(sh->pid, sh->tagId, name, sizeof(name));
+        munmap((void *) sh->range.virt, sh->range.size);
+        shm_unlink(name);
+        delete sh;
+        i.remove();
+        removed++;
+    }
+
+    return share && !removed ? API::NotFound : API::Success;
+}
+
+ProcessShares::MemoryShare * HostShareManager::findShare(const ProcessID pid,
+                                                         const Size tagId) const
 {
-    return API::InvalidArgument;
+    const List<ProcessShares::MemoryShare *> shares = m_shares.values(pid);
+
+    for (ListIterator<ProcessShares::MemoryShare *> i(shares); i.hasCurrent(); i++)
+    {
+        if (i.current()->tagId == tagId)
+            return i.current();
+    }
+
+    return ZERO;
 }
 
-void HostShareManager::notifyShareCreated(const ProcessID pid)
+void HostShareManager::notifyShareCreated(const ProcessID pid, const Size tagId)
 {
     ProcessShares::MemoryShare share;
+    share.tagId = tagId;
+
     const Result result = createShare(pid, &share, false, false);
     if (result != API::Success)
     {
@@ -239,15 +302,18 @@ void HostShareManager::notifyShareCreated(const ProcessID pid)
 }
 
 void HostShareManager::getChannelName(const ProcessID pid,
+                                      const Size tagId,
                                       char *buf,
                                       const Size size) const
 {
     const ProcessID own_pid = getpid();
+    const ProcessID low  = own_pid < pid ? own_pid : pid;
+    const ProcessID high = own_pid < pid ? pid : own_pid;
 
-    if (own_pid < pid)
-        snprintf(buf, size, "/FreeNOS.%u.%u", own_pid, pid);
+    if (tagId == 0)
+        snprintf(buf, size, "/FreeNOS.%u.%u", low, high);
     else
-        snprintf(buf, size, "/FreeNOS.%u.%u", pid, own_pid);
+        snprintf(buf, size, "/FreeNOS.%u.%u.%u", low, high, (uint) tagId);
 }
 
 void HostShareManager::setReady(const bool ready) const
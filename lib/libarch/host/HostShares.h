@@ -102,17 +102,19 @@ class HostShareManager : public StrictSingleton<HostShareManager>
      * Remove shares for a Process.
      *
      * @param pid Target process identifier
+     * @param share Only remove the share with this tag if not ZERO
      *
      * @return Result code
      */
-    Result deleteShares(const ProcessID pid);
+    Result deleteShares(const ProcessID pid, const ProcessShares::MemoryShare *share = ZERO);
 
     /**
      * Called whenever another process created a share for IPC with us.
      *
      * @param pid ProcessID of the remote process that created the share.
+     * @param tagId Tag of the share.
      */
-    void notifyShareCreated(const ProcessID pid);
+    void notifyShareCreated(const ProcessID pid, const Size tagId);
 
   private:
 
@@ -120,13 +122,25 @@ class HostShareManager : public StrictSingleton<HostShareManager>
      * Retrieve unique name for channel between target process and this process.
      *
      * @param pid Target process
+     * @param tagId Tag of the share
      * @param buf Output buffer for the name
      * @Param size Size of the buffer in bytes
      */
     void getChannelName(const ProcessID pid,
+                        const Size tagId,
                         char *buf,
                         const Size size) const;
 
+    /**
+     * Find a known share.
+     *
+     * @param pid Target process
+     * @param tagId Tag of the share
+     *
+     * @return MemoryShare pointer or ZERO if not found
+     */
+    ProcessShares::MemoryShare * findShare(const ProcessID pid, const Size tagId) const;
+
     /**
      * Marks this process as initialized.
      *
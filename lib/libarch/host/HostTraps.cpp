@@ -151,7 +151,7 @@ static API::Result hostVMShareHandler(ProcessID procID,
                 return API::NotFound;
 
         case API::Delete:
-            return HostShareManager::instance()->deleteShares(procID);
+            return HostShareManager::instance()->deleteShares(procID, share);
 
         default:
             break;
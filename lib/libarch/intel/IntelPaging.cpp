@@ -91,6 +91,9 @@ MemoryContext::Result IntelPaging::map(Address virt, Address phys, Memory::Acces
 {
     MemoryContext::Result r = m_pageDirectory->map(virt, phys, acc, m_alloc);
 
+    if (r == Success)
+        trackRange(virt, PAGESIZE, true);
+
     // Flush TLB entry
     if (r == Success && m_current == this)
         tlb_flush(virt);
@@ -102,6 +105,9 @@ MemoryContext::Result IntelPaging::unmap(Address virt)
 {
     MemoryContext::Result r = m_pageDirectory->unmap(virt, m_alloc);
 
+    if (r == Success)
+        trackRange(virt, PAGESIZE, false);
+
     // Flush TLB entry
     if (r == Success && m_current == this)
         tlb_flush(virt);
@@ -109,6 +115,34 @@ MemoryContext::Result IntelPaging::unmap(Address virt)
     return r;
 }
 
+MemoryContext::Result IntelPaging::unmapRange(Memory::Range *range)
+{
+    MemoryContext::Result r = Success;
+
+    for (Size i = 0; i < range->size; i += PAGESIZE)
+        if ((r = m_pageDirectory->unmap(range->virt + i, m_alloc)) != Success)
+            break;
+
+    trackRange(range->virt, range->size, false);
+
+    // Flush TLB entries
+    if (m_current == this)
+    {
+        if (range->size > FlushAllThreshold)
+        {
+            IntelCore core;
+            core.writeCR3(m_pageDirectoryAddr);
+        }
+        else
+        {
+            for (Size i = 0; i < range->size; i += PAGESIZE)
+                tlb_flush(range->virt + i);
+        }
+    }
+
+    return r;
+}
+
 MemoryContext::Result IntelPaging::lookup(Address virt, Address *phys) const
 {
     return m_pageDirectory->translate(virt, phys, m_alloc);
@@ -121,10 +155,12 @@ MemoryContext::Result IntelPaging::access(Address virt, Memory::Access *access)
 
 MemoryContext::Result IntelPaging::releaseRegion(MemoryMap::Region region, bool tablesOnly)
 {
+    untrackRegion(region);
     return m_pageDirectory->releaseRange(m_map->range(region), m_alloc, tablesOnly);
 }
 
 MemoryContext::Result IntelPaging::releaseRange(Memory::Range *range, bool tablesOnly)
 {
+    trackRange(range->virt, range->size, false);
     return m_pageDirectory->releaseRange(*range, m_alloc, tablesOnly);
 }
@@ -18,6 +18,7 @@
 #ifndef __LIBARCH_INTEL_PAGING_H
 #define __LIBARCH_INTEL_PAGING_H
 
+#include <FreeNOS/Constant.h>
 #include <Types.h>
 #include "MemoryContext.h"
 #include "MemoryMap.h"
@@ -105,6 +106,18 @@ class IntelPaging : public MemoryContext
      */
     virtual Result unmap(Address virt);
 
+    /**
+     * Unmaps a range of virtual memory.
+     *
+     * Invalidates the TLB once after all pages are unmapped. Large ranges
+     * reload the whole TLB instead of invalidating each page.
+     *
+     * @param range Range of virtual addresses to unmap
+     *
+     * @return Result code
+     */
+    virtual Result unmapRange(Memory::Range *range);
+
     /**
      * Translate virtual address to physical address.
      *
@@ -146,6 +159,9 @@ class IntelPaging : public MemoryContext
 
   private:
 
+    /** Unmapping more than this number of bytes reloads the whole TLB. */
+    static const Size FlushAllThreshold = PAGESIZE * 32;
+
     /** Pointer to page directory in kernel's virtual memory. */
     IntelPageDirectory *m_pageDirectory;
 
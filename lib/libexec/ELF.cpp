@@ -31,6 +31,10 @@ ELF::Result ELF::detect(const u8 *image, const Size size, ExecutableFormat **fmt
 {
     const ELFHeader *header = (const ELFHeader *) image;
 
+    // The image must at least contain the header
+    if (size < sizeof(ELFHeader))
+        return InvalidFormat;
+
     // Verify ELF magic bytes
     if (header->ident[ELF_INDEX_MAGIC0] == ELF_MAGIC0 &&
         header->ident[ELF_INDEX_MAGIC1] == ELF_MAGIC1 &&
@@ -64,6 +68,10 @@ ELF::Result ELF::regions(ELF::Region *regions, Size *count) const
         return InvalidFormat;
     }
 
+    // The program headers must be inside the image
+    if (header->programHeaderOffset + (maxSegments * sizeof(ELFSegment)) > m_size)
+        return InvalidFormat;
+
     // Fill in the memory regions
     for (;numRegions < maxRegions && numSegments < maxSegments; numSegments++)
     {
@@ -76,7 +84,17 @@ ELF::Result ELF::regions(ELF::Region *regions, Size *count) const
         regions[numRegions].dataOffset = segments[numSegments].offset;
         regions[numRegions].dataSize   = segments[numSegments].fileSize;
         regions[numRegions].memorySize = segments[numSegments].memorySize;
-        regions[numRegions++].access   = Memory::User | Memory::Readable | Memory::Writable | Memory::Executable;
+
+        // Read-only segments can be shared between processes
+        uint access = Memory::User | Memory::Readable;
+
+        if (segments[numSegments].flags & ELF_SEGMENT_WRITE)
+            access |= Memory::Writable;
+
+        if (segments[numSegments].flags & ELF_SEGMENT_EXECUTE)
+            access |= Memory::Executable;
+
+        regions[numRegions++].access   = (Memory::Access) access;
     }
 
     // All done
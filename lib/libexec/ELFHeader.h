@@ -286,6 +286,24 @@ ELFHeader;
 /** Reserved for processor-specific semantics. */
 #define ELF_SEGMENT_HIPROC      0x7fffffff
 
+/**
+ * @}
+ */
+
+/**
+ * @name Segment flags
+ * @{
+ */
+
+/** Segment is executable. */
+#define ELF_SEGMENT_EXECUTE     (1 << 0)
+
+/** Segment is writable. */
+#define ELF_SEGMENT_WRITE       (1 << 1)
+
+/** Segment is readable. */
+#define ELF_SEGMENT_READ        (1 << 2)
+
 /**
  * @}
  */
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Assert.h>
+#include <MemoryBlock.h>
+#include "BlockCache.h"
+
+BlockCache::BlockCache(Storage *storage,
+                       const Size blockSize,
+                       const Size maximumBlocks)
+    : m_storage(storage)
+    , m_blockSize(blockSize)
+    , m_maximumBlocks(maximumBlocks)
+    , m_index(maximumBlocks)
+    , m_hits(0)
+    , m_misses(0)
+    , m_prefetched(0)
+    , m_evictions(0)
+{
+    assert(blockSize > 0);
+    assert(maximumBlocks > 0);
+
+    m_blocks = new Block[maximumBlocks];
+    assert(m_blocks != NULL);
+    m_data = new u8[maximumBlocks * blockSize];
+    assert(m_data != NULL);
+    m_batch = new u8[MaximumBatch * blockSize];
+    assert(m_batch != NULL);
+
+    // All blocks start unused in the least recently used list
+    for (Size i = 0; i < maximumBlocks; i++)
+    {
+        m_blocks[i].number = 0;
+        m_blocks[i].size   = 0;
+        m_blocks[i].data   = m_data + (i * blockSize);
+        m_blocks[i].prev   = i > 0 ? &m_blocks[i - 1] : ZERO;
+        m_blocks[i].next   = i < maximumBlocks - 1 ? &m_blocks[i + 1] : ZERO;
+    }
+    m_head = &m_blocks[0];
+    m_tail = &m_blocks[maximumBlocks - 1];
+}
+
+BlockCache::~BlockCache()
+{
+    delete[] m_blocks;
+    delete[] m_data;
+    delete[] m_batch;
+}
+
+FileSystem::Result BlockCache::initialize()
+{
+    return FileSystem::Success;
+}
+
+FileSystem::Result BlockCache::read(const u64 offset, void *buffer, const Size size) const
+{
+    const Size batch = MaximumBatch < m_maximumBlocks ? MaximumBatch : m_maximumBlocks;
+    u8 *dest = (u8 *) buffer;
+    Size total = 0;
+    u64 loadedEnd = 0;
+
+    // Memory-resident storage does not need to be cached
+    const u8 *data = m_storage->map(offset, size);
+    if (data != ZERO)
+    {
+        MemoryBlock::copy(buffer, data, size);
+        return FileSystem::Success;
+    }
+
+    while (total < size)
+    {
+        const u64 position = offset + total;
+        const u32 number = position / m_blockSize;
+        const Size blockOffset = position % m_blockSize;
+        const Size bytes = m_blockSize - blockOffset < size - total ?
+                           m_blockSize - blockOffset : size - total;
+        Block *block = find(number);
+
+        if (block != ZERO)
+        {
+            // Blocks loaded earlier by this request are not hits
+            if (number >= loadedEnd)
+                m_hits++;
+        }
+        else
+        {
+            // Read the missing blocks of this request from storage at once
+            Size count = (blockOffset + (size - total) + m_blockSize - 1) / m_blockSize;
+            if (count > batch)
+                count = batch;
+
+            const FileSystem::Result result = load(number, count, m_misses);
+            if (result != FileSystem::Success)
+                return result;
+
+            block = find(number);
+            assert(block != ZERO);
+            loadedEnd = (u64) number + count;
+        }
+
+        // The last block of storage may be partial
+        if (block->size < blockOffset + bytes)
+            return FileSystem::IOError;
+
+        MemoryBlock::copy(dest + total, block->data + blockOffset, bytes);
+        total += bytes;
+    }
+
+    return FileSystem::Success;
+}
+
+FileSystem::Result BlockCache::write(const u64 offset, void *buffer, const Size size)
+{
+    const u8 *src = (const u8 *) buffer;
+    const FileSystem::Result result = m_storage->write(offset, buffer, size);
+    Size total = 0;
+
+    if (result != FileSystem::Success)
+        return result;
+
+    // Update the cached copies of all written blocks
+    while (total < size)
+    {
+        const u64 position = offset + total;
+        const u32 number = position / m_blockSize;
+        const Size blockOffset = position % m_blockSize;
+        const Size bytes = m_blockSize - blockOffset < size - total ?
+                           m_blockSize - blockOffset : size - total;
+        Block * const *entry = m_index.get(number);
+
+        if (entry != ZERO)
+        {
+            Block *block = *entry;
+
+            if (block->size >= blockOffset + bytes)
+            {
+                MemoryBlock::copy(block->data + blockOffset, src + total, bytes);
+            }
+            else
+            {
+                m_index.remove(number);
+                block->size = 0;
+            }
+        }
+        total += bytes;
+    }
+
+    return FileSystem::Success;
+}
+
+const u8 * BlockCache::map(const u64 offset, const Size size) const
+{
+    return m_storage->map(offset, size);
+}
+
+u64 BlockCache::capacity() const
+{
+    return m_storage->capacity();
+}
+
+FileSystem::Result BlockCache::prefetch(const u64 offset, const Size size) const
+{
+    const u64 storageSize = m_storage->capacity();
+    const u32 first = offset / m_blockSize;
+    Size count;
+
+    if (offset >= storageSize || size == 0 || m_storage->map(offset, 1) != ZERO)
+        return FileSystem::Success;
+
+    // Never prefetch beyond the end of storage or more than half of the cache
+    count = (((size < storageSize - offset ? size : storageSize - offset) +
+              (offset % m_blockSize)) + m_blockSize - 1) / m_blockSize;
+
+    if (count > m_maximumBlocks / 2)
+        count = m_maximumBlocks / 2;
+
+    return load(first, count, m_prefetched);
+}
+
+Size BlockCache::getBlockSize() const
+{
+    return m_blockSize;
+}
+
+Size BlockCache::getHits() const
+{
+    return m_hits;
+}
+
+Size BlockCache::getMisses() const
+{
+    return m_misses;
+}
+
+Size BlockCache::getPrefetched() const
+{
+    return m_prefetched;
+}
+
+Size BlockCache::getEvictions() const
+{
+    return m_evictions;
+}
+
+BlockCache::Block * BlockCache::find(const u32 number) const
+{
+    Block * const *entry = m_index.get(number);
+
+    if (entry == ZERO)
+        return ZERO;
+
+    touch(*entry);
+    return *entry;
+}
+
+FileSystem::Result BlockCache::load(const u32 first, const Size count, Size & loaded) const
+{
+    const u64 storageSize = m_storage->capacity();
+    Size i = 0;
+
+    while (i < count)
+    {
+        // Skip blocks which are cached already
+        if (m_index.get(first + i) != ZERO)
+        {
+            i++;
+            continue;
+        }
+
+        // Collect the run of missing blocks
+        Size run = 1;
+        while (i + run < count && run < MaximumBatch &&
+               m_index.get(first + i + run) == ZERO)
+        {
+            run++;
+        }
+
+        // Respect the end of storage
+        const u64 offset = (u64) (first + i) * m_blockSize;
+        if (offset >= storageSize)
+            return FileSystem::IOError;
+
+        const Size bytes = storageSize - offset < run * m_blockSize ?
+                           storageSize - offset : run * m_blockSize;
+
+        const FileSystem::Result result = m_storage->read(offset, m_batch, bytes);
+        if (result != FileSystem::Success)
+            return result;
+
+        // Fill the blocks
+        for (Size j = 0; j * m_blockSize < bytes; j++)
+        {
+            Block *block = reuse(first + i + j);
+            block->size = bytes - (j * m_blockSize) < m_blockSize ?
+                          bytes - (j * m_blockSize) : m_blockSize;
+            MemoryBlock::copy(block->data, m_batch + (j * m_blockSize), block->size);
+            loaded++;
+        }
+        i += run;
+    }
+
+    return FileSystem::Success;
+}
+
+BlockCache::Block * BlockCache::reuse(const u32 number) const
+{
+    Block *block = m_tail;
+
+    if (block->size != 0)
+    {
+        m_index.remove(block->number);
+        m_evictions++;
+    }
+
+    block->number = number;
+    block->size   = 0;
+    m_index.insert(number, block);
+    touch(block);
+    return block;
+}
+
+void BlockCache::touch(Block *block) const
+{
+    if (block == m_head)
+        return;
+
+    // Unlink from the current position
+    block->prev->next = block->next;
+
+    if (block->next)
+        block->next->prev = block->prev;
+    else
+        m_tail = block->prev;
+
+    // Insert at the head
+    block->prev = ZERO;
+    block->next = m_head;
+    m_head->prev = block;
+    m_head = block;
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_BLOCKCACHE_H
+#define __LIB_LIBFS_BLOCKCACHE_H
+
+#include <Types.h>
+#include <HashTable.h>
+#include "Storage.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Caches fixed size blocks of another Storage in memory.
+ *
+ * Blocks are kept in least-recently-used order and the oldest
+ * block is reused when the cache is full. Writes go straight through
+ * to the underlying Storage and update the cached copy.
+ *
+ * @see Storage
+ */
+class BlockCache : public Storage
+{
+  private:
+
+    /**
+     * Cached block of storage.
+     */
+    typedef struct Block
+    {
+        u32 number;     /**< Block number in storage. */
+        Size size;      /**< Number of valid bytes in data, zero if unused. */
+        u8 *data;       /**< Block contents. */
+        Block *prev;    /**< More recently used block. */
+        Block *next;    /**< Less recently used block. */
+    }
+    Block;
+
+  public:
+
+    /** Default number of blocks in the cache */
+    static const Size DefaultBlocks = 256;
+
+    /** Maximum number of blocks read from storage at once */
+    static const Size MaximumBatch = 16;
+
+    /**
+     * Constructor function.
+     *
+     * @param storage Storage to cache.
+     * @param blockSize Size of a single block in bytes.
+     * @param maximumBlocks Maximum number of blocks in the cache.
+     */
+    BlockCache(Storage *storage,
+               const Size blockSize,
+               const Size maximumBlocks = DefaultBlocks);
+
+    /**
+     * Destructor function.
+     */
+    virtual ~BlockCache();
+
+    /**
+     * Initialize the Storage device
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result initialize();
+
+    /**
+     * Read a contiguous set of data.
+     *
+     * @param offset Offset to start reading from.
+     * @param buffer Output buffer.
+     * @param size Number of bytes to copied.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result read(const u64 offset, void *buffer, const Size size) const;
+
+    /**
+     * Write a contiguous set of data.
+     *
+     * @param offset Offset to start writing to.
+     * @param buffer Input buffer.
+     * @param size Number of bytes to written.
+     *
+     * @return Result code
+     */
+    virtual FileSystem::Result write(const u64 offset, void *buffer, const Size size);
+
+    /**
+     * Get direct access to memory-resident contents.
+     *
+     * @param offset Offset of the first byte to access.
+     * @param size Number of bytes to access.
+     *
+     * @return Pointer to the contents of the underlying Storage or ZERO if not supported.
+     */
+    virtual const u8 * map(const u64 offset, const Size size) const;
+
+    /**
+     * Retrieve maximum storage capacity.
+     *
+     * @return Storage capacity.
+     */
+    virtual u64 capacity() const;
+
+    /**
+     * Load blocks into the cache ahead of use.
+     *
+     * @param offset Offset in storage of the first byte to load.
+     * @param size Number of bytes to load.
+     *
+     * @return Result code
+     */
+    FileSystem::Result prefetch(const u64 offset, const Size size) const;
+
+    /**
+     * Get the size of a single block.
+     *
+     * @return Block size in bytes.
+     */
+    Size getBlockSize() const;
+
+    /**
+     * Get the number of blocks found in the cache.
+     *
+     * @return Number of cache hits.
+     */
+    Size getHits() const;
+
+    /**
+     * Get the number of blocks read from storage on demand.
+     *
+     * @return Number of cache misses.
+     */
+    Size getMisses() const;
+
+    /**
+     * Get the number of blocks read from storage by prefetch().
+     *
+     * @return Number of prefetched blocks.
+     */
+    Size getPrefetched() const;
+
+    /**
+     * Get the number of blocks reused for other storage blocks.
+     *
+     * @return Number of evictions.
+     */
+    Size getEvictions() const;
+
+  private:
+
+    /**
+     * Find a cached block and mark it most recently used.
+     *
+     * @param number Block number.
+     *
+     * @return Block pointer or ZERO if not cached.
+     */
+    Block * find(const u32 number) const;
+
+    /**
+     * Read a range of blocks from storage into the cache.
+     *
+     * Blocks which are already cached are skipped. Each run of
+     * missing blocks is read from storage with a single read.
+     *
+     * @param first First block number.
+     * @param count Number of blocks.
+     * @param loaded Incremented with the number of blocks read.
+     *
+     * @return Result code
+     */
+    FileSystem::Result load(const u32 first, const Size count, Size & loaded) const;
+
+    /**
+     * Take the least recently used block for reuse.
+     *
+     * @param number New block number.
+     *
+     * @return Block pointer, marked most recently used.
+     */
+    Block * reuse(const u32 number) const;
+
+    /**
+     * Make a block the most recently used.
+     *
+     * @param block Block pointer.
+     */
+    void touch(Block *block) const;
+
+  private:
+
+    /** Storage to cache. */
+    Storage *m_storage;
+
+    /** Size of a single block. */
+    const Size m_blockSize;
+
+    /** Maximum number of blocks in the cache. */
+    const Size m_maximumBlocks;
+
+    /** All block entries. */
+    Block *m_blocks;
+
+    /** Contents of all blocks. */
+    u8 *m_data;
+
+    /** Buffer for reading multiple blocks at once. */
+    u8 *m_batch;
+
+    /** Most recently used block. */
+    mutable Block *m_head;
+
+    /** Least recently used block. */
+    mutable Block *m_tail;
+
+    /** Maps block numbers to cached blocks. */
+    mutable HashTable<u32, Block *> m_index;
+
+    /** Number of cache hits. */
+    mutable Size m_hits;
+
+    /** Number of cache misses. */
+    mutable Size m_misses;
+
+    /** Number of prefetched blocks. */
+    mutable Size m_prefetched;
+
+    /** Number of evicted blocks. */
+    mutable Size m_evictions;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_BLOCKCACHE_H */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <String.h>
+#include "BlockCacheFile.h"
+
+BlockCacheFile::BlockCacheFile(const BlockCache *cache)
+    : File(FileSystem::RegularFile)
+    , m_cache(cache)
+{
+    m_access = FileSystem::OwnerR;
+}
+
+FileSystem::Error BlockCacheFile::read(IOBuffer & buffer, Size size, Size offset)
+{
+    String output;
+
+    output << "blocksize " << m_cache->getBlockSize() << "\n";
+    output << "hits " << m_cache->getHits() << "\n";
+    output << "misses " << m_cache->getMisses() << "\n";
+    output << "prefetched " << m_cache->getPrefetched() << "\n";
+    output << "evictions " << m_cache->getEvictions() << "\n";
+    m_size = output.length();
+
+    // Bounds checking
+    if (offset >= m_size)
+        return 0;
+
+    // How much bytes to copy?
+    const Size bytes = m_size - offset > size ? size : m_size - offset;
+
+    // Copy the buffers
+    return buffer.write(*output + offset, bytes);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_BLOCKCACHEFILE_H
+#define __LIB_LIBFS_BLOCKCACHEFILE_H
+
+#include <Types.h>
+#include "File.h"
+#include "BlockCache.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * Pseudo file which outputs the statistics of a BlockCache.
+ *
+ * @see BlockCache
+ */
+class BlockCacheFile : public File
+{
+  public:
+
+    /**
+     * Constructor function.
+     *
+     * @param cache BlockCache to report on.
+     */
+    BlockCacheFile(const BlockCache *cache);
+
+    /**
+     * Read bytes from the file.
+     *
+     * @param buffer Output buffer.
+     * @param size Number of bytes to read, at maximum.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Number of bytes read on success, Error on failure.
+     *
+     * @see IOBuffer
+     */
+    virtual FileSystem::Error read(IOBuffer & buffer, Size size, Size offset);
+
+  private:
+
+    /** BlockCache to report on. */
+    const BlockCache *m_cache;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_BLOCKCACHEFILE_H */
@@ -60,6 +60,14 @@ FileSystem::Result BootImageStorage::read(const u64 offset, void *buffer, const
     return FileSystem::Success;
 }
 
+const u8 * BootImageStorage::map(const u64 offset, const Size size) const
+{
+    if (m_image == ZERO || offset + size > m_image->bootImageSize)
+        return ZERO;
+
+    return ((const u8 *)(m_image)) + offset;
+}
+
 u64 BootImageStorage::capacity() const
 {
     return m_image->bootImageSize;
@@ -44,6 +44,14 @@ FileSystem::Result BootSymbolStorage::read(const u64 offset, void *buffer, const
     return m_bootImage.read(offset + m_segment.offset, buffer, size);
 }
 
+const u8 * BootSymbolStorage::map(const u64 offset, const Size size) const
+{
+    if (offset + size > m_symbol.segmentsTotalSize)
+        return ZERO;
+
+    return m_bootImage.map(offset + m_segment.offset, size);
+}
+
 u64 BootSymbolStorage::capacity() const
 {
     return m_symbol.segmentsTotalSize;
@@ -67,6 +67,16 @@ class BootSymbolStorage : public Storage
      */
     virtual FileSystem::Result read(const u64 offset, void *buffer, const Size size) const;
 
+    /**
+     * Get direct access to the BootSymbol contents.
+     *
+     * @param offset Offset of the first byte to access.
+     * @param size Number of bytes to access.
+     *
+     * @return Pointer to the contents or ZERO if out of range.
+     */
+    virtual const u8 * map(const u64 offset, const Size size) const;
+
     /**
      * Retrieve maximum storage capacity.
      *
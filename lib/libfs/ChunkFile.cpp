@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "ChunkFile.h"
+
+u8 ChunkFile::m_zeroes[ChunkFile::ChunkSize];
+
+ChunkFile::ChunkFile()
+    : File(FileSystem::RegularFile)
+    , m_chunks(ZERO)
+    , m_capacity(0)
+{
+    m_access = FileSystem::OwnerRW;
+}
+
+ChunkFile::~ChunkFile()
+{
+    for (Size i = 0; i < m_capacity; i++)
+    {
+        if (m_chunks[i])
+        {
+            delete[] m_chunks[i];
+        }
+    }
+
+    if (m_chunks)
+    {
+        delete[] m_chunks;
+    }
+}
+
+FileSystem::Error ChunkFile::read(IOBuffer & buffer, Size size, Size offset)
+{
+    // Bounds checking
+    if (offset >= m_size)
+        return 0;
+
+    // How much bytes to copy?
+    const Size total = m_size - offset > size ? size : m_size - offset;
+
+    // Copy from each chunk in turn
+    for (Size done = 0; done < total;)
+    {
+        const Size index = (offset + done) / ChunkSize;
+        const Size chunkOffset = (offset + done) % ChunkSize;
+        const Size bytes = ChunkSize - chunkOffset > total - done ?
+                           total - done : ChunkSize - chunkOffset;
+        u8 *data = m_chunks[index] ? m_chunks[index] + chunkOffset : m_zeroes;
+
+        const FileSystem::Error result = buffer.write(data, bytes, done);
+        if (result < 0)
+            return result;
+
+        done += bytes;
+    }
+
+    return total;
+}
+
+FileSystem::Error ChunkFile::write(IOBuffer & buffer, Size size, Size offset)
+{
+    const Size end = offset + size;
+
+    // Reject writes beyond the maximum file size
+    if (end < offset)
+        return FileSystem::InvalidArgument;
+
+    // Make room for all chunks written to, without overflowing near the maximum size
+    if (!reserve((end / ChunkSize) + (end % ChunkSize != 0)))
+        return FileSystem::IOError;
+
+    // Copy into each chunk in turn
+    for (Size done = 0; done < size;)
+    {
+        const Size index = (offset + done) / ChunkSize;
+        const Size chunkOffset = (offset + done) % ChunkSize;
+        const Size bytes = ChunkSize - chunkOffset > size - done ?
+                           size - done : ChunkSize - chunkOffset;
+
+        // Allocate the chunk on first use
+        if (!m_chunks[index])
+        {
+            if (!(m_chunks[index] = new u8[ChunkSize]))
+                return FileSystem::IOError;
+
+            MemoryBlock::set(m_chunks[index], 0, ChunkSize);
+        }
+
+        const FileSystem::Error result = buffer.read(m_chunks[index] + chunkOffset, bytes, done);
+        if (result < 0)
+            return result;
+
+        done += bytes;
+    }
+
+    // Extend the file, if needed
+    if (end > m_size)
+        m_size = end;
+
+    return size;
+}
+
+const u8 * ChunkFile::getChunk(const Size offset) const
+{
+    const Size index = offset / ChunkSize;
+
+    return offset < m_size && index < m_capacity ? m_chunks[index] : ZERO;
+}
+
+bool ChunkFile::reserve(const Size count)
+{
+    Size capacity = m_capacity ? m_capacity : 1;
+    u8 **chunks;
+
+    if (count <= m_capacity)
+        return true;
+
+    // Double the table, such that appending is amortized constant time
+    while (capacity < count)
+        capacity *= 2;
+
+    if (!(chunks = new u8 *[capacity]))
+        return false;
+
+    for (Size i = 0; i < capacity; i++)
+        chunks[i] = i < m_capacity ? m_chunks[i] : ZERO;
+
+    if (m_chunks)
+        delete[] m_chunks;
+
+    m_chunks = chunks;
+    m_capacity = capacity;
+    return true;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIB_LIBFS_CHUNKFILE_H
+#define __LIB_LIBFS_CHUNKFILE_H
+
+#include <FreeNOS/Constant.h>
+#include <Types.h>
+#include "File.h"
+#include "IOBuffer.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libfs
+ * @{
+ */
+
+/**
+ * File which stores its contents in memory, in page sized chunks.
+ *
+ * Chunks are allocated when first written, such that ranges which
+ * are never written form holes that read as zeroes. The table of chunks
+ * grows by doubling, which keeps appending amortized constant time.
+ */
+class ChunkFile : public File
+{
+  public:
+
+    /** Size of a single chunk in bytes. */
+    static const Size ChunkSize = PAGESIZE;
+
+  public:
+
+    /**
+     * Default constructor.
+     */
+    ChunkFile();
+
+    /**
+     * Destructor.
+     */
+    virtual ~ChunkFile();
+
+    /**
+     * Read bytes from the file.
+     *
+     * @param buffer Output buffer.
+     * @param size Number of bytes to read, at maximum.
+     * @param offset Offset inside the file to start reading.
+     *
+     * @return Number of bytes read on success, Error on failure.
+     *
+     * @see IOBuffer
+     */
+    virtual FileSystem::Error read(IOBuffer & buffer, Size size, Size offset);
+
+    /**
+     * Write bytes to the file.
+     *
+     * @param buffer Input/Output buffer to input bytes from.
+     * @param size Number of bytes to write, at maximum.
+     * @param offset Offset inside the file to start writing.
+     *
+     * @return Number of bytes written on success, Error on failure.
+     */
+    virtual FileSystem::Error write(IOBuffer & buffer, Size size, Size offset);
+
+    /**
+     * Get the chunk containing the given offset.
+     *
+     * @param offset Offset inside the file.
+     *
+     * @return Pointer to the start of the chunk or ZERO for a hole.
+     */
+    const u8 * getChunk(const Size offset) const;
+
+  private:
+
+    /**
+     * Grow the table of chunks.
+     *
+     * @param count Minimum number of chunks the table must hold.
+     *
+     * @return True on success, false if out of memory.
+     */
+    bool reserve(const Size count);
+
+  private:
+
+    /** Table of pointers to chunks, ZERO for holes. */
+    u8 **m_chunks;
+
+    /** Number of entries in the table of chunks. */
+    Size m_capacity;
+
+    /** Chunk of zeroes, which is output for holes. */
+    static u8 m_zeroes[ChunkSize];
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIB_LIBFS_CHUNKFILE_H */
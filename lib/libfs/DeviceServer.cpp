@@ -91,6 +91,7 @@ void DeviceServer::interruptHandler(Size vector)
         for (ListIterator<Device *> i(lst); i.hasCurrent(); i++)
         {
             i.current()->interrupt(vector);
+            i.current()->signalReady();
         }
     }
 
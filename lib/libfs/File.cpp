@@ -18,13 +18,19 @@
 #include <FreeNOS/User.h>
 #include "File.h"
 
+u32 File::m_stamp = 0;
+
 File::File(FileSystem::FileType type, UserID uid, GroupID gid)
     : m_type(type)
     , m_uid(uid)
     , m_gid(gid)
+    , m_readyEvents(false)
+    , m_ready(false)
 {
     m_access    = FileSystem::OwnerRWX;
     m_size      = 0;
+    m_inode     = ++m_stamp;
+    m_modified  = m_inode;
 }
 
 File::~File()
@@ -59,6 +65,8 @@ Error File::status(FileSystemMessage *msg)
     st.groupID  = m_gid;
     st.deviceID.major = m_deviceId.major;
     st.deviceID.minor = m_deviceId.minor;
+    st.inode    = m_inode;
+    st.modified = m_modified;
 
     // Copy to the remote process
     if ((e = VMCopy(msg->from, API::Write, (Address) &st,
@@ -71,3 +79,25 @@ Error File::status(FileSystemMessage *msg)
         return e;
     }
 }
+
+List<FileSystemRequest *> & File::getWaitQueue()
+{
+    return m_waitQueue;
+}
+
+void File::signalReady()
+{
+    m_ready = true;
+}
+
+bool File::checkReady()
+{
+    const bool ready = m_ready || !m_readyEvents;
+    m_ready = false;
+    return ready;
+}
+
+void File::setModified()
+{
+    m_modified = ++m_stamp;
+}
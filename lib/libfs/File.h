@@ -19,10 +19,13 @@
 #define __LIB_LIBFS_FILE_H
 
 #include <Types.h>
+#include <List.h>
 #include "FileSystemMessage.h"
 #include "FileSystem.h"
 #include "IOBuffer.h"
 
+class FileSystemRequest;
+
 /**
  * @addtogroup lib
  * @{
@@ -92,6 +95,38 @@ class File
      */
     virtual FileSystem::Error status(FileSystemMessage *msg);
 
+    /**
+     * Get requests waiting on the File.
+     *
+     * @return List of requests which returned RetryAgain.
+     */
+    List<FileSystemRequest *> & getWaitQueue();
+
+    /**
+     * Signal that waiting read requests can make progress.
+     *
+     * Files which call this function when data arrives must
+     * set m_readyEvents, so that their waiting read requests
+     * are only retried after a signal.
+     */
+    void signalReady();
+
+    /**
+     * Check if waiting read requests should be retried.
+     *
+     * Clears the ready state of Files which use readiness events.
+     *
+     * @return True if signalled or if the File does not use readiness events.
+     */
+    bool checkReady();
+
+    /**
+     * Mark the contents of the file as changed.
+     *
+     * Assigns a new modification stamp, which is reported by status().
+     */
+    void setModified();
+
   protected:
 
     /** Type of this file. */
@@ -111,6 +146,26 @@ class File
 
     /** Device major/minor ID. */
     DeviceID m_deviceId;
+
+    /** True if the File calls signalReady() when data arrives. */
+    bool m_readyEvents;
+
+  private:
+
+    /** Requests waiting on the File. */
+    List<FileSystemRequest *> m_waitQueue;
+
+    /** True if signalReady() was called since the last checkReady(). */
+    bool m_ready;
+
+    /** Number of the file, unique within this file system. */
+    u32 m_inode;
+
+    /** Modification stamp of the file. */
+    u32 m_modified;
+
+    /** Incremented for every new file and every modification. */
+    static u32 m_stamp;
 };
 
 /**
@@ -22,6 +22,7 @@
 #include <Macros.h>
 #include <String.h>
 #include <MemoryBlock.h>
+#include "FileSystem.h"
 #include "FileSystemPath.h"
 
 /**
@@ -46,12 +47,16 @@ class FileDescriptor
         path[0]  = ZERO;
         position = 0;
         open     = false;
+        mount    = 0;
+        handle   = 0;
     }
 
     FileDescriptor(const FileDescriptor & fd)
     {
         position = fd.position;
         open     = fd.open;
+        mount    = fd.mount;
+        handle   = fd.handle;
         MemoryBlock::copy(path, fd.path, FileSystemPath::MaximumLength);
     }
 
@@ -78,6 +83,12 @@ class FileDescriptor
 
     /** State of the file descriptor. */
     bool open;
+
+    /** ProcessID of the file system which opened the file. */
+    ProcessID mount;
+
+    /** Handle of the opened file or ZERO to use the path. */
+    FileSystem::Handle handle;
 };
 
 /**
@@ -18,6 +18,7 @@
 #ifndef __LIB_LIBFS_FILESYSTEM_H
 #define __LIB_LIBFS_FILESYSTEM_H
 
+#include <FreeNOS/Constant.h>
 #include <Types.h>
 
 /**
@@ -89,9 +90,29 @@ namespace FileSystem
         DeleteFile,
         MountFileSystem,
         WaitFileSystem,
-        GetFileSystems
+        GetFileSystems,
+        ReadFileBulk,
+        WriteFileBulk,
+        OpenFile
     };
 
+    /**
+     * Identifies an opened file on its file system.
+     *
+     * Handles are returned by OpenFile and can be used instead of the path
+     * in ReadFile and WriteFile. Zero is never a valid handle.
+     */
+    typedef u32 Handle;
+
+    /** VMShare tag of the bulk I/O buffer between a client and a file system. */
+    const Size BulkShareTag = 1;
+
+    /** Size of the bulk I/O buffer in bytes. */
+    const Size BulkShareSize = PAGESIZE * 16;
+
+    /** Minimum byte count of a read or write to use the bulk I/O buffer. */
+    const Size BulkMinimumSize = PAGESIZE;
+
     /**
      * Result code for filesystem Actions.
      */
@@ -106,7 +127,8 @@ namespace FileSystem
         AlreadyExists    = -6,
         NotSupported     = -7,
         RedirectRequest  = -8,
-        IpcError         = -9
+        IpcError         = -9,
+        StaleHandle      = -10
     };
 
     /** May contain a byte count or Result code with an error. */
@@ -166,6 +188,8 @@ namespace FileSystem
         UserID userID;      /**< User identity. */
         GroupID groupID;    /**< Group identity. */
         DeviceID deviceID;  /**< Device identity. */
+        u32 inode;          /**< Number of the file, unique within its file system. */
+        u32 modified;       /**< Modification stamp, which changes on every write. */
     };
 };
 
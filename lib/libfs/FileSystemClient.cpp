@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/User.h>
 #include <ChannelClient.h>
 #include "FileSystemMessage.h"
 #include "FileSystemClient.h"
@@ -34,19 +35,7 @@ inline FileSystem::Result FileSystemClient::request(const char *path,
     const ProcessID mnt = m_pid == ANY ? findMount(path) : m_pid;
     char fullpath[FileSystemPath::MaximumLength];
 
-    // Use the current directory as prefix for relative paths
-    if (path[0] != '/' && m_currentDirectory != NULL)
-    {
-        const Size copied = MemoryBlock::copy(fullpath, **m_currentDirectory, sizeof(fullpath));
-
-        if (copied < sizeof(fullpath))
-            MemoryBlock::copy(fullpath + copied, path, sizeof(fullpath) - copied);
-    }
-    else
-    {
-        MemoryBlock::copy(fullpath, path, sizeof(fullpath));
-    }
-
+    getFullPath(path, fullpath);
     msg.path = fullpath;
 
     return request(mnt, msg);
@@ -55,12 +44,15 @@ inline FileSystem::Result FileSystemClient::request(const char *path,
 inline FileSystem::Result FileSystemClient::request(const ProcessID pid,
                                                     FileSystemMessage &msg) const
 {
+    u8 *bulk = (u8 *) prepareBulk(pid, msg);
+
     if (ChannelClient::instance()->syncSendReceive(&msg, sizeof(msg), pid) != ChannelClient::Success)
     {
         return FileSystem::IpcError;
     }
     else if (msg.result != FileSystem::RedirectRequest)
     {
+        completeBulk(bulk, msg);
         return msg.result;
     }
 
@@ -82,33 +74,87 @@ inline FileSystem::Result FileSystemClient::request(const ProcessID pid,
     }
 
     msg.type = ChannelMessage::Request;
+    bulk = (u8 *) prepareBulk(msg.pid, msg);
+
     if (ChannelClient::instance()->syncSendReceive(&msg, sizeof(msg), msg.pid) != ChannelClient::Success)
     {
         return FileSystem::IpcError;
     }
 
     assert (msg.result != FileSystem::RedirectRequest);
+    completeBulk(bulk, msg);
     return msg.result;
 }
 
-ProcessID FileSystemClient::findMount(const char *path) const
+Address FileSystemClient::prepareBulk(const ProcessID pid, FileSystemMessage &msg) const
 {
-    FileSystemMount *m = ZERO;
-    Size length = 0;
-    char fullpath[FileSystemPath::MaximumLength];
+    // Start from the regular action, the request may be re-directed
+    if (msg.action == FileSystem::ReadFileBulk)
+        msg.action = FileSystem::ReadFile;
+    else if (msg.action == FileSystem::WriteFileBulk)
+        msg.action = FileSystem::WriteFile;
+
+    if ((msg.action != FileSystem::ReadFile && msg.action != FileSystem::WriteFile) ||
+         msg.size < FileSystem::BulkMinimumSize || msg.size > FileSystem::BulkShareSize)
+    {
+        return ZERO;
+    }
 
-    // Use the current directory as prefix for relative paths
-    if (path[0] != '/' && m_currentDirectory != NULL)
+    // Retrieve the bulk I/O share with the file system, or create it once
+    const SystemInformation info;
+    ProcessShares::MemoryShare share;
+    share.pid    = pid;
+    share.coreId = info.coreId;
+    share.tagId  = FileSystem::BulkShareTag;
+
+    const API::Result result = VMShare(SELF, API::Read, &share);
+
+    // Release our side of the share if the file system has detached from it
+    if (result == API::Success && !share.attached)
+    {
+        VMShare(pid, API::Delete, &share);
+    }
+
+    if (result != API::Success || !share.attached)
     {
-        const Size copied = MemoryBlock::copy(fullpath, **m_currentDirectory, sizeof(fullpath));
+        share.range.virt   = 0;
+        share.range.phys   = 0;
+        share.range.size   = FileSystem::BulkShareSize;
+        share.range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+        if (VMShare(pid, API::Create, &share) != API::Success)
+            return ZERO;
+    }
 
-        if (copied < sizeof(fullpath))
-            MemoryBlock::copy(fullpath + copied, path, sizeof(fullpath) - copied);
+    // Place the data to write in the share
+    if (msg.action == FileSystem::WriteFile)
+    {
+        MemoryBlock::copy((void *) share.range.virt, msg.buffer, msg.size);
+        msg.action = FileSystem::WriteFileBulk;
     }
     else
     {
-        MemoryBlock::copy(fullpath, path, sizeof(fullpath));
+        msg.action = FileSystem::ReadFileBulk;
+    }
+
+    return share.range.virt;
+}
+
+void FileSystemClient::completeBulk(const u8 *bulk, FileSystemMessage &msg) const
+{
+    if (bulk && msg.action == FileSystem::ReadFileBulk && msg.result == FileSystem::Success)
+    {
+        MemoryBlock::copy(msg.buffer, bulk, msg.size);
     }
+}
+
+ProcessID FileSystemClient::findMount(const char *path) const
+{
+    FileSystemMount *m = ZERO;
+    Size length = 0;
+    char fullpath[FileSystemPath::MaximumLength];
+
+    getFullPath(path, fullpath);
 
     // Find the longest match
     for (Size i = 0; i < MaximumFileSystemMounts; i++)
@@ -132,6 +178,24 @@ ProcessID FileSystemClient::findMount(const char *path) const
     return m ? m->procID : ROOTFS_PID;
 }
 
+void FileSystemClient::getFullPath(const char *path, char *fullpath) const
+{
+    const Size size = FileSystemPath::MaximumLength;
+
+    // Use the current directory as prefix for relative paths
+    if (path[0] != '/' && m_currentDirectory != NULL)
+    {
+        const Size copied = MemoryBlock::copy(fullpath, **m_currentDirectory, size);
+
+        if (copied < size)
+            MemoryBlock::copy(fullpath + copied, path, size - copied);
+    }
+    else
+    {
+        MemoryBlock::copy(fullpath, path, size);
+    }
+}
+
 const String * FileSystemClient::getCurrentDirectory() const
 {
     return m_currentDirectory;
@@ -215,6 +279,74 @@ FileSystem::Result FileSystemClient::writeFile(const char *path,
     return result;
 }
 
+FileSystem::Result FileSystemClient::readFile(const ProcessID pid,
+                                              const FileSystem::Handle handle,
+                                              void *buf,
+                                              Size *size,
+                                              const Size offset) const
+{
+    FileSystemMessage msg;
+    msg.type     = ChannelMessage::Request;
+    msg.action   = FileSystem::ReadFile;
+    msg.path     = ZERO;
+    msg.handle   = handle;
+    msg.buffer   = (char *)buf;
+    msg.size     = *size;
+    msg.offset   = offset;
+
+    const FileSystem::Result result = request(pid, msg);
+    if (result == FileSystem::Success)
+    {
+        *size = msg.size;
+    }
+
+    return result;
+}
+
+FileSystem::Result FileSystemClient::writeFile(const ProcessID pid,
+                                               const FileSystem::Handle handle,
+                                               const void *buf,
+                                               Size *size,
+                                               const Size offset) const
+{
+    FileSystemMessage msg;
+    msg.type     = ChannelMessage::Request;
+    msg.action   = FileSystem::WriteFile;
+    msg.path     = ZERO;
+    msg.handle   = handle;
+    msg.buffer   = (char *)buf;
+    msg.size     = *size;
+    msg.offset   = offset;
+
+    const FileSystem::Result result = request(pid, msg);
+    if (result == FileSystem::Success)
+    {
+        *size = msg.size;
+    }
+
+    return result;
+}
+
+FileSystem::Result FileSystemClient::openFile(const char *path,
+                                              ProcessID *pid,
+                                              FileSystem::Handle *handle) const
+{
+    FileSystemMessage msg;
+    msg.type   = ChannelMessage::Request;
+    msg.action = FileSystem::OpenFile;
+    msg.path   = (char *)path;
+
+    const FileSystem::Result result = request(path, msg);
+    if (result == FileSystem::Success)
+    {
+        // The mounts table is updated if the request was re-directed
+        *pid    = m_pid == ANY ? findMount(path) : m_pid;
+        *handle = msg.handle;
+    }
+
+    return result;
+}
+
 FileSystem::Result FileSystemClient::statFile(const char *path, FileSystem::FileStat *st) const
 {
     FileSystemMessage msg;
@@ -90,6 +90,14 @@ class FileSystemClient
      */
     ProcessID findMount(const char *path) const;
 
+    /**
+     * Get the full path of a file.
+     *
+     * @param path Absolute path or path relative to the current directory.
+     * @param fullpath Output buffer of FileSystemPath::MaximumLength bytes.
+     */
+    void getFullPath(const char *path, char *fullpath) const;
+
     /**
      * Create a new file.
      *
@@ -120,6 +128,23 @@ class FileSystemClient
                                 Size *size,
                                 const Size offset) const;
 
+    /**
+     * Read an opened file.
+     *
+     * @param pid ProcessID of the file system which opened the file
+     * @param handle Handle of the opened file
+     * @param buf Buffer for storing bytes read.
+     * @param size On input, number of bytes to read. On output, actual bytes read.
+     * @param offset Specifies absolute starting point in bytes to read.
+     *
+     * @return Result code, where StaleHandle means the file must be opened again
+     */
+    FileSystem::Result readFile(const ProcessID pid,
+                                const FileSystem::Handle handle,
+                                void *buf,
+                                Size *size,
+                                const Size offset) const;
+
     /**
      * Write a file.
      *
@@ -135,6 +160,39 @@ class FileSystemClient
                                  Size *size,
                                  const Size offset) const;
 
+    /**
+     * Write an opened file.
+     *
+     * @param pid ProcessID of the file system which opened the file
+     * @param handle Handle of the opened file
+     * @param buf Input buffer for bytes to write.
+     * @param size On input, number of bytes to write. On output, actual bytes written.
+     * @param offset Specifies absolute starting point in bytes to write.
+     *
+     * @return Result code, where StaleHandle means the file must be opened again
+     */
+    FileSystem::Result writeFile(const ProcessID pid,
+                                 const FileSystem::Handle handle,
+                                 const void *buf,
+                                 Size *size,
+                                 const Size offset) const;
+
+    /**
+     * Open a file.
+     *
+     * The returned handle can be used to read and write the file
+     * without sending and resolving its path on every request.
+     *
+     * @param path Path to the file
+     * @param pid ProcessID of the file system on output
+     * @param handle Handle of the opened file on output
+     *
+     * @return Result code
+     */
+    FileSystem::Result openFile(const char *path,
+                                ProcessID *pid,
+                                FileSystem::Handle *handle) const;
+
     /**
      * Retrieve status of a file.
      *
@@ -206,6 +264,31 @@ class FileSystemClient
      */
     FileSystem::Result request(const ProcessID pid, FileSystemMessage &msg) const;
 
+    /**
+     * Prepare a ReadFile or WriteFile request for the bulk I/O share
+     *
+     * Requests within the bulk size limits are converted to ReadFileBulk
+     * or WriteFileBulk. The bulk I/O share with the target file system is
+     * created on first use, and re-created if the file system detached from
+     * it. For writes the data is copied into the share.
+     *
+     * @param pid Process identifier of the target file system.
+     * @param msg Reference to the FileSystemMessage to send
+     *
+     * @return Virtual address of the bulk I/O share or ZERO if not used
+     */
+    Address prepareBulk(const ProcessID pid, FileSystemMessage &msg) const;
+
+    /**
+     * Complete a bulk I/O request
+     *
+     * Copies the bytes read by a ReadFileBulk request to the caller's buffer.
+     *
+     * @param bulk Virtual address of the bulk I/O share or ZERO if not used
+     * @param msg Reference to the FileSystemMessage received
+     */
+    void completeBulk(const u8 *bulk, FileSystemMessage &msg) const;
+
   private:
 
     /** FileSystem mounts table */
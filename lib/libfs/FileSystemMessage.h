@@ -47,6 +47,7 @@ typedef struct FileSystemMessage : public ChannelMessage
     DeviceID deviceID;             /**< Device major/minor numbers. */
     ProcessID pid;                 /**< Process identifier (used for redirection) */
     Size pathMountLength;          /**< Length of the mounted path (used for redirection) */
+    FileSystem::Handle handle;     /**< Handle of an opened file (used if path is ZERO). */
 }
 FileSystemMessage;
 
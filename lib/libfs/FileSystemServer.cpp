@@ -32,7 +32,10 @@ FileSystemServer::FileSystemServer(Directory *root, const char *path)
     , m_mountPath(path)
     , m_mounts(ZERO)
     , m_requests(new List<FileSystemRequest *>())
+    , m_handleGeneration(initialGeneration())
+    , m_openFilesNext(0)
 {
+    MemoryBlock::set(m_openFiles, 0, sizeof(m_openFiles));
     setRoot(root);
 
     // Register message handlers
@@ -44,6 +47,9 @@ FileSystemServer::FileSystemServer(Directory *root, const char *path)
     addIPCHandler(FileSystem::MountFileSystem, &FileSystemServer::mountHandler);
     addIPCHandler(FileSystem::WaitFileSystem,  &FileSystemServer::pathHandler, false);
     addIPCHandler(FileSystem::GetFileSystems,  &FileSystemServer::getFileSystemsHandler);
+    addIPCHandler(FileSystem::ReadFileBulk,    &FileSystemServer::pathHandler, false);
+    addIPCHandler(FileSystem::WriteFileBulk,   &FileSystemServer::pathHandler, false);
+    addIPCHandler(FileSystem::OpenFile,        &FileSystemServer::pathHandler, false);
 }
 
 FileSystemServer::~FileSystemServer()
@@ -137,16 +143,34 @@ void FileSystemServer::pathHandler(FileSystemMessage *msg)
 {
     // Prepare request
     FileSystemRequest req(msg);
+    File *file;
 
     // Process the request.
-    if (processRequest(req) == FileSystem::RetryAgain)
+    if (processRequest(req, &file) == FileSystem::RetryAgain)
     {
         FileSystemRequest *reqCopy = new FileSystemRequest(msg);
         assert(reqCopy != NULL);
-        m_requests->append(reqCopy);
+        waitRequest(reqCopy, file);
     }
 }
 
+void FileSystemServer::waitRequest(FileSystemRequest *req, File *file)
+{
+    // Requests without a File are retried on every wakeup
+    if (file == ZERO)
+    {
+        m_requests->append(req);
+        return;
+    }
+
+    List<FileSystemRequest *> &queue = file->getWaitQueue();
+    if (queue.count() == 0)
+    {
+        m_waitFiles.append(file);
+    }
+    queue.append(req);
+}
+
 bool FileSystemServer::redirectRequest(const char *path, FileSystemMessage *msg)
 {
     Size savedMountLength = 0;
@@ -185,7 +209,7 @@ bool FileSystemServer::redirectRequest(const char *path, FileSystemMessage *msg)
     return true;
 }
 
-FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
+FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req, File **waitFile)
 {
     char buf[FileSystemPath::MaximumLength];
     FileCache *cache = ZERO;
@@ -194,6 +218,29 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
     FileSystemMessage *msg = req.getMessage();
     Error ret;
 
+    *waitFile = ZERO;
+
+    // Opened files may be given by handle, which skips the path lookup
+    if (msg->path == ZERO)
+    {
+        if ((file = findHandle(msg->handle)) != ZERO)
+        {
+            *waitFile = file;
+            processFileIO(req, file);
+        }
+        else
+        {
+            DEBUG(m_self << ": stale handle " << msg->handle);
+            msg->result = FileSystem::StaleHandle;
+        }
+
+        if (msg->result != FileSystem::RetryAgain)
+        {
+            sendResponse(msg);
+        }
+        return msg->result;
+    }
+
     // Copy the file path
     if ((ret = VMCopy(msg->from, API::Read, (Address) buf,
                     (Address) msg->path, FileSystemPath::MaximumLength)) <= 0)
@@ -283,7 +330,53 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
             DEBUG(m_self << ": stat = " << (int)msg->result);
             break;
 
-        case FileSystem::ReadFile: {
+        case FileSystem::ReadFile:
+        case FileSystem::ReadFileBulk:
+        case FileSystem::WriteFile:
+        case FileSystem::WriteFileBulk:
+            processFileIO(req, file);
+            break;
+
+        case FileSystem::OpenFile:
+            msg->handle = openHandle(file);
+            msg->result = FileSystem::Success;
+            DEBUG(m_self << ": open = " << msg->handle);
+            break;
+
+        case FileSystem::WaitFileSystem: {
+            // Do nothing here. Once the targeted file system is mounted
+            // this function will send a redirect message when called again
+            DEBUG(m_self << ": wait for " << buf);
+            msg->result = FileSystem::RetryAgain;
+            break;
+        }
+
+        default: {
+            ERROR("unhandled file I/O operation: " << (int)msg->action);
+            msg->result = FileSystem::NotSupported;
+            break;
+        }
+    }
+
+    // Only send reply if completed (not RetryAgain)
+    if (msg->result != FileSystem::RetryAgain)
+    {
+        sendResponse(msg);
+    }
+
+    *waitFile = file;
+    return msg->result;
+}
+
+FileSystem::Result FileSystemServer::processFileIO(FileSystemRequest &req, File *file)
+{
+    FileSystemMessage *msg = req.getMessage();
+    Error ret;
+
+    switch (msg->action)
+    {
+        case FileSystem::ReadFile:
+        case FileSystem::ReadFileBulk: {
             if ((ret = file->read(req.getBuffer(), msg->size, msg->offset)) >= 0)
             {
                 msg->size = ret;
@@ -304,7 +397,8 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
             break;
         }
 
-        case FileSystem::WriteFile: {
+        case FileSystem::WriteFile:
+        case FileSystem::WriteFileBulk: {
             if (!req.getBuffer().getCount())
                 req.getBuffer().bufferedRead();
 
@@ -312,6 +406,7 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
             {
                 msg->size = ret;
                 msg->result = FileSystem::Success;
+                file->setModified();
             }
             else if (ret == FileSystem::RetryAgain)
             {
@@ -325,25 +420,9 @@ FileSystem::Result FileSystemServer::processRequest(FileSystemRequest &req)
             break;
         }
 
-        case FileSystem::WaitFileSystem: {
-            // Do nothing here. Once the targeted file system is mounted
-            // this function will send a redirect message when called again
-            DEBUG(m_self << ": wait for " << buf);
-            msg->result = FileSystem::RetryAgain;
-            break;
-        }
-
-        default: {
-            ERROR("unhandled file I/O operation: " << (int)msg->action);
+        default:
             msg->result = FileSystem::NotSupported;
             break;
-        }
-    }
-
-    // Only send reply if completed (not RetryAgain)
-    if (msg->result != FileSystem::RetryAgain)
-    {
-        sendResponse(msg);
     }
 
     return msg->result;
@@ -444,20 +523,102 @@ bool FileSystemServer::retryRequests()
 
     DEBUG("");
 
-    for (ListIterator<FileSystemRequest *> i(m_requests); i.hasCurrent(); i++)
+    // Requests without a File are processed again completely
+    for (ListIterator<FileSystemRequest *> i(m_requests); i.hasCurrent();)
     {
-        FileSystem::Result result = processRequest(*i.current());
+        FileSystemRequest *req = i.current();
+        File *file;
+
+        const FileSystem::Result result = processRequest(*req, &file);
         if (result != FileSystem::RetryAgain)
         {
-            delete i.current();
+            delete req;
             i.remove();
             restartNeeded = true;
         }
+        else if (file != ZERO)
+        {
+            i.remove();
+            waitRequest(req, file);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    // Only retry the I/O for requests waiting on a File
+    for (ListIterator<File *> i(m_waitFiles); i.hasCurrent();)
+    {
+        File *file = i.current();
+
+        if (retryFile(file))
+        {
+            restartNeeded = true;
+        }
+
+        if (file->getWaitQueue().count() == 0)
+            i.remove();
+        else
+            i++;
     }
 
     return restartNeeded;
 }
 
+bool FileSystemServer::retryFile(File *file)
+{
+    const bool ready = file->checkReady();
+    bool completed = false;
+
+    for (ListIterator<FileSystemRequest *> i(file->getWaitQueue()); i.hasCurrent();)
+    {
+        FileSystemRequest *req = i.current();
+        FileSystemMessage *msg = req->getMessage();
+
+        // Reads wait for the File to signal new data
+        if (!ready && (msg->action == FileSystem::ReadFile ||
+                       msg->action == FileSystem::ReadFileBulk))
+        {
+            i++;
+            continue;
+        }
+
+        if (processFileIO(*req, file) != FileSystem::RetryAgain)
+        {
+            sendResponse(msg);
+            delete req;
+            i.remove();
+            completed = true;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    return completed;
+}
+
+void FileSystemServer::cancelRequests(File *file)
+{
+    List<FileSystemRequest *> &queue = file->getWaitQueue();
+
+    if (queue.count() == 0)
+        return;
+
+    for (ListIterator<FileSystemRequest *> i(queue); i.hasCurrent(); i++)
+    {
+        FileSystemMessage *msg = i.current()->getMessage();
+        msg->result = FileSystem::NotFound;
+        sendResponse(msg);
+        delete i.current();
+    }
+
+    queue.clear();
+    m_waitFiles.remove(file);
+}
+
 void FileSystemServer::setRoot(Directory *newRoot)
 {
     if (newRoot != ZERO)
@@ -627,7 +788,82 @@ void FileSystemServer::clearFileCache(FileCache *cache)
             cache->parent->entries.remove(cache->name);
         }
 
+        closeHandles(cache->file);
+        cancelRequests(cache->file);
         delete cache->file;
     }
     delete cache;
 }
+
+u32 FileSystemServer::initialGeneration() const
+{
+    static u32 instances = 0;
+    const u32 mask = (1U << (32 - HandleIndexBits)) - 1;
+    u32 seed = (m_pid * 2654435761U) ^ (++instances * 40503U);
+    Timer::Info timer;
+
+    if (ProcessCtl(SELF, InfoTimer, (Address) &timer) == API::Success)
+        seed ^= timer.ticks * 2246822519U;
+
+    // Generation numbers must fit in the handle and never be zero
+    seed ^= seed >> 16;
+    return (seed & mask) ? (seed & mask) : 1;
+}
+
+FileSystem::Handle FileSystemServer::openHandle(File *file)
+{
+    Size index = MaximumOpenFiles;
+
+    // The File may be opened already, otherwise take a free entry
+    for (Size i = 0; i < MaximumOpenFiles; i++)
+    {
+        if (m_openFiles[i].file == file)
+        {
+            return (m_openFiles[i].generation << HandleIndexBits) | i;
+        }
+        else if (m_openFiles[i].file == ZERO && index == MaximumOpenFiles)
+        {
+            index = i;
+        }
+    }
+
+    // Reuse the least recently assigned entry if the table is full
+    if (index == MaximumOpenFiles)
+    {
+        index = m_openFilesNext;
+        m_openFilesNext = (m_openFilesNext + 1) % MaximumOpenFiles;
+    }
+
+    m_openFiles[index].file = file;
+    m_openFiles[index].generation = m_handleGeneration;
+
+    // Generation numbers must fit in the handle and never be zero
+    if (++m_handleGeneration >= (1U << (32 - HandleIndexBits)))
+        m_handleGeneration = 1;
+
+    return (m_openFiles[index].generation << HandleIndexBits) | index;
+}
+
+File * FileSystemServer::findHandle(const FileSystem::Handle handle) const
+{
+    const Size index = handle & ((1U << HandleIndexBits) - 1);
+
+    if (index >= MaximumOpenFiles || m_openFiles[index].file == ZERO ||
+        m_openFiles[index].generation != (handle >> HandleIndexBits))
+    {
+        return ZERO;
+    }
+
+    return m_openFiles[index].file;
+}
+
+void FileSystemServer::closeHandles(const File *file)
+{
+    for (Size i = 0; i < MaximumOpenFiles; i++)
+    {
+        if (m_openFiles[i].file == file)
+        {
+            m_openFiles[i].file = ZERO;
+        }
+    }
+}
@@ -48,6 +48,22 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
     /** Maximum number of supported file system mount entries */
     static const Size MaximumFileSystemMounts = 32;
 
+    /** Maximum number of open file handles */
+    static const Size MaximumOpenFiles = 128;
+
+    /** Number of bits in a handle used for the index in the open files table */
+    static const Size HandleIndexBits = 8;
+
+    /**
+     * Entry in the open files table.
+     */
+    typedef struct OpenFileEntry
+    {
+        File *file;     /**< Opened file or ZERO if unused. */
+        u32 generation; /**< Generation number, to detect stale handles. */
+    }
+    OpenFileEntry;
+
   public:
 
     /**
@@ -139,10 +155,50 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
     /**
      * Process a FileSystemRequest.
      *
+     * @param req Request to process.
+     * @param file Set to the File of the request, if found.
+     *
      * @return Result code, where RetryAgain indicates the request cannot
      *         be completed yet.
      */
-    FileSystem::Result processRequest(FileSystemRequest &req);
+    FileSystem::Result processRequest(FileSystemRequest &req, File **file);
+
+    /**
+     * Keep a request which returned RetryAgain for later.
+     *
+     * Requests are parked on the wait queue of their File,
+     * such that only requests of Files which are ready are retried.
+     *
+     * @param req Copy of the request allocated on the heap.
+     * @param file File of the request or ZERO if none.
+     */
+    void waitRequest(FileSystemRequest *req, File *file);
+
+    /**
+     * Retry the requests waiting on a File.
+     *
+     * @param file File with a non-empty wait queue.
+     *
+     * @return True if any request was completed.
+     */
+    bool retryFile(File *file);
+
+    /**
+     * Fail all requests waiting on a File.
+     *
+     * @param file File which is removed.
+     */
+    void cancelRequests(File *file);
+
+    /**
+     * Perform a read or write on a File.
+     *
+     * @param req FileSystemRequest with a ReadFile or WriteFile message.
+     * @param file File to read or write.
+     *
+     * @return Result code, also set in the message.
+     */
+    FileSystem::Result processFileIO(FileSystemRequest &req, File *file);
 
     /**
      * Send response for a FileSystemMessage
@@ -241,6 +297,47 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
      */
     void clearFileCache(FileCache *cache = ZERO);
 
+    /**
+     * Get the first handle generation number of this instance.
+     *
+     * The generation is seeded from the process ID, the timer and the
+     * number of instances in this process. Handles which a client got from
+     * a previous instance of the file system are thus stale after a restart
+     * or remount, instead of matching unrelated files.
+     *
+     * @return Generation number for the first handle.
+     */
+    u32 initialGeneration() const;
+
+    /**
+     * Get a handle for a File.
+     *
+     * All openers of the same File share its handle. If the open files table
+     * is full, the least recently assigned entry is reused and its handle
+     * becomes stale.
+     *
+     * @param file File to open.
+     *
+     * @return Handle of the File.
+     */
+    FileSystem::Handle openHandle(File *file);
+
+    /**
+     * Retrieve the File of a handle.
+     *
+     * @param handle Handle returned by openHandle().
+     *
+     * @return File pointer or ZERO if the handle is stale.
+     */
+    File * findHandle(const FileSystem::Handle handle) const;
+
+    /**
+     * Invalidate all handles of a File.
+     *
+     * @param file File which is removed.
+     */
+    void closeHandles(const File *file);
+
   protected:
 
     /** Process identifier */
@@ -255,8 +352,20 @@ class FileSystemServer : public ChannelServer<FileSystemServer, FileSystemMessag
     /** Table with mounted file systems (only used by the root file system). */
     FileSystemMount *m_mounts;
 
-    /** Contains ongoing requests */
+    /** Contains ongoing requests without a File */
     List<FileSystemRequest *> *m_requests;
+
+    /** Files with requests in their wait queue */
+    List<File *> m_waitFiles;
+
+    /** Open files table */
+    OpenFileEntry m_openFiles[MaximumOpenFiles];
+
+    /** Generation number for the next handle */
+    u32 m_handleGeneration;
+
+    /** Next entry to reuse in the open files table when full */
+    Size m_openFilesNext;
 };
 
 /**
@@ -17,6 +17,8 @@
 
 #include <FreeNOS/User.h>
 #include <Assert.h>
+#include <Log.h>
+#include <MemoryBlock.h>
 #include "IOBuffer.h"
 
 IOBuffer::IOBuffer()
@@ -24,6 +26,7 @@ IOBuffer::IOBuffer()
     , m_buffer(ZERO)
     , m_size(0)
     , m_count(0)
+    , m_bulk(false)
 {
 }
 
@@ -32,13 +35,14 @@ IOBuffer::IOBuffer(const FileSystemMessage *msg)
     , m_buffer(ZERO)
     , m_size(0)
     , m_count(0)
+    , m_bulk(false)
 {
     setMessage(msg);
 }
 
 IOBuffer::~IOBuffer()
 {
-    if (m_buffer)
+    if (m_buffer && !m_bulk)
     {
         delete[] m_buffer;
     }
@@ -46,8 +50,15 @@ IOBuffer::~IOBuffer()
 
 void IOBuffer::setMessage(const FileSystemMessage *msg)
 {
-    if (msg->action == FileSystem::ReadFile ||
-        msg->action == FileSystem::WriteFile)
+    if (msg->action == FileSystem::ReadFileBulk ||
+        msg->action == FileSystem::WriteFileBulk)
+    {
+        assert(m_buffer == NULL);
+        m_buffer = (u8 *) getBulkShare(msg);
+        m_bulk = true;
+    }
+    else if (msg->action == FileSystem::ReadFile ||
+             msg->action == FileSystem::WriteFile)
     {
         m_buffer = new u8[msg->size];
         assert(m_buffer != NULL);
@@ -63,6 +74,29 @@ void IOBuffer::setMessage(const FileSystemMessage *msg)
     m_count  = 0;
 }
 
+Address IOBuffer::getBulkShare(const FileSystemMessage *msg) const
+{
+    const SystemInformation info;
+    ProcessShares::MemoryShare share;
+    share.pid    = msg->from;
+    share.coreId = info.coreId;
+    share.tagId  = FileSystem::BulkShareTag;
+
+    const API::Result result = VMShare(SELF, API::Read, &share);
+    if (result != API::Success)
+    {
+        ERROR("failed to find bulk I/O share for PID " << msg->from << ": result = " << (int) result);
+        return ZERO;
+    }
+    else if (msg->size > share.range.size)
+    {
+        ERROR("bulk I/O request of " << msg->size << " bytes exceeds share size " << share.range.size);
+        return ZERO;
+    }
+
+    return share.range.virt;
+}
+
 Size IOBuffer::getCount() const
 {
     return m_count;
@@ -80,6 +114,16 @@ const u8 * IOBuffer::getBuffer() const
 
 FileSystem::Error IOBuffer::bufferedRead()
 {
+    // The client has already placed its data in the bulk share
+    if (m_bulk)
+    {
+        if (!m_buffer)
+            return FileSystem::IOError;
+
+        m_count = m_size;
+        return m_count;
+    }
+
     m_count = read(m_buffer, m_message->size, 0);
     return m_count;
 }
@@ -88,7 +132,11 @@ FileSystem::Error IOBuffer::bufferedWrite(const void *buffer, Size size)
 {
     Size i = 0;
 
-    if (!m_buffer)
+    if (m_bulk && !m_buffer)
+    {
+        return FileSystem::IOError;
+    }
+    else if (!m_buffer)
     {
         m_buffer = new u8[m_message->size];
         assert(m_buffer != NULL);
@@ -103,6 +151,15 @@ FileSystem::Error IOBuffer::bufferedWrite(const void *buffer, Size size)
 
 FileSystem::Error IOBuffer::read(void *buffer, Size size, Size offset) const
 {
+    if (m_bulk)
+    {
+        if (!m_buffer || offset + size > m_size)
+            return FileSystem::IOError;
+
+        MemoryBlock::copy(buffer, m_buffer + offset, size);
+        return size;
+    }
+
     return VMCopy(m_message->from, API::Read,
                  (Address) buffer,
                  (Address) m_message->buffer + offset, size);
@@ -110,6 +167,15 @@ FileSystem::Error IOBuffer::read(void *buffer, Size size, Size offset) const
 
 FileSystem::Error IOBuffer::write(void *buffer, Size size, Size offset) const
 {
+    if (m_bulk)
+    {
+        if (!m_buffer || offset + size > m_size)
+            return FileSystem::IOError;
+
+        MemoryBlock::copy(m_buffer + offset, buffer, size);
+        return size;
+    }
+
     return VMCopy(m_message->from, API::Write,
                  (Address) buffer,
                  (Address) m_message->buffer + offset, size);
@@ -117,6 +183,10 @@ FileSystem::Error IOBuffer::write(void *buffer, Size size, Size offset) const
 
 FileSystem::Error IOBuffer::flush() const
 {
+    // Buffered bytes are already stored in the bulk share
+    if (m_bulk)
+        return m_count;
+
     return write(m_buffer, m_count, 0);
 }
 
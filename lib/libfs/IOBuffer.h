@@ -32,6 +32,10 @@
 
 /**
  * @brief Abstract Input/Output buffer.
+ *
+ * For ReadFileBulk and WriteFileBulk requests the buffer is the bulk
+ * I/O share with the client, such that data is transferred without
+ * intermediate copies and without VMCopy.
  */
 class IOBuffer
 {
@@ -138,6 +142,17 @@ class IOBuffer
      */
     u8 operator[] (Size index) const;
 
+  private:
+
+    /**
+     * Lookup the bulk I/O share with the client.
+     *
+     * @param msg Describes the request being processed.
+     *
+     * @return Virtual address of the share or ZERO on failure.
+     */
+    Address getBulkShare(const FileSystemMessage *msg) const;
+
   private:
 
     /**
@@ -160,6 +175,9 @@ class IOBuffer
 
     /** Bytes written to the buffer. */
     Size m_count;
+
+    /** True if the buffer is the bulk I/O share with the client. */
+    bool m_bulk;
 };
 
 /**
@@ -66,12 +66,12 @@ FileSystem::Error PseudoFile::write(IOBuffer & buffer, Size size, Size offset)
         // Allocate a new buffer and copy the old data
         char *new_buffer = new char[size+offset];
         assert(new_buffer != NULL);
-        MemoryBlock::set(new_buffer, 0, sizeof(size+offset));
+        MemoryBlock::set(new_buffer, 0, size+offset);
 
         // Inherit from the old buffer, if needed
         if (m_buffer)
         {
-            MemoryBlock::copy(new_buffer, m_buffer, m_size);
+            MemoryBlock::copy((void *) new_buffer, (void *) m_buffer, m_size);
             delete[] m_buffer;
         }
         // Assign buffer
@@ -16,6 +16,7 @@
  */
 
 #include <Types.h>
+#include <Macros.h>
 #include "Storage.h"
 
 Storage::Storage()
@@ -30,3 +31,8 @@ FileSystem::Result Storage::write(const u64 offset, void *buffer, const Size siz
 {
     return FileSystem::NotSupported;
 }
+
+const u8 * Storage::map(const u64 offset, const Size size) const
+{
+    return ZERO;
+}
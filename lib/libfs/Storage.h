@@ -75,6 +75,19 @@ class Storage
      */
     virtual FileSystem::Result write(const u64 offset, void *buffer, const Size size);
 
+    /**
+     * Get direct access to memory-resident contents.
+     *
+     * Storage which is already mapped in memory can return a pointer
+     * to its contents, which avoids copying the data with read().
+     *
+     * @param offset Offset of the first byte to access.
+     * @param size Number of bytes to access.
+     *
+     * @return Pointer to the contents or ZERO if not supported.
+     */
+    virtual const u8 * map(const u64 offset, const Size size) const;
+
     /**
      * Retrieve maximum storage capacity.
      *
@@ -42,6 +42,38 @@ Channel::Result Channel::write(const void *buffer)
     return NotSupported;
 }
 
+Channel::Result Channel::readBatch(void *buffer, const Size maximum, Size *count)
+{
+    Result result = Success;
+    Size n = 0;
+
+    for (; n < maximum; n++)
+    {
+        result = read(((u8 *) buffer) + (n * m_messageSize));
+        if (result != Success)
+            break;
+    }
+
+    *count = n;
+    return n > 0 ? Success : result;
+}
+
+Channel::Result Channel::writeBatch(const void *buffer, const Size count, Size *written)
+{
+    Result result = Success;
+    Size n = 0;
+
+    for (; n < count; n++)
+    {
+        result = write(((const u8 *) buffer) + (n * m_messageSize));
+        if (result != Success)
+            break;
+    }
+
+    *written = n;
+    return result;
+}
+
 Channel::Result Channel::flush()
 {
     return NotSupported;
@@ -99,6 +99,33 @@ class Channel
      */
     virtual Result write(const void *buffer);
 
+    /**
+     * Read a batch of messages.
+     *
+     * The default implementation calls read() for each message.
+     *
+     * @param buffer Output buffer with room for maximum messages.
+     * @param maximum Maximum number of messages to read.
+     * @param count On output contains the number of messages read.
+     *
+     * @return Success if at least one message was read, NotFound if empty.
+     */
+    virtual Result readBatch(void *buffer, const Size maximum, Size *count);
+
+    /**
+     * Write a batch of messages.
+     *
+     * The default implementation calls write() for each message.
+     *
+     * @param buffer Input buffer containing count messages.
+     * @param count Number of messages to write.
+     * @param written On output contains the number of messages written.
+     *
+     * @return Success if all messages were written, ChannelFull if
+     *         the channel filled up before all messages were written.
+     */
+    virtual Result writeBatch(const void *buffer, const Size count, Size *written);
+
     /**
      * Flush message buffers.
      *
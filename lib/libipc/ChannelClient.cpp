@@ -40,20 +40,27 @@ ChannelClient::Result ChannelClient::initialize()
     return Success;
 }
 
-ChannelClient::Result ChannelClient::connect(const ProcessID pid, const Size messageSize)
+ChannelClient::Result ChannelClient::connect(const ProcessID pid,
+                                             const Size messageSize,
+                                             const Size ringSize)
 {
     Address prodAddr, consAddr;
     const SystemInformation info;
 
+    if (ringSize == 0 || (ringSize % PAGESIZE) != 0)
+    {
+        return InvalidSize;
+    }
+
     // Allocate consumer
-    MemoryChannel *cons = new MemoryChannel(Channel::Consumer, messageSize);
+    MemoryChannel *cons = new MemoryChannel(Channel::Consumer, messageSize, ringSize);
     if (!cons)
     {
         return OutOfMemory;
     }
 
     // Allocate producer
-    MemoryChannel *prod = new MemoryChannel(Channel::Producer, messageSize);
+    MemoryChannel *prod = new MemoryChannel(Channel::Producer, messageSize, ringSize);
     if (!prod)
     {
         delete cons;
@@ -65,7 +72,7 @@ ChannelClient::Result ChannelClient::connect(const ProcessID pid, const Size mes
     share.pid    = pid;
     share.coreId = info.coreId;
     share.tagId  = 0;
-    share.range.size = PAGESIZE * 4;
+    share.range.size = (ringSize + PAGESIZE) * 2;
     share.range.virt = 0;
     share.range.phys = 0;
     share.range.access = Memory::User | Memory::Readable | Memory::Writable;
@@ -94,16 +101,16 @@ ChannelClient::Result ChannelClient::connect(const ProcessID pid, const Size mes
     if (m_pid < pid)
     {
         prodAddr = share.range.virt;
-        consAddr = share.range.virt + (PAGESIZE * 2);
+        consAddr = share.range.virt + ringSize + PAGESIZE;
     }
     else
     {
-        prodAddr = share.range.virt + (PAGESIZE * 2);
+        prodAddr = share.range.virt + ringSize + PAGESIZE;
         consAddr = share.range.virt;
     }
 
     // Setup producer memory address
-    if (prod->setVirtual(prodAddr, prodAddr + PAGESIZE) != MemoryChannel::Success)
+    if (prod->setVirtual(prodAddr, prodAddr + ringSize) != MemoryChannel::Success)
     {
         delete prod;
         delete cons;
@@ -111,7 +118,7 @@ ChannelClient::Result ChannelClient::connect(const ProcessID pid, const Size mes
     }
 
     // Setup consumer memory address
-    if (cons->setVirtual(consAddr, consAddr + PAGESIZE) != MemoryChannel::Success)
+    if (cons->setVirtual(consAddr, consAddr + ringSize) != MemoryChannel::Success)
     {
         delete prod;
         delete cons;
@@ -146,7 +153,7 @@ ChannelClient::Result ChannelClient::sendRequest(const ProcessID pid,
 {
     Request *req = 0;
     Size identifier = 0;
-    Channel *ch = findProducer(pid, msgSize);
+    Channel *ch = findProducer(pid, msgSize, BatchRingSize);
     if (!ch)
         return NotFound;
 
@@ -219,27 +226,27 @@ ChannelClient::Result ChannelClient::processResponse(const ProcessID pid,
 }
 
 
-Channel * ChannelClient::findConsumer(const ProcessID pid, const Size msgSize)
+Channel * ChannelClient::findConsumer(const ProcessID pid, const Size msgSize, const Size ringSize)
 {
     Channel *ch = m_registry.getConsumer(pid);
     if (ch)
         return ch;
 
     // Try to connect
-    if (connect(pid, msgSize) != Success)
+    if (connect(pid, msgSize, ringSize) != Success)
         return ZERO;
 
     return m_registry.getConsumer(pid);
 }
 
-Channel * ChannelClient::findProducer(const ProcessID pid, const Size msgSize)
+Channel * ChannelClient::findProducer(const ProcessID pid, const Size msgSize, const Size ringSize)
 {
     Channel *ch = m_registry.getProducer(pid);
     if (ch)
         return ch;
 
     // Try to connect
-    if (connect(pid, msgSize) != Success)
+    if (connect(pid, msgSize, ringSize) != Success)
         return ZERO;
 
     return m_registry.getProducer(pid);
@@ -259,19 +266,32 @@ ChannelClient::Result ChannelClient::syncReceiveFrom(void *buffer, const Size ms
 
 ChannelClient::Result ChannelClient::syncSendTo(const void *buffer, const Size msgSize, const ProcessID pid)
 {
-    Channel *ch = findProducer(pid, msgSize);
+    return syncSendBatch(buffer, msgSize, 1, pid);
+}
+
+ChannelClient::Result ChannelClient::syncSendBatch(const void *buffer,
+                                                   const Size msgSize,
+                                                   const Size count,
+                                                   const ProcessID pid)
+{
+    const u8 *input = (const u8 *) buffer;
+    Size sent = 0;
+    Channel *ch = findProducer(pid, msgSize, count > 1 ? BatchRingSize : PAGESIZE);
     if (!ch)
         return NotFound;
 
     while (true)
     {
-        switch (ch->write(buffer))
+        Size written = 0;
+
+        switch (ch->writeBatch(input + (sent * msgSize), count - sent, &written))
         {
             case Channel::Success:
                 ProcessCtl(pid, Wakeup, 0);
                 return Success;
 
             case Channel::ChannelFull:
+                sent += written;
                 ProcessCtl(pid, Wakeup, 0);
                 break;
 
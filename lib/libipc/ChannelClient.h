@@ -18,6 +18,7 @@
 #ifndef __LIBIPC_CHANNELCLIENT_H
 #define __LIBIPC_CHANNELCLIENT_H
 
+#include <FreeNOS/Constant.h>
 #include <Singleton.h>
 #include <Callback.h>
 #include <Index.h>
@@ -46,6 +47,15 @@ class ChannelClient : public StrictSingleton<ChannelClient>
     /** Maximum number of retries for establishing new connection. */
     static const Size MaxConnectRetries = 16u;
 
+    /**
+     * Ring size of connections opened for asynchronous requests or batches.
+     *
+     * Several messages are in flight on such connections, and the server
+     * replies in batches too. Larger rings let both sides move more messages
+     * per wakeup. Synchronous request/reply only needs a single page.
+     */
+    static const Size BatchRingSize = PAGESIZE * 4;
+
     /**
      * Holds an outgoing request
      */
@@ -114,13 +124,20 @@ class ChannelClient : public StrictSingleton<ChannelClient>
      *
      * This function creates a producer and consumer Channel
      * to the given process and registers it with the ChannelRegistry.
+     * The ring size is passed to the other process by the size of the
+     * shared memory mapping, which holds for each direction a data
+     * ring followed by a feedback page.
      *
      * @param pid ProcessID for the process to connect to.
      * @param msgSize Message size to use.
+     * @param ringSize Size of the data ring in each direction in bytes.
+     *                 Must be a non-zero multiple of PAGESIZE.
      *
      * @return Result code
      */
-    virtual Result connect(const ProcessID pid, const Size msgSize);
+    virtual Result connect(const ProcessID pid,
+                           const Size msgSize,
+                           const Size ringSize = PAGESIZE);
 
     /**
      * Try to receive message from any channel.
@@ -138,7 +155,8 @@ class ChannelClient : public StrictSingleton<ChannelClient>
      *
      * The client assigns an internal request identifier
      * for the message and ensures that the callback will be
-     * called when a response messages is received.
+     * called when a response messages is received. A new connection
+     * uses rings of BatchRingSize.
      *
      * @param pid ProcessID to send the message to
      * @param buffer Points to message to send
@@ -185,6 +203,28 @@ class ChannelClient : public StrictSingleton<ChannelClient>
      */
     virtual Result syncSendTo(const void *buffer, const Size msgSize, const ProcessID pid);
 
+    /**
+     * Synchronous send of multiple messages to one process.
+     *
+     * The receiver is woken up once per written batch
+     * instead of once per message. A new connection for more than
+     * one message uses rings of BatchRingSize. Servers already reply in batches
+     * via ChannelServer, and the FileSystemClient based producers wait
+     * for each reply, so this is only useful for callers which have
+     * several independent messages ready at once.
+     *
+     * @param buffer Message buffer containing count messages to send
+     * @param msgSize Message size to use.
+     * @param count Number of messages to send
+     * @param pid ProcessID for the channel
+     *
+     * @return Result code
+     */
+    virtual Result syncSendBatch(const void *buffer,
+                                 const Size msgSize,
+                                 const Size count,
+                                 const ProcessID pid);
+
     /**
      * Synchronous send and receive to/from one process.
      *
@@ -203,20 +243,24 @@ class ChannelClient : public StrictSingleton<ChannelClient>
      *
      * @param pid ProcessID of the process
      * @param msgSize Message size to use.
+     * @param ringSize Ring size to use when a new connection is needed.
      *
      * @return Channel object if found or ZERO otherwise.
      */
-    Channel * findConsumer(const ProcessID pid, const Size msgSize);
+    Channel * findConsumer(const ProcessID pid, const Size msgSize,
+                           const Size ringSize = PAGESIZE);
 
     /**
      * Get producer for a process.
      *
      * @param pid ProcessID of the process
      * @param msgSize Message size to use.
+     * @param ringSize Ring size to use when a new connection is needed.
      *
      * @return Channel object if found or ZERO otherwise.
      */
-    Channel * findProducer(const ProcessID pid, const Size msgSize);
+    Channel * findProducer(const ProcessID pid, const Size msgSize,
+                           const Size ringSize = PAGESIZE);
 
   private:
 
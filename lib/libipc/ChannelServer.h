@@ -83,6 +83,9 @@ template <class Base, class MsgType> class ChannelServer
     /** Maximum number of IPC/IRQ handlers. */
     static const Size MaximumHandlerCount = 255u;
 
+    /** Maximum number of messages read from a Channel at once. */
+    static const Size MaximumBatchCount = 16u;
+
   protected:
 
     /** Member function pointer inside Base, to handle IPC messages. */
@@ -296,6 +299,10 @@ template <class Base, class MsgType> class ChannelServer
     /**
      * Accept new channel connection.
      *
+     * The size of the data rings is derived from the size of the shared
+     * memory mapping, which holds for each direction a data ring followed
+     * by a feedback page.
+     *
      * @param pid ProcessID
      * @param range Memory range of shared mapping
      *
@@ -305,36 +312,43 @@ template <class Base, class MsgType> class ChannelServer
                   const Memory::Range range,
                   const bool hardReset = true)
     {
+        const Size ringSize = (range.size / 2) - PAGESIZE;
         Address prodAddr, consAddr;
 
+        if (range.size < (PAGESIZE * 4) || (range.size % (PAGESIZE * 2)) != 0)
+        {
+            ERROR(m_self << ": invalid share size " << range.size << " for PID " << pid);
+            return InvalidSize;
+        }
+
         // ProcessID's determine where the producer/consumer is placed
         if (m_self < pid)
         {
             prodAddr = range.virt;
-            consAddr = range.virt + (PAGESIZE * 2);
+            consAddr = range.virt + ringSize + PAGESIZE;
         }
         else
         {
-            prodAddr = range.virt + (PAGESIZE * 2);
+            prodAddr = range.virt + ringSize + PAGESIZE;
             consAddr = range.virt;
         }
 
         // Create consumer
         if (!m_registry.getConsumer(pid))
         {
-            MemoryChannel *consumer = new MemoryChannel(Channel::Consumer, sizeof(MsgType));
+            MemoryChannel *consumer = new MemoryChannel(Channel::Consumer, sizeof(MsgType), ringSize);
             assert(consumer != NULL);
-            consumer->setVirtual(consAddr, consAddr + PAGESIZE, hardReset);
+            consumer->setVirtual(consAddr, consAddr + ringSize, hardReset);
             m_registry.registerConsumer(pid, consumer);
         }
 
         // Create producer
         if (!m_registry.getProducer(pid))
         {
-            MemoryChannel *producer = new MemoryChannel(Channel::Producer, sizeof(MsgType));
+            MemoryChannel *producer = new MemoryChannel(Channel::Producer, sizeof(MsgType), ringSize);
             assert(producer != NULL);
             producer->setVirtual(prodAddr,
-                                 prodAddr + PAGESIZE,
+                                 prodAddr + ringSize,
                                  hardReset);
             m_registry.registerProducer(pid, producer);
         }
@@ -392,7 +406,10 @@ template <class Base, class MsgType> class ChannelServer
                 case ShareCreated:
                 {
                     DEBUG(m_self << ": share created for PID: " << event.share.pid);
-                    accept(event.share.pid, event.share.range);
+
+                    // Only untagged shares are used for channels
+                    if (event.share.tagId == 0)
+                        accept(event.share.pid, event.share.range);
                     break;
                 }
                 case InterruptEvent:
@@ -447,67 +464,109 @@ template <class Base, class MsgType> class ChannelServer
     /**
      * Read each Channel for messages.
      *
+     * Messages are read in batches. Replies for a batch are written
+     * back with a single write and a single wakeup of the client.
+     *
      * @return Result code
      */
     Result readChannels()
     {
-        MsgType msg;
+        MsgType batch[MaximumBatchCount];
+        Size count;
 
-        // Try to receive message on each consumer channel
+        // Try to receive messages on each consumer channel
         for (HashIterator<ProcessID, Channel *> i(m_registry.getConsumers()); i.hasCurrent(); i++)
         {
             Channel *ch = i.current();
             DEBUG(m_self << ": trying to receive from PID " << i.key());
 
             // Read all messages in the consumer channel
-            while (ch->read(&msg) == Channel::Success)
+            while (ch->readBatch(batch, MaximumBatchCount, &count) == Channel::Success)
             {
-                DEBUG(m_self << ": received message");
-                msg.from = i.key();
+                Size replies = 0;
 
-                // Is the message a response from earlier client request?
-                if (msg.type == ChannelMessage::Response)
-                {
-                    if (m_client->processResponse(msg.from, &msg) != ChannelClient::Success)
-                    {
-                        ERROR(m_self << ": failed to process client response from PID " <<
-                               msg.from << " with identifier " << msg.identifier);
-                    }
-                }
-                // Message is a request to us
-                else
+                for (Size j = 0; j < count; j++)
                 {
-                    const MessageHandler<IPCHandlerFunction> *h = m_ipcHandlers.get(msg.action);
-                    if (h)
+                    if (processMessage(i.key(), &batch[j]))
                     {
-                        (m_instance->*h->exec) (&msg);
-
-                        // Send reply
-                        if (h->sendReply)
-                        {
-                            Channel *ch = m_registry.getProducer(i.key());
-                            if (!ch)
-                            {
-                                ERROR(m_self << ": no producer channel found for PID: " << i.key());
-                            }
-                            else if (ch->write(&msg) != Channel::Success)
-                            {
-                                ERROR(m_self << ": failed to send reply message to PID: " << i.key());
-                            }
-                            else
-                                ProcessCtl(i.key(), Wakeup, 0);
-                        }
-                    }
-                    else
-                    {
-                        ERROR(m_self << ": invalid action " << (int)msg.action << " from PID " << i.key());
+                        // Move replies to the front of the batch, in order
+                        if (replies != j)
+                            batch[replies] = batch[j];
+
+                        replies++;
                     }
                 }
+
+                if (replies > 0)
+                    sendReplies(i.key(), batch, replies);
             }
         }
         return Success;
     }
 
+    /**
+     * Process a single received message.
+     *
+     * @param pid ProcessID of the sender
+     * @param msg Message received
+     *
+     * @return True if msg must be sent back as a reply, false otherwise
+     */
+    bool processMessage(const ProcessID pid, MsgType *msg)
+    {
+        DEBUG(m_self << ": received message");
+        msg->from = pid;
+
+        // Is the message a response from earlier client request?
+        if (msg->type == ChannelMessage::Response)
+        {
+            if (m_client->processResponse(msg->from, msg) != ChannelClient::Success)
+            {
+                ERROR(m_self << ": failed to process client response from PID " <<
+                       msg->from << " with identifier " << msg->identifier);
+            }
+            return false;
+        }
+
+        // Message is a request to us
+        const MessageHandler<IPCHandlerFunction> *h = m_ipcHandlers.get(msg->action);
+        if (!h)
+        {
+            ERROR(m_self << ": invalid action " << (int)msg->action << " from PID " << pid);
+            return false;
+        }
+
+        (m_instance->*h->exec) (msg);
+        return h->sendReply;
+    }
+
+    /**
+     * Send reply messages back to a process.
+     *
+     * @param pid ProcessID to send the replies to
+     * @param replies Array of reply messages
+     * @param count Number of reply messages
+     */
+    void sendReplies(const ProcessID pid, const MsgType *replies, const Size count)
+    {
+        Size written = 0;
+        Channel *ch = m_registry.getProducer(pid);
+        if (!ch)
+        {
+            ERROR(m_self << ": no producer channel found for PID: " << pid);
+            return;
+        }
+
+        if (ch->writeBatch(replies, count, &written) != Channel::Success)
+        {
+            ERROR(m_self << ": failed to send " << (count - written) <<
+                  " reply messages to PID: " << pid);
+        }
+
+        if (written > 0)
+            ProcessCtl(pid, Wakeup, 0);
+    }
+
   protected:
 
     /** Server object instance. */
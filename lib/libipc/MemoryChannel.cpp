@@ -20,11 +20,16 @@
 #include <MemoryBlock.h>
 #include "MemoryChannel.h"
 
-MemoryChannel::MemoryChannel(const Channel::Mode mode, const Size messageSize)
+MemoryChannel::MemoryChannel(const Channel::Mode mode,
+                             const Size messageSize,
+                             const Size ringSize)
     : Channel(mode, messageSize)
-    , m_maximumMessages((PAGESIZE / messageSize) - 1U)
+    , m_ringSize(ringSize)
+    , m_maximumMessages((ringSize - RingHeadSize) / messageSize)
 {
-    assert(messageSize >= sizeof(RingHead));
+    assert(sizeof(RingHead) <= RingHeadSize);
+    assert(ringSize >= PAGESIZE);
+    assert((ringSize % PAGESIZE) == 0);
     assert(messageSize < (PAGESIZE / 2));
 
     reset(true);
@@ -79,7 +84,7 @@ MemoryChannel::Result MemoryChannel::setPhysical(const Address data,
             break;
     }
 
-    IO::Result result = m_data.map(data, PAGESIZE, dataAccess);
+    IO::Result result = m_data.map(data, m_ringSize, dataAccess);
     if (result != IO::Success)
     {
         ERROR("failed to map data physical address " << (void*)data << ": " << (int)result);
@@ -98,51 +103,108 @@ MemoryChannel::Result MemoryChannel::setPhysical(const Address data,
 
 MemoryChannel::Result MemoryChannel::read(void *buffer)
 {
+    Size count;
+
+    return readBatch(buffer, 1, &count);
+}
+
+MemoryChannel::Result MemoryChannel::write(const void *buffer)
+{
+    Size written;
+
+    return writeBatch(buffer, 1, &written);
+}
+
+MemoryChannel::Result MemoryChannel::readBatch(void *buffer, const Size maximum, Size *count)
+{
+    u8 *output = (u8 *) buffer;
     RingHead head;
+    Size n = 0;
 
-    // Read the current ring head
+    // Read the current ring head once for the whole batch
     m_data.read(0, sizeof(head), &head);
 
-    // Check if a message is present
-    if (head.index == m_head.index)
-        return NotFound;
+    // Copy messages in contiguous runs, which are split where the ring wraps
+    while (n < maximum && m_head.index != head.index)
+    {
+        const Size end = head.index > m_head.index ? head.index : m_maximumMessages;
+        Size run = end - m_head.index;
+
+        if (run > maximum - n)
+            run = maximum - n;
+
+        m_data.read(RingHeadSize + (m_head.index * m_messageSize), run * m_messageSize,
+                    output + (n * m_messageSize));
+
+        n += run;
+        m_head.index = (m_head.index + run) % m_maximumMessages;
+    }
 
-    // Read one message
-    m_data.read((m_head.index+1) * m_messageSize, m_messageSize, buffer);
+    *count = n;
 
-    // Increment head index
-    m_head.index = (m_head.index + 1) % m_maximumMessages;
+    // Check if any message was present
+    if (n == 0)
+        return NotFound;
 
     // Update read index
     m_feedback.write(0, sizeof(m_head), &m_head);
     return Success;
 }
 
-MemoryChannel::Result MemoryChannel::write(const void *buffer)
+MemoryChannel::Result MemoryChannel::writeBatch(const void *buffer, const Size count, Size *written)
 {
+    const u8 *input = (const u8 *) buffer;
     RingHead reader;
+    Size n = 0;
 
-    // Read current ring head
+    // Read current ring head once for the whole batch
     m_feedback.read(0, sizeof(RingHead), &reader);
 
-    // Check if buffer space is available for the message
-    if (((m_head.index + 1) % m_maximumMessages) == reader.index)
-        return ChannelFull;
+    // Copy messages in contiguous runs. One slot always stays unused
+    // such that a full ring can be told apart from an empty ring.
+    while (n < count)
+    {
+        Size end;
 
-    // write the message
-    m_data.write((m_head.index+1) * m_messageSize, m_messageSize, buffer);
+        if (reader.index > m_head.index)
+            end = reader.index - 1;
+        else if (reader.index == 0)
+            end = m_maximumMessages - 1;
+        else
+            end = m_maximumMessages;
 
-    // Increment write index
-    m_head.index = (m_head.index + 1) % m_maximumMessages;
+        Size run = end - m_head.index;
+        if (run == 0)
+            break;
+        else if (run > count - n)
+            run = count - n;
+
+        m_data.write(RingHeadSize + (m_head.index * m_messageSize), run * m_messageSize,
+                     input + (n * m_messageSize));
+
+        n += run;
+        m_head.index = (m_head.index + run) % m_maximumMessages;
+    }
+
+    *written = n;
+
+    // Check if buffer space was available for any message
+    if (n == 0)
+        return ChannelFull;
+
+    // Update write index
     m_data.write(0, sizeof(m_head), &m_head);
-    return Success;
+    return n == count ? Success : ChannelFull;
 }
 
 MemoryChannel::Result MemoryChannel::flush()
 {
 #ifndef INTEL
     if (m_mode == Producer)
-        flushPage(m_data.getBase());
+    {
+        for (Size i = 0; i < m_ringSize; i += PAGESIZE)
+            flushPage(m_data.getBase() + i);
+    }
     else if (m_mode == Consumer)
         flushPage(m_feedback.getBase());
 #endif /* INTEL */
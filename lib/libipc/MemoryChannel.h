@@ -33,12 +33,17 @@
 /**
  * Unidirectional point-to-point channel using shared memory.
  *
- * Implemented by using two separated memory pages.
- * The data page is for the consumer in which it only reads
+ * Implemented by using two separated memory areas.
+ * The data ring is for the consumer in which it only reads
  * the incoming data payloads. The producer writes payloads
- * to the data page. The feedback page is written only by the
- * consumer, where it stores the feedback information from its
- * consumption.
+ * to the data ring, which spans one or more contiguous pages.
+ * The feedback page is written only by the consumer, where it
+ * stores the feedback information from its consumption.
+ *
+ * The ring header occupies a full cache line at the start of the
+ * data ring, such that the producer index never shares a cache line
+ * with message payloads. The consumer index lives on the separate
+ * feedback page.
  */
 class MemoryChannel : public Channel
 {
@@ -54,6 +59,9 @@ class MemoryChannel : public Channel
     }
     RingHead;
 
+    /** Bytes reserved for the RingHead at the start of the data ring. */
+    static const Size RingHeadSize = 64U;
+
   public:
 
     /**
@@ -61,8 +69,11 @@ class MemoryChannel : public Channel
      *
      * @param mode Channel mode is either a producer or consumer
      * @param messageSize Size of each individual message in bytes
+     * @param ringSize Size of the data ring in bytes, must be a multiple of PAGESIZE
      */
-    MemoryChannel(const Mode mode, const Size messageSize);
+    MemoryChannel(const Mode mode,
+                  const Size messageSize,
+                  const Size ringSize = PAGESIZE);
 
     /**
      * Destructor.
@@ -75,7 +86,7 @@ class MemoryChannel : public Channel
      * This function assumes that the given virtual addresses
      * are already mapped into the associated address space.
      *
-     * @param data Virtual memory address of the data page.
+     * @param data Virtual memory address of the data ring.
      *             Read/Write for the producer, Read-only for the consumer.
      * @param feedback Virtual memory address of the feedback page.
      *        Read/write for the consumer, read-only for the producer.
@@ -93,7 +104,7 @@ class MemoryChannel : public Channel
      * This function maps the given physical addresses
      * into the current address space using IO::map.
      *
-     * @param data Physical memory address of the data page.
+     * @param data Physical memory address of the data ring.
      *             Read/Write for the producer, Read-only for the consumer.
      * @param feedback Physical memory address of the feedback page.
      *        Read/write for the consumer, read-only for the producer.
@@ -123,6 +134,36 @@ class MemoryChannel : public Channel
      */
     virtual Result write(const void *buffer);
 
+    /**
+     * Read a batch of messages.
+     *
+     * Reads the ring head once, copies all available messages
+     * up to the given maximum and publishes the new read index
+     * to the feedback page only once for the whole batch.
+     *
+     * @param buffer Output buffer with room for maximum messages.
+     * @param maximum Maximum number of messages to read.
+     * @param count On output contains the number of messages read.
+     *
+     * @return Success if at least one message was read, NotFound if empty.
+     */
+    virtual Result readBatch(void *buffer, const Size maximum, Size *count);
+
+    /**
+     * Write a batch of messages.
+     *
+     * Reads the feedback index once, copies as many messages as
+     * fit in the ring and publishes the new write index only once.
+     *
+     * @param buffer Input buffer containing count messages.
+     * @param count Number of messages to write.
+     * @param written On output contains the number of messages written.
+     *
+     * @return Success if all messages were written, ChannelFull if
+     *         the channel filled up before all messages were written.
+     */
+    virtual Result writeBatch(const void *buffer, const Size count, Size *written);
+
     /**
      * Flush message buffers.
      *
@@ -165,10 +206,13 @@ class MemoryChannel : public Channel
 
   private:
 
+    /** Size of the data ring in bytes. */
+    const Size m_ringSize;
+
     /** Maximum number of messages that can be stored. */
     const Size m_maximumMessages;
 
-    /** The data page */
+    /** The data ring */
     Arch::IO m_data;
 
     /** The feedback page */
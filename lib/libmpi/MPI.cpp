@@ -28,6 +28,7 @@
 #include <stdlib.h>
 #include <errno.h>
 #include "MPIMessage.h"
+#include "MPIProgress.h"
 #include "mpi.h"
 
 #define MPI_PROG_CMDLEN 512
@@ -62,6 +63,24 @@ int MPI_Init(int *argc, char ***argv)
             return MPI_ERR_BAD_FILE;
         }
 
+        // Optionally run on fewer cores with -n COUNT
+        if ((*argc) > 2 && strcmp((*argv)[1], "-n") == 0)
+        {
+            const Size count = atoi((*argv)[2]);
+            if (count == 0)
+            {
+                printf("%s: invalid core count: %s\n", programName, (*argv)[2]);
+                return MPI_ERR_ARG;
+            }
+            if (count < coreCount)
+                coreCount = count;
+
+            // Hide the argument from the user program
+            (*argc) -= 2;
+            (*argv)[2] = (*argv)[0];
+            (*argv) += 2;
+        }
+
         // Read our own ELF program to a buffer and pass it to CoreServer
         // for creating new programs on the remote core.
         if (strncmp(programName, "/bin/", 5) != 0)
@@ -115,7 +134,8 @@ int MPI_Init(int *argc, char ***argv)
         // Allocate memory space on the local processor for the whole
         // UniChannel array, NxN communication with MPI.
         // Then pass the channel offset physical address as an argument -addr 0x.... to spawn()
-        memChannelBase.size = (PAGESIZE * 2) * (coreCount * coreCount);
+        // The extra page at the end holds the sleep flags of the MPIProgress engine.
+        memChannelBase.size = ((PAGESIZE * 2) * (coreCount * coreCount)) + PAGESIZE;
         memChannelBase.phys = 0;
         memChannelBase.virt = 0;
         memChannelBase.access = Memory::Readable | Memory::Writable | Memory::User;
@@ -231,7 +251,8 @@ int MPI_Init(int *argc, char ***argv)
         }
     }
 
-    return MPI_SUCCESS;
+    // Start the progress engine for non-blocking requests
+    return MPIProgress::initialize(info.coreId, MEMBASE(coreCount));
 }
 
 int MPI_Finalize(void)
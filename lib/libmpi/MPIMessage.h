@@ -18,6 +18,9 @@
 #ifndef __LIBMPI_MPIMESSAGE_H
 #define __LIBMPI_MPIMESSAGE_H
 
+#include <Types.h>
+#include "mpi.h"
+
 /**
  * @addtogroup lib
  * @{
@@ -26,11 +29,32 @@
  * @{
  */
 
+/** Size of each message in the MemoryChannel, which is one cache line */
+#define MPI_MESSAGE_SIZE 64
+
+/**
+ * Describes the data which follows in the next messages.
+ */
+typedef struct MPIHeader
+{
+    int tag;               /**< Tag given by the sender */
+    MPI_Datatype datatype; /**< Type of each element */
+    Size count;            /**< Number of elements */
+}
+MPIHeader;
+
+/**
+ * Message in the MemoryChannel between two ranks.
+ *
+ * Each transfer starts with one header message, followed by
+ * the data in chunks of MPI_MESSAGE_SIZE bytes.
+ */
 typedef struct MPIMessage
 {
     union
     {
-        int integer;
+        MPIHeader header;
+        u8 data[MPI_MESSAGE_SIZE];
     };
 }
 MPIMessage;
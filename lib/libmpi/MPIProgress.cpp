@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <MemoryBlock.h>
+#include <MemoryChannel.h>
+#include <ListIterator.h>
+#include <Index.h>
+#include <Timer.h>
+#include "MPIProgress.h"
+
+/**
+ * Interrupt used to wake up a sleeping rank on another core.
+ * This is the same inter-processor interrupt used by the CoreServer.
+ */
+#ifdef INTEL
+#define MPI_WAKEUP_IRQ 50
+#else
+#define MPI_WAKEUP_IRQ 1
+#endif
+
+extern Size coreCount;
+extern Index<MemoryChannel, MPI_MAX_CHANNELS> *readChannel;
+extern Index<MemoryChannel, MPI_MAX_CHANNELS> *writeChannel;
+
+int MPIProgress::m_rank = 0;
+Arch::IO MPIProgress::m_sleepFlags;
+List<MPIRequest *> * MPIProgress::m_sendQueue = ZERO;
+List<MPIRequest *> * MPIProgress::m_receiveQueue = ZERO;
+
+int MPIProgress::initialize(const int rank, const Address sleepFlags)
+{
+    m_rank = rank;
+    m_sendQueue = new List<MPIRequest *>[coreCount];
+    m_receiveQueue = new List<MPIRequest *>[coreCount];
+
+    if (!m_sendQueue || !m_receiveQueue)
+        return MPI_ERR_NO_MEM;
+
+    if (m_sleepFlags.map(sleepFlags, PAGESIZE) != IO::Success)
+        return MPI_ERR_NO_MEM;
+
+    // Without the wakeup interrupt, sleeping ranks rely on the sleep timer
+    ProcessCtl(SELF, WatchIRQ, MPI_WAKEUP_IRQ);
+    return MPI_SUCCESS;
+}
+
+int MPIProgress::start(MPIRequest *request)
+{
+    List<MPIRequest *> *queues = request->send ? m_sendQueue : m_receiveQueue;
+    Index<MemoryChannel, MPI_MAX_CHANNELS> *channels = request->send ? writeChannel : readChannel;
+
+    if (request->peer < 0 || !channels->get(request->peer))
+        return MPI_ERR_RANK;
+
+    request->started = false;
+    request->done = false;
+    request->chunk = 0;
+    request->result = MPI_SUCCESS;
+
+    // Sends know their size up front, receives learn it from the header
+    if (request->send)
+    {
+        request->bytes = request->capacity;
+        request->chunks = (request->bytes + sizeof(MPIMessage) - 1) / sizeof(MPIMessage);
+    }
+    else
+    {
+        request->bytes = 0;
+        request->chunks = 0;
+    }
+
+    queues[request->peer].append(request);
+    poll();
+    return MPI_SUCCESS;
+}
+
+bool MPIProgress::poll()
+{
+    bool progress = false;
+
+    for (Size peer = 0; peer < coreCount; peer++)
+    {
+        bool moved = false;
+
+        // Complete requests in order. Stop at the first one that cannot finish.
+        for (ListIterator<MPIRequest *> i(m_sendQueue[peer]); i.hasCurrent(); )
+        {
+            MPIRequest *request = i.current();
+
+            moved |= progressSend(request);
+            if (!request->done)
+                break;
+
+            i.remove();
+        }
+
+        for (ListIterator<MPIRequest *> i(m_receiveQueue[peer]); i.hasCurrent(); )
+        {
+            MPIRequest *request = i.current();
+
+            moved |= progressReceive(request);
+            if (!request->done)
+                break;
+
+            i.remove();
+        }
+
+        // New data or free space on the channels with this peer
+        if (moved)
+        {
+            wakeup(peer);
+            progress = true;
+        }
+    }
+    return progress;
+}
+
+void MPIProgress::wait(MPIRequest *request)
+{
+    Size idle = 0;
+
+    while (!request->done)
+    {
+        if (poll())
+            idle = 0;
+        else if (++idle >= SpinCount)
+        {
+            sleep();
+            idle = 0;
+        }
+    }
+}
+
+int MPIProgress::status(const MPIRequest *request, MPI_Status *status)
+{
+    if (status != MPI_STATUS_IGNORE)
+    {
+        status->MPI_SOURCE = request->peer;
+        status->MPI_TAG    = request->tag;
+        status->MPI_ERROR  = request->result;
+        status->count      = request->bytes;
+    }
+    return request->result;
+}
+
+bool MPIProgress::progressSend(MPIRequest *request)
+{
+    MemoryChannel *ch = writeChannel->get(request->peer);
+    const Size direct = request->bytes / sizeof(MPIMessage);
+    bool progress = false;
+    MPIMessage msg;
+    Size written;
+
+    // Announce the transfer
+    if (!request->started)
+    {
+        msg.header.tag      = request->tag;
+        msg.header.datatype = request->datatype;
+        msg.header.count    = request->count;
+
+        if (ch->write(&msg) != Channel::Success)
+            return false;
+
+        request->started = true;
+        progress = true;
+    }
+
+    // Write whole chunks directly from the user buffer
+    while (request->chunk < direct)
+    {
+        ch->writeBatch(request->buffer + (request->chunk * sizeof(MPIMessage)),
+                       direct - request->chunk, &written);
+        if (written == 0)
+            return progress;
+
+        request->chunk += written;
+        progress = true;
+    }
+
+    // Write the remaining bytes, if any
+    if (request->chunk < request->chunks)
+    {
+        MemoryBlock::copy(msg.data, request->buffer + (direct * sizeof(MPIMessage)),
+                          request->bytes % sizeof(MPIMessage));
+
+        if (ch->write(&msg) != Channel::Success)
+            return progress;
+
+        request->chunk++;
+        progress = true;
+    }
+
+    request->done = true;
+    return progress;
+}
+
+bool MPIProgress::progressReceive(MPIRequest *request)
+{
+    MemoryChannel *ch = readChannel->get(request->peer);
+    bool progress = false;
+    MPIMessage msg;
+    Size received;
+    int size;
+
+    // Wait for the transfer to start. Messages are received in the order
+    // they were sent, so a message with another tag is not skipped but
+    // consumed and reported as MPI_ERR_TAG.
+    if (!request->started)
+    {
+        if (ch->read(&msg) != Channel::Success)
+            return false;
+
+        if (MPI_Type_size(msg.header.datatype, &size) != MPI_SUCCESS)
+        {
+            request->result = MPI_ERR_TYPE;
+            request->done = true;
+            return true;
+        }
+
+        const Size incoming = msg.header.count * size;
+
+        if (request->tag != MPI_ANY_TAG && request->tag != msg.header.tag)
+        {
+            request->bytes  = 0;
+            request->result = MPI_ERR_TAG;
+        }
+        else
+        {
+            request->bytes  = incoming < request->capacity ? incoming : request->capacity;
+            request->result = incoming > request->capacity ? MPI_ERR_TRUNCATE : MPI_SUCCESS;
+        }
+        request->tag     = msg.header.tag;
+        request->chunks  = (incoming + sizeof(MPIMessage) - 1) / sizeof(MPIMessage);
+        request->started = true;
+        progress = true;
+    }
+
+    // Read whole chunks directly into the user buffer
+    const Size direct = request->bytes / sizeof(MPIMessage);
+
+    while (request->chunk < direct)
+    {
+        if (ch->readBatch(request->buffer + (request->chunk * sizeof(MPIMessage)),
+                          direct - request->chunk, &received) != Channel::Success)
+            return progress;
+
+        request->chunk += received;
+        progress = true;
+    }
+
+    // Read the remaining chunks and keep only what fits
+    while (request->chunk < request->chunks)
+    {
+        if (ch->read(&msg) != Channel::Success)
+            return progress;
+
+        const Size offset = request->chunk * sizeof(MPIMessage);
+        if (offset < request->bytes)
+        {
+            const Size remaining = request->bytes - offset;
+            MemoryBlock::copy(request->buffer + offset, msg.data,
+                              remaining < sizeof(MPIMessage) ? remaining : sizeof(MPIMessage));
+        }
+        request->chunk++;
+        progress = true;
+    }
+
+    request->done = true;
+    return progress;
+}
+
+void MPIProgress::sleep()
+{
+    Timer::Info timer;
+
+#ifdef INTEL
+    // Core0 receives interrupts via the PIC and cannot be woken by
+    // the IPI. Rank 0 only sleeps for a single timer tick instead.
+    const bool wakeable = m_rank != 0;
+#else
+    const bool wakeable = true;
+#endif
+
+    // Announce that we sleep, then check once more before sleeping.
+    // A wakeup which arrives in between is kept pending by the kernel.
+    m_sleepFlags.write(m_rank * sizeof(u32), wakeable);
+
+    if (!poll() && ProcessCtl(SELF, InfoTimer, (Address) &timer) == API::Success)
+    {
+        timer.ticks++;
+        ProcessCtl(SELF, EnableIRQ, MPI_WAKEUP_IRQ);
+        ProcessCtl(SELF, EnterSleep, (Address) &timer);
+    }
+
+    m_sleepFlags.write(m_rank * sizeof(u32), 0);
+}
+
+void MPIProgress::wakeup(const int peer)
+{
+    if (peer != m_rank && m_sleepFlags.read(peer * sizeof(u32)))
+        ProcessCtl(SELF, SendIRQ, (peer << 16) | MPI_WAKEUP_IRQ);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBMPI_MPIPROGRESS_H
+#define __LIBMPI_MPIPROGRESS_H
+
+#include <FreeNOS/System.h>
+#include <Types.h>
+#include <List.h>
+#include "MPIRequest.h"
+#include "mpi.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libmpi
+ * @{
+ */
+
+/**
+ * Progress engine for non-blocking MPI requests.
+ *
+ * Every call makes progress on all channels, so requests also advance
+ * while the program waits for another request. Blocking waits spin for
+ * a short while and then sleep. A rank that moves data on a channel sends
+ * a wakeup interrupt to the peer core, if the peer is sleeping.
+ */
+class MPIProgress
+{
+  private:
+
+    /** Number of polls without progress before going to sleep */
+    static const Size SpinCount = 1024;
+
+  public:
+
+    /**
+     * Initialize the progress engine.
+     *
+     * @param rank Rank of the current program
+     * @param sleepFlags Physical address of the page with the sleep flag of each rank
+     *
+     * @return MPI_SUCCESS or an error code
+     */
+    static int initialize(const int rank, const Address sleepFlags);
+
+    /**
+     * Start a request.
+     *
+     * The request is queued on the channel of its peer and
+     * makes as much progress as possible without blocking.
+     *
+     * @param request Request to start
+     *
+     * @return MPI_SUCCESS or MPI_ERR_RANK
+     */
+    static int start(MPIRequest *request);
+
+    /**
+     * Make progress on all channels without blocking.
+     *
+     * @return True if any message was transferred
+     */
+    static bool poll();
+
+    /**
+     * Wait until a request is done.
+     *
+     * @param request Request to wait for
+     */
+    static void wait(MPIRequest *request);
+
+    /**
+     * Fill in the status of a request that is done.
+     *
+     * @param request Finished request
+     * @param status Status to fill in, or MPI_STATUS_IGNORE
+     *
+     * @return Result code of the request
+     */
+    static int status(const MPIRequest *request, MPI_Status *status);
+
+  private:
+
+    /**
+     * Write as many messages of a send request as possible.
+     *
+     * @return True if any message was written
+     */
+    static bool progressSend(MPIRequest *request);
+
+    /**
+     * Read as many messages of a receive request as possible.
+     *
+     * @return True if any message was read
+     */
+    static bool progressReceive(MPIRequest *request);
+
+    /**
+     * Sleep until a peer wakes us up or the sleep timer expires.
+     */
+    static void sleep();
+
+    /**
+     * Wake up a peer rank, if it is sleeping.
+     *
+     * @param peer Rank to wake up
+     */
+    static void wakeup(const int peer);
+
+  private:
+
+    /** Rank of the current program */
+    static int m_rank;
+
+    /** Page with one sleep flag per rank, shared by all ranks */
+    static Arch::IO m_sleepFlags;
+
+    /** Started send requests per destination rank */
+    static List<MPIRequest *> *m_sendQueue;
+
+    /** Started receive requests per source rank */
+    static List<MPIRequest *> *m_receiveQueue;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBMPI_MPIPROGRESS_H */
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBMPI_MPIREQUEST_H
+#define __LIBMPI_MPIREQUEST_H
+
+#include <Types.h>
+#include "MPIMessage.h"
+#include "mpi.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libmpi
+ * @{
+ */
+
+/**
+ * State of a non-blocking send or receive.
+ *
+ * Requests on the same channel are completed in the order they
+ * were started. Only the first request of each channel makes progress.
+ */
+typedef struct MPIRequest
+{
+    bool send;             /**< True for a send, false for a receive */
+    int peer;              /**< Destination or source rank */
+    int tag;               /**< Tag given by the sender, or the tag to receive */
+    MPI_Datatype datatype; /**< Type of each element */
+    Size count;            /**< Number of elements to send */
+    u8 *buffer;            /**< User buffer */
+    Size capacity;         /**< Size of the user buffer in bytes */
+    Size bytes;            /**< Bytes copied to or from the user buffer */
+    Size chunk;            /**< Next chunk to transfer */
+    Size chunks;           /**< Total number of chunks */
+    bool started;          /**< True once the header is transferred */
+    bool done;             /**< True when the transfer is complete */
+    int result;            /**< Result code when done */
+}
+MPIRequest;
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBMPI_MPIREQUEST_H */
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mpi.h"
+
+int MPI_Barrier(MPI_Comm comm)
+{
+    int result;
+
+    // Wait until every rank arrived at rank 0, then release them all
+    result = MPI_Reduce(ZERO, ZERO, 0, MPI_BYTE, MPI_SUM, 0, comm);
+    if (result != MPI_SUCCESS)
+        return result;
+
+    return MPI_Bcast(ZERO, 0, MPI_BYTE, 0, comm);
+}
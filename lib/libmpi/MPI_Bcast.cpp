@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mpi.h"
+
+int MPI_Bcast(void *buffer,
+              int count,
+              MPI_Datatype datatype,
+              int root,
+              MPI_Comm comm)
+{
+    int rank, size, result;
+    int mask = 1;
+
+    if (MPI_Comm_rank(comm, &rank) != MPI_SUCCESS ||
+        MPI_Comm_size(comm, &size) != MPI_SUCCESS)
+        return MPI_ERR_COMM;
+
+    if (root < 0 || root >= size)
+        return MPI_ERR_ROOT;
+
+    // Ranks relative to the root form a binomial tree
+    const int relative = (rank - root + size) % size;
+
+    // Receive from the parent, which differs in the lowest set bit
+    for (; mask < size; mask <<= 1)
+    {
+        if (relative & mask)
+        {
+            const int parent = (relative - mask + root) % size;
+
+            result = MPI_Recv(buffer, count, datatype, parent, 0, comm, MPI_STATUS_IGNORE);
+            if (result != MPI_SUCCESS)
+                return result;
+            break;
+        }
+    }
+
+    // Forward to the children below that bit
+    for (mask >>= 1; mask > 0; mask >>= 1)
+    {
+        if (relative + mask < size)
+        {
+            const int child = (relative + mask + root) % size;
+
+            result = MPI_Send(buffer, count, datatype, child, 0, comm);
+            if (result != MPI_SUCCESS)
+                return result;
+        }
+    }
+    return MPI_SUCCESS;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "mpi.h"
+
+int MPI_Gather(const void *sendbuf,
+               int sendcount,
+               MPI_Datatype sendtype,
+               void *recvbuf,
+               int recvcount,
+               MPI_Datatype recvtype,
+               int root,
+               MPI_Comm comm)
+{
+    int rank, size, sendSize, recvSize, result = MPI_SUCCESS;
+
+    if (MPI_Comm_rank(comm, &rank) != MPI_SUCCESS ||
+        MPI_Comm_size(comm, &size) != MPI_SUCCESS)
+        return MPI_ERR_COMM;
+
+    if (root < 0 || root >= size)
+        return MPI_ERR_ROOT;
+
+    if (sendcount < 0)
+        return MPI_ERR_COUNT;
+
+    if (MPI_Type_size(sendtype, &sendSize) != MPI_SUCCESS)
+        return MPI_ERR_TYPE;
+
+    // The root must receive exactly one block from every rank
+    if (rank == root)
+    {
+        if (MPI_Type_size(recvtype, &recvSize) != MPI_SUCCESS)
+            return MPI_ERR_TYPE;
+
+        if (recvcount * recvSize != sendcount * sendSize)
+            return MPI_ERR_COUNT;
+    }
+
+    // Each subtree collects the blocks of its relative ranks in order
+    const Size block = sendcount * sendSize;
+    const int relative = (rank - root + size) % size;
+    u8 *blocks = new u8[block * size];
+    MemoryBlock::copy(blocks, sendbuf, block);
+
+    for (int mask = 1; mask < size && result == MPI_SUCCESS; mask <<= 1)
+    {
+        if ((relative & mask) == 0)
+        {
+            const int first = relative | mask;
+
+            if (first < size)
+            {
+                const int count = (size - first) < mask ? (size - first) : mask;
+                const int child = (first + root) % size;
+
+                result = MPI_Recv(blocks + (mask * block), count * block, MPI_BYTE,
+                                  child, 0, comm, MPI_STATUS_IGNORE);
+            }
+        }
+        else
+        {
+            const int parent = ((relative & ~mask) + root) % size;
+            const int count = (size - relative) < mask ? (size - relative) : mask;
+
+            result = MPI_Send(blocks, count * block, MPI_BYTE, parent, 0, comm);
+            break;
+        }
+    }
+
+    // Blocks are ordered by relative rank
+    if (rank == root && result == MPI_SUCCESS)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            MemoryBlock::copy((u8 *) recvbuf + (((i + root) % size) * block),
+                              blocks + (i * block), block);
+        }
+    }
+
+    delete[] blocks;
+    return result;
+}
@@ -15,12 +15,40 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <MemoryChannel.h>
-#include <Index.h>
 #include "mpi.h"
-#include "MPIMessage.h"
+#include "MPIRequest.h"
+#include "MPIProgress.h"
 
-extern Index<MemoryChannel, MPI_MAX_CHANNELS> *readChannel;
+/**
+ * Fill in a receive request.
+ */
+static int prepareReceive(MPIRequest *request,
+                          void *buf,
+                          int count,
+                          MPI_Datatype datatype,
+                          int source,
+                          int tag)
+{
+    int size;
+
+    if (count < 0)
+        return MPI_ERR_COUNT;
+
+    if (MPI_Type_size(datatype, &size) != MPI_SUCCESS)
+        return MPI_ERR_TYPE;
+
+    if (tag < 0 && tag != MPI_ANY_TAG)
+        return MPI_ERR_TAG;
+
+    request->send     = false;
+    request->peer     = source;
+    request->tag      = tag;
+    request->datatype = datatype;
+    request->count    = count;
+    request->buffer   = (u8 *) buf;
+    request->capacity = count * size;
+    return MPI_SUCCESS;
+}
 
 int MPI_Recv(void *buf,
              int count,
@@ -30,20 +58,57 @@ int MPI_Recv(void *buf,
              MPI_Comm comm,
              MPI_Status *status)
 {
-    MPIMessage msg;
-    MemoryChannel *ch;
+    MPIRequest request;
+    int result;
 
-    if (datatype != MPI_INT)
-        return MPI_ERR_UNSUPPORTED_DATAREP;
+    if ((result = prepareReceive(&request, buf, count, datatype, source, tag)) != MPI_SUCCESS)
+        return result;
 
-    if (!(ch = readChannel->get(source)))
-        return MPI_ERR_RANK;
+    if ((result = MPIProgress::start(&request)) != MPI_SUCCESS)
+        return result;
 
-    for (int i = 0; i < count; i++)
+    MPIProgress::wait(&request);
+    return MPIProgress::status(&request, status);
+}
+
+int MPI_Irecv(void *buf,
+              int count,
+              MPI_Datatype datatype,
+              int source,
+              int tag,
+              MPI_Comm comm,
+              MPI_Request *request)
+{
+    MPIRequest *req = new MPIRequest;
+    int result;
+
+    if (!req)
+        return MPI_ERR_NO_MEM;
+
+    if ((result = prepareReceive(req, buf, count, datatype, source, tag)) != MPI_SUCCESS ||
+        (result = MPIProgress::start(req)) != MPI_SUCCESS)
     {
-        while (ch->read(&msg) != Channel::Success)
-            ;
-        *(((int *) buf) + i) = msg.integer;
+        delete req;
+        return result;
     }
+
+    *request = req;
+    return MPI_SUCCESS;
+}
+
+int MPI_Get_count(const MPI_Status *status,
+                  MPI_Datatype datatype,
+                  int *count)
+{
+    int size;
+
+    if (MPI_Type_size(datatype, &size) != MPI_SUCCESS)
+        return MPI_ERR_TYPE;
+
+    if (status->count % size)
+        *count = MPI_UNDEFINED;
+    else
+        *count = status->count / size;
+
     return MPI_SUCCESS;
 }
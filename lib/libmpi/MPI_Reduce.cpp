@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "mpi.h"
+
+/**
+ * Combine count elements of input into output.
+ */
+template <class T> static int combine(T *output, const T *input, int count, MPI_Op op)
+{
+    for (int i = 0; i < count; i++)
+    {
+        switch (op)
+        {
+            case MPI_MAX:  if (input[i] > output[i]) output[i] = input[i]; break;
+            case MPI_MIN:  if (input[i] < output[i]) output[i] = input[i]; break;
+            case MPI_SUM:  output[i] += input[i]; break;
+            case MPI_PROD: output[i] *= input[i]; break;
+            default:       return MPI_ERR_OP;
+        }
+    }
+    return MPI_SUCCESS;
+}
+
+/**
+ * Combine count elements of the given datatype.
+ */
+static int reduce(void *output, const void *input, int count,
+                  MPI_Datatype datatype, MPI_Op op)
+{
+    switch (datatype)
+    {
+        case MPI_CHAR:           return combine((char *) output, (const char *) input, count, op);
+        case MPI_SHORT:          return combine((short *) output, (const short *) input, count, op);
+        case MPI_LONG:           return combine((long *) output, (const long *) input, count, op);
+        case MPI_INT:            return combine((int *) output, (const int *) input, count, op);
+        case MPI_BYTE:
+        case MPI_UNSIGNED_CHAR:  return combine((u8 *) output, (const u8 *) input, count, op);
+        case MPI_UNSIGNED_SHORT: return combine((u16 *) output, (const u16 *) input, count, op);
+        case MPI_UNSIGNED:       return combine((uint *) output, (const uint *) input, count, op);
+        case MPI_UNSIGNED_LONG:  return combine((ulong *) output, (const ulong *) input, count, op);
+        case MPI_FLOAT:          return combine((float *) output, (const float *) input, count, op);
+        case MPI_DOUBLE:         return combine((double *) output, (const double *) input, count, op);
+    }
+    return MPI_ERR_TYPE;
+}
+
+int MPI_Reduce(const void *sendbuf,
+               void *recvbuf,
+               int count,
+               MPI_Datatype datatype,
+               MPI_Op op,
+               int root,
+               MPI_Comm comm)
+{
+    int rank, size, typeSize, result = MPI_SUCCESS;
+
+    if (MPI_Comm_rank(comm, &rank) != MPI_SUCCESS ||
+        MPI_Comm_size(comm, &size) != MPI_SUCCESS)
+        return MPI_ERR_COMM;
+
+    if (root < 0 || root >= size)
+        return MPI_ERR_ROOT;
+
+    if (count < 0)
+        return MPI_ERR_COUNT;
+
+    if (MPI_Type_size(datatype, &typeSize) != MPI_SUCCESS)
+        return MPI_ERR_TYPE;
+
+    // Partial result of this subtree and a buffer for the children
+    const Size bytes = count * typeSize;
+    u8 *partial = new u8[bytes];
+    u8 *incoming = new u8[bytes];
+    MemoryBlock::copy(partial, sendbuf, bytes);
+
+    // Ranks relative to the root form a binomial tree
+    const int relative = (rank - root + size) % size;
+
+    for (int mask = 1; mask < size && result == MPI_SUCCESS; mask <<= 1)
+    {
+        // Add the result of the child subtree
+        if ((relative & mask) == 0)
+        {
+            if ((relative | mask) < size)
+            {
+                const int child = ((relative | mask) + root) % size;
+
+                result = MPI_Recv(incoming, count, datatype, child, 0, comm, MPI_STATUS_IGNORE);
+                if (result == MPI_SUCCESS)
+                    result = reduce(partial, incoming, count, datatype, op);
+            }
+        }
+        // Pass the result of this subtree to the parent
+        else
+        {
+            const int parent = ((relative & ~mask) + root) % size;
+
+            result = MPI_Send(partial, count, datatype, parent, 0, comm);
+            break;
+        }
+    }
+
+    if (rank == root && result == MPI_SUCCESS)
+        MemoryBlock::copy(recvbuf, partial, bytes);
+
+    delete[] partial;
+    delete[] incoming;
+    return result;
+}
+
+int MPI_Allreduce(const void *sendbuf,
+                  void *recvbuf,
+                  int count,
+                  MPI_Datatype datatype,
+                  MPI_Op op,
+                  MPI_Comm comm)
+{
+    int rank, size, typeSize, result = MPI_SUCCESS;
+
+    if (MPI_Comm_rank(comm, &rank) != MPI_SUCCESS ||
+        MPI_Comm_size(comm, &size) != MPI_SUCCESS)
+        return MPI_ERR_COMM;
+
+    // Recursive doubling needs a power of two ranks
+    if (size & (size - 1))
+    {
+        result = MPI_Reduce(sendbuf, recvbuf, count, datatype, op, 0, comm);
+        if (result != MPI_SUCCESS)
+            return result;
+
+        return MPI_Bcast(recvbuf, count, datatype, 0, comm);
+    }
+
+    if (count < 0)
+        return MPI_ERR_COUNT;
+
+    if (MPI_Type_size(datatype, &typeSize) != MPI_SUCCESS)
+        return MPI_ERR_TYPE;
+
+    const Size bytes = count * typeSize;
+    u8 *incoming = new u8[bytes];
+    MemoryBlock::copy(recvbuf, sendbuf, bytes);
+
+    // Exchange partial results with a partner at doubling distance.
+    // The lower rank sends first, such that full channels cannot deadlock.
+    for (int mask = 1; mask < size && result == MPI_SUCCESS; mask <<= 1)
+    {
+        const int partner = rank ^ mask;
+
+        if (rank < partner)
+        {
+            result = MPI_Send(recvbuf, count, datatype, partner, 0, comm);
+            if (result == MPI_SUCCESS)
+                result = MPI_Recv(incoming, count, datatype, partner, 0, comm, MPI_STATUS_IGNORE);
+        }
+        else
+        {
+            result = MPI_Recv(incoming, count, datatype, partner, 0, comm, MPI_STATUS_IGNORE);
+            if (result == MPI_SUCCESS)
+                result = MPI_Send(recvbuf, count, datatype, partner, 0, comm);
+        }
+
+        if (result == MPI_SUCCESS)
+            result = reduce(recvbuf, incoming, count, datatype, op);
+    }
+
+    delete[] incoming;
+    return result;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <MemoryBlock.h>
+#include "mpi.h"
+
+int MPI_Scatter(const void *sendbuf,
+                int sendcount,
+                MPI_Datatype sendtype,
+                void *recvbuf,
+                int recvcount,
+                MPI_Datatype recvtype,
+                int root,
+                MPI_Comm comm)
+{
+    int rank, size, sendSize, recvSize, mask = 1, result = MPI_SUCCESS;
+
+    if (MPI_Comm_rank(comm, &rank) != MPI_SUCCESS ||
+        MPI_Comm_size(comm, &size) != MPI_SUCCESS)
+        return MPI_ERR_COMM;
+
+    if (root < 0 || root >= size)
+        return MPI_ERR_ROOT;
+
+    if (recvcount < 0)
+        return MPI_ERR_COUNT;
+
+    if (MPI_Type_size(recvtype, &recvSize) != MPI_SUCCESS)
+        return MPI_ERR_TYPE;
+
+    // The root must send exactly one block to every rank
+    if (rank == root)
+    {
+        if (MPI_Type_size(sendtype, &sendSize) != MPI_SUCCESS)
+            return MPI_ERR_TYPE;
+
+        if (recvcount * recvSize != sendcount * sendSize)
+            return MPI_ERR_COUNT;
+    }
+
+    // Each subtree receives the blocks of its relative ranks in order
+    const Size block = recvcount * recvSize;
+    const int relative = (rank - root + size) % size;
+    u8 *blocks = new u8[block * size];
+
+    if (rank == root)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            MemoryBlock::copy(blocks + (i * block),
+                              (const u8 *) sendbuf + (((i + root) % size) * block), block);
+        }
+        while (mask < size)
+            mask <<= 1;
+    }
+    else
+    {
+        // Receive the blocks of this subtree from the parent
+        for (; mask < size; mask <<= 1)
+        {
+            if (relative & mask)
+            {
+                const int parent = ((relative & ~mask) + root) % size;
+                const int count = (size - relative) < mask ? (size - relative) : mask;
+
+                result = MPI_Recv(blocks, count * block, MPI_BYTE,
+                                  parent, 0, comm, MPI_STATUS_IGNORE);
+                break;
+            }
+        }
+    }
+
+    // Pass the blocks of each child subtree on
+    for (mask >>= 1; mask > 0 && result == MPI_SUCCESS; mask >>= 1)
+    {
+        const int first = relative + mask;
+
+        if (first < size)
+        {
+            const int count = (size - first) < mask ? (size - first) : mask;
+            const int child = (first + root) % size;
+
+            result = MPI_Send(blocks + (mask * block), count * block, MPI_BYTE, child, 0, comm);
+        }
+    }
+
+    if (result == MPI_SUCCESS)
+        MemoryBlock::copy(recvbuf, blocks, block);
+
+    delete[] blocks;
+    return result;
+}
@@ -15,12 +15,40 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <MemoryChannel.h>
-#include <Index.h>
 #include "mpi.h"
-#include "MPIMessage.h"
+#include "MPIRequest.h"
+#include "MPIProgress.h"
 
-extern Index<MemoryChannel, MPI_MAX_CHANNELS> *writeChannel;
+/**
+ * Fill in a send request.
+ */
+static int prepareSend(MPIRequest *request,
+                       const void *buf,
+                       int count,
+                       MPI_Datatype datatype,
+                       int dest,
+                       int tag)
+{
+    int size;
+
+    if (count < 0)
+        return MPI_ERR_COUNT;
+
+    if (MPI_Type_size(datatype, &size) != MPI_SUCCESS)
+        return MPI_ERR_TYPE;
+
+    if (tag < 0)
+        return MPI_ERR_TAG;
+
+    request->send     = true;
+    request->peer     = dest;
+    request->tag      = tag;
+    request->datatype = datatype;
+    request->count    = count;
+    request->buffer   = (u8 *) buf;
+    request->capacity = count * size;
+    return MPI_SUCCESS;
+}
 
 int MPI_Send(const void *buf,
              int count,
@@ -29,21 +57,40 @@ int MPI_Send(const void *buf,
              int tag,
              MPI_Comm comm)
 {
-    MPIMessage msg;
-    MemoryChannel *ch;
+    MPIRequest request;
+    int result;
 
-    if (datatype != MPI_INT)
-        return MPI_ERR_UNSUPPORTED_DATAREP;
+    if ((result = prepareSend(&request, buf, count, datatype, dest, tag)) != MPI_SUCCESS)
+        return result;
 
-    if (!(ch = writeChannel->get(dest)))
-        return MPI_ERR_RANK;
+    if ((result = MPIProgress::start(&request)) != MPI_SUCCESS)
+        return result;
 
-    for (int i = 0; i < count; i++)
-    {
-        msg.integer = *(((int *) buf) + i);
+    MPIProgress::wait(&request);
+    return request.result;
+}
+
+int MPI_Isend(const void *buf,
+              int count,
+              MPI_Datatype datatype,
+              int dest,
+              int tag,
+              MPI_Comm comm,
+              MPI_Request *request)
+{
+    MPIRequest *req = new MPIRequest;
+    int result;
 
-        while (ch->write(&msg) != Channel::Success)
-            ;
+    if (!req)
+        return MPI_ERR_NO_MEM;
+
+    if ((result = prepareSend(req, buf, count, datatype, dest, tag)) != MPI_SUCCESS ||
+        (result = MPIProgress::start(req)) != MPI_SUCCESS)
+    {
+        delete req;
+        return result;
     }
+
+    *request = req;
     return MPI_SUCCESS;
 }
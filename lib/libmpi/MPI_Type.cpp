@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mpi.h"
+
+int MPI_Type_size(MPI_Datatype datatype,
+                  int *size)
+{
+    switch (datatype)
+    {
+        case MPI_CHAR:
+        case MPI_UNSIGNED_CHAR:
+        case MPI_BYTE:
+            *size = sizeof(char);
+            break;
+
+        case MPI_SHORT:
+        case MPI_UNSIGNED_SHORT:
+            *size = sizeof(short);
+            break;
+
+        case MPI_INT:
+        case MPI_UNSIGNED:
+            *size = sizeof(int);
+            break;
+
+        case MPI_LONG:
+        case MPI_UNSIGNED_LONG:
+            *size = sizeof(long);
+            break;
+
+        case MPI_FLOAT:
+            *size = sizeof(float);
+            break;
+
+        case MPI_DOUBLE:
+            *size = sizeof(double);
+            break;
+
+        default:
+            return MPI_ERR_TYPE;
+    }
+    return MPI_SUCCESS;
+}
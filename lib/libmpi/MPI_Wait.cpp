@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mpi.h"
+#include "MPIRequest.h"
+#include "MPIProgress.h"
+
+int MPI_Wait(MPI_Request *request,
+             MPI_Status *status)
+{
+    MPIRequest *req = *request;
+    int result;
+
+    if (req == MPI_REQUEST_NULL)
+        return MPI_SUCCESS;
+
+    MPIProgress::wait(req);
+    result = MPIProgress::status(req, status);
+
+    delete req;
+    *request = MPI_REQUEST_NULL;
+    return result;
+}
+
+int MPI_Waitall(int count,
+                MPI_Request requests[],
+                MPI_Status statuses[])
+{
+    int result = MPI_SUCCESS, r;
+
+    // Requests may complete in any order, waiting on one progresses all
+    for (int i = 0; i < count; i++)
+    {
+        r = MPI_Wait(&requests[i], statuses != MPI_STATUSES_IGNORE ?
+                                   &statuses[i] : MPI_STATUS_IGNORE);
+        if (r != MPI_SUCCESS)
+            result = r;
+    }
+    return result;
+}
+
+int MPI_Test(MPI_Request *request,
+             int *flag,
+             MPI_Status *status)
+{
+    MPIRequest *req = *request;
+
+    if (req == MPI_REQUEST_NULL)
+    {
+        *flag = 1;
+        return MPI_SUCCESS;
+    }
+
+    MPIProgress::poll();
+
+    if (!req->done)
+    {
+        *flag = 0;
+        return MPI_SUCCESS;
+    }
+
+    *flag = 1;
+    return MPI_Wait(request, status);
+}
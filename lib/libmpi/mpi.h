@@ -40,8 +40,35 @@
 /** Communicator identifier */
 typedef uint MPI_Comm;
 
-/** Status holder */
-typedef uint MPI_Status;
+/** Returned by MPI_Get_count() if the size does not match the datatype */
+#define MPI_UNDEFINED (-32766)
+
+/** Pass to MPI_Recv() to accept a message with any tag */
+#define MPI_ANY_TAG (-1)
+
+/**
+ * Status holder
+ */
+typedef struct MPI_Status
+{
+    int MPI_SOURCE; /**< Rank of the sender */
+    int MPI_TAG;    /**< Tag given by the sender */
+    int MPI_ERROR;  /**< Result of the receive */
+    int count;      /**< Number of bytes received */
+}
+MPI_Status;
+
+/** Pass to MPI_Recv() if the status is not needed */
+#define MPI_STATUS_IGNORE ((MPI_Status *) 0)
+
+/** Pass to MPI_Waitall() if the statuses are not needed */
+#define MPI_STATUSES_IGNORE ((MPI_Status *) 0)
+
+/** Handle of a non-blocking send or receive */
+typedef struct MPIRequest * MPI_Request;
+
+/** Request handle which does not refer to any request */
+#define MPI_REQUEST_NULL ((MPI_Request) 0)
 
 /**
  * Named Predefined Datatypes
@@ -55,10 +82,25 @@ typedef enum
     MPI_UNSIGNED_CHAR,
     MPI_UNSIGNED_SHORT,
     MPI_UNSIGNED,
-    MPI_UNSIGNED_LONG
+    MPI_UNSIGNED_LONG,
+    MPI_BYTE,
+    MPI_FLOAT,
+    MPI_DOUBLE
 }
 MPI_Datatype;
 
+/**
+ * Reduction operations.
+ */
+typedef enum
+{
+    MPI_MAX,
+    MPI_MIN,
+    MPI_SUM,
+    MPI_PROD
+}
+MPI_Op;
+
 /**
  * Reserved communicators.
  */
@@ -166,6 +208,14 @@ extern C int MPI_Send(const void *buf,
                       int tag,
                       MPI_Comm comm);
 
+/**
+ * Receive a message from a rank.
+ *
+ * Messages from the same rank are received in the order they were sent.
+ * Tags do not reorder messages: if the next message has another tag than
+ * requested, it is consumed anyway and MPI_ERR_TAG is returned. Use
+ * MPI_ANY_TAG to accept the next message regardless of its tag.
+ */
 extern C int MPI_Recv(void *buf,
                       int count,
                       MPI_Datatype datatype,
@@ -174,6 +224,118 @@ extern C int MPI_Recv(void *buf,
                       MPI_Comm comm,
                       MPI_Status *status);
 
+extern C int MPI_Get_count(const MPI_Status *status,
+                           MPI_Datatype datatype,
+                           int *count);
+
+/**
+ * @}
+ */
+
+/**
+ * @brief Non-blocking Communication
+ *
+ * Requests on the same peer complete in the order they were started.
+ * Waiting on any request also makes progress on all other requests.
+ * @{
+ */
+
+extern C int MPI_Isend(const void *buf,
+                       int count,
+                       MPI_Datatype datatype,
+                       int dest,
+                       int tag,
+                       MPI_Comm comm,
+                       MPI_Request *request);
+
+extern C int MPI_Irecv(void *buf,
+                       int count,
+                       MPI_Datatype datatype,
+                       int source,
+                       int tag,
+                       MPI_Comm comm,
+                       MPI_Request *request);
+
+extern C int MPI_Wait(MPI_Request *request,
+                      MPI_Status *status);
+
+extern C int MPI_Waitall(int count,
+                         MPI_Request requests[],
+                         MPI_Status statuses[]);
+
+extern C int MPI_Test(MPI_Request *request,
+                      int *flag,
+                      MPI_Status *status);
+
+/**
+ * @}
+ */
+
+/**
+ * @brief Collective Communication
+ *
+ * Collectives are built on MPI_Send() and MPI_Recv() using binomial
+ * trees or recursive doubling, such that latency grows with O(log N) ranks.
+ * Tags do not reorder messages between two ranks, so all ranks must
+ * call the same collectives in the same order and point-to-point messages
+ * must not be in flight between the ranks at that time.
+ *
+ * @{
+ */
+
+extern C int MPI_Barrier(MPI_Comm comm);
+
+extern C int MPI_Bcast(void *buffer,
+                       int count,
+                       MPI_Datatype datatype,
+                       int root,
+                       MPI_Comm comm);
+
+extern C int MPI_Reduce(const void *sendbuf,
+                        void *recvbuf,
+                        int count,
+                        MPI_Datatype datatype,
+                        MPI_Op op,
+                        int root,
+                        MPI_Comm comm);
+
+extern C int MPI_Allreduce(const void *sendbuf,
+                           void *recvbuf,
+                           int count,
+                           MPI_Datatype datatype,
+                           MPI_Op op,
+                           MPI_Comm comm);
+
+extern C int MPI_Gather(const void *sendbuf,
+                        int sendcount,
+                        MPI_Datatype sendtype,
+                        void *recvbuf,
+                        int recvcount,
+                        MPI_Datatype recvtype,
+                        int root,
+                        MPI_Comm comm);
+
+extern C int MPI_Scatter(const void *sendbuf,
+                         int sendcount,
+                         MPI_Datatype sendtype,
+                         void *recvbuf,
+                         int recvcount,
+                         MPI_Datatype recvtype,
+                         int root,
+                         MPI_Comm comm);
+
+/**
+ * @}
+ */
+
+/**
+ * @brief Datatypes
+ * @{
+ */
+
+extern C int MPI_Type_size(MPI_Datatype datatype,
+                           int *size);
+
 /**
  * @}
  */
@@ -22,6 +22,7 @@
 #include "ICMPFactory.h"
 #include "ICMPSocket.h"
 #include "IPV4.h"
+#include "InternetChecksum.h"
 
 ICMP::ICMP(NetworkServer *server,
            NetworkDevice *device)
@@ -60,9 +61,10 @@ Error ICMP::process(NetworkQueue::Packet *pkt, Size offset)
     {
         case EchoRequest: {
             DEBUG("request");
+            const u16 oldTypeCode = *(u16 *) &hdr->type;
             hdr->type     = EchoReply;
-            hdr->checksum = 0;
-            hdr->checksum = checksum(hdr);
+            hdr->checksum = InternetChecksum::update(hdr->checksum, oldTypeCode,
+                                                     *(u16 *) &hdr->type);
             return sendPacket(source, hdr);
         }
         case EchoReply: {
@@ -127,5 +129,5 @@ Error ICMP::sendPacket(IPV4::Address ip, ICMP::Header *header)
 
 const u16 ICMP::checksum(Header *header)
 {
-    return IPV4::checksum(header, sizeof(*header));
+    return InternetChecksum::checksum(header, sizeof(*header));
 }
@@ -28,6 +28,7 @@ ICMPSocket::ICMPSocket(ICMP *icmp)
 {
     m_icmp = icmp;
     m_gotReply = false;
+    m_readyEvents = true;
     MemoryBlock::set(&m_info, 0, sizeof(m_info));
 }
 
@@ -93,5 +94,6 @@ void ICMPSocket::setReply(ICMP::Header *header)
     {
         MemoryBlock::copy(&m_reply, header, sizeof(ICMP::Header));
         m_gotReply = true;
+        signalReady();
     }
 }
@@ -26,6 +26,7 @@
 #include "IPV4Address.h"
 #include "UDP.h"
 #include "ICMP.h"
+#include "InternetChecksum.h"
 
 IPV4::IPV4(NetworkServer *server,
            NetworkDevice *device)
@@ -134,6 +135,9 @@ Error IPV4::getTransmitPacket(NetworkQueue::Packet **pkt,
         &ethAddr,
         Ethernet::IPV4
     );
+    if (!*pkt)
+        return FileSystem::RetryAgain;
+
     // Fill IP header
     Header *hdr = (Header *) ((*pkt)->data + (*pkt)->size);
     hdr->versionIHL     = (sizeof(Header) / sizeof(u32)) | (4 << 4);
@@ -146,7 +150,11 @@ Error IPV4::getTransmitPacket(NetworkQueue::Packet **pkt,
     hdr->source         = cpu_to_be32(m_address);
     hdr->destination    = cpu_to_be32(destination);
     hdr->checksum       = 0;
-    hdr->checksum       = checksum(hdr, sizeof(Header));
+
+    // Devices with checksum offload fill in the checksum themselves
+    if (!m_device->getChecksumOffload())
+        hdr->checksum = checksum(hdr, sizeof(Header));
+
     (*pkt)->size += sizeof(Header);
     m_id++;
 
@@ -156,27 +164,7 @@ Error IPV4::getTransmitPacket(NetworkQueue::Packet **pkt,
 
 const u16 IPV4::checksum(const void *buffer, Size len)
 {
-    const u16 *ptr = (const u16 *) buffer;
-    uint sum = 0;
-
-    // Calculate sum of the buffer
-    while (len > 1)
-    {
-        sum += *ptr;
-        ptr++;
-        len -= 2;
-    }
-
-    // Add left-over byte, if any
-    if (len > 0)
-        sum += be16_to_cpu(*((u8 *)ptr) << 8);
-
-    // Enforce 16-bit checksum
-    while (sum >> 16)
-        sum = (sum >> 16) + (sum & 0xFFFF);
-
-    // Convert to one's complement
-    return (~sum);
+    return InternetChecksum::checksum(buffer, len);
 }
 
 Error IPV4::process(NetworkQueue::Packet *pkt, Size offset)
@@ -193,12 +181,10 @@ Error IPV4::process(NetworkQueue::Packet *pkt, Size offset)
     switch (hdr->protocol)
     {
         case ICMP:
-            m_icmp->process(pkt, offset + sizeof(Header));
-            break;
+            return m_icmp->process(pkt, offset + sizeof(Header));
 
         case UDP:
-            m_udp->process(pkt, offset + sizeof(Header));
-            break;
+            return m_udp->process(pkt, offset + sizeof(Header));
 
         default:
             break;
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define HAS_VECTOR_CHECKSUM
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HAS_VECTOR_CHECKSUM
+#endif
+
+#include "InternetChecksum.h"
+
+InternetChecksum::Method InternetChecksum::m_method = InternetChecksum::Vector;
+
+const InternetChecksum::Method InternetChecksum::getMethod()
+{
+    return m_method;
+}
+
+void InternetChecksum::setMethod(const InternetChecksum::Method method)
+{
+    m_method = method;
+}
+
+const bool InternetChecksum::hasVector()
+{
+#ifdef HAS_VECTOR_CHECKSUM
+    return true;
+#else
+    return false;
+#endif
+}
+
+const u32 InternetChecksum::sum(const void *buffer, Size length, u32 partial)
+{
+    return sum(m_method, buffer, length, partial);
+}
+
+const u32 InternetChecksum::sum(const InternetChecksum::Method method,
+                                const void *buffer,
+                                Size length,
+                                u32 partial)
+{
+    const u8 *ptr = (const u8 *) buffer;
+    u64 total = partial;
+
+    // Word loads need at least 2-byte alignment
+    if (method == Reference || ((Address) ptr & 1))
+        total += sumReference(ptr, length);
+    else if (method == Vector)
+        total += sumVector(ptr, length);
+    else
+        total += sumWide(ptr, length);
+
+    return fold(total);
+}
+
+const u32 InternetChecksum::pseudoHeader(const u32 source,
+                                         const u32 destination,
+                                         const u8 protocol,
+                                         const u16 length)
+{
+    const u8 trailer[4] = { 0, protocol, (u8) (length >> 8), (u8) length };
+    u64 total = 0;
+
+    // Addresses are already in network byte order
+    total += (source >> 16) + (source & 0xffff);
+    total += (destination >> 16) + (destination & 0xffff);
+
+    // Reserved byte, protocol and length
+    total += sumReference(trailer, sizeof(trailer));
+
+    return fold(total);
+}
+
+const u16 InternetChecksum::finish(const u32 partial)
+{
+    return (u16) ~fold(partial);
+}
+
+const u16 InternetChecksum::checksum(const void *buffer, Size length)
+{
+    return finish(sum(buffer, length));
+}
+
+const u16 InternetChecksum::update(const u16 checksum,
+                                   const u16 oldValue,
+                                   const u16 newValue)
+{
+    // HC' = ~(~HC + ~m + m'), see RFC 1624 section 3
+    u64 total = (u16) ~checksum;
+    total += (u16) ~oldValue;
+    total += newValue;
+
+    return (u16) ~fold(total);
+}
+
+const u16 InternetChecksum::update32(const u16 checksum,
+                                     const u32 oldValue,
+                                     const u32 newValue)
+{
+    return update(update(checksum, oldValue >> 16, newValue >> 16),
+                  oldValue & 0xffff, newValue & 0xffff);
+}
+
+const u32 InternetChecksum::fold(u64 sum)
+{
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+
+    return (u32) sum;
+}
+
+const u64 InternetChecksum::sumReference(const u8 *buffer, Size length)
+{
+    u64 total = 0;
+    u16 word;
+    u8 *bytes = (u8 *) &word;
+
+    // Assemble each word from bytes to allow any alignment
+    for (; length > 1; length -= 2, buffer += 2)
+    {
+        bytes[0] = buffer[0];
+        bytes[1] = buffer[1];
+        total += word;
+    }
+
+    // Add left-over byte, padded with zero
+    if (length > 0)
+    {
+        bytes[0] = buffer[0];
+        bytes[1] = 0;
+        total += word;
+    }
+    return total;
+}
+
+const u64 InternetChecksum::sumWide(const u8 *buffer, Size length)
+{
+    u64 total = 0;
+
+    // Align on four bytes
+    if (((Address) buffer & 2) && length >= 2)
+    {
+        total += *(const u16 *) buffer;
+        buffer += 2;
+        length -= 2;
+    }
+
+    // Add 16 bytes per iteration. The 64-bit accumulator cannot overflow.
+    const u32 *ptr = (const u32 *) buffer;
+
+    for (; length >= 16; length -= 16, ptr += 4)
+        total += (u64) ptr[0] + ptr[1] + ptr[2] + ptr[3];
+
+    for (; length >= 4; length -= 4, ptr++)
+        total += *ptr;
+
+    return total + sumReference((const u8 *) ptr, length);
+}
+
+#if defined(__SSE2__)
+
+const u64 InternetChecksum::sumVector(const u8 *buffer, Size length)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    u64 lanes[2];
+
+    // Widen each 32-bit word to a 64-bit lane before adding
+    for (; length >= 32; length -= 32, buffer += 32)
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i *) buffer);
+        const __m128i b = _mm_loadu_si128((const __m128i *) (buffer + 16));
+
+        acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(a, zero));
+        acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(a, zero));
+        acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(b, zero));
+        acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(b, zero));
+    }
+    _mm_storeu_si128((__m128i *) lanes, _mm_add_epi64(acc0, acc1));
+
+    return lanes[0] + lanes[1] + sumWide(buffer, length);
+}
+
+#elif defined(__ARM_NEON)
+
+const u64 InternetChecksum::sumVector(const u8 *buffer, Size length)
+{
+    uint64x2_t acc0 = vdupq_n_u64(0), acc1 = vdupq_n_u64(0);
+
+    // Pairwise add 32-bit words into 64-bit lanes
+    for (; length >= 32; length -= 32, buffer += 32)
+    {
+        acc0 = vpadalq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(buffer)));
+        acc1 = vpadalq_u32(acc1, vreinterpretq_u32_u8(vld1q_u8(buffer + 16)));
+    }
+    acc0 = vaddq_u64(acc0, acc1);
+
+    return vgetq_lane_u64(acc0, 0) + vgetq_lane_u64(acc0, 1) + sumWide(buffer, length);
+}
+
+#else
+
+const u64 InternetChecksum::sumVector(const u8 *buffer, Size length)
+{
+    return sumWide(buffer, length);
+}
+
+#endif /* __SSE2__ */
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBNET_INTERNETCHECKSUM_H
+#define __LIBNET_INTERNETCHECKSUM_H
+
+#include <Types.h>
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libnet
+ * @{
+ */
+
+/**
+ * Internet checksum (RFC 1071) shared by IPV4, UDP and ICMP.
+ *
+ * The checksum is the one's complement of the one's complement sum
+ * of all 16-bit words. The sum does not depend on byte order, so
+ * words are added in host order and the result can be stored in
+ * a header without conversion.
+ *
+ * Partial sums are returned folded to 16-bits and can be passed as
+ * the initial value of the next call, as long as every buffer
+ * except the last has an even length.
+ */
+class InternetChecksum
+{
+  public:
+
+    /**
+     * Available implementations of the sum.
+     */
+    enum Method
+    {
+        Reference, /**< Adds 16-bit words one at a time */
+        Wide,      /**< Adds 32-bit words in a 64-bit accumulator */
+        Vector     /**< Uses SSE2 or NEON if available, otherwise Wide */
+    };
+
+  public:
+
+    /**
+     * Get the implementation used by sum()
+     *
+     * @return Method
+     */
+    static const Method getMethod();
+
+    /**
+     * Select the implementation used by sum()
+     *
+     * @param method New method to use
+     */
+    static void setMethod(const Method method);
+
+    /**
+     * Check if a vector implementation was compiled in.
+     *
+     * @return True if SSE2 or NEON is available
+     */
+    static const bool hasVector();
+
+    /**
+     * Add a buffer to a partial sum.
+     *
+     * @param buffer Input buffer
+     * @param length Number of bytes in the buffer
+     * @param partial Partial sum of the preceding data
+     *
+     * @return Partial sum including the buffer, folded to 16-bits
+     */
+    static const u32 sum(const void *buffer, Size length, u32 partial = 0);
+
+    /**
+     * Add a buffer to a partial sum using the given method.
+     *
+     * @param method Implementation to use
+     * @param buffer Input buffer
+     * @param length Number of bytes in the buffer
+     * @param partial Partial sum of the preceding data
+     *
+     * @return Partial sum including the buffer, folded to 16-bits
+     */
+    static const u32 sum(const Method method, const void *buffer,
+                         Size length, u32 partial = 0);
+
+    /**
+     * Calculate the partial sum of an IPV4 pseudo header.
+     *
+     * Used by UDP and TCP, which cover the pseudo header in their checksum.
+     *
+     * @param source Source address in network byte order
+     * @param destination Destination address in network byte order
+     * @param protocol IP protocol number
+     * @param length Length of the transport header and payload in bytes
+     *
+     * @return Partial sum of the pseudo header
+     */
+    static const u32 pseudoHeader(const u32 source,
+                                  const u32 destination,
+                                  const u8 protocol,
+                                  const u16 length);
+
+    /**
+     * Fold a partial sum and take the one's complement.
+     *
+     * @param partial Partial sum
+     *
+     * @return Checksum value to store in a header
+     */
+    static const u16 finish(const u32 partial);
+
+    /**
+     * Calculate the checksum of a buffer.
+     *
+     * @param buffer Input buffer
+     * @param length Number of bytes in the buffer
+     *
+     * @return Checksum value to store in a header
+     */
+    static const u16 checksum(const void *buffer, Size length);
+
+    /**
+     * Update a checksum after a 16-bit field has changed (RFC 1624).
+     *
+     * @param checksum Current checksum value
+     * @param oldValue Previous value of the field, as stored in the header
+     * @param newValue New value of the field, as stored in the header
+     *
+     * @return Updated checksum value
+     */
+    static const u16 update(const u16 checksum,
+                            const u16 oldValue,
+                            const u16 newValue);
+
+    /**
+     * Update a checksum after a 32-bit field has changed (RFC 1624).
+     *
+     * @param checksum Current checksum value
+     * @param oldValue Previous value of the field, as stored in the header
+     * @param newValue New value of the field, as stored in the header
+     *
+     * @return Updated checksum value
+     */
+    static const u16 update32(const u16 checksum,
+                              const u32 oldValue,
+                              const u32 newValue);
+
+  private:
+
+    /**
+     * Fold a 64-bit sum to 16-bits
+     *
+     * @param sum Sum to fold
+     *
+     * @return Folded sum
+     */
+    static const u32 fold(u64 sum);
+
+    /**
+     * Add 16-bit words one at a time.
+     *
+     * @param buffer Input buffer
+     * @param length Number of bytes
+     *
+     * @return Unfolded sum
+     */
+    static const u64 sumReference(const u8 *buffer, Size length);
+
+    /**
+     * Add 32-bit words into a 64-bit accumulator.
+     *
+     * @param buffer Input buffer, aligned on two bytes
+     * @param length Number of bytes
+     *
+     * @return Unfolded sum
+     */
+    static const u64 sumWide(const u8 *buffer, Size length);
+
+    /**
+     * Add 16-byte blocks with SIMD instructions.
+     *
+     * @param buffer Input buffer, aligned on two bytes
+     * @param length Number of bytes
+     *
+     * @return Unfolded sum
+     */
+    static const u64 sumVector(const u8 *buffer, Size length);
+
+  private:
+
+    /** Method used by sum() */
+    static Method m_method;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBNET_INTERNETCHECKSUM_H */
@@ -132,9 +132,10 @@ NetworkClient::Result NetworkClient::writeSocketInfo(
     if (r < 0)
         return IOError;
 
-    // Update the file descriptor path
+    // Update the file descriptor path. The handle refers to the factory.
     FileDescriptor *fd = &getFiles()[sock];
     MemoryBlock::copy(fd->path, buf, sizeof(buf));
+    fd->handle = ZERO;
 
     // Write address+port+action info to the socket
     SocketInfo info;
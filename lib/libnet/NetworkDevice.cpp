@@ -20,10 +20,11 @@
 
 NetworkDevice::NetworkDevice(NetworkServer *server)
     : Device(FileSystem::CharacterDeviceFile),
-      m_receive(1500),
-      m_transmit(1500)
+      m_receive(1500, 0, QueueSize),
+      m_transmit(1500, 0, QueueSize)
 {
     m_maximumPacketSize = 1500;
+    m_checksumOffload = false;
     m_server = server;
     m_eth = 0;
     m_arp = 0;
@@ -77,6 +78,11 @@ const Size NetworkDevice::getMaximumPacketSize() const
     return m_maximumPacketSize;
 }
 
+const bool NetworkDevice::getChecksumOffload() const
+{
+    return m_checksumOffload;
+}
+
 NetworkQueue * NetworkDevice::getReceiveQueue()
 {
     return &m_receive;
@@ -92,6 +98,5 @@ Error NetworkDevice::process(NetworkQueue::Packet *pkt, Size offset)
     DEBUG("");
 
     // Let the protocols process the packet
-    m_eth->process(pkt, offset);
-    return ESUCCESS;
+    return m_eth->process(pkt, offset);
 }
@@ -40,6 +40,11 @@
  */
 class NetworkDevice : public Device
 {
+  protected:
+
+    /** Number of packets in the receive and transmit queues. Sockets may hold received packets. */
+    static const Size QueueSize = 32;
+
   public:
 
     /**
@@ -66,6 +71,13 @@ class NetworkDevice : public Device
      */
     const Size getMaximumPacketSize() const;
 
+    /**
+     * Check if the device calculates checksums on transmit.
+     *
+     * @return True if protocols should skip their software checksum
+     */
+    const bool getChecksumOffload() const;
+
     /**
      * Read ethernet address.
      *
@@ -118,6 +130,9 @@ class NetworkDevice : public Device
     /** Maximum size of each packet */
     Size m_maximumPacketSize;
 
+    /** True if the device fills in IPV4, UDP and ICMP checksums itself */
+    bool m_checksumOffload;
+
     NetworkQueue m_receive;
 
     NetworkQueue m_transmit;
@@ -15,78 +15,119 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <Assert.h>
 #include "NetworkQueue.h"
 
 NetworkQueue::NetworkQueue(Size packetSize, Size headerSize, Size queueSize)
 {
+    Size ringSize = 1;
+
     assert(queueSize <= MaxPackets);
 
+    while (ringSize < queueSize)
+        ringSize <<= 1;
+
     m_packetSize   = packetSize;
     m_packetHeader = headerSize;
+    m_packetCount  = packetSize ? queueSize : 0;
+    m_packets      = new Packet[m_packetCount];
+    m_free         = new Packet *[m_packetCount];
+    m_freeCount    = 0;
+    m_ring         = new Packet *[ringSize];
+    m_ringMask     = ringSize - 1;
+    m_head         = 0;
+    m_tail         = 0;
+    m_releaseCallback = ZERO;
 
-    for (Size i = 0; i < queueSize; i++)
+    for (Size i = 0; i < m_packetCount; i++)
     {
-        Packet *packet = new Packet;
+        Packet *packet = &m_packets[i];
         packet->size = m_packetHeader;
         packet->data = new u8[packetSize];
-        m_free.insertAt(i, packet);
+        packet->refCount = 0;
+        packet->pool = this;
+        m_free[m_freeCount++] = packet;
     }
 }
 
 NetworkQueue::~NetworkQueue()
 {
-    for (Size i = 0; i < m_free.size(); i++)
+    for (Size i = 0; i < m_packetCount; i++)
     {
-        Packet *p = m_free.get(i);
-        if (p)
-        {
-            delete p->data;
-            delete p;
-        }
+        delete[] m_packets[i].data;
     }
+
+    delete[] m_packets;
+    delete[] m_free;
+    delete[] m_ring;
 }
 
 void NetworkQueue::setHeaderSize(Size size)
 {
     m_packetHeader = size;
+
+    for (Size i = 0; i < m_freeCount; i++)
+    {
+        m_free[i]->size = size;
+    }
 }
 
 NetworkQueue::Packet * NetworkQueue::get()
 {
-    for (Size i = 0; i < m_free.size(); i++)
+    if (m_freeCount == 0)
+        return ZERO;
+
+    Packet *p = m_free[--m_freeCount];
+    p->size = m_packetHeader;
+    p->refCount = 1;
+    return p;
+}
+
+void NetworkQueue::retain(NetworkQueue::Packet *packet)
+{
+    assert(packet->refCount > 0);
+    packet->refCount++;
+}
+
+void NetworkQueue::release(NetworkQueue::Packet *packet)
+{
+    NetworkQueue *pool = packet->pool;
+
+    assert(packet->refCount > 0);
+
+    if (--packet->refCount == 0)
     {
-        Packet *p = m_free.get(i);
-        if (p)
-        {
-            p->size = m_packetHeader;
-            m_free.remove(i);
-            return p;
-        }
+        packet->size = pool->m_packetHeader;
+        pool->m_free[pool->m_freeCount++] = packet;
+
+        if (pool->m_releaseCallback)
+            pool->m_releaseCallback->execute(packet);
     }
-    return ZERO;
 }
 
-void NetworkQueue::release(NetworkQueue::Packet *packet)
+void NetworkQueue::setReleaseCallback(CallbackFunction *callback)
 {
-    packet->size = m_packetHeader;
-    m_free.insert(packet);
+    m_releaseCallback = callback;
 }
 
-void NetworkQueue::push(NetworkQueue::Packet *packet)
+bool NetworkQueue::push(NetworkQueue::Packet *packet)
 {
-    m_data.insert(packet);
+    if (m_tail - m_head > m_ringMask)
+        return false;
+
+    m_ring[m_tail++ & m_ringMask] = packet;
+    return true;
 }
 
 NetworkQueue::Packet * NetworkQueue::pop()
 {
-    for (Size i = 0; i < m_data.size(); i++)
-    {
-        Packet *p = m_data.get(i);
-        if (p)
-        {
-            m_data.remove(i);
-            return p;
-        }
-    }
-    return ZERO;
+    if (m_head == m_tail)
+        return ZERO;
+
+    return m_ring[m_head++ & m_ringMask];
+}
+
+Size NetworkQueue::count() const
+{
+    return m_tail - m_head;
 }
@@ -19,7 +19,8 @@
 #define __LIBNET_NETWORKQUEUE_H
 
 #include <Types.h>
-#include <Index.h>
+#include <Macros.h>
+#include <Callback.h>
 
 /**
  * @addtogroup lib
@@ -31,11 +32,18 @@
 
 /**
  * Networking packet queue implementation.
+ *
+ * Each queue owns a pool of packet buffers and a ring of packets
+ * with data. Getting a free packet, pushing and popping are O(1)
+ * and packets are popped in the order they were pushed. Packets are
+ * reference counted such that they can be queued on another NetworkQueue
+ * without a copy. The last release returns the packet to its pool.
  */
 class NetworkQueue
 {
   private:
 
+    /** Maximum number of packets in the ring */
     static const Size MaxPackets = 128u;
 
   public:
@@ -47,6 +55,8 @@ class NetworkQueue
     {
         Size size;
         u8 *data;
+        Size refCount;      /**< Number of references to the packet. */
+        NetworkQueue *pool; /**< Queue which owns the packet buffer. */
 
         const bool operator == (const struct Packet & pkt) const
         {
@@ -64,9 +74,11 @@ class NetworkQueue
     /**
      * Constructor
      *
-     * @param packetSize The size of each packet in bytes
+     * @param packetSize The size of each packet in bytes or zero to
+     *                   only queue packets of other queues
      * @param headerSize Size of the physical header, if any
-     * @param queueSize The size of the queue in number of packets
+     * @param queueSize The size of the queue in number of packets,
+     *                  rounded up to a power of two for the ring
      */
     NetworkQueue(Size packetSize, Size headerSize = 0, Size queueSize = 8);
 
@@ -82,35 +94,86 @@ class NetworkQueue
 
     /**
      * Get unused packet
+     *
+     * @return Packet with one reference or ZERO if none available
      */
     Packet * get();
 
     /**
-     * Put unused packet back.
+     * Add a reference to a packet.
+     *
+     * @param packet Packet from any NetworkQueue
+     */
+    void retain(Packet *packet);
+
+    /**
+     * Drop a reference to a packet.
+     *
+     * The last reference puts the packet back in the pool of its owner
+     * and invokes the release callback of the owner, if any.
+     *
+     * @param packet Packet from any NetworkQueue
      */
     void release(Packet *packet);
 
+    /**
+     * Set a callback for packets which return to the pool.
+     *
+     * @param callback Invoked with the Packet as parameter or ZERO to disable
+     */
+    void setReleaseCallback(CallbackFunction *callback);
+
     /**
      * Enqueue packet with data.
+     *
+     * @return True on success, false if the ring is full
      */
-    void push(Packet *packet);
+    bool push(Packet *packet);
 
     /**
-     * Retrieve packet with data.
+     * Retrieve the oldest packet with data.
+     *
+     * @return Packet pointer or ZERO if empty
      */
     Packet * pop();
 
+    /**
+     * Get number of packets with data.
+     */
+    Size count() const;
+
   private:
 
-    /** Contains unused packets */
-    Index<Packet, MaxPackets> m_free;
+    /** Packets owned by this queue */
+    Packet *m_packets;
+
+    /** Number of packets owned by this queue */
+    Size m_packetCount;
 
-    /** Contains packets with data */
-    Index<Packet, MaxPackets> m_data;
+    /** Stack of unused packets */
+    Packet **m_free;
+
+    /** Number of packets on the stack of unused packets */
+    Size m_freeCount;
+
+    /** Ring of packets with data */
+    Packet **m_ring;
+
+    /** Ring size minus one, used to mask head and tail */
+    Size m_ringMask;
+
+    /** Position of the oldest packet in the ring */
+    Size m_head;
+
+    /** Position of the next free slot in the ring */
+    Size m_tail;
 
     /** Size of each packet */
     Size m_packetSize;
 
+    /** Invoked when a packet returns to the pool */
+    CallbackFunction *m_releaseCallback;
+
     /**
      * Size of physical hardware header.
      * This reserves some bytes at the start of
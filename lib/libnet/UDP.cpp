@@ -21,6 +21,7 @@
 #include "UDP.h"
 #include "UDPSocket.h"
 #include "UDPFactory.h"
+#include "InternetChecksum.h"
 
 UDP::UDP(NetworkServer *server,
          NetworkDevice *device)
@@ -57,7 +58,7 @@ UDPSocket * UDP::createSocket(String & path)
     if (!sock)
         return ZERO;
 
-    if (!m_sockets.insert(sock))
+    if (!m_sockets.insert(pos, sock))
     {
         delete sock;
         return ZERO;
@@ -84,8 +85,7 @@ Error UDP::process(NetworkQueue::Packet *pkt, Size offset)
         DEBUG("dropped");
         return EINVAL;
     }
-    (*sock)->process(pkt);
-    return ESUCCESS;
+    return (*sock)->process(pkt);
 }
 
 Error UDP::sendPacket(NetworkClient::SocketInfo *src, IOBuffer & buffer, Size size)
@@ -118,9 +118,10 @@ Error UDP::sendPacket(NetworkClient::SocketInfo *src, IOBuffer & buffer, Size si
     // Insert payload. The payload is just after the 'dest' struct in the IOBuffer.
     buffer.read(pkt->data + pkt->size + sizeof(Header), size - sizeof(dest), sizeof(dest));
 
-    // Calculate final checksum
-    hdr->checksum = checksum((IPV4::Header *)(pkt->data + pkt->size - sizeof(IPV4::Header)),
-                             hdr, size - sizeof(dest));
+    // Calculate final checksum, unless the device does it for us
+    if (!m_device->getChecksumOffload())
+        hdr->checksum = checksum((IPV4::Header *)(pkt->data + pkt->size - sizeof(IPV4::Header)),
+                                 hdr, size - sizeof(dest));
     DEBUG("checksum = " << (uint) hdr->checksum);
 
     // Increment packet size
@@ -141,46 +142,20 @@ Error UDP::bind(UDPSocket *sock, u16 port)
     return ESUCCESS;
 }
 
-const ulong UDP::calculateSum(const u16 *ptr, Size bytes)
-{
-    ulong sum = 0;
-
-    for (;bytes > 0; bytes -= 2, ptr++)
-    {
-        if (bytes == 1) {
-            sum += *(u8 *)ptr;
-            break;
-        }
-        else
-            sum += *ptr;
-    }
-    return sum;
-}
-
 const u16 UDP::checksum(const IPV4::Header *ip,
                         const UDP::Header *udp,
                         const Size datalen)
 {
-    IPV4::PseudoHeader phr;
-    ulong sum = 0;
-
-    // Setup a pseudo header
-    phr.reserved    = 0;
-    phr.source      = ip->source;
-    phr.destination = ip->destination;
-    phr.protocol    = IPV4::UDP;
-    phr.length      = cpu_to_be16((sizeof(Header) + datalen));
-    DEBUG("ip src = " << phr.source << " dst = " << phr.destination);
-
-    // Sum the pseudo header
-    sum += calculateSum((u16 *) &phr, sizeof(phr));
-    sum += calculateSum((u16 *) udp, sizeof(*udp) + datalen);
-
-    // Keep only last 16 bits and add carry bits
-    sum = (sum >> 16) + (sum & 0xffff);
-    sum += (sum >> 16);
-
-    // Take one's complement
-    sum = ~sum;
-    return (u16) sum;
+    const Size length = sizeof(Header) + datalen;
+    u32 sum;
+
+    DEBUG("ip src = " << ip->source << " dst = " << ip->destination);
+
+    // Sum the pseudo header, UDP header and payload
+    sum = InternetChecksum::pseudoHeader(ip->source, ip->destination, IPV4::UDP, length);
+    sum = InternetChecksum::sum(udp, length, sum);
+
+    // Zero means no checksum in UDP, which is sent as all ones instead
+    const u16 result = InternetChecksum::finish(sum);
+    return result ? result : 0xffff;
 }
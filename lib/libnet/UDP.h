@@ -112,20 +112,18 @@ class UDP : public NetworkProtocol
     Error sendPacket(NetworkClient::SocketInfo *info, IOBuffer & buffer, Size size);
 
     /**
-     * Calculate ICMP checksum
+     * Calculate UDP checksum
      *
-     * @param header ICMP header
-     * @return ICMP checksum value for the given header
+     * @param ip IPV4 header with the source and destination address
+     * @param header UDP header, followed by the payload
+     * @param datalen Number of payload bytes
+     *
+     * @return UDP checksum value for the given header and payload
      */
     static const u16 checksum(const IPV4::Header *ip,
                               const Header *header,
                               const Size datalen);
 
-  private:
-
-    static const ulong calculateSum(const u16 *ptr,
-                                    Size bytes);
-
   private:
 
     UDPFactory *m_factory;
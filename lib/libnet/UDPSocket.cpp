@@ -17,20 +17,28 @@
 
 #include <stdlib.h>
 #include <errno.h>
+#include <MemoryBlock.h>
 #include "Ethernet.h"
 #include "UDP.h"
 #include "UDPSocket.h"
 
 UDPSocket::UDPSocket(UDP *udp)
     : NetworkSocket(udp->getMaximumPacketSize()),
-      m_queue(udp->getMaximumPacketSize())
+      m_queue(udp->getMaximumPacketSize(), 0, QueueSize)
 {
     m_udp  = udp;
     m_port = 0;
+    m_held = 0;
+    m_readyEvents = true;
 }
 
 UDPSocket::~UDPSocket()
 {
+    NetworkQueue::Packet *pkt;
+
+    // Give back unread packets to the network device
+    while ((pkt = m_queue.pop()) != ZERO)
+        m_queue.release(pkt);
 }
 
 const u16 UDPSocket::getPort() const
@@ -61,6 +69,10 @@ Error UDPSocket::read(IOBuffer & buffer, Size size, Size offset)
     // Fill payload
     Size sz = size > payloadSize ? payloadSize : size;
     buffer.write(udpHdr+1, sz, sizeof(info));
+
+    if (pkt->pool != &m_queue)
+        m_held--;
+
     m_queue.release(pkt);
     return sz + sizeof(info);
 }
@@ -93,15 +105,37 @@ Error UDPSocket::process(NetworkQueue::Packet *pkt)
 {
     DEBUG("");
 
-    NetworkQueue::Packet *buf = m_queue.get();
-    if (!buf)
+    // Keep the packet itself until it is read, up to a limit
+    if (m_held < MaximumHeldPackets)
+    {
+        if (!m_queue.push(pkt))
+        {
+            ERROR("udp socket queue full");
+            return EIO;
+        }
+        m_queue.retain(pkt);
+        m_held++;
+    }
+    // Copy the packet, such that the device can re-use it
+    else
     {
-        ERROR("udp socket queue full");
-        return EIO;
+        NetworkQueue::Packet *buf = m_queue.get();
+        if (!buf)
+        {
+            ERROR("udp socket queue full");
+            return EIO;
+        }
+        buf->size = pkt->size;
+        MemoryBlock::copy(buf->data, pkt->data, pkt->size);
+
+        if (!m_queue.push(buf))
+        {
+            m_queue.release(buf);
+            ERROR("udp socket queue full");
+            return EIO;
+        }
     }
-    buf->size = pkt->size;
-    MemoryBlock::copy(buf->data, pkt->data, pkt->size);
-    m_queue.push(buf);
+    signalReady();
     return ESUCCESS;
 }
 
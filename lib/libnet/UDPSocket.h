@@ -40,6 +40,19 @@ class UDP;
  */
 class UDPSocket : public NetworkSocket
 {
+  private:
+
+    /** Maximum number of received packets in the queue */
+    static const Size QueueSize = 16;
+
+    /**
+     * Maximum number of network device packets to hold.
+     *
+     * Holding a packet keeps it out of the receive pool of the device.
+     * Packets received beyond this limit are copied instead.
+     */
+    static const Size MaximumHeldPackets = 4;
+
   public:
 
     /**
@@ -84,7 +97,7 @@ class UDPSocket : public NetworkSocket
     /**
      * Process incoming network packet.
      *
-     * @return Error code
+     * @return Error code, EIO if the receive queue is full
      */
     virtual Error process(NetworkQueue::Packet *pkt);
 
@@ -112,8 +125,11 @@ class UDPSocket : public NetworkSocket
     /** Local port */
     u16 m_port;
 
-    /** Incoming packet queue */
+    /** Incoming packets, either held from the network device or copied */
     NetworkQueue m_queue;
+
+    /** Number of network device packets in the queue */
+    Size m_held;
 };
 
 /**
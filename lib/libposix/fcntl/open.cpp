@@ -28,12 +28,13 @@ int open(const char *path, int oflag, ...)
 {
     const FileSystemClient filesystem;
     FileDescriptor *files = getFiles();
-    FileSystem::FileStat st;
+    FileSystem::Handle handle;
+    ProcessID mount;
 
-    // Ask the FileSystem for the file.
+    // Ask the FileSystem to open the file.
     if (files != NULL)
     {
-        const FileSystem::Result result = filesystem.statFile(path, &st);
+        const FileSystem::Result result = filesystem.openFile(path, &mount, &handle);
 
         // Set errno
         if (result == FileSystem::Success)
@@ -48,6 +49,8 @@ int open(const char *path, int oflag, ...)
                     files[i].open  = true;
                     files[i].identifier = 0;
                     files[i].position = 0;
+                    files[i].mount = mount;
+                    files[i].handle = handle;
                     strlcpy(files[i].path, path, PATH_MAX);
                     return i;
                 }
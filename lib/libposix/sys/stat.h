@@ -176,6 +176,7 @@ struct stat
         this->st_uid   = stat->userID;
         this->st_gid   = stat->groupID;
         this->st_dev   = stat->deviceID;
+        this->st_ino   = stat->inode;
     }
 #endif /* CPP */
 
@@ -151,6 +151,20 @@ extern C int forkexec(const char *path, const char *argv[]);
  */
 extern C int spawn(Address program, Size programSize, const char *argv[]);
 
+/**
+ * @brief Create a new process using an open executable file.
+ *
+ * Only the loadable regions are read from the file, directly
+ * into the memory of the new process.
+ *
+ * @param fd File descriptor of the executable
+ * @param argv Argument list pointer.
+ *
+ * @return New process ID on success and -1 on failure.
+ * @note  Errno is set with the appropriate error code on failure.
+ */
+extern C int spawnfd(int fd, const char *argv[]);
+
 /**
  * @brief Get name of current host.
  *
@@ -18,7 +18,6 @@
 #include <FreeNOS/User.h>
 #include <Types.h>
 #include <string.h>
-#include <sys/stat.h>
 #include <errno.h>
 #include <fcntl.h>
 #include "unistd.h"
@@ -26,48 +25,15 @@
 int forkexec(const char *path, const char *argv[])
 {
     int fd, ret = 0;
-    struct stat st;
-    Memory::Range range;
-
-    // Find program image
-    if (stat(path, &st) != 0)
-        return -1;
 
     // Open program image
     if ((fd = open(path, O_RDONLY)) < 0)
         return -1;
 
-    // Map memory buffer for the program image
-    range.virt   = ZERO;
-    range.phys   = ZERO;
-    range.size   = st.st_size;
-    range.access = Memory::User|Memory::Readable|Memory::Writable;
-
-    // Create mapping
-    if (VMCtl(SELF, MapContiguous, &range) != API::Success)
-    {
-        errno = EFAULT;
-        return -1;
-    }
-
-    // Read the program image
-    ret = read(fd, (void *)range.virt, st.st_size);
+    // Load the program directly from the file
+    ret = spawnfd(fd, argv);
 
     // Close file handle
     close(fd);
-
-    // Spawn the new program
-    if (ret == st.st_size)
-    {
-        ret = spawn(range.virt, st.st_size, argv);
-    }
-
-    // Cleanup program buffer
-    if (VMCtl(SELF, Release, &range) != API::Success)
-    {
-        errno = EFAULT;
-        return -1;
-    }
-
     return ret;
 }
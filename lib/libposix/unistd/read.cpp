@@ -37,12 +37,30 @@ ssize_t read(int fildes, void *buf, size_t nbyte)
         return -1;
     }
 
-    // Read the file.
+    FileDescriptor *fd = &files[fildes];
     const FileSystemClient filesystem;
-    const FileSystem::Result result = filesystem.readFile(files[fildes].path,
-                                                          (char *)buf,
-                                                         &nbyte,
-                                                          files[fildes].position);
+    FileSystem::Result result;
+
+    // Read the file using its handle, which avoids path lookups
+    if (fd->handle != ZERO)
+    {
+        result = filesystem.readFile(fd->mount, fd->handle, (char *)buf, &nbyte, fd->position);
+
+        // The file was removed or its file system is gone: open it again
+        if (result == FileSystem::StaleHandle || result == FileSystem::IpcError)
+        {
+            result = filesystem.openFile(fd->path, &fd->mount, &fd->handle);
+
+            if (result == FileSystem::Success)
+                result = filesystem.readFile(fd->mount, fd->handle, (char *)buf, &nbyte, fd->position);
+            else
+                fd->handle = ZERO;
+        }
+    }
+    else
+    {
+        result = filesystem.readFile(fd->path, (char *)buf, &nbyte, fd->position);
+    }
 
     // Did the read succeed?
     if (result != FileSystem::Success)
@@ -51,6 +69,6 @@ ssize_t read(int fildes, void *buf, size_t nbyte)
         return -1;
     }
 
-    files[fildes].position += nbyte;
+    fd->position += nbyte;
     return nbyte;
 }
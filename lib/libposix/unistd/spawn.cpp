@@ -23,23 +23,86 @@
 #include <Runtime.h>
 #include "limits.h"
 #include "string.h"
+#include "stdio.h"
 #include "errno.h"
 #include "unistd.h"
 
-int spawn(Address program, Size programSize, const char *argv[])
+/** Maximum number of memory regions in a program */
+#define SPAWN_MAX_REGIONS 16
+
+/**
+ * Fill a memory region of the new program.
+ *
+ * The region data is either copied from an in-memory image,
+ * or read from the file directly into the mapped region.
+ *
+ * @param dest Temporary mapping of the region in our process
+ * @param region Region to fill
+ * @param program In-memory executable or ZERO
+ * @param fd Executable file descriptor, if program is ZERO
+ *
+ * @return Zero on success and -1 on failure
+ */
+static int loadRegion(u8 *dest,
+                      const ExecutableFormat::Region & region,
+                      const Address program,
+                      const int fd)
+{
+    if (program)
+    {
+        MemoryBlock::copy(dest, (const void *)(program + region.dataOffset),
+                          region.dataSize);
+    }
+    else if (region.dataSize > 0)
+    {
+        if (lseek(fd, region.dataOffset, SEEK_SET) == (off_t) -1 ||
+            read(fd, dest, region.dataSize) != (ssize_t) region.dataSize)
+        {
+            errno = EIO;
+            return -1;
+        }
+    }
+
+    // Nulify remaining space
+    if (region.memorySize > region.dataSize)
+    {
+        MemoryBlock::set(dest + region.dataSize, 0,
+                         region.memorySize - region.dataSize);
+    }
+    return 0;
+}
+
+/**
+ * Create a new process from an executable.
+ *
+ * @param image Executable image containing at least the program headers
+ * @param imageSize Number of bytes in the image
+ * @param program In-memory executable or ZERO to read regions from fd
+ * @param fd Executable file descriptor, if program is ZERO
+ * @param key Identity of the executable for sharing read-only regions, or ZERO
+ * @param argv Argument list pointer.
+ *
+ * @return New process ID on success and -1 on failure.
+ */
+static int spawnImage(const u8 *image,
+                      const Size imageSize,
+                      const Address program,
+                      const int fd,
+                      const ImageKey *key,
+                      const char *argv[])
 {
     const FileSystemClient filesystem;
     ExecutableFormat *fmt;
-    ExecutableFormat::Region regions[16];
+    ExecutableFormat::Region regions[SPAWN_MAX_REGIONS];
     Arch::MemoryMap map;
     Memory::Range range;
     uint count = 0;
     pid_t pid = 0;
-    Size numRegions = 16;
+    Size numRegions = SPAWN_MAX_REGIONS;
     Address entry;
 
     // Attempt to read executable format
-    if (ExecutableFormat::find((u8 *) program, programSize, &fmt) != ExecutableFormat::Success)
+    if (ExecutableFormat::find(image, imageSize, &fmt) != ExecutableFormat::Success)
     {
         errno = ENOEXEC;
         return -1;
@@ -76,11 +139,44 @@ int spawn(Address program, Size programSize, const char *argv[])
     // Map program regions into virtual memory of the new process
     for (Size i = 0; i < numRegions; i++)
     {
+        // Read-only regions are shared by all processes running the same program
+        const bool shared = key != ZERO && !(regions[i].access & Memory::Writable);
+
+        if (shared)
+        {
+            range.virt   = regions[i].virt;
+            range.phys   = (Address) key;
+            range.size   = regions[i].memorySize;
+            range.access = regions[i].access;
+
+            if (VMCtl(pid, MapImage, &range) == API::Success)
+                continue;
+        }
+
+        // Whole pages after the data are zeroed by the kernel on first access
+        ExecutableFormat::Region region = regions[i];
+        const Address lazyStart = (region.virt + region.dataSize + PAGESIZE - 1) & PAGEMASK;
+        const Address lazyEnd = (region.virt + region.memorySize + PAGESIZE - 1) & PAGEMASK;
+
+        if (!shared && lazyEnd > lazyStart)
+        {
+            range.virt   = lazyStart;
+            range.phys   = ZERO;
+            range.size   = lazyEnd - lazyStart;
+            range.access = region.access;
+
+            if (VMCtl(pid, MapLazy, &range) == API::Success)
+                region.memorySize = lazyStart - region.virt;
+        }
+
+        if (region.memorySize == 0)
+            continue;
+
         // Setup memory range to copy region data
-        range.virt   = regions[i].virt;
+        range.virt   = region.virt;
         range.phys   = ZERO;
-        range.size   = regions[i].memorySize;
-        range.access = regions[i].access;
+        range.size   = region.memorySize;
+        range.access = region.access;
 
         // Create mapping first in the new process
         if (VMCtl(pid, MapContiguous, &range) != API::Success)
@@ -92,6 +188,7 @@ int spawn(Address program, Size programSize, const char *argv[])
 
         // Map inside our process
         range.virt = ZERO;
+        range.access = Memory::User | Memory::Readable | Memory::Writable;
         if (VMCtl(SELF, MapContiguous, &range) != API::Success)
         {
             errno = EFAULT;
@@ -99,15 +196,12 @@ int spawn(Address program, Size programSize, const char *argv[])
             return -1;
         }
 
-        // Copy data bytes
-        MemoryBlock::copy((void *)range.virt, (const void *)(program + regions[i].dataOffset),
-                          regions[i].dataSize);
-
-        // Nulify remaining space
-        if (regions[i].memorySize > regions[i].dataSize)
+        // Fill the region with program data
+        if (loadRegion((u8 *) range.virt, region, program, fd) != 0)
         {
-            MemoryBlock::set((void *)(range.virt + regions[i].dataSize), 0,
-                             regions[i].memorySize - regions[i].dataSize);
+            VMCtl(SELF, UnMap, &range);
+            ProcessCtl(pid, KillPID);
+            return -1;
         }
 
         // Remove temporary mapping
@@ -117,8 +211,16 @@ int spawn(Address program, Size programSize, const char *argv[])
             ProcessCtl(pid, KillPID);
             return -1;
         }
-    }
 
+        // Keep the loaded pages for the next process. Fails for unprivileged processes
+        // and if the cache is full.
+        if (shared)
+        {
+            range.virt = regions[i].virt;
+            range.phys = (Address) key;
+            VMCtl(pid, InsertImage, &range);
+        }
+    }
     // Create mapping for command-line arguments
     range = map.range(MemoryMap::UserArgs);
     range.phys = ZERO;
@@ -153,9 +255,18 @@ int spawn(Address program, Size programSize, const char *argv[])
         return -1;
     }
 
-    // Copy fds into the new process.
-    if ((VMCopy(pid, API::Write, (Address) getFiles(),
-                range.virt + (PAGESIZE * 2), range.size - (PAGESIZE * 2))) < 0)
+    // Copy fds into the new process. The executable file is not inherited.
+    FileDescriptor *files = getFiles();
+    const bool programOpen = fd >= 0 && files[fd].open;
+    if (programOpen)
+        files[fd].open = false;
+
+    const API::Result copyResult = VMCopy(pid, API::Write, (Address) files,
+                                          range.virt + (PAGESIZE * 2), range.size - (PAGESIZE * 2));
+    if (programOpen)
+        files[fd].open = true;
+
+    if (copyResult < 0)
     {
         delete[] arguments;
         errno = EFAULT;
@@ -176,3 +287,57 @@ int spawn(Address program, Size programSize, const char *argv[])
     delete[] arguments;
     return pid;
 }
+
+int spawn(Address program, Size programSize, const char *argv[])
+{
+    return spawnImage((const u8 *) program, programSize, program, -1, ZERO, argv);
+}
+
+/**
+ * Retrieve the identity of an executable file.
+ *
+ * The key covers the full path, the file system process,
+ * the inode number, the modification stamp and the size of the file.
+ *
+ * @return True on success, false if the file cannot be identified
+ */
+static bool imageKey(const char *path, ImageKey *key)
+{
+    const FileSystemClient filesystem;
+    FileSystem::FileStat st;
+
+    if (filesystem.statFile(path, &st) != FileSystem::Success)
+        return false;
+
+    filesystem.getFullPath(path, key->path);
+    key->server   = filesystem.findMount(key->path);
+    key->inode    = st.inode;
+    key->modified = st.modified;
+    key->size     = st.size;
+    return true;
+}
+
+int spawnfd(int fd, const char *argv[])
+{
+    const FileDescriptor *files = getFiles();
+    u8 *header = new u8[PAGESIZE];
+    ssize_t headerSize;
+    ImageKey key;
+    int ret;
+
+    // Read only the start of the file, which contains the program headers
+    if (lseek(fd, 0, SEEK_SET) == (off_t) -1 ||
+        (headerSize = read(fd, header, PAGESIZE)) <= 0)
+    {
+        delete[] header;
+        errno = EIO;
+        return -1;
+    }
+
+    // Only share regions of files which can be identified
+    const bool identified = fd < FILE_DESCRIPTOR_MAX && imageKey(files[fd].path, &key);
+
+    ret = spawnImage(header, headerSize, ZERO, fd, identified ? &key : ZERO, argv);
+    delete[] header;
+    return ret;
+}
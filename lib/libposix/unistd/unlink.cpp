@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/User.h>
 #include <FileSystemClient.h>
 #include "errno.h"
 #include "limits.h"
@@ -30,7 +31,19 @@ int unlink(const char *path)
 
     // Set error number
     if (result == FileSystem::Success)
+    {
+        ImageKey key;
+        Memory::Range range;
+
+        // Drop program pages which the kernel keeps for this file. Only privileged
+        // processes may do so, otherwise the pages are freed when memory runs low.
+        filesystem.getFullPath(path, key.path);
+        key.server = filesystem.findMount(key.path);
+        range.phys = (Address) &key;
+        VMCtl(SELF, RemoveImage, &range);
+
         errno = ESUCCESS;
+    }
     else
         errno = EIO;
 
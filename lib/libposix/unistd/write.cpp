@@ -37,12 +37,30 @@ ssize_t write(int fildes, const void *buf, size_t nbyte)
         return -1;
     }
 
-    // Write the file.
+    FileDescriptor *fd = &files[fildes];
     const FileSystemClient filesystem;
-    const FileSystem::Result result = filesystem.writeFile(files[fildes].path,
-                                                          (const char *)buf,
-                                                         &nbyte,
-                                                          files[fildes].position);
+    FileSystem::Result result;
+
+    // Write the file using its handle, which avoids path lookups
+    if (fd->handle != ZERO)
+    {
+        result = filesystem.writeFile(fd->mount, fd->handle, (const char *)buf, &nbyte, fd->position);
+
+        // The file was removed or its file system is gone: open it again
+        if (result == FileSystem::StaleHandle || result == FileSystem::IpcError)
+        {
+            result = filesystem.openFile(fd->path, &fd->mount, &fd->handle);
+
+            if (result == FileSystem::Success)
+                result = filesystem.writeFile(fd->mount, fd->handle, (const char *)buf, &nbyte, fd->position);
+            else
+                fd->handle = ZERO;
+        }
+    }
+    else
+    {
+        result = filesystem.writeFile(fd->path, (const char *)buf, &nbyte, fd->position);
+    }
 
     // Did the write succeed?
     if (result != FileSystem::Success)
@@ -51,6 +69,6 @@ ssize_t write(int fildes, const void *buf, size_t nbyte)
         return -1;
     }
 
-    files[fildes].position += nbyte;
+    fd->position += nbyte;
     return nbyte;
 }
@@ -88,9 +88,28 @@ bool BitArray::isSet(const Size bit) const
 
 void BitArray::setRange(const Size from, const Size to)
 {
-    for (Size i = from; i <= to; i++)
+    const Size last = to < m_bitCount ? to : m_bitCount - 1;
+    Size bit = from;
+
+    if (m_bitCount == 0)
+        return;
+
+    while (bit <= last)
     {
-        set(i, true);
+        const Size index = bit / BitsPerWord;
+        const Size first = bit % BitsPerWord;
+        const Size end = (last - bit) >= (BitsPerWord - first) ? BitsPerWord : first + (last - bit) + 1;
+        Word mask = ~((Word) 0) << first;
+
+        if (end < BitsPerWord)
+            mask &= ~(~((Word) 0) << end);
+
+        // Fill all bits in the range of this word at once
+        const Word value = loadWord(index);
+        m_set += countBits(mask & ~value);
+        storeWord(index, value | mask);
+
+        bit += end - first;
     }
 }
 
@@ -99,65 +118,43 @@ BitArray::Result BitArray::setNext(Size *bit,
                                    const Size start,
                                    const Size boundary)
 {
-    Size from = 0, found = 0;
+    const Result result = findNext(bit, count, start, boundary);
+
+    if (result == Success)
+        setRange(*bit, *bit + (count ? count : 1) - 1);
+
+    return result;
+}
+
+BitArray::Result BitArray::findNext(Size *bit,
+                                    const Size count,
+                                    const Size start,
+                                    const Size boundary) const
+{
+    const Size num = count ? count : 1;
+    Size from = alignUp(start, boundary);
 
-    // Loop BitArray for unset bits
-    for (Size i = start; i < m_bitCount;)
+    while (from < m_bitCount && num <= m_bitCount - from)
     {
-        // Try to fast-forward 32 bits to search
-        if (m_bitCount > 32 && i < m_bitCount - 32 && ((u32 *)m_array)[i / 32] == 0xffffffff)
-        {
-            from = found = 0;
+        // Jump to the first unset bit on the given boundary
+        from = findBit(from, m_bitCount, false);
+        from = alignUp(from, boundary);
 
-            if (i & 31)
-                i += (32 - (i % 32));
-            else
-                i += 32;
-            continue;
-        }
-        // Try to fast-forward 8 bits to search
-        else if (m_bitCount > 8 && i < m_bitCount - 8 && m_array[i / 8] == 0xff)
-        {
-            from = found = 0;
+        if (from >= m_bitCount || num > m_bitCount - from)
+            break;
 
-            if (i & 7)
-                i += (8 - (i % 8));
-            else
-                i += 8;
-            continue;
-        }
-        else if (!isSet(i))
-        {
-            // Remember this bit
-            if (!found)
-            {
-                if (!(i % boundary))
-                {
-                    from  = i;
-                    found = 1;
-                }
-            }
-            else
-            {
-                found++;
-            }
-
-            // Are there enough contigious bits?
-            if (found >= count)
-            {
-                setRange(from, i);
-                *bit = from;
-                return Success;
-            }
-        }
-        else
+        // The range is available if it contains no set bits
+        const Size next = findBit(from, from + num, true);
+        if (next == from + num)
         {
-            from = found = 0;
+            *bit = from;
+            return Success;
         }
 
-        // Move to the next bit
-        i++;
+        // Continue searching after the set bit
+        from = alignUp(next + 1, boundary);
     }
+
     // No unset bits left!
     return OutOfMemory;
 }
@@ -186,13 +183,15 @@ void BitArray::setArray(u8 *map, const Size bitCount)
     m_allocated = false;
     m_set   = 0;
 
-    // Recalculate set bits
-    for (Size i = 0; i < m_bitCount; i++)
+    // Recalculate set bits, one word at a time
+    for (Size i = 0; i < m_bitCount; i += BitsPerWord)
     {
-        if (isSet(i))
-        {
-            m_set++;
-        }
+        Word word = loadWord(i / BitsPerWord);
+
+        if (m_bitCount - i < BitsPerWord)
+            word &= ~(~((Word) 0) << (m_bitCount - i));
+
+        m_set += countBits(word);
     }
 }
 
@@ -215,6 +214,99 @@ bool BitArray::operator[](const int bit) const
     return isSet(bit);
 }
 
+Size BitArray::findBit(const Size from, const Size to, const bool value) const
+{
+    Size bit = from;
+
+    while (bit < to)
+    {
+        const Size index = bit / BitsPerWord;
+        const Word word = value ? loadWord(index) : ~loadWord(index);
+        const Word match = word & (~((Word) 0) << (bit % BitsPerWord));
+
+        // Skip over words which contain no matching bit
+        if (match)
+        {
+            const Size found = (index * BitsPerWord) + countTrailingZeros(match);
+            return found < to ? found : to;
+        }
+
+        bit = (index + 1) * BitsPerWord;
+    }
+
+    return to;
+}
+
+inline BitArray::Word BitArray::loadWord(const Size index) const
+{
+    const Size bytes = calculateBitmapSize(m_bitCount);
+    const Size offset = index * sizeof(Word);
+    Word value = 0;
+
+    if (offset + sizeof(Word) <= bytes)
+        return ((const Word *) m_array)[index];
+
+    // The last word may only be partially inside the array
+    for (Size i = offset; i < bytes; i++)
+        value |= ((Word) m_array[i]) << ((i - offset) * 8);
+
+    return value;
+}
+
+inline void BitArray::storeWord(const Size index, const Word value)
+{
+    const Size bytes = calculateBitmapSize(m_bitCount);
+    const Size offset = index * sizeof(Word);
+
+    if (offset + sizeof(Word) <= bytes)
+    {
+        ((Word *) m_array)[index] = value;
+        return;
+    }
+
+    // The last word may only be partially inside the array
+    for (Size i = offset; i < bytes; i++)
+        m_array[i] = (u8) (value >> ((i - offset) * 8));
+}
+
+inline Size BitArray::alignUp(const Size bit, const Size boundary)
+{
+    if (boundary <= 1)
+        return bit;
+
+    const Size remainder = bit % boundary;
+
+    return remainder ? bit + (boundary - remainder) : bit;
+}
+
+inline Size BitArray::countTrailingZeros(const Word word)
+{
+#ifdef __GNUC__
+    return __builtin_ctzl(word);
+#else
+    Size n = 0;
+
+    for (Word w = word; !(w & 1); w >>= 1)
+        n++;
+
+    return n;
+#endif /* __GNUC__ */
+}
+
+inline Size BitArray::countBits(const Word word)
+{
+#ifdef __GNUC__
+    return __builtin_popcountl(word);
+#else
+    Size n = 0;
+
+    for (Word w = word; w != 0; w &= w - 1)
+        n++;
+
+    return n;
+#endif /* __GNUC__ */
+}
+
 inline Size BitArray::calculateBitmapSize(const Size bitCount) const
 {
     const Size bytes = bitCount / 8;
@@ -32,9 +32,20 @@
 
 /**
  * Represents an array of bits.
+ *
+ * Searching and setting ranges of bits is done one machine word at a time.
+ * Bits are stored in little-endian order: bit N is stored in byte N / 8.
  */
 class BitArray
 {
+  private:
+
+    /** Machine word used for processing multiple bits at once */
+    typedef ulong Word;
+
+    /** Number of bits in a Word */
+    static const Size BitsPerWord = sizeof(Word) * 8;
+
   public:
 
     /**
@@ -109,6 +120,21 @@ class BitArray
                    const Size offset = 0,
                    const Size boundary = 1);
 
+    /**
+     * Find the next unset bit(s), without setting them.
+     *
+     * @param bit Start bit number on success.
+     * @param count Number of consequetive bits required.
+     * @param offset Start bit number to start searching at inside the BitArray.
+     * @param boundary First bit number must be on the given alignment boundary.
+     *
+     * @return Result code.
+     */
+    Result findNext(Size *bit,
+                    const Size count = 1,
+                    const Size offset = 0,
+                    const Size boundary = 1) const;
+
     /**
      * Sets the given bit to zero.
      *
@@ -165,6 +191,62 @@ class BitArray
 
   private:
 
+    /**
+     * Find the first bit with the given value.
+     *
+     * @param from Bit number to start searching at.
+     * @param to Bit number to stop searching at (exclusive).
+     * @param value Bit value to search for.
+     *
+     * @return Bit number of the first matching bit or the value of to if not found.
+     */
+    Size findBit(const Size from, const Size to, const bool value) const;
+
+    /**
+     * Read a word from the bits array.
+     *
+     * @param index Word index number.
+     *
+     * @return Word value, with bits outside the array set to zero.
+     */
+    Word loadWord(const Size index) const;
+
+    /**
+     * Write a word to the bits array.
+     *
+     * @param index Word index number.
+     * @param value New Word value. Bits outside the array are ignored.
+     */
+    void storeWord(const Size index, const Word value);
+
+    /**
+     * Round a bit number up to the given boundary.
+     *
+     * @param bit Bit number
+     * @param boundary Alignment boundary in bits
+     *
+     * @return Aligned bit number
+     */
+    static Size alignUp(const Size bit, const Size boundary);
+
+    /**
+     * Count the number of trailing zero bits.
+     *
+     * @param word Input Word, which must be non-zero.
+     *
+     * @return Number of zero bits below the lowest set bit.
+     */
+    static Size countTrailingZeros(const Word word);
+
+    /**
+     * Count the number of set bits.
+     *
+     * @param word Input Word
+     *
+     * @return Number of 1-bits in the word
+     */
+    static Size countBits(const Word word);
+
     /**
      * Calculate required size of bitmap array in bytes.
      *
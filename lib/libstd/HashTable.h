@@ -20,9 +20,7 @@
 
 #include "Types.h"
 #include "Macros.h"
-#include "Vector.h"
 #include "List.h"
-#include "ListIterator.h"
 #include "HashFunction.h"
 #include "Associative.h"
 #include "Assert.h"
@@ -30,6 +28,9 @@
 /** Default size of the HashTable internal table. */
 #define HASHTABLE_DEFAULT_SIZE    64
 
+/** Maximum percentage of used and removed slots before the HashTable grows. */
+#define HASHTABLE_LOAD_FACTOR     75
+
 /**
  * @addtogroup lib
  * @{
@@ -40,6 +41,11 @@
 
 /**
  * Efficient key -> value lookups.
+ *
+ * Items are stored in a single contiguous table using open addressing
+ * with linear probing. Removed items leave a marker in their slot, such
+ * that probing continues past them. The table is rebuilt with twice its
+ * size when the number of used and removed slots exceeds the load factor.
  */
 template <class K, class V> class HashTable : public Associative<K,V>
 {
@@ -103,21 +109,67 @@ template <class K, class V> class HashTable : public Associative<K,V>
         V value;
     };
 
+  private:
+
+    /**
+     * State of a slot in the table.
+     */
+    enum SlotState
+    {
+        Empty = 0,
+        Used,
+        Removed
+    };
+
+  public:
+
     /**
      * Class constructor.
      *
      * @param size Initial size of the internal table.
      */
     HashTable(Size size = HASHTABLE_DEFAULT_SIZE)
-        : m_table(size)
     {
         assert(size > 0);
+        allocate(size);
+    }
 
-        m_count = ZERO;
+    /**
+     * Copy constructor.
+     *
+     * @param table HashTable to copy.
+     */
+    HashTable(const HashTable<K,V> & table)
+        : Associative<K,V>()
+    {
+        allocate(table.m_size);
+        copy(table);
+    }
 
-        // Fill the Vector with empty Bucket Lists.
-        for (Size i = 0; i < m_table.size(); i++)
-            m_table.insert(List<Bucket>());
+    /**
+     * Destructor.
+     */
+    virtual ~HashTable()
+    {
+        delete[] m_buckets;
+        delete[] m_states;
+    }
+
+    /**
+     * Assignment operator.
+     *
+     * @param table HashTable to copy.
+     */
+    HashTable<K,V> & operator = (const HashTable<K,V> & table)
+    {
+        if (this != &table)
+        {
+            delete[] m_buckets;
+            delete[] m_states;
+            allocate(table.m_size);
+            copy(table);
+        }
+        return *this;
     }
 
     /**
@@ -132,23 +184,31 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual bool insert(const K & key, const V & value)
     {
-
-        Size idx = hash(key, m_table.size());
+        Size idx = hash(key, m_size);
+        Size freeSlot = m_size;
 
         // See if the given key exists. Overwrite if so.
-        for (ListIterator<Bucket> i(m_table[idx]); i.hasCurrent(); i++)
+        for (Size i = 0; i < m_size && m_states[idx] != Empty; i++)
         {
-            if (i.current().key == key)
+            if (m_states[idx] == Used && m_buckets[idx].key == key)
             {
-                i.current().value = value;
+                m_buckets[idx].value = value;
                 return true;
             }
+            else if (m_states[idx] == Removed && freeSlot == m_size)
+            {
+                freeSlot = idx;
+            }
+            idx = (idx + 1) % m_size;
         }
 
-        // Key does not exist. Append it.
-        m_table[idx].append(Bucket(key, value));
-        m_count++;
-        return true;
+        // Key does not exist. Reuse a removed slot or take the empty slot.
+        if (freeSlot != m_size)
+        {
+            store(freeSlot, key, value);
+            return true;
+        }
+        return append(key, value);
     }
 
     /**
@@ -161,10 +221,21 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual bool append(const K & key, const V & value)
     {
+        reserve();
 
-        // Always append
-        m_table[hash(key, m_table.size())].append(Bucket(key, value));
-        m_count++;
+        Size idx = hash(key, m_size);
+        Size freeSlot = m_size;
+
+        // Always append, after any existing value for the same key
+        for (; m_states[idx] != Empty; idx = (idx + 1) % m_size)
+        {
+            if (m_states[idx] == Used && m_buckets[idx].key == key)
+                freeSlot = m_size;
+            else if (m_states[idx] == Removed && freeSlot == m_size)
+                freeSlot = idx;
+        }
+
+        store(freeSlot != m_size ? freeSlot : idx, key, value);
         return true;
     }
 
@@ -177,22 +248,35 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual int remove(const K & key)
     {
+        Size idx = hash(key, m_size);
         int removed = 0;
 
-        for (ListIterator<Bucket> i(m_table[hash(key, m_table.size())]); i.hasCurrent(); )
+        for (Size i = 0; i < m_size && m_states[idx] != Empty; i++)
         {
-            if (i.current().key == key)
+            if (m_states[idx] == Used && m_buckets[idx].key == key)
             {
-                i.remove();
+                m_states[idx] = Removed;
                 m_count--;
+                m_removed++;
                 removed++;
             }
-            else
-                i++;
+            idx = (idx + 1) % m_size;
         }
         return removed;
     }
 
+    /**
+     * Removes all items from the HashTable.
+     */
+    virtual void clear()
+    {
+        for (Size i = 0; i < m_size; i++)
+            m_states[i] = Empty;
+
+        m_count = 0;
+        m_removed = 0;
+    }
+
     /**
      * Get the size of the HashTable.
      *
@@ -200,7 +284,7 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual Size size() const
     {
-        return m_table.size();
+        return m_size;
     }
 
     /**
@@ -222,10 +306,10 @@ template <class K, class V> class HashTable : public Associative<K,V>
     {
         List<K> lst;
 
-        for (Size i = 0; i < m_table.count(); i++)
-            for (ListIterator<Bucket> j(m_table[i]); j.hasCurrent(); j++)
-                if (!lst.contains(j.current().key))
-                    lst << j.current().key;
+        // Only add a key at the slot holding its first value
+        for (Size i = 0; i < m_size; i++)
+            if (m_states[i] == Used && find(m_buckets[i].key) == i)
+                lst << m_buckets[i].key;
 
         return lst;
     }
@@ -237,10 +321,23 @@ template <class K, class V> class HashTable : public Associative<K,V>
     {
         List<K> lst;
 
-        for (Size i = 0; i < m_table.count(); i++)
-            for (ListIterator<Bucket> j(m_table[i]); j.hasCurrent(); j++)
-                if (j.current().value == value && !lst.contains(j.current().key))
-                    lst << j.current().key;
+        for (Size i = 0; i < m_size; i++)
+        {
+            if (m_states[i] != Used || !(m_buckets[i].value == value))
+                continue;
+
+            // Skip keys which have the same value in an earlier slot
+            Size idx = hash(m_buckets[i].key, m_size);
+            while (idx != i && !(m_states[idx] == Used &&
+                                 m_buckets[idx].key == m_buckets[i].key &&
+                                 m_buckets[idx].value == value))
+            {
+                idx = (idx + 1) % m_size;
+            }
+
+            if (idx == i)
+                lst << m_buckets[i].key;
+        }
 
         return lst;
     }
@@ -254,9 +351,9 @@ template <class K, class V> class HashTable : public Associative<K,V>
     {
         List<V> lst;
 
-        for (Size i = 0; i < m_table.count(); i++)
-            for (ListIterator<Bucket> j(m_table[i]); j.hasCurrent(); j++)
-                lst << j.current().value;
+        for (Size i = 0; i < m_size; i++)
+            if (m_states[i] == Used)
+                lst << m_buckets[i].value;
 
         return lst;
     }
@@ -269,14 +366,29 @@ template <class K, class V> class HashTable : public Associative<K,V>
     virtual List<V> values(const K & key) const
     {
         List<V> lst;
+        Size idx = hash(key, m_size);
+
+        for (Size i = 0; i < m_size && m_states[idx] != Empty; i++)
+        {
+            if (m_states[idx] == Used && m_buckets[idx].key == key)
+                lst << m_buckets[idx].value;
 
-        for (ListIterator<Bucket> i(m_table[hash(key, m_table.size())]); i.hasCurrent(); i++)
-            if (i.current().key == key)
-                lst << i.current().value;
+            idx = (idx + 1) % m_size;
+        }
 
         return lst;
     }
 
+    /**
+     * Check if the given key exists.
+     *
+     * @return True if exists, false otherwise.
+     */
+    virtual bool contains(const K & key) const
+    {
+        return find(key) != m_size;
+    }
+
     /**
      * Returns the first value for the given key.
      *
@@ -286,13 +398,9 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual const V * get(const K & key) const
     {
-        const List<Bucket> & lst = m_table[hash(key, m_table.size())];
-
-        for (ListIterator<Bucket> i(lst); i.hasCurrent(); i++)
-            if (i.current().key == key)
-                return &i.current().value;
+        const Size idx = find(key);
 
-        return ZERO;
+        return idx != m_size ? &m_buckets[idx].value : ZERO;
     }
 
     /**
@@ -306,13 +414,9 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual const V & at(const K & key) const
     {
-        const List<Bucket> & lst = m_table[hash(key, m_table.size())];
+        const Size idx = find(key);
 
-        for (ListIterator<Bucket> i(lst); i.hasCurrent(); i++)
-            if (i.current().key == key)
-                return i.current().value;
-
-        return m_table[0].head()->data.value;
+        return m_buckets[idx != m_size ? idx : 0].value;
     }
 
     /**
@@ -324,48 +428,158 @@ template <class K, class V> class HashTable : public Associative<K,V>
      */
     virtual const V value(const K & key, const V defaultValue = V()) const
     {
-        const List<Bucket> & lst = m_table[hash(key, m_table.size())];
+        const Size idx = find(key);
 
-        for (ListIterator<Bucket> i(lst); i.hasCurrent(); i++)
-            if (i.current().key == key)
-                return i.current().value;
+        return idx != m_size ? m_buckets[idx].value : defaultValue;
+    }
 
-        return defaultValue;
+    /**
+     * Modifiable index operator.
+     */
+    V & operator[](const K & key)
+    {
+        return (V &) at(key);
     }
 
     /**
-     * Get the internal Vector with Buckets.
+     * Constant index operator.
+     */
+    const V & operator[](const K & key) const
+    {
+        return (const V &) at(key);
+    }
+
+  private:
+
+    /**
+     * Find the slot with the first value for the given key.
+     *
+     * @param key Key to find.
      *
-     * @return Reference to the Vector with Buckets.
+     * @return Slot index or the table size if not found.
      */
-    Vector<List<Bucket> > & table()
+    Size find(const K & key) const
     {
-        return m_table;
+        Size idx = hash(key, m_size);
+
+        for (Size i = 0; i < m_size && m_states[idx] != Empty; i++)
+        {
+            if (m_states[idx] == Used && m_buckets[idx].key == key)
+                return idx;
+
+            idx = (idx + 1) % m_size;
+        }
+        return m_size;
     }
 
     /**
-     * Modifiable index operator.
+     * Fill a free slot.
+     *
+     * @param idx Slot index.
+     * @param key Key of the item.
+     * @param value Value of the item.
      */
-    V & operator[](const K & key)
+    void store(const Size idx, const K & key, const V & value)
     {
-        return (V &) at(key);
+        if (m_states[idx] == Removed)
+            m_removed--;
+
+        m_buckets[idx].key   = key;
+        m_buckets[idx].value = value;
+        m_states[idx] = Used;
+        m_count++;
     }
 
     /**
-     * Constant index operator.
+     * Make room for one more item.
+     *
+     * Rebuilds the table when the load factor would be exceeded, which
+     * also drops all removed slots. The table doubles in size if it is
+     * more than half full with items.
      */
-    const V & operator[](const K & key) const
+    void reserve()
     {
-        return (const V &) at(key);
+        if ((m_count + m_removed + 1) * 100 <= m_size * HASHTABLE_LOAD_FACTOR)
+            return;
+
+        const Size oldSize = m_size;
+        Bucket *oldBuckets = m_buckets;
+        u8 *oldStates = m_states;
+        Size start = 0;
+
+        // Start at an empty slot, to keep the values of a key in order
+        while (oldStates[start] != Empty)
+            start++;
+
+        allocate((m_count + 1) * 2 > oldSize ? oldSize * 2 : oldSize);
+
+        for (Size i = 0; i < oldSize; i++)
+        {
+            const Size idx = (start + i) % oldSize;
+
+            if (oldStates[idx] == Used)
+                append(oldBuckets[idx].key, oldBuckets[idx].value);
+        }
+
+        delete[] oldBuckets;
+        delete[] oldStates;
+    }
+
+    /**
+     * Allocate an empty table.
+     *
+     * @param size Number of slots.
+     */
+    void allocate(const Size size)
+    {
+        m_size    = size;
+        m_count   = 0;
+        m_removed = 0;
+        m_buckets = new Bucket[size];
+        assert(m_buckets != NULL);
+        m_states  = new u8[size];
+        assert(m_states != NULL);
+
+        for (Size i = 0; i < size; i++)
+            m_states[i] = Empty;
+    }
+
+    /**
+     * Copy all items from another HashTable with the same size.
+     *
+     * @param table HashTable to copy.
+     */
+    void copy(const HashTable<K,V> & table)
+    {
+        for (Size i = 0; i < m_size; i++)
+        {
+            m_states[i] = table.m_states[i];
+            if (m_states[i] == Used)
+            {
+                m_buckets[i].key   = table.m_buckets[i].key;
+                m_buckets[i].value = table.m_buckets[i].value;
+            }
+        }
+        m_count   = table.m_count;
+        m_removed = table.m_removed;
     }
 
   private:
 
-    /** Internal table. */
-    Vector<List<Bucket> > m_table;
+    /** Table of buckets. */
+    Bucket *m_buckets;
+
+    /** State of each bucket. */
+    u8 *m_states;
+
+    /** Number of buckets in the table. */
+    Size m_size;
 
     /** Number of values in the buckets. */
     Size m_count;
+
+    /** Number of removed buckets which are not yet reused. */
+    Size m_removed;
 };
 
 /**
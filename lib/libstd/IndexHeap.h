@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBSTD_INDEXHEAP_H
+#define __LIBSTD_INDEXHEAP_H
+
+#include "Assert.h"
+#include "Types.h"
+#include "Macros.h"
+#include "Container.h"
+
+/**
+ * @addtogroup lib
+ * @{
+ *
+ * @addtogroup libstd
+ * @{
+ */
+
+/**
+ * Binary min-heap of N-sized index numbers ordered by a key of type K.
+ *
+ * Each index number in the range 0 to N-1 can be stored at most once.
+ * The IndexHeap remembers the heap position of every stored index, such that
+ * the index with the smallest key can be retrieved in constant time and any
+ * index can be inserted or removed in logarithmic time.
+ */
+template <class K, const Size N> class IndexHeap : public Container
+{
+  private:
+
+    /** Marks an index which is not stored in the heap */
+    static const Size Unused = (Size) -1;
+
+  public:
+
+    /**
+     * Constructor.
+     */
+    IndexHeap()
+    {
+        for (Size i = 0; i < N; i++)
+        {
+            m_position[i] = Unused;
+        }
+
+        m_count = 0;
+    }
+
+    /**
+     * Insert an index with the given key.
+     *
+     * @param index Index number to insert
+     * @param key Key used for ordering the index
+     *
+     * @return True on success, false if the index is out of range or already stored.
+     */
+    bool insert(const Size index, const K & key)
+    {
+        if (index >= N || m_position[index] != Unused)
+        {
+            return false;
+        }
+
+        assert(m_count < N);
+
+        m_heap[m_count] = index;
+        m_key[index] = key;
+        m_position[index] = m_count;
+        siftUp(m_count++);
+
+        return true;
+    }
+
+    /**
+     * Remove an index.
+     *
+     * @param index Index number to remove
+     *
+     * @return True if removed, false if the index was not stored.
+     */
+    bool remove(const Size index)
+    {
+        if (!contains(index))
+        {
+            return false;
+        }
+
+        const Size pos = m_position[index];
+        m_position[index] = Unused;
+        m_count--;
+
+        // Move the last index into the empty slot and restore the heap order
+        if (pos != m_count)
+        {
+            const Size moved = m_heap[m_count];
+
+            m_heap[pos] = moved;
+            m_position[moved] = pos;
+            siftUp(pos);
+
+            if (m_position[moved] == pos)
+                siftDown(pos);
+        }
+
+        return true;
+    }
+
+    /**
+     * Check if an index is stored.
+     *
+     * @param index Index number to look for
+     *
+     * @return True if stored, false otherwise.
+     */
+    bool contains(const Size index) const
+    {
+        return index < N && m_position[index] != Unused;
+    }
+
+    /**
+     * Get the index with the smallest key.
+     *
+     * @return Index number
+     *
+     * @note Do not call this function if the IndexHeap is empty
+     */
+    Size top() const
+    {
+        assert(m_count > 0);
+        return m_heap[0];
+    }
+
+    /**
+     * Get the smallest key.
+     *
+     * @return Key reference
+     *
+     * @note Do not call this function if the IndexHeap is empty
+     */
+    const K & topKey() const
+    {
+        assert(m_count > 0);
+        return m_key[m_heap[0]];
+    }
+
+    /**
+     * Remove the index with the smallest key.
+     *
+     * @return Index number which was removed
+     *
+     * @note Do not call this function if the IndexHeap is empty
+     */
+    Size pop()
+    {
+        const Size index = top();
+        remove(index);
+        return index;
+    }
+
+    /**
+     * Get the key of a stored index.
+     *
+     * @param index Index number
+     *
+     * @return Key reference
+     *
+     * @note The index must be stored in the IndexHeap
+     */
+    const K & key(const Size index) const
+    {
+        assert(contains(index));
+        return m_key[index];
+    }
+
+    /**
+     * Removes all items from the IndexHeap.
+     */
+    virtual void clear()
+    {
+        for (Size i = 0; i < m_count; i++)
+        {
+            m_position[m_heap[i]] = Unused;
+        }
+
+        m_count = 0;
+    }
+
+    /**
+     * Returns the maximum size of this IndexHeap.
+     *
+     * @return size The maximum size of the IndexHeap.
+     */
+    virtual Size size() const
+    {
+        return N;
+    }
+
+    /**
+     * Returns the number of items in the IndexHeap.
+     *
+     * @return Number of items in the IndexHeap.
+     */
+    virtual Size count() const
+    {
+        return m_count;
+    }
+
+  private:
+
+    /**
+     * Move the item at the given heap position towards the root.
+     *
+     * @param pos Heap position of the item
+     */
+    void siftUp(Size pos)
+    {
+        const Size index = m_heap[pos];
+
+        while (pos > 0)
+        {
+            const Size parent = (pos - 1) / 2;
+
+            if (!(m_key[index] < m_key[m_heap[parent]]))
+                break;
+
+            m_heap[pos] = m_heap[parent];
+            m_position[m_heap[pos]] = pos;
+            pos = parent;
+        }
+
+        m_heap[pos] = index;
+        m_position[index] = pos;
+    }
+
+    /**
+     * Move the item at the given heap position towards the leaves.
+     *
+     * @param pos Heap position of the item
+     */
+    void siftDown(Size pos)
+    {
+        const Size index = m_heap[pos];
+
+        for (;;)
+        {
+            Size child = (pos * 2) + 1;
+
+            if (child >= m_count)
+                break;
+
+            if (child + 1 < m_count && m_key[m_heap[child + 1]] < m_key[m_heap[child]])
+                child++;
+
+            if (!(m_key[m_heap[child]] < m_key[index]))
+                break;
+
+            m_heap[pos] = m_heap[child];
+            m_position[m_heap[pos]] = pos;
+            pos = child;
+        }
+
+        m_heap[pos] = index;
+        m_position[index] = pos;
+    }
+
+  private:
+
+    /** Index numbers in heap order */
+    Size m_heap[N];
+
+    /** Key for each index number */
+    K m_key[N];
+
+    /** Heap position for each index number, or Unused */
+    Size m_position[N];
+
+    /** Number of items in the heap */
+    Size m_count;
+};
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __LIBSTD_INDEXHEAP_H */
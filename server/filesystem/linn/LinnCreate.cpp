@@ -27,6 +27,7 @@
 #include "LinnGroup.h"
 #include "LinnInode.h"
 #include "LinnDirectoryEntry.h"
+#include "LinnDirectoryIndex.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <dirent.h>
@@ -38,6 +39,7 @@
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 
 LinnCreate::LinnCreate()
 {
@@ -46,6 +48,19 @@ LinnCreate::LinnCreate()
     super     = ZERO;
     input     = ZERO;
     verbose   = false;
+    extents   = true;
+    update    = false;
+    timing    = false;
+    threads   = sysconf(_SC_NPROCESSORS_ONLN) > 0 ? sysconf(_SC_NPROCESSORS_ONLN) : 1;
+    buildTime = ZERO;
+    blocks    = ZERO;
+    dataBlocks = ZERO;
+    output    = ZERO;
+    copySince = ZERO;
+    nextFile  = ZERO;
+    copiedFiles = ZERO;
+    copyFailed  = false;
+    pthread_mutex_init(&copyLock, ZERO);
 }
 
 LinnInode * LinnCreate::createInode(le32 inodeNum, FileSystem::FileType type,
@@ -70,7 +85,7 @@ LinnInode * LinnCreate::createInode(le32 inodeNum, FileSystem::FileType type,
     inode->gid   = gid;
     inode->size  = ZERO;
     inode->accessTime = ZERO;
-    inode->createTime = time(ZERO);
+    inode->createTime = buildTime;
     inode->modifyTime = inode->createTime;
     inode->changeTime = inode->createTime;
     inode->links = 1;
@@ -88,6 +103,19 @@ LinnInode * LinnCreate::createInode(le32 inodeNum, FileSystem::FileType type,
     return inode;
 }
 
+LinnInode * LinnCreate::getInode(le32 inodeNum)
+{
+    LinnGroup *group;
+
+    // Point to the correct group
+    group  = BLOCKPTR(LinnGroup, super->groupsTable);
+    group += inodeNum / super->inodesPerGroup;
+
+    // Use it to find the inode
+    return BLOCKPTR(LinnInode, group->inodeTable) +
+                   (inodeNum % super->inodesPerGroup);
+}
+
 le32 LinnCreate::createInode(char *inputFile, struct stat *st)
 {
     LinnGroup *group;
@@ -123,6 +151,7 @@ le32 LinnCreate::createInode(char *inputFile, struct stat *st)
     inodeMap.setArray(BLOCKPTR(u8, group->inodeMap),
                     super->inodesPerGroup);
     inodeMap.setNext(&in);
+    in += gn * super->inodesPerGroup;
 
     // Instantiate the inode
     inode = createInode(in, FILETYPE_FROM_ST(st),
@@ -131,7 +160,7 @@ le32 LinnCreate::createInode(char *inputFile, struct stat *st)
     // Insert file contents
     if (S_ISREG(st->st_mode))
     {
-        insertFile(inputFile, inode, st);
+        insertFile(inputFile, in, inode, st);
     }
 
     // Debug out
@@ -142,6 +171,157 @@ le32 LinnCreate::createInode(char *inputFile, struct stat *st)
     return in;
 }
 
+LinnExtent * LinnCreate::getExtent(LinnInode *inode, Size extentNum, bool allocate)
+{
+    le32 *next = &inode->block[LINN_INODE_EXTENT_BLOCK];
+    LinnExtent *extent;
+
+    // Extent inside the inode
+    if (extentNum < LINN_INODE_EXTENTS)
+    {
+        return ((LinnExtent *) inode->block) + extentNum;
+    }
+    extentNum -= LINN_INODE_EXTENTS;
+
+    // Follow the chain of extent blocks
+    while (true)
+    {
+        if (!*next)
+        {
+            if (!allocate)
+                return ZERO;
+
+            *next = BLOCK(super);
+        }
+        extent = BLOCKPTR(LinnExtent, *next);
+
+        if (extentNum < LINN_EXTENTS_PER_BLOCK(super))
+            return extent + extentNum;
+
+        extentNum -= LINN_EXTENTS_PER_BLOCK(super);
+        next = &extent[LINN_EXTENTS_PER_BLOCK(super)].start;
+    }
+}
+
+bool LinnCreate::insertBlock(LinnInode *inode, le32 blockIndex, le32 blockValue)
+{
+    LinnExtent *extent, *last = ZERO;
+    le32 count = 0;
+
+    // Extend the last extent or append a new one
+    if (extents)
+    {
+        for (Size i = 0; (extent = getExtent(inode, i, false)) && extent->length; i++)
+        {
+            count += extent->length;
+            last   = extent;
+        }
+        assert(blockIndex == count);
+
+        if (last && last->start + last->length == blockValue)
+        {
+            last->length++;
+        }
+        else
+        {
+            for (Size i = 0; ; i++)
+            {
+                if (!(extent = getExtent(inode, i, true))->length)
+                    break;
+            }
+            extent->start  = blockValue;
+            extent->length = 1;
+        }
+        return true;
+    }
+    // Insert the block (direct)
+    else if (blockIndex < LINN_INODE_DIR_BLOCKS)
+    {
+        inode->block[blockIndex] = blockValue;
+    }
+    // Insert the block (indirect)
+    else if (blockIndex < LINN_INODE_DIR_BLOCKS + LINN_SUPER_NUM_PTRS(super))
+    {
+        insertIndirect(&inode->block[LINN_INODE_IND_BLOCKS-1],
+                        blockIndex - LINN_INODE_DIR_BLOCKS, blockValue, 1);
+    }
+    // Insert the block (double indirect)
+    else if (blockIndex < LINN_INODE_DIR_BLOCKS + (LINN_SUPER_NUM_PTRS(super) *
+                                                   LINN_SUPER_NUM_PTRS(super)))
+    {
+        insertIndirect(&inode->block[LINN_INODE_DIND_BLOCKS-1],
+                        blockIndex - LINN_INODE_DIR_BLOCKS, blockValue, 2);
+    }
+    // Insert the block (triple indirect)
+    else if (blockIndex < LINN_INODE_DIR_BLOCKS + (LINN_SUPER_NUM_PTRS(super) *
+                                                   LINN_SUPER_NUM_PTRS(super) *
+                                                   LINN_SUPER_NUM_PTRS(super)))
+    {
+        insertIndirect(&inode->block[LINN_INODE_TIND_BLOCKS-1],
+                        blockIndex - LINN_INODE_DIR_BLOCKS, blockValue, 3);
+    }
+    // Maximum file capacity reached
+    else
+        return false;
+
+    return true;
+}
+
+le32 LinnCreate::getBlock(LinnInode *inode, le32 blockIndex)
+{
+    const Size numPerBlock = LINN_SUPER_NUM_PTRS(super);
+    const le32 blockNumber = blockIndex - LINN_INODE_DIR_BLOCKS;
+    Size depth, remain;
+    le32 block, *map;
+    LinnExtent *extent;
+
+    // Find the extent containing the block
+    if (extents)
+    {
+        for (Size i = 0; (extent = getExtent(inode, i, false)) && extent->length; i++)
+        {
+            if (blockIndex < extent->length)
+                return extent->start + blockIndex;
+
+            blockIndex -= extent->length;
+        }
+        return ZERO;
+    }
+    // Direct blocks
+    if (blockIndex < LINN_INODE_DIR_BLOCKS)
+    {
+        return inode->block[blockIndex];
+    }
+    // Level of indirection
+    if (blockNumber < numPerBlock)
+        depth = 1;
+    else if (blockNumber < numPerBlock * numPerBlock)
+        depth = 2;
+    else
+        depth = 3;
+
+    // Walk the block maps, in the same way as insertIndirect()
+    block = inode->block[LINN_INODE_DIR_BLOCKS + depth - 1];
+
+    for (; block && depth > 1; depth--)
+    {
+        remain = 1;
+
+        for (Size i = 0; i < depth - 1; i++)
+        {
+            remain *= numPerBlock;
+        }
+        map   = BLOCKPTR(le32, block);
+        block = map[blockNumber / remain];
+    }
+    if (!block)
+    {
+        return ZERO;
+    }
+    map = BLOCKPTR(le32, block);
+    return map[blockNumber % numPerBlock];
+}
+
 void LinnCreate::insertIndirect(le32 *ptr, le32 blockNumber,
                                 le32 blockValue, Size depth)
 {
@@ -175,133 +355,122 @@ void LinnCreate::insertIndirect(le32 *ptr, le32 blockNumber,
     }
 }
 
-void LinnCreate::insertFile(char *inputFile, LinnInode *inode,
-                            struct stat *st)
+void LinnCreate::insertFile(char *inputFile, le32 inodeNum,
+                            LinnInode *inode, struct stat *st)
 {
-    int fd, bytes;
-    le32 blockNr;
+    const Size count = (st->st_size + super->blockSize - 1) / super->blockSize;
+    FileJob *job = new FileJob;
+    le32 first = ZERO;
 
-    // Open the local file
-    if ((fd = open(inputFile, O_RDONLY)) < 0)
+    // Reserve all blocks at once, such that the contents are contiguous
+    if (extents && count > 0)
     {
-        printf("%s: failed to fopen() `%s': %s\n",
-                prog, inputFile, strerror(errno));
-        exit(EXIT_FAILURE);
+        first = BLOCKS(super, count);
     }
 
-    // Read blocks from the file
-    while (true)
+    for (Size i = 0; i < count; i++)
     {
-        // Grab a block
-        blockNr = BLOCK(super);
+        const le32 blockNr = extents ? first + i : BLOCK(super);
 
-        // Read a block
-        if ((bytes = read(fd, BLOCKPTR(u8, blockNr), super->blockSize)) < 0)
-        {
-            printf("%s: failed to read() `%s': %s\n",
-                    prog, inputFile, strerror(errno));
-            exit(EXIT_FAILURE);
-        }
-
-        // End of file?
-        if (!bytes) break;
-
-        // Insert the block (direct)
-        if (LINN_INODE_NUM_BLOCKS(super, inode) <
-            LINN_INODE_DIR_BLOCKS)
-        {
-            inode->block[LINN_INODE_NUM_BLOCKS(super,inode)] = blockNr;
-        }
-        // Insert the block (indirect)
-        else if (LINN_INODE_NUM_BLOCKS(super, inode) <
-                 LINN_INODE_DIR_BLOCKS + LINN_SUPER_NUM_PTRS(super))
-        {
-            insertIndirect(&inode->block[LINN_INODE_IND_BLOCKS-1],
-                            LINN_INODE_NUM_BLOCKS(super, inode) -
-                            LINN_INODE_DIR_BLOCKS, blockNr, 1);
-        }
-        // Insert the block (double indirect)
-        else if (LINN_INODE_NUM_BLOCKS(super, inode) <
-                 LINN_INODE_DIR_BLOCKS + (LINN_SUPER_NUM_PTRS(super) *
-                                          LINN_SUPER_NUM_PTRS(super)))
-        {
-            insertIndirect(&inode->block[LINN_INODE_DIND_BLOCKS-1],
-                            LINN_INODE_NUM_BLOCKS(super, inode) -
-                            LINN_INODE_DIR_BLOCKS, blockNr, 2);
-        }
-        // Insert the blck (triple indirect)
-        else if (LINN_INODE_NUM_BLOCKS(super, inode) <
-                 LINN_INODE_DIR_BLOCKS + (LINN_SUPER_NUM_PTRS(super) *
-                                          LINN_SUPER_NUM_PTRS(super) *
-                                          LINN_SUPER_NUM_PTRS(super)))
-        {
-            insertIndirect(&inode->block[LINN_INODE_TIND_BLOCKS-1],
-                            LINN_INODE_NUM_BLOCKS(super, inode) -
-                            LINN_INODE_DIR_BLOCKS, blockNr, 3);
-        }
-        // Maximum file capacity reached
-        else
+        if (!insertBlock(inode, i, blockNr))
         {
             printf("%s: maximum file size reached for `%s'\n",
                     prog, inputFile);
-            break;
+            exit(EXIT_FAILURE);
         }
-        // Increment size appropriately
-        inode->size += bytes;
+        dataBlocks->set(blockNr);
     }
-    // Cleanup
-    close(fd);
+    inode->size = st->st_size;
+
+    // The contents are copied by writeImage()
+    job->path     = strdup(inputFile);
+    job->inode    = inodeNum;
+    job->size     = st->st_size;
+    job->modified = st->st_mtime > st->st_ctime ? st->st_mtime : st->st_ctime;
+    files.insert(job);
 }
 
 void LinnCreate::insertEntry(le32 dirInode, le32 entryInode,
                              const char *name, FileSystem::FileType type)
 {
-    LinnGroup *group;
-    LinnInode *inode;
+    LinnInode *inode = getInode(dirInode);
     LinnDirectoryEntry *entry;
     le32 entryNum, blockNum;
 
-    // Point to the correct group
-    group = BLOCKPTR(LinnGroup, super->groupsTable);
-    if (dirInode != ZERO)
+    // Calculate entry and block number
+    entryNum = inode->size / sizeof(LinnDirectoryEntry);
+    blockNum = entryNum / LINN_DIRENT_PER_BLOCK(super);
+
+    // Allocate a new block, if needed
+    if (entryNum % LINN_DIRENT_PER_BLOCK(super) == 0 &&
+        !insertBlock(inode, blockNum, BLOCK(super)))
     {
-        group += (dirInode / super->inodesPerGroup);
+        printf("%s: maximum directory size reached for `%s'\n",
+                prog, name);
+        exit(EXIT_FAILURE);
     }
-    // Fetch inode
-    inode = BLOCKPTR(LinnInode, group->inodeTable) +
-                    (dirInode % super->inodesPerGroup);
+    // Point to the fresh entry
+    entry = BLOCKPTR(LinnDirectoryEntry, getBlock(inode, blockNum)) +
+                    (entryNum % LINN_DIRENT_PER_BLOCK(super));
+    // Fill it
+    entry->inode = entryInode;
+    entry->type  = type;
+    strncpy(entry->name, name, LINN_DIRENT_NAME_LEN);
+    entry->name[LINN_DIRENT_NAME_LEN - 1] = ZERO;
 
-    // Calculate entry and block number
-    entryNum = inode->size / sizeof(LinnDirectoryEntry);
-    blockNum = (entryNum * sizeof(LinnDirectoryEntry)) /
-                super->blockSize;
+    // Increment directory size
+    inode->size += sizeof(LinnDirectoryEntry);
+}
 
-    // Direct block
-    if (blockNum < LINN_INODE_DIR_BLOCKS)
+void LinnCreate::insertIndex(le32 dirInode)
+{
+    LinnInode *inode = getInode(dirInode);
+    const u32 entries = inode->size / sizeof(LinnDirectoryEntry);
+    const u32 buckets = linnDirectoryIndexBuckets(entries);
+    const Size indexSize = sizeof(LinnDirectoryIndex) + (buckets * sizeof(le32));
+    const Size indexBlocks = (indexSize + super->blockSize - 1) / super->blockSize;
+    const le32 firstBlock = LINN_INODE_NUM_BLOCKS(super, inode);
+    LinnDirectoryIndex *index;
+    le32 *bucket, blockNr;
+    u8 *buffer;
+
+    // Prepare the index in a separate buffer first
+    buffer = new u8[indexBlocks * super->blockSize];
+    memset(buffer, 0, indexBlocks * super->blockSize);
+    index  = (LinnDirectoryIndex *) buffer;
+    bucket = (le32 *) (index + 1);
+    index->magic   = LINN_DIRINDEX_MAGIC;
+    index->buckets = buckets;
+
+    // Place each entry in the first free bucket from its hash
+    for (u32 i = 0; i < entries; i++)
     {
-        // Allocate a new block, if needed
-        if (!inode->block[blockNum])
+        const LinnDirectoryEntry *entry =
+            BLOCKPTR(LinnDirectoryEntry, getBlock(inode, i / LINN_DIRENT_PER_BLOCK(super))) +
+                    (i % LINN_DIRENT_PER_BLOCK(super));
+        u32 b = linnDirectoryHash(entry->name) & (buckets - 1);
+
+        while (bucket[b] != LINN_DIRINDEX_EMPTY)
         {
-            inode->block[blockNum] = BLOCK(super);
+            b = (b + 1) & (buckets - 1);
         }
-        // Point to the fresh entry
-        entry = BLOCKPTR(LinnDirectoryEntry, inode->block[blockNum]) +
-                        (entryNum % super->blockSize);
-        // Fill it
-        entry->inode = entryInode;
-        entry->type  = type;
-        strncpy(entry->name, name, LINN_DIRENT_NAME_LEN);
-        entry->name[LINN_DIRENT_NAME_LEN - 1] = ZERO;
-    }
-    // Indirect block
-    else
+        bucket[b] = i + 1;
+    }
+
+    // The index follows the entries, beyond the size of the directory
+    for (Size i = 0; i < indexBlocks; i++)
     {
-        printf("%s: indirect blocks not (yet) supported for directories\n",
-                prog);
-        exit(EXIT_FAILURE);
+        blockNr = BLOCK(super);
+
+        if (!insertBlock(inode, firstBlock + i, blockNr))
+        {
+            printf("%s: maximum directory size reached for index of inode %u\n",
+                    prog, dirInode);
+            exit(EXIT_FAILURE);
+        }
+        memcpy(BLOCKPTR(u8, blockNr), buffer + (i * super->blockSize), super->blockSize);
     }
-    // Increment directory size
-    inode->size += sizeof(LinnDirectoryEntry);
+    delete[] buffer;
 }
 
 void LinnCreate::insertDirectory(char *inputDir, le32 inodeNum, le32 parentNum)
@@ -370,21 +539,41 @@ void LinnCreate::insertDirectory(char *inputDir, le32 inodeNum, le32 parentNum)
     }
     // All done
     closedir(dir);
+
+    // Allow lookups without scanning all entries
+    insertIndex(inodeNum);
 }
 
 int LinnCreate::create(Size blockSize, Size blockNum, Size inodeNum)
 {
     LinnGroup *group;
     BitArray map(128);
+    struct timeval start;
 
     assert(image != ZERO);
     assert(prog  != ZERO);
     assert(blockNum >= 2);
     assert(inodeNum > 0);
 
-    // Allocate blocks
-    blocks = new u8[blockSize * blockNum];
-    memset(blocks, 0, blockSize * blockNum);
+    gettimeofday(&start, ZERO);
+
+    // Keep the timestamps of an existing image, such
+    // that an unchanged layout results in the same blocks
+    if (!update || !(buildTime = readCreationTime()))
+    {
+        buildTime = time(ZERO);
+    }
+
+    // Allocate blocks, which are zeroed on first use
+    blocks = (u8 *) mmap(ZERO, blockSize * blockNum, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (blocks == MAP_FAILED)
+    {
+        printf("%s: failed to mmap() %lu blocks: %s\n",
+                prog, (ulong) blockNum, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    dataBlocks = new BitArray(blockNum);
 
     // Create a superblock
     super = (LinnSuperBlock *) (blocks + LINN_SUPER_OFFSET);
@@ -392,7 +581,7 @@ int LinnCreate::create(Size blockSize, Size blockNum, Size inodeNum)
     super->magic1 = LINN_SUPER_MAGIC1;
     super->majorRevision    = LINN_SUPER_MAJOR;
     super->minorRevision    = LINN_SUPER_MINOR;
-    super->state            = LINN_SUPER_VALID;
+    super->state            = LINN_SUPER_UNCLEAN;
     super->blockSize        = blockSize;
     super->blocksPerGroup   = LINN_CREATE_BLOCKS_PER_GROUP;
     super->inodesCount      = inodeNum;
@@ -400,11 +589,12 @@ int LinnCreate::create(Size blockSize, Size blockNum, Size inodeNum)
     super->inodesPerGroup   = super->inodesCount / LINN_GROUP_COUNT(super);
     super->freeInodesCount  = super->inodesCount;
     super->freeBlocksCount  = blockNum - 3;
-    super->creationTime     = time(ZERO);
+    super->creationTime     = buildTime;
     super->mountTime            = ZERO;
     super->mountCount            = ZERO;
     super->lastCheck            = ZERO;
     super->groupsTable            = 2;
+    super->features         = extents ? LINN_SUPER_FEATURE_EXTENTS : 0;
 
     // Allocate LinnGroups
     for (Size i = 0; i < LINN_GROUP_COUNT(super); i++)
@@ -443,36 +633,270 @@ int LinnCreate::create(Size blockSize, Size blockNum, Size inodeNum)
                    super->blocksPerGroup);
         map.set(block % super->blocksPerGroup);
     }
+    printTime("layout", &start);
+
     // Write the final image
     return writeImage();
 }
 
 int LinnCreate::writeImage()
 {
-    FILE *fp;
+    const Size used = super->blocksCount - super->freeBlocksCount;
+    const Size size = used * super->blockSize;
+    struct timeval start;
+    struct stat st;
+    LinnSuperBlock *written;
+    bool inPlace = false;
+    Size copied;
+    int fd = -1;
+
+    gettimeofday(&start, ZERO);
 
-    // Open output image
-    if ((fp = fopen(image, "w")) == NULL)
+    // Try to update the existing image
+    if (update && (fd = open(image, O_RDWR)) >= 0)
     {
-        printf("%s: failed to fopen() `%s' for writing: %s\r\n",
-                prog, image, strerror(errno));
-        return EXIT_FAILURE;
+        if (fstat(fd, &st) == 0 && (Size) st.st_size == size &&
+           (output = (u8 *) mmap(ZERO, size, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED, fd, 0)) != MAP_FAILED)
+        {
+            written = (LinnSuperBlock *) (output + LINN_SUPER_OFFSET);
+
+            // Only a completely written image can be updated. It stays
+            // marked unclean until all changed files are copied again.
+            if (written->state == LINN_SUPER_VALID)
+            {
+                written->state = LINN_SUPER_UNCLEAN;
+                inPlace = true;
+            }
+
+            // The layout is unchanged if all blocks except file contents are equal
+
+            for (Size i = 0; i < used && inPlace; i++)
+            {
+                if (!dataBlocks->isSet(i) &&
+                    memcmp(BLOCKPTR(u8, i), output + (i * super->blockSize), super->blockSize) != 0)
+                {
+                    inPlace = false;
+                }
+            }
+            if (!inPlace)
+            {
+                munmap(output, size);
+            }
+        }
+        if (!inPlace)
+        {
+            close(fd);
+        }
+        printTime("compare", &start);
     }
 
-    // Write all blocks at once
-    if (fwrite(blocks, super->blockSize *
-                      (super->blocksCount - super->freeBlocksCount), 1, fp) != 1)
+    // Otherwise write a new image
+    if (!inPlace)
     {
-        printf("%s: failed to fwrite() `%s': %s\r\n",
-                prog, image, strerror(errno));
-        fclose(fp);
+        if ((fd = open(image, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+        {
+            printf("%s: failed to open() `%s' for writing: %s\r\n",
+                    prog, image, strerror(errno));
+            return EXIT_FAILURE;
+        }
+        if (ftruncate(fd, size) != 0 ||
+           (output = (u8 *) mmap(ZERO, size, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED, fd, 0)) == MAP_FAILED)
+        {
+            printf("%s: failed to map `%s': %s\r\n",
+                    prog, image, strerror(errno));
+            close(fd);
+            return EXIT_FAILURE;
+        }
+        // Copy all blocks except file contents
+        for (Size i = 0; i < used; i++)
+        {
+            if (!dataBlocks->isSet(i))
+            {
+                memcpy(output + (i * super->blockSize), BLOCKPTR(u8, i), super->blockSize);
+            }
+        }
+        written = (LinnSuperBlock *) (output + LINN_SUPER_OFFSET);
+        printTime("metadata", &start);
+    }
+
+    // Copy the contents of all files, or only the changed files
+    copied = copyFiles(inPlace ? st.st_mtime : 0);
+    printTime("copy", &start);
+
+    if (verbose || timing)
+    {
+        printf("%s: %s `%s': %lu of %lu files copied\n",
+                prog, inPlace ? "updated" : "created", image,
+               (ulong) copied, (ulong) files.count());
+    }
+
+    // Mark the image valid only after all contents are written
+    if (!copyFailed && msync(output, size, MS_SYNC) == 0)
+    {
+        written->state = LINN_SUPER_VALID;
+    }
+    else
+    {
+        copyFailed = true;
+    }
+
+    // Write out the image
+    munmap(output, size);
+    close(fd);
+    printTime("write", &start);
+
+    // A partially written image cannot be used
+    if (copyFailed)
+    {
+        unlink(image);
         return EXIT_FAILURE;
     }
-    // All done
-    fclose(fp);
     return EXIT_SUCCESS;
 }
 
+u32 LinnCreate::readCreationTime()
+{
+    LinnSuperBlock old;
+    u32 creationTime = ZERO;
+    int fd;
+
+    if ((fd = open(image, O_RDONLY)) >= 0)
+    {
+        if (pread(fd, &old, sizeof(old), LINN_SUPER_OFFSET) == sizeof(old) &&
+            old.magic0 == LINN_SUPER_MAGIC0 && old.magic1 == LINN_SUPER_MAGIC1)
+        {
+            creationTime = old.creationTime;
+        }
+        close(fd);
+    }
+    return creationTime;
+}
+
+Size LinnCreate::copyFiles(time_t since)
+{
+    pthread_t tids[LINN_CREATE_MAX_THREADS];
+    Size count = 0;
+
+    copySince   = since;
+    nextFile    = 0;
+    copiedFiles = 0;
+
+    // Start the threads, and copy files with this thread too
+    while (count < threads - 1 && count < LINN_CREATE_MAX_THREADS &&
+           pthread_create(&tids[count], ZERO, copyThread, this) == 0)
+    {
+        count++;
+    }
+    copyThread(this);
+
+    for (Size i = 0; i < count; i++)
+    {
+        pthread_join(tids[i], ZERO);
+    }
+    return copiedFiles;
+}
+
+void * LinnCreate::copyThread(void *arg)
+{
+    LinnCreate *fs = (LinnCreate *) arg;
+    const FileJob *job;
+    bool success;
+
+    while (true)
+    {
+        // Take the next file
+        pthread_mutex_lock(&fs->copyLock);
+        job = fs->nextFile < fs->files.count() ? fs->files[fs->nextFile++] : ZERO;
+        pthread_mutex_unlock(&fs->copyLock);
+
+        if (!job)
+        {
+            break;
+        }
+        if (job->modified < fs->copySince)
+        {
+            continue;
+        }
+        success = fs->copyFile(job);
+
+        pthread_mutex_lock(&fs->copyLock);
+        if (success)
+            fs->copiedFiles++;
+        else
+            fs->copyFailed = true;
+        pthread_mutex_unlock(&fs->copyLock);
+    }
+    return ZERO;
+}
+
+bool LinnCreate::copyFile(const FileJob *job)
+{
+    LinnInode *inode = getInode(job->inode);
+    const Size count = (job->size + super->blockSize - 1) / super->blockSize;
+    Size run, want, done;
+    ssize_t bytes;
+    le32 first;
+    u8 *dest;
+    int fd;
+
+    // Open the local file
+    if ((fd = open(job->path, O_RDONLY)) < 0)
+    {
+        printf("%s: failed to open() `%s': %s\n",
+                prog, job->path, strerror(errno));
+        return false;
+    }
+
+    for (Size i = 0; i < count; i += run)
+    {
+        // Blocks which are contiguous in the image are read at once
+        first = getBlock(inode, i);
+
+        for (run = 1; i + run < count && getBlock(inode, i + run) == first + run; run++)
+            ;
+
+        dest = output + ((Size) first * super->blockSize);
+        want = job->size - (i * super->blockSize);
+        if (want > run * super->blockSize)
+            want = run * super->blockSize;
+
+        for (done = 0; done < want; done += bytes)
+        {
+            if ((bytes = pread(fd, dest + done, want - done, (i * super->blockSize) + done)) < 0)
+            {
+                printf("%s: failed to read() `%s': %s\n",
+                        prog, job->path, strerror(errno));
+                close(fd);
+                return false;
+            }
+            // The file has become smaller
+            else if (bytes == 0)
+                break;
+        }
+        // Clear the rest of the blocks
+        memset(dest + done, 0, (run * super->blockSize) - done);
+    }
+    // Cleanup
+    close(fd);
+    return true;
+}
+
+void LinnCreate::printTime(const char *stage, struct timeval *start)
+{
+    struct timeval now;
+
+    gettimeofday(&now, ZERO);
+
+    if (timing)
+    {
+        printf("%s: %s: %.3f seconds\n", prog, stage,
+              (now.tv_sec - start->tv_sec) + ((now.tv_usec - start->tv_usec) / 1000000.0));
+    }
+    *start = now;
+}
+
 void LinnCreate::setProgram(char *progName)
 {
     this->prog = progName;
@@ -498,89 +922,22 @@ void LinnCreate::setVerbose(bool newVerbose)
     this->verbose = newVerbose;
 }
 
-int main(int argc, char **argv)
+void LinnCreate::setExtents(bool newExtents)
 {
-    LinnCreate fs;
-    Size blockSize = LINN_CREATE_BLOCK_SIZE;
-    Size blockNum  = LINN_CREATE_BLOCK_NUM;
-    Size inodeNum  = LINN_CREATE_INODE_NUM;
-
-    // Verify command-line arguments
-    if (argc < 2)
-    {
-        printf("usage: %s IMAGE [OPTIONS...]\r\n"
-               "Creates a new Linnenbank FileSystem\r\n"
-               "\r\n"
-               " -h           Show this help message.\r\n"
-               " -v           Output verbose messages.\r\n"
-               " -d DIRECTORY Insert files from the given directory into the image\r\n"
-               " -e PATTERN   Exclude matching files from the created filesystem\r\n"
-               " -b SIZE      Specifies the blocksize in bytes.\r\n"
-               " -n COUNT     Specifies the maximum number of blocks.\r\n"
-               " -i COUNT     Specifies the number of inodes to allocate.\r\n",
-                argv[0]);
-        return EXIT_FAILURE;
-    }
-    // Process command-line arguments
-    fs.setProgram(argv[0]);
-    fs.setImage(argv[1]);
+    this->extents = newExtents;
+}
 
-    // Process command-line options
-    for (int i = 0; i < argc - 2; i++)
-    {
-        // Exclude files matching the given pattern
-        if (!strcmp(argv[i + 2], "-e") && i < argc - 3)
-        {
-            fs.setExclude(argv[i + 3]);
-            i++;
-        }
-        // Verbose output
-        else if (!strcmp(argv[i + 2], "-v"))
-        {
-            fs.setVerbose(true);
-        }
-        // Input directory
-        else if (!strcmp(argv[i + 2], "-d") && i < argc - 3)
-        {
-            fs.setInput(argv[i + 3]);
-            i++;
-        }
-        // Block size
-        else if (!strcmp(argv[i + 2], "-b") && i < argc - 3)
-        {
-            blockSize = atoi(argv[i + 3]);
-            i++;
-        }
-        // Maximum block count
-        else if (!strcmp(argv[i + 2], "-n") && i < argc - 3)
-        {
-            if ((blockNum = atoi(argv[i + 3])) < 2)
-            {
-                printf("%s: block count must be >= 2\r\n",
-                        argv[0]);
-                return EXIT_FAILURE;
-            }
-            i++;
-        }
-        // Inode count
-        else if (!strcmp(argv[i + 2], "-i") && i < argc - 3)
-        {
-            if ((inodeNum = atoi(argv[i + 3])) < 1)
-            {
-                printf("%s: inode count must be >= 1\r\n",
-                        argv[0]);
-                return EXIT_FAILURE;
-            };
-            i++;
-        }
-        // Unknown argument
-        else
-        {
-            printf("%s: unknown option `%s'\r\n",
-                    argv[0], argv[i + 2]);
-            return EXIT_FAILURE;
-        }
-    }
-    // Create a new Linnenbank FileSystem
-    return fs.create(blockSize, blockNum, inodeNum);
+void LinnCreate::setUpdate(bool newUpdate)
+{
+    this->update = newUpdate;
+}
+
+void LinnCreate::setTiming(bool newTiming)
+{
+    this->timing = newTiming;
+}
+
+void LinnCreate::setThreads(Size newThreads)
+{
+    this->threads = newThreads;
 }
@@ -20,10 +20,14 @@
 
 #include <BitArray.h>
 #include <List.h>
+#include <Vector.h>
 #include <String.h>
 #include <FileSystem.h>
 #include "LinnSuperBlock.h"
 #include "LinnInode.h"
+#include <pthread.h>
+#include <time.h>
+#include <sys/time.h>
 
 /**
  * @addtogroup server
@@ -51,6 +55,9 @@
 /** Default number of inodes per group descriptor. */
 #define LINN_CREATE_INODES_PER_GROUP    1024
 
+/** Maximum number of threads copying file contents. */
+#define LINN_CREATE_MAX_THREADS         32
+
 /**
  * @brief Returns a pointer to the correct in-memory block.
  *
@@ -95,6 +102,20 @@
  */
 class LinnCreate
 {
+  private:
+
+    /**
+     * Local file of which the contents must be copied into the image.
+     */
+    typedef struct FileJob
+    {
+        char *path;     /**< Path to the local file. */
+        le32 inode;     /**< Inode number in the image. */
+        Size size;      /**< Size of the file when it was inserted. */
+        time_t modified; /**< Latest modification or status change time of the local file. */
+    }
+    FileJob;
+
   public:
 
     /**
@@ -148,6 +169,34 @@ class LinnCreate
      */
     void setVerbose(bool newVerbose);
 
+    /**
+     * Map the blocks of inodes with extents.
+     *
+     * @param newExtents True to use extents, false to use (in)direct block pointers.
+     */
+    void setExtents(bool newExtents);
+
+    /**
+     * Update an existing image in place, if only file contents have changed.
+     *
+     * @param newUpdate True to update, false to always write a new image.
+     */
+    void setUpdate(bool newUpdate);
+
+    /**
+     * Print the time spent in each stage.
+     *
+     * @param newTiming True to print, false to stay silent.
+     */
+    void setTiming(bool newTiming);
+
+    /**
+     * Set the number of threads copying file contents.
+     *
+     * @param newThreads Number of threads.
+     */
+    void setThreads(Size newThreads);
+
   private:
 
     /**
@@ -164,6 +213,15 @@ class LinnCreate
     LinnInode * createInode(le32 inodeNum, FileSystem::FileType type, FileSystem::FileModes mode,
                             UserID uid = ZERO, GroupID gid = ZERO);
 
+    /**
+     * Get a pointer to an existing LinnInode.
+     *
+     * @param inodeNum Inode number.
+     *
+     * @return LinnInode pointer.
+     */
+    LinnInode * getInode(le32 inodeNum);
+
     /**
      * Copies a local file contents into an LinnInode.
      *
@@ -185,6 +243,13 @@ class LinnCreate
     void insertEntry(le32 dirInode, le32 entryInode,
                      const char *name, FileSystem::FileType type);
 
+    /**
+     * Inserts a LinnDirectoryIndex for all entries of the given directory inode.
+     *
+     * @param dirInode Inode number of the directory.
+     */
+    void insertIndex(le32 dirInode);
+
     /**
      * Inserts the given directory and it's childs to the filesystem image.
      *
@@ -197,14 +262,49 @@ class LinnCreate
     void insertDirectory(char *inputFile, le32 inodeNum, le32 parentNum);
 
     /**
-     * Inserts the contents of a local file into an LinnInode.
+     * Reserves blocks for the contents of a local file in an LinnInode.
+     *
+     * The contents are copied later by writeImage().
      *
      * @param inputFile Path to the local file.
+     * @param inodeNum Inode number of the file.
      * @param inode Pointer to the inode to fill.
      * @param st POSIX stats structure of inputFile.
      */
-    void insertFile(char *inputFile, LinnInode *inode,
-                    struct stat *st);
+    void insertFile(char *inputFile, le32 inodeNum,
+                    LinnInode *inode, struct stat *st);
+
+    /**
+     * Inserts a block address in an LinnInode.
+     *
+     * @param inode Pointer to the inode.
+     * @param blockIndex Index of the block inside the inode.
+     * @param blockValue The block address to insert.
+     *
+     * @return True if inserted, false if the maximum file size is reached.
+     */
+    bool insertBlock(LinnInode *inode, le32 blockIndex, le32 blockValue);
+
+    /**
+     * Retrieve a block address of an LinnInode.
+     *
+     * @param inode Pointer to the inode.
+     * @param blockIndex Index of the block inside the inode.
+     *
+     * @return Block address or ZERO if not inserted.
+     */
+    le32 getBlock(LinnInode *inode, le32 blockIndex);
+
+    /**
+     * Retrieve an extent of an LinnInode.
+     *
+     * @param inode Pointer to the inode.
+     * @param extentNum Number of the extent.
+     * @param allocate Allocate extent blocks, if needed.
+     *
+     * @return Pointer to the extent or ZERO if not available.
+     */
+    LinnExtent * getExtent(LinnInode *inode, Size extentNum, bool allocate);
 
     /**
      * Inserts an indirect block address.
@@ -221,10 +321,58 @@ class LinnCreate
     /**
      * Writes the final image to disk.
      *
+     * The image is mapped in memory and file contents are copied
+     * into it by multiple threads. When updating an existing image with
+     * the same layout, only the contents of changed files are copied.
+     * The superblock is marked valid after all contents are written,
+     * and only a valid image is updated in place.
+     *
      * @return EXIT_SUCCESS if successful and EXIT_FAILURE otherwise.
      */
     int writeImage();
 
+    /**
+     * Read the creation time of the existing image.
+     *
+     * @return Creation time or ZERO if not available.
+     */
+    u32 readCreationTime();
+
+    /**
+     * Copies the contents of local files into the image.
+     *
+     * @param since Only copy files modified at or after this time.
+     *
+     * @return Number of files copied.
+     */
+    Size copyFiles(time_t since);
+
+    /**
+     * Copy the contents of a single local file into the image.
+     *
+     * @param job File to copy.
+     *
+     * @return True on success, false otherwise.
+     */
+    bool copyFile(const FileJob *job);
+
+    /**
+     * Entry point of the threads copying file contents.
+     *
+     * @param arg Pointer to the LinnCreate object.
+     *
+     * @return Always ZERO.
+     */
+    static void * copyThread(void *arg);
+
+    /**
+     * Print the time spent in a stage, if enabled.
+     *
+     * @param stage Name of the stage.
+     * @param start Time at the start of the stage. Updated to the current time.
+     */
+    void printTime(const char *stage, struct timeval *start);
+
   private:
 
     /** Program name we are invoked with. */
@@ -239,6 +387,21 @@ class LinnCreate
     /** Output verbose messages. */
     bool verbose;
 
+    /** Map blocks of inodes with extents. */
+    bool extents;
+
+    /** Update an existing image in place if possible. */
+    bool update;
+
+    /** Print the time spent in each stage. */
+    bool timing;
+
+    /** Number of threads copying file contents. */
+    Size threads;
+
+    /** Time used for all timestamps in the image. */
+    u32 buildTime;
+
     /** List of file patterns to ignore. */
     List<String *> excludes;
 
@@ -247,6 +410,30 @@ class LinnCreate
 
     /** Array of blocks available in the filesystem. */
     u8 *blocks;
+
+    /** Marks blocks which contain file contents. */
+    BitArray *dataBlocks;
+
+    /** Local files to copy into the image. */
+    Vector<FileJob *> files;
+
+    /** Mapping of the output image. */
+    u8 *output;
+
+    /** Only copy files modified at or after this time. */
+    time_t copySince;
+
+    /** Index in files of the next file to copy. */
+    Size nextFile;
+
+    /** Number of files copied. */
+    Size copiedFiles;
+
+    /** Set if copying a file failed. */
+    bool copyFailed;
+
+    /** Protects nextFile, copiedFiles and copyFailed. */
+    pthread_mutex_t copyLock;
 };
 
 /**
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LinnCreate.h"
+
+int main(int argc, char **argv)
+{
+    LinnCreate fs;
+    Size blockSize = LINN_CREATE_BLOCK_SIZE;
+    Size blockNum  = LINN_CREATE_BLOCK_NUM;
+    Size inodeNum  = LINN_CREATE_INODE_NUM;
+
+    // Verify command-line arguments
+    if (argc < 2)
+    {
+        printf("usage: %s IMAGE [OPTIONS...]\r\n"
+               "Creates a new Linnenbank FileSystem\r\n"
+               "\r\n"
+               " -h           Show this help message.\r\n"
+               " -v           Output verbose messages.\r\n"
+               " -d DIRECTORY Insert files from the given directory into the image\r\n"
+               " -e PATTERN   Exclude matching files from the created filesystem\r\n"
+               " -b SIZE      Specifies the blocksize in bytes.\r\n"
+               " -n COUNT     Specifies the maximum number of blocks.\r\n"
+               " -i COUNT     Specifies the number of inodes to allocate.\r\n"
+               " -m           Map blocks with (in)direct blocks instead of extents.\r\n"
+               " -u           Update an existing image, copying only changed files.\r\n"
+               " -t           Print the time spent in each stage.\r\n"
+               " -j COUNT     Specifies the number of threads copying files.\r\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    // Process command-line arguments
+    fs.setProgram(argv[0]);
+    fs.setImage(argv[1]);
+
+    // Process command-line options
+    for (int i = 0; i < argc - 2; i++)
+    {
+        // Exclude files matching the given pattern
+        if (!strcmp(argv[i + 2], "-e") && i < argc - 3)
+        {
+            fs.setExclude(argv[i + 3]);
+            i++;
+        }
+        // Verbose output
+        else if (!strcmp(argv[i + 2], "-v"))
+        {
+            fs.setVerbose(true);
+        }
+        // Update existing image
+        else if (!strcmp(argv[i + 2], "-u"))
+        {
+            fs.setUpdate(true);
+        }
+        // Timing report
+        else if (!strcmp(argv[i + 2], "-t"))
+        {
+            fs.setTiming(true);
+        }
+        // Number of threads
+        else if (!strcmp(argv[i + 2], "-j") && i < argc - 3)
+        {
+            if (atoi(argv[i + 3]) < 1)
+            {
+                printf("%s: thread count must be >= 1\r\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+            }
+            fs.setThreads(atoi(argv[i + 3]));
+            i++;
+        }
+        // Compatible block mapping
+        else if (!strcmp(argv[i + 2], "-m"))
+        {
+            fs.setExtents(false);
+        }
+        // Input directory
+        else if (!strcmp(argv[i + 2], "-d") && i < argc - 3)
+        {
+            fs.setInput(argv[i + 3]);
+            i++;
+        }
+        // Block size
+        else if (!strcmp(argv[i + 2], "-b") && i < argc - 3)
+        {
+            blockSize = atoi(argv[i + 3]);
+            i++;
+        }
+        // Maximum block count
+        else if (!strcmp(argv[i + 2], "-n") && i < argc - 3)
+        {
+            if ((blockNum = atoi(argv[i + 3])) < 2)
+            {
+                printf("%s: block count must be >= 2\r\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+            }
+            i++;
+        }
+        // Inode count
+        else if (!strcmp(argv[i + 2], "-i") && i < argc - 3)
+        {
+            if ((inodeNum = atoi(argv[i + 3])) < 1)
+            {
+                printf("%s: inode count must be >= 1\r\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+            };
+            i++;
+        }
+        // Unknown argument
+        else
+        {
+            printf("%s: unknown option `%s'\r\n",
+                    argv[0], argv[i + 2]);
+            return EXIT_FAILURE;
+        }
+    }
+    // Create a new Linnenbank FileSystem
+    return fs.create(blockSize, blockNum, inodeNum);
+}
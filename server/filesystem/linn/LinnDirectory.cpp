@@ -26,36 +26,43 @@ LinnDirectory::LinnDirectory(LinnFileSystem *f,
                              LinnInode *i)
     : fs(f)
     , inode(i)
+    , indexBuckets(ZERO)
 {
+    LinnSuperBlock *sb = fs->getSuperBlock();
+    LinnDirectoryIndex index;
+
     m_size   = inode->size;
     m_access = inode->mode;
+
+    // Newer filesystems have a hashed index following the entries.
+    if (sb->minorRevision >= LINN_SUPER_MINOR_DIRINDEX && inode->size > 0)
+    {
+        const u64 offset = getOffset(LINN_INODE_NUM_BLOCKS(sb, inode) * sb->blockSize);
+
+        if (offset != 0 &&
+            fs->getStorage()->read(offset, &index, sizeof(index)) == FileSystem::Success &&
+            index.magic == LINN_DIRINDEX_MAGIC && index.buckets != 0 &&
+            (index.buckets & (index.buckets - 1)) == 0)
+        {
+            indexBuckets = index.buckets;
+        }
+    }
 }
 
 FileSystem::Error LinnDirectory::read(IOBuffer & buffer, Size size, Size offset)
 {
-    LinnSuperBlock *sb = fs->getSuperBlock();
     LinnDirectoryEntry dent;
+    const LinnDirectoryEntry *entry;
     LinnInode *dInode;
-    Size bytes = ZERO, blk;
+    Size bytes = ZERO;
     FileSystem::Error e;
     Dirent tmp;
 
     // Read directory entries
     for (u32 ent = 0; ent < inode->size / sizeof(LinnDirectoryEntry); ent++)
     {
-        // Point to correct (direct) block
-        if ((blk = (ent * sizeof(LinnDirectoryEntry)) / sb->blockSize)
-             >= LINN_INODE_DIR_BLOCKS)
-        {
-            break;
-        }
-        // Calculate offset to read.
-        u64 off = (inode->block[blk] * sb->blockSize) +
-                      (ent * sizeof(LinnDirectoryEntry));
-
         // Get the next entry.
-        if (fs->getStorage()->read(off, &dent,
-                                   sizeof(LinnDirectoryEntry)) != FileSystem::Success)
+        if (!(entry = getEntry(ent, &dent)))
         {
             return FileSystem::PermissionDenied;
         }
@@ -67,11 +74,11 @@ FileSystem::Error LinnDirectory::read(IOBuffer & buffer, Size size, Size offset)
         }
 
         // Fill in the Dirent.
-        if (!(dInode = fs->getInode(dent.inode)))
+        if (!(dInode = fs->getInode(entry->inode)))
         {
             return FileSystem::NotFound;
         }
-        MemoryBlock::copy(tmp.name, dent.name, LINN_DIRENT_NAME_LEN);
+        MemoryBlock::copy(tmp.name, (char *) entry->name, LINN_DIRENT_NAME_LEN);
         tmp.type = (FileSystem::FileType) dInode->type;
 
         // Copy to the buffer.
@@ -122,34 +129,99 @@ bool LinnDirectory::getLinnDirectoryEntry(LinnDirectoryEntry *dent,
                                           const char *name)
 {
     const String nameStr(name, false);
-    LinnSuperBlock *sb = fs->getSuperBlock();
-    u64 offset;
+    const u32 entries = inode->size / sizeof(LinnDirectoryEntry);
+    const LinnDirectoryEntry *entry;
+    u32 bucket;
 
-    // Loop all blocks.
-    for (u32 blk = 0; blk < LINN_INODE_NUM_BLOCKS(sb, inode); blk++)
+    // Use the hashed index, if available.
+    if (indexBuckets != ZERO)
     {
-        // Read directory entries.
-        for (u32 ent = 0; ent < LINN_DIRENT_PER_BLOCK(sb); ent++)
-        {
-            // Calculate offset to read.
-            offset = (inode->block[blk] * sb->blockSize) +
-                     (sizeof(LinnDirectoryEntry) * ent);
+        u32 b = linnDirectoryHash(name) & (indexBuckets - 1);
 
-            // Get the next entry.
-            if (fs->getStorage()->read(offset, dent,
-                                       sizeof(LinnDirectoryEntry)) != FileSystem::Success)
+        for (u32 probes = 0; probes < indexBuckets; probes++)
+        {
+            if (!getBucket(b, &bucket) || bucket == LINN_DIRINDEX_EMPTY || bucket > entries)
+            {
+                return false;
+            }
+            if (!(entry = getEntry(bucket - 1, dent)))
             {
                 return false;
             }
-
             // Is it the entry we are looking for?
-            if (nameStr.equals(dent->name))
+            if (nameStr.equals(entry->name))
             {
+                if (entry != dent)
+                {
+                    MemoryBlock::copy(dent, entry, sizeof(LinnDirectoryEntry));
+                }
                 return true;
             }
+            b = (b + 1) & (indexBuckets - 1);
+        }
+        return false;
+    }
+
+    // Otherwise loop all entries.
+    for (u32 ent = 0; ent < entries; ent++)
+    {
+        if (!(entry = getEntry(ent, dent)))
+        {
+            return false;
+        }
+
+        // Is it the entry we are looking for?
+        if (nameStr.equals(entry->name))
+        {
+            if (entry != dent)
+            {
+                MemoryBlock::copy(dent, entry, sizeof(LinnDirectoryEntry));
+            }
+            return true;
         }
     }
 
     // Not found.
     return false;
 }
+
+const LinnDirectoryEntry * LinnDirectory::getEntry(u32 entryNum, LinnDirectoryEntry *dent)
+{
+    const LinnDirectoryEntry *entry;
+    const u64 offset = getOffset((u64) entryNum * sizeof(LinnDirectoryEntry));
+
+    if (offset == 0)
+    {
+        return ZERO;
+    }
+
+    // Use memory-resident entries in place.
+    if ((entry = (const LinnDirectoryEntry *) fs->getStorage()->map(offset, sizeof(LinnDirectoryEntry))))
+    {
+        return entry;
+    }
+
+    if (fs->getStorage()->read(offset, dent, sizeof(LinnDirectoryEntry)) != FileSystem::Success)
+    {
+        return ZERO;
+    }
+    return dent;
+}
+
+bool LinnDirectory::getBucket(u32 bucketNum, u32 *value)
+{
+    LinnSuperBlock *sb = fs->getSuperBlock();
+    const u64 offset = getOffset((LINN_INODE_NUM_BLOCKS(sb, inode) * sb->blockSize) +
+                                 sizeof(LinnDirectoryIndex) + ((u64) bucketNum * sizeof(le32)));
+
+    return offset != 0 &&
+           fs->getStorage()->read(offset, value, sizeof(u32)) == FileSystem::Success;
+}
+
+u64 LinnDirectory::getOffset(u64 position)
+{
+    LinnSuperBlock *sb = fs->getSuperBlock();
+    const u64 offset = fs->getOffset(inode, position / sb->blockSize);
+
+    return offset != 0 ? offset + (position % sb->blockSize) : 0;
+}
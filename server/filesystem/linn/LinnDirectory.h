@@ -17,11 +17,11 @@
 
 #ifndef __FILESYSTEM_LINN_DIRECTORY_H
 #define __FILESYSTEM_LINN_DIRECTORY_H
-#ifndef __HOST__
 
 #include <Directory.h>
 #include <Types.h>
 #include "LinnDirectoryEntry.h"
+#include "LinnDirectoryIndex.h"
 #include "LinnFileSystem.h"
 #include "LinnInode.h"
 #include "IOBuffer.h"
@@ -98,6 +98,35 @@ class LinnDirectory : public Directory
     bool getLinnDirectoryEntry(LinnDirectoryEntry *dent,
                                const char *name);
 
+    /**
+     * Retrieve a directory entry by its number.
+     *
+     * @param entryNum Number of the entry in the directory.
+     * @param dent LinnDirectoryEntry buffer, used if the storage is not memory-resident.
+     *
+     * @return Pointer to the entry or ZERO on failure.
+     */
+    const LinnDirectoryEntry * getEntry(u32 entryNum, LinnDirectoryEntry *dent);
+
+    /**
+     * Retrieve a bucket from the LinnDirectoryIndex.
+     *
+     * @param bucketNum Bucket number.
+     * @param value Output value of the bucket.
+     *
+     * @return True if successful, false otherwise.
+     */
+    bool getBucket(u32 bucketNum, u32 *value);
+
+    /**
+     * Calculate the offset in storage of a position inside the directory.
+     *
+     * @param position Byte position inside the directory blocks.
+     *
+     * @return Offset in bytes in storage.
+     */
+    u64 getOffset(u64 position);
+
   private:
 
     /** Filesystem pointer. */
@@ -105,6 +134,9 @@ class LinnDirectory : public Directory
 
     /** Inode which describes the directory. */
     LinnInode *inode;
+
+    /** Number of buckets in the LinnDirectoryIndex or ZERO if not available. */
+    u32 indexBuckets;
 };
 
 /**
@@ -112,5 +144,4 @@ class LinnDirectory : public Directory
  * @}
  */
 
-#endif /* __HOST__ */
 #endif /* __FILESYSTEM_EXT2DIRECTORY_H */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FILESYSTEM_LINN_DIRECTORY_INDEX_H
+#define __FILESYSTEM_LINN_DIRECTORY_INDEX_H
+
+#include <Types.h>
+#include <HashFunction.h>
+
+/**
+ * @addtogroup server
+ * @{
+ *
+ * @addtogroup linnfs
+ * @{
+ */
+
+/** Magic number of a directory index ('Ldix'). */
+#define LINN_DIRINDEX_MAGIC 0x4c646978
+
+/** Marks an unused bucket in the directory index. */
+#define LINN_DIRINDEX_EMPTY 0
+
+/**
+ * Calculate the number of buckets for a directory index.
+ *
+ * The number of buckets is a power of two and at least twice
+ * the number of entries, which keeps the probe sequences short.
+ *
+ * @param entries Number of directory entries.
+ *
+ * @return Number of buckets.
+ */
+inline u32 linnDirectoryIndexBuckets(const u32 entries)
+{
+    u32 buckets = 8;
+
+    while (buckets < entries * 2)
+        buckets <<= 1;
+
+    return buckets;
+}
+
+/**
+ * Compute the hash of a directory entry name.
+ *
+ * @param name Null terminated file name.
+ *
+ * @return FNV hash of the name.
+ */
+inline u32 linnDirectoryHash(const char *name)
+{
+    u32 hash = FNV_INIT;
+
+    for (const u8 *ch = (const u8 *) name; *ch; ch++)
+    {
+        hash ^= *ch;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * Hashed index of the entries in a directory.
+ *
+ * The index is stored in the blocks of the directory which follow
+ * the LinnDirectoryEntry's, beyond the size of the directory inode.
+ * It consists of this header and an array of le32 buckets. Each bucket
+ * contains the entry number plus one, or LINN_DIRINDEX_EMPTY. Collisions
+ * are resolved by probing the next bucket.
+ */
+typedef struct LinnDirectoryIndex
+{
+    /** Allows detection of a valid index. */
+    le32 magic;
+
+    /** Number of buckets following the header. Always a power of two. */
+    le32 buckets;
+}
+LinnDirectoryIndex;
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* __FILESYSTEM_LINN_DIRECTORY_INDEX_H */
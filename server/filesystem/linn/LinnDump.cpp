@@ -148,6 +148,7 @@ int main(int argc, char **argv)
             "   mountCount      = %u\n"
             "   lastCheck       = %s\n"
             "   groupsTable     = %u\n"
+            "   features        = %x\n"
             "]\n",
             super.magic0, super.magic1,
             super.majorRevision, super.minorRevision,
@@ -158,7 +159,8 @@ int main(int argc, char **argv)
             super.freeInodesCount, percentFreeInodes,
             timeString(super.creationTime),
             timeString(super.mountTime), super.mountCount,
-            timeString(super.lastCheck), super.groupsTable);
+            timeString(super.lastCheck), super.groupsTable,
+            super.features);
 
     // Seek to the group table.
     if (fseek(fp, super.groupsTable * super.blockSize, SEEK_SET) == -1)
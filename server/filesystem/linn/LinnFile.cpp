@@ -20,7 +20,7 @@
 #include "LinnFile.h"
 
 LinnFile::LinnFile(LinnFileSystem *f, LinnInode *i)
-    : fs(f), inode(i)
+    : fs(f), inode(i), nextBlock(0), aheadBlock(0)
 {
     m_size   = inode->size;
     m_access = inode->mode;
@@ -35,7 +35,8 @@ FileSystem::Error LinnFile::read(IOBuffer & buffer, Size size, Size offset)
     LinnSuperBlock *sb;
     Size bytes = 0, blockNr = 0;
     u64 storageOffset, copyOffset = offset;
-    static u8 block[LINN_MAX_BLOCK_SIZE];
+    u64 runStorage = 0;
+    Size runSize = 0, runOffset = 0;
     Size total = 0;
     FileSystem::Error e;
 
@@ -51,6 +52,29 @@ FileSystem::Error LinnFile::read(IOBuffer & buffer, Size size, Size offset)
     // Adjust the copy offset within this block.
     copyOffset -= sb->blockSize * blockNr;
 
+    // Load the blocks of this read at once, and keep the
+    // read-ahead window filled while reading sequentially.
+    const u32 numBlocks = LINN_INODE_NUM_BLOCKS(sb, inode);
+    u64 first = blockNr;
+    u64 last  = blockNr + ((copyOffset + size + sb->blockSize - 1) / sb->blockSize);
+
+    if (blockNr == nextBlock)
+    {
+        if (aheadBlock > first)
+            first = aheadBlock;
+
+        if (aheadBlock < last + (fs->getReadAhead() / 2))
+            last += fs->getReadAhead();
+    }
+    if (last > numBlocks)
+        last = numBlocks;
+
+    if (first < last)
+    {
+        prefetch(first, last);
+        aheadBlock = last;
+    }
+
     // Loop all blocks.
     while (blockNr < LINN_INODE_NUM_BLOCKS(sb, inode) &&
            total < size && inode->size - (offset + total) > 0)
@@ -58,12 +82,6 @@ FileSystem::Error LinnFile::read(IOBuffer & buffer, Size size, Size offset)
         // Calculate the offset in storage for this block.
         storageOffset = fs->getOffset(inode, blockNr);
 
-        // Fetch the next block.
-        if (fs->getStorage()->read(storageOffset, block, sb->blockSize) != FileSystem::Success)
-        {
-            return FileSystem::IOError;
-        }
-
         // Calculate the number of bytes to copy.
         bytes = sb->blockSize - copyOffset;
 
@@ -79,10 +97,20 @@ FileSystem::Error LinnFile::read(IOBuffer & buffer, Size size, Size offset)
             bytes = size - total;
         }
 
-        // Copy into the buffer.
-        if ((e = buffer.write(block + copyOffset, bytes, total)) < 0)
+        // Blocks adjacent in storage are copied to the buffer at once.
+        if (runSize != 0 && runStorage + runSize == storageOffset + copyOffset)
         {
-            return e;
+            runSize += bytes;
+        }
+        else
+        {
+            if (runSize != 0 && (e = copyRange(buffer, runStorage, runSize, runOffset)) < 0)
+            {
+                return e;
+            }
+            runStorage = storageOffset + copyOffset;
+            runSize    = bytes;
+            runOffset  = total;
         }
 
         // Update state.
@@ -90,6 +118,74 @@ FileSystem::Error LinnFile::read(IOBuffer & buffer, Size size, Size offset)
         copyOffset  = 0;
         blockNr++;
     }
+    // Copy the last run of blocks.
+    if (runSize != 0 && (e = copyRange(buffer, runStorage, runSize, runOffset)) < 0)
+    {
+        return e;
+    }
+    // Remember where a sequential read would continue.
+    nextBlock = (offset + total) / sb->blockSize;
+
     // Success.
     return (Error) total;
 }
+
+FileSystem::Error LinnFile::copyRange(IOBuffer & buffer, u64 storageOffset,
+                                      Size size, Size bufferOffset)
+{
+    static u8 chunk[LINN_READ_CHUNK];
+    const u8 *data;
+    Size copied = 0, bytes;
+    FileSystem::Error e;
+
+    // Use memory-resident storage directly, to avoid an extra copy.
+    if ((data = fs->getStorage()->map(storageOffset, size)) != ZERO)
+    {
+        return buffer.write((void *) data, size, bufferOffset);
+    }
+
+    // Otherwise read from storage in large chunks.
+    while (copied < size)
+    {
+        bytes = size - copied < sizeof(chunk) ? size - copied : sizeof(chunk);
+
+        if (fs->getStorage()->read(storageOffset + copied, chunk, bytes) != FileSystem::Success)
+        {
+            return FileSystem::IOError;
+        }
+        if ((e = buffer.write(chunk, bytes, bufferOffset + copied)) < 0)
+        {
+            return e;
+        }
+        copied += bytes;
+    }
+    return (FileSystem::Error) copied;
+}
+
+void LinnFile::prefetch(u32 first, u32 last)
+{
+    const Size blockSize = fs->getSuperBlock()->blockSize;
+    u64 runOffset = 0;
+    Size runSize = 0;
+
+    for (u32 blk = first; blk < last; blk++)
+    {
+        const u64 storageOffset = fs->getOffset(inode, blk);
+
+        // Extend the current run if this block follows it in storage
+        if (runSize != 0 && storageOffset == runOffset + runSize)
+        {
+            runSize += blockSize;
+            continue;
+        }
+
+        if (runSize != 0)
+            fs->getCache()->prefetch(runOffset, runSize);
+
+        runOffset = storageOffset;
+        runSize   = storageOffset != 0 ? blockSize : 0;
+    }
+
+    if (runSize != 0)
+        fs->getCache()->prefetch(runOffset, runSize);
+}
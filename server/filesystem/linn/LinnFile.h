@@ -17,7 +17,6 @@
 
 #ifndef __FILESYSTEM_LINN_FILE_H
 #define __FILESYSTEM_LINN_FILE_H
-#ifndef __HOST__
 
 #include <File.h>
 #include <Types.h>
@@ -65,6 +64,31 @@ class LinnFile : public File
      */
     virtual FileSystem::Error read(IOBuffer & buffer, Size size, Size offset);
 
+  private:
+
+    /**
+     * Load a range of file blocks into the block cache.
+     *
+     * Blocks which are contiguous in storage are loaded together.
+     *
+     * @param first First block number in the file.
+     * @param last Block number in the file after the last block to load.
+     */
+    void prefetch(u32 first, u32 last);
+
+    /**
+     * Copy a contiguous range of storage into the buffer.
+     *
+     * @param buffer Output buffer.
+     * @param storageOffset Offset in storage of the first byte.
+     * @param size Number of bytes to copy.
+     * @param bufferOffset Offset in the buffer to copy to.
+     *
+     * @return Number of bytes copied or Error on failure.
+     */
+    FileSystem::Error copyRange(IOBuffer & buffer, u64 storageOffset,
+                                Size size, Size bufferOffset);
+
   private:
 
     /** Filesystem pointer. */
@@ -72,6 +96,12 @@ class LinnFile : public File
 
     /** Inode pointer. */
     LinnInode *inode;
+
+    /** Block number where the next sequential read starts. */
+    u32 nextBlock;
+
+    /** Block number after the last block read ahead. */
+    u32 aheadBlock;
 };
 
 /**
@@ -79,5 +109,4 @@ class LinnFile : public File
  * @}
  */
 
-#endif /* __HOST__ */
 #endif /* __FILESYSTEM_LINN_FILE_H */
@@ -17,13 +17,15 @@
 
 #include <Types.h>
 #include <Assert.h>
+#include <BlockCacheFile.h>
 #include "LinnFileSystem.h"
 #include "LinnInode.h"
 #include "LinnFile.h"
 #include "LinnDirectory.h"
 
-LinnFileSystem::LinnFileSystem(const char *p, Storage *s)
-    : FileSystemServer(ZERO, p), storage(s), groups(ZERO)
+LinnFileSystem::LinnFileSystem(const char *p, Storage *s,
+                               const Size cacheBlocks, const Size ahead)
+    : FileSystemServer(ZERO, p), storage(s), cache(ZERO), readAhead(ahead), groups(ZERO)
 {
     LinnInode *rootInode;
     LinnGroup *group;
@@ -42,6 +44,22 @@ LinnFileSystem::LinnFileSystem(const char *p, Storage *s)
     {
         FATAL("magic mismatch");
     }
+    // Verify blocksize.
+    if (super.blockSize < LINN_MIN_BLOCK_SIZE ||
+        super.blockSize > LINN_MAX_BLOCK_SIZE)
+    {
+        FATAL("invalid blocksize: " << super.blockSize);
+    }
+    // Refuse images which need features we do not know.
+    if (super.features & ~LINN_SUPER_FEATURES)
+    {
+        FATAL("unsupported features: " << super.features);
+    }
+    // Read all further blocks through the cache.
+    cache = new BlockCache(s, super.blockSize, cacheBlocks);
+    assert(cache != NULL);
+    storage = cache;
+
     // Create groups vector.
     groups = new Vector<LinnGroup *>(LINN_GROUP_COUNT(&super));
     assert(groups != NULL);
@@ -57,7 +75,7 @@ LinnFileSystem::LinnFileSystem(const char *p, Storage *s)
                  (sizeof(LinnGroup)  * i);
 
         // Read from storage.
-        if ((e = s->read(offset, group, sizeof(LinnGroup))) != FileSystem::Success)
+        if ((e = storage->read(offset, group, sizeof(LinnGroup))) != FileSystem::Success)
         {
             FATAL("reading group descriptor failed: result = " << (int) e);
         }
@@ -76,6 +94,9 @@ LinnFileSystem::LinnFileSystem(const char *p, Storage *s)
     assert(dir != NULL);
     setRoot(dir);
 
+    // Export the block cache statistics.
+    registerFile(new BlockCacheFile(cache), LINN_CACHE_FILE);
+
     // Done.
     NOTICE("mounted at " << p);
 }
@@ -132,11 +153,14 @@ LinnGroup * LinnFileSystem::getGroupByInode(u32 inodeNum)
 u64 LinnFileSystem::getOffset(LinnInode *inode, u32 blk)
 {
     u64 numPerBlock = LINN_SUPER_NUM_PTRS(&super), offset;
-    static u32 block[LINN_MAX_BLOCK_SIZE / sizeof(u32)];
+    u32 entry;
     Size depth = ZERO, remain = 1;
 
-    assert(LINN_SUPER_NUM_PTRS(&super) <= sizeof(block) / sizeof(u32));
-
+    // Blocks are mapped with extents.
+    if (super.features & LINN_SUPER_FEATURE_EXTENTS)
+    {
+        return getExtentOffset(inode, blk);
+    }
     // Direct blocks.
     if (blk < LINN_INODE_DIR_BLOCKS)
     {
@@ -156,18 +180,13 @@ u64 LinnFileSystem::getOffset(LinnInode *inode, u32 blk)
     else
         depth = 3;
 
-    // Allocate temporary block.
+    // Start at the top indirect block.
     offset  = inode->block[(LINN_INODE_DIR_BLOCKS + depth - 1)];
     offset *= super.blockSize;
 
     // Lookup the block number.
     while (true)
     {
-        // Fetch block.
-        if (storage->read(offset, block, super.blockSize) != FileSystem::Success)
-        {
-            return 0;
-        }
         // Calculate the number of blocks remaining per entry.
         for (Size i = 0; i < depth - 1; i++)
         {
@@ -178,21 +197,80 @@ u64 LinnFileSystem::getOffset(LinnInode *inode, u32 blk)
         {
             break;
         }
+        // Fetch the entry pointing to the next indirect block.
+        if (storage->read(offset + (((blk - LINN_INODE_DIR_BLOCKS) / remain) * sizeof(u32)),
+                          &entry, sizeof(u32)) != FileSystem::Success)
+        {
+            return 0;
+        }
         // Calculate the next offset.
-        offset  = block[ (blk - LINN_INODE_DIR_BLOCKS) / remain ];
+        offset  = entry;
         offset *= super.blockSize;
         remain  = 1;
         depth--;
     }
+    // Fetch the entry pointing to the data block.
+    if (storage->read(offset + (((blk - LINN_INODE_DIR_BLOCKS) %
+                                  LINN_SUPER_NUM_PTRS(&super)) * sizeof(u32)),
+                      &entry, sizeof(u32)) != FileSystem::Success)
+    {
+        return 0;
+    }
     // Calculate the final offset.
-    offset  = block[ (blk - LINN_INODE_DIR_BLOCKS) %
-                      LINN_SUPER_NUM_PTRS(&super) ];
+    offset  = entry;
     offset *= super.blockSize;
 
     // All done.
     return offset;
 }
 
+u64 LinnFileSystem::getExtentOffset(LinnInode *inode, u32 blk)
+{
+    const LinnExtent *extent = (const LinnExtent *) inode->block;
+    LinnExtent next;
+    u64 offset;
+
+    // Extents inside the inode.
+    for (Size i = 0; i < LINN_INODE_EXTENTS && extent[i].length; i++)
+    {
+        if (blk < extent[i].length)
+        {
+            return ((u64) extent[i].start + blk) * super.blockSize;
+        }
+        blk -= extent[i].length;
+    }
+    if (!extent[LINN_INODE_EXTENTS - 1].length)
+    {
+        return 0;
+    }
+
+    // Follow the chain of extent blocks.
+    for (offset = (u64) inode->block[LINN_INODE_EXTENT_BLOCK] * super.blockSize;
+         offset != 0;
+         offset = (u64) next.start * super.blockSize)
+    {
+        for (Size i = 0; i <= LINN_EXTENTS_PER_BLOCK(&super); i++)
+        {
+            if (storage->read(offset + (i * sizeof(LinnExtent)), &next,
+                              sizeof(LinnExtent)) != FileSystem::Success)
+            {
+                return 0;
+            }
+            // The last extent points to the next extent block.
+            if (i == LINN_EXTENTS_PER_BLOCK(&super) || !next.length)
+            {
+                break;
+            }
+            if (blk < next.length)
+            {
+                return ((u64) next.start + blk) * super.blockSize;
+            }
+            blk -= next.length;
+        }
+    }
+    return 0;
+}
+
 void LinnFileSystem::notSupportedHandler(FileSystemMessage *msg)
 {
     msg->result = FileSystem::NotSupported;
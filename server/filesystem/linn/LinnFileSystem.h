@@ -21,6 +21,7 @@
 #include <FileSystemServer.h>
 #include <FileSystemMessage.h>
 #include <Storage.h>
+#include <BlockCache.h>
 #include <Types.h>
 #include <Vector.h>
 #include <HashTable.h>
@@ -54,7 +55,26 @@
  * @}
  */
 
-#ifndef __HOST__
+/**
+ * @name Block cache.
+ * @{
+ */
+
+/** Default number of blocks in the block cache. */
+#define LINN_CACHE_BLOCKS 256
+
+/** Default number of blocks to read ahead on sequential file reads. */
+#define LINN_READ_AHEAD 16
+
+/** Maximum number of bytes read from storage at once by a file read. */
+#define LINN_READ_CHUNK (LINN_MAX_BLOCK_SIZE * 16)
+
+/** Path of the block cache statistics pseudo file. */
+#define LINN_CACHE_FILE "/.blockcache"
+
+/**
+ * @}
+ */
 
 /**
  * @brief Linnenbank FileSystem (LinnFS).
@@ -77,8 +97,13 @@ class LinnFileSystem : public FileSystemServer
      *
      * @param path Path to which we are mounted.
      * @param storage Storage provider.
+     * @param cacheBlocks Maximum number of blocks in the block cache.
+     * @param readAhead Number of blocks to read ahead on sequential file reads.
      */
-    LinnFileSystem(const char *path, Storage *storage);
+    LinnFileSystem(const char *path,
+                   Storage *storage,
+                   const Size cacheBlocks = LINN_CACHE_BLOCKS,
+                   const Size readAhead = LINN_READ_AHEAD);
 
     /**
      * Retrieve the superblock pointer.
@@ -104,6 +129,28 @@ class LinnFileSystem : public FileSystemServer
         return storage;
     }
 
+    /**
+     * Get the block cache in front of the Storage.
+     *
+     * @return BlockCache pointer.
+     *
+     * @see BlockCache
+     */
+    BlockCache * getCache()
+    {
+        return cache;
+    }
+
+    /**
+     * Get the number of blocks to read ahead on sequential file reads.
+     *
+     * @return Number of blocks.
+     */
+    Size getReadAhead() const
+    {
+        return readAhead;
+    }
+
     /**
      * Read an inode from the filesystem.
      *
@@ -152,6 +199,16 @@ class LinnFileSystem : public FileSystemServer
 
   private:
 
+    /**
+     * Calculates the offset inside storage for a given block of an extent mapped inode.
+     *
+     * @param inode LinnInode pointer.
+     * @param blk Calculate the offset for this block.
+     *
+     * @return Offset in bytes in storage or ZERO if not mapped.
+     */
+    u64 getExtentOffset(LinnInode *inode, u32 blk);
+
     /**
      * Callback handler for unsupported operations
      *
@@ -164,6 +221,12 @@ class LinnFileSystem : public FileSystemServer
     /** Provides storage. */
     Storage *storage;
 
+    /** Caches blocks of the storage. */
+    BlockCache *cache;
+
+    /** Number of blocks to read ahead on sequential file reads. */
+    const Size readAhead;
+
     /** Describes the filesystem. */
     LinnSuperBlock super;
 
@@ -174,8 +237,6 @@ class LinnFileSystem : public FileSystemServer
     HashTable<u32, LinnInode *> inodes;
 };
 
-#endif /* __HOST__ */
-
 /**
  * @}
  * @}
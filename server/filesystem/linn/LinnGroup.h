@@ -95,8 +95,10 @@
  * @return Number of blocks needed for the inodes table.
  */
 #define LINN_GROUP_NUM_INODETAB(sb) \
-    ((sb)->inodesPerGroup / ((sb)->blockSize / sizeof(LinnInode)) ? \
-     (sb)->inodesPerGroup / ((sb)->blockSize / sizeof(LinnInode)) : 1)
+    (((sb)->inodesPerGroup + ((sb)->blockSize / sizeof(LinnInode)) - 1) / \
+      ((sb)->blockSize / sizeof(LinnInode)) ? \
+     ((sb)->inodesPerGroup + ((sb)->blockSize / sizeof(LinnInode)) - 1) / \
+      ((sb)->blockSize / sizeof(LinnInode)) : 1)
 
 /**
  * Calculate the number of LinnGroups which fit in one block.
@@ -60,6 +60,37 @@
 /** Total number of block pointers in an LinnInode. */
 #define LINN_INODE_BLOCKS       (LINN_INODE_TIND_BLOCKS + 1)
 
+/**
+ * @}
+ */
+
+/**
+ * @name Inode extents.
+ *
+ * With LINN_SUPER_FEATURE_EXTENTS the block pointers of an inode contain
+ * LinnExtent's instead. The first extents are stored in the inode itself.
+ * Further extents are stored in a chain of extent blocks. The last
+ * LinnExtent of each extent block contains the address of the next one.
+ *
+ * @{
+ */
+
+/** Number of extents stored in the inode itself. */
+#define LINN_INODE_EXTENTS      3
+
+/** Index of the block pointer with the address of the first extent block. */
+#define LINN_INODE_EXTENT_BLOCK (LINN_INODE_EXTENTS * 2)
+
+/**
+ * Calculate the number of LinnExtent's in one extent block.
+ *
+ * @param super LinnSuperBlock pointer.
+ *
+ * @return Number of extents, excluding the pointer to the next extent block.
+ */
+#define LINN_EXTENTS_PER_BLOCK(super) \
+    (((super)->blockSize / sizeof(LinnExtent)) - 1)
+
 /**
  * @}
  */
@@ -86,6 +117,16 @@
  * @}
  */
 
+/**
+ * Contiguous run of blocks of an inode.
+ */
+typedef struct LinnExtent
+{
+    le32 start;         /**< Address of the first block. */
+    le32 length;        /**< Number of blocks. Zero marks the end. */
+}
+LinnExtent;
+
 /**
  * Structure of an inode on the disk in the LinnFS filesystem.
  */
@@ -52,7 +52,10 @@
 #define LINN_SUPER_MAJOR        1
 
 /** Current minor revision number. */
-#define LINN_SUPER_MINOR        0
+#define LINN_SUPER_MINOR        1
+
+/** First minor revision with a LinnDirectoryIndex in each directory. */
+#define LINN_SUPER_MINOR_DIRINDEX 1
 
 /**
  * @}
@@ -72,6 +75,21 @@
 /** Serious corruption has been detected. */
 #define LINN_SUPER_CORRUPT      2
 
+/**
+ * @}
+ */
+
+/**
+ * @name Feature Flags.
+ * @{
+ */
+
+/** Inodes map their blocks with LinnExtent's instead of (in)direct block pointers. */
+#define LINN_SUPER_FEATURE_EXTENTS (1 << 0)
+
+/** All feature flags known to this implementation. */
+#define LINN_SUPER_FEATURES        (LINN_SUPER_FEATURE_EXTENTS)
+
 /**
  * @}
  */
@@ -133,6 +151,7 @@ typedef struct LinnSuperBlock
     le32 lastCheck;             /**< Timestamp of the last check. */
 
     le32 groupsTable;           /**< Block address of the LinnGroup table. */
+    le32 features;              /**< Optional features, as LINN_SUPER_FEATURE_* flags. */
 }
 LinnSuperBlock;
 
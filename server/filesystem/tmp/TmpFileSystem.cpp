@@ -17,7 +17,7 @@
 
 #include <Assert.h>
 #include <File.h>
-#include <PseudoFile.h>
+#include <ChunkFile.h>
 #include <Directory.h>
 #include "TmpFileSystem.h"
 
@@ -33,7 +33,7 @@ File * TmpFileSystem::createFile(const FileSystem::FileType type,
     switch (type)
     {
         case FileSystem::RegularFile: {
-            PseudoFile *file = new PseudoFile;
+            ChunkFile *file = new ChunkFile;
             assert(file != NULL);
             return file;
         }
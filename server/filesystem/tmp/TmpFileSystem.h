@@ -32,6 +32,10 @@
 
 /**
  * Temporary filesystem (TmpFS). Maps files into virtual memory.
+ *
+ * Regular files are stored in page sized chunks.
+ *
+ * @see ChunkFile
  */
 class TmpFileSystem : public FileSystemServer
 {
@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <errno.h>
 #include "Loopback.h"
 
 Loopback::Loopback(NetworkServer *server)
@@ -27,6 +28,9 @@ Loopback::Loopback(NetworkServer *server)
     m_address.addr[3] = 0x44;
     m_address.addr[4] = 0x55;
     m_address.addr[5] = 0x66;
+
+    // Packets never leave the host, so checksums are not needed
+    m_checksumOffload = true;
 }
 
 Loopback::~Loopback()
@@ -56,15 +60,21 @@ FileSystem::Error Loopback::setAddress(Ethernet::Address *address)
 
 FileSystem::Error Loopback::transmit(NetworkQueue::Packet *pkt)
 {
-    DEBUG("size = " << pkt->size);
+    const Size size = pkt->size;
+
+    DEBUG("size = " << size);
 
     // Process the packet by protocols as input (loopback)
-    process(pkt);
+    const Error result = process(pkt);
 
-    // Release packet buffer
+    // Release packet buffer. Sockets may still hold a reference.
     m_transmit.release(pkt);
 
+    // Report datagrams dropped by a full socket to the sender
+    if (result == EIO)
+        return FileSystem::IOError;
+
     // TODO: Restart FileSystem::Error flag triggers a restart of all other requests.
     // This is required because we need to retry all read requests.
-    return pkt->size;
+    return size;
 }
@@ -40,17 +40,23 @@ SMSC95xxUSB::SMSC95xxUSB(u8 deviceId,
     m_packetSize    = 1500 + TransmitCommandSize;
     m_readFinished  = new Callback<SMSC95xxUSB, FileSystemMessage>(this, &SMSC95xxUSB::readFinished);
     m_writeFinished = new Callback<SMSC95xxUSB, FileSystemMessage>(this, &SMSC95xxUSB::writeFinished);
+    m_receiveReleased = new Callback<SMSC95xxUSB, NetworkQueue::Packet>(this, &SMSC95xxUSB::receivePacketReleased);
     m_server        = server;
     m_smsc          = smsc;
 
     // Set packet header size
     m_smsc->getTransmitQueue()->setHeaderSize(TransmitCommandSize);
+
+    // Sockets may hold receive packets, continue receiving once one is released
+    m_smsc->getReceiveQueue()->setReleaseCallback(m_receiveReleased);
 }
 
 SMSC95xxUSB::~SMSC95xxUSB()
 {
     DEBUG("");
 
+    m_smsc->getReceiveQueue()->setReleaseCallback(ZERO);
+    delete m_receiveReleased;
     delete m_value;
 }
 
@@ -143,12 +149,12 @@ void SMSC95xxUSB::readFinished(FileSystemMessage *message)
         // Publish the packet to our parent
         m_rxPacket->size = frameLength;
         m_smsc->process(m_rxPacket, ReceiveCommandSize);
-
-        // Release the packet buffer
-        m_smsc->getReceiveQueue()->release(m_rxPacket);
-        m_rxPacket = 0;
     }
 
+    // Release the packet buffer
+    m_smsc->getReceiveQueue()->release(m_rxPacket);
+    m_rxPacket = 0;
+
     // Release USB transfer
     finishTransfer(message);
 
@@ -156,6 +162,15 @@ void SMSC95xxUSB::readFinished(FileSystemMessage *message)
     readStart();
 }
 
+void SMSC95xxUSB::receivePacketReleased(NetworkQueue::Packet *packet)
+{
+    DEBUG("");
+
+    // Restart the receive transfer if it stopped for lack of buffers
+    if (!m_rxPacket)
+        readStart();
+}
+
 void SMSC95xxUSB::writeStart()
 {
     DEBUG("");
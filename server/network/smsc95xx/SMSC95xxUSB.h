@@ -196,6 +196,13 @@ class SMSC95xxUSB : public USBDevice
     void readStart();
     void readFinished(FileSystemMessage *message);
 
+    /**
+     * Restart receiving when a packet buffer became available.
+     *
+     * @param packet Packet which returned to the receive pool
+     */
+    void receivePacketReleased(NetworkQueue::Packet *packet);
+
     void writeStart();
     void writeFinished(FileSystemMessage *message);
 
@@ -230,6 +237,9 @@ class SMSC95xxUSB : public USBDevice
     /** Callback object for writeFinished() */
     Callback<SMSC95xxUSB, FileSystemMessage> *m_writeFinished;
 
+    /** Callback object for receivePacketReleased() */
+    Callback<SMSC95xxUSB, NetworkQueue::Packet> *m_receiveReleased;
+
     Size m_packetSize;
     NetworkServer *m_server;
     SMSC95xx *m_smsc;
@@ -282,6 +282,7 @@ bool RecoveryServer::rewriteProgram(const ProcessID pid,
 
         // Map inside our process
         range.virt = ZERO;
+        range.access = Memory::User | Memory::Readable | Memory::Writable;
         const API::Result selfResult = VMCtl(SELF, MapContiguous, &range);
         if (selfResult != API::Success)
         {
@@ -22,6 +22,8 @@ SerialDevice::SerialDevice(const u32 irq)
     , AbstractFactory<SerialDevice>()
     , m_irq(irq)
 {
+    // Received data raises an interrupt
+    m_readyEvents = true;
 }
 
 u32 SerialDevice::getIrq() const
@@ -25,7 +25,7 @@ def linnfs_generate(target, source, env):
     """
     rootfs_path = env.Dir(env['ROOTFS']).srcnode().path
     linn_cmd = "build/host/server/filesystem/linn/create '" + str(target[0]) + \
-               "' -n 32768 -d '" + rootfs_path + "'"
+               "' -u -n 32768 -d '" + rootfs_path + "'"
 
     r = os.system(linn_cmd)
     if r != 0:
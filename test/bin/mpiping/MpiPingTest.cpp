@@ -42,3 +42,24 @@ TestCase(RunMpiPing)
     // Done
     return OK;
 }
+
+TestCase(RunMpiPingBench)
+{
+    const char *prog = "/bin/mpiping";
+    const char *args[] = { prog, "bench", (const char *)NULL };
+    int status;
+    int pid;
+
+    // Start the MPI ping benchmark
+    pid = forkexec(prog, args);
+    testAssert(pid != -1);
+    testAssert(pid > 0);
+
+    // Wait for it to terminate. Exit status must be zero (success)
+    pid_t p = waitpid(pid, &status, 0);
+    testAssert(p == (pid_t) pid);
+    testAssert(status == 0);
+
+    // Done
+    return OK;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+
+/** Search for primes up to this number */
+#define MPIPRIME_NUMBER "1000000"
+
+TestCase(RunMpiPrimeCores)
+{
+    const char *prog = "/bin/mpiprime";
+    const char *cores[] = { "1", "2", "4" };
+    struct timeval t1, t2;
+    int status;
+    int pid;
+
+    // Compare the wall time of mpiprime on 1, 2 and 4 cores
+    for (Size i = 0; i < sizeof(cores) / sizeof(cores[0]); i++)
+    {
+        const char *args[] = { prog, "-n", cores[i], MPIPRIME_NUMBER, (const char *)NULL };
+
+        gettimeofday(&t1, 0);
+
+        // Start the MPI prime program
+        pid = forkexec(prog, args);
+        testAssert(pid != -1);
+        testAssert(pid > 0);
+
+        // Wait for it to terminate. Exit status must be zero (success)
+        pid_t p = waitpid(pid, &status, 0);
+        testAssert(p == (pid_t) pid);
+        testAssert(status == 0);
+
+        gettimeofday(&t2, 0);
+        printf("%s: %s cores (at most): ", prog, cores[i]);
+        printtimediff(&t1, &t2);
+        printf("\r\n");
+    }
+
+    // Done
+    return OK;
+}
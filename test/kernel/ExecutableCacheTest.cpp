@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/System.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+
+/**
+ * Create a stopped child with one read-only page of program text.
+ *
+ * @return Process ID of the child, or -1 on failure
+ */
+static ProcessID createChild(Memory::Range *range)
+{
+    const Arch::MemoryMap map;
+    const ProcessID pid = ProcessCtl(ANY, Spawn, map.range(MemoryMap::UserData).virt);
+
+    if (pid == (ProcessID) -1)
+        return pid;
+
+    range->virt   = map.range(MemoryMap::UserData).virt;
+    range->phys   = ZERO;
+    range->size   = PAGESIZE;
+    range->access = Memory::User | Memory::Readable | Memory::Executable;
+
+    if (VMCtl(pid, MapContiguous, range) != API::Success)
+    {
+        ProcessCtl(pid, KillPID);
+        return -1;
+    }
+    return pid;
+}
+
+TestCase(ExecutableCacheUnprivilegedInsert)
+{
+    Memory::Range range;
+    ImageKey key;
+
+    // Claim the identity of a program which other processes run
+    MemoryBlock::set(&key, 0, sizeof(key));
+    MemoryBlock::copy(key.path, (char *) "/bin/sh", sizeof(key.path));
+    key.server = 1;
+    key.inode  = 1;
+    key.size   = PAGESIZE;
+
+    // Pages of our own stopped child may not be inserted under that key
+    const ProcessID pid = createChild(&range);
+    testAssert(pid != (ProcessID) -1);
+
+    range.phys = (Address) &key;
+    testAssert(VMCtl(pid, InsertImage, &range) == API::AccessViolation);
+    ProcessCtl(pid, KillPID);
+
+    // Nothing was cached, so another child cannot map the pages
+    const ProcessID other = createChild(&range);
+    testAssert(other != (ProcessID) -1);
+
+    range.phys = (Address) &key;
+    testAssert(VMCtl(other, MapImage, &range) == API::NotFound);
+    ProcessCtl(other, KillPID);
+
+    return OK;
+}
+
+TestCase(ExecutableCacheUnprivilegedRemove)
+{
+    Memory::Range range;
+    ImageKey key;
+
+    MemoryBlock::set(&key, 0, sizeof(key));
+    MemoryBlock::copy(key.path, (char *) "/bin/sh", sizeof(key.path));
+    range.phys = (Address) &key;
+
+    // Unprivileged processes may not drop the pages of other programs
+    testAssert(VMCtl(SELF, RemoveImage, &range) == API::AccessViolation);
+
+    return OK;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <ProcessManager.h>
+#include <RunQueue.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+/**
+ * Process with only the members needed by the RunQueue.
+ */
+struct BenchProcess
+{
+    uint m_priority;
+    uint m_level;
+    BenchProcess *m_schedulePrev;
+    BenchProcess *m_scheduleNext;
+    bool m_scheduled;
+};
+
+typedef RunQueue<BenchProcess, Process::MaximumPriority + 1> BenchQueue;
+
+/** Number of scheduling rounds measured per process count. */
+static const Size BenchRounds = 100000;
+
+/** Number of measurements of which the fastest is taken. */
+static const Size BenchRepeat = 5;
+
+/**
+ * Get the current time in nanoseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (((u64) tv.tv_sec * 1000000) + tv.tv_usec) * 1000;
+}
+
+/**
+ * Measure a round of select, remove and insert with a number of queued processes.
+ *
+ * @return Nanoseconds per round.
+ */
+static u64 benchQueue(const Size count)
+{
+    BenchProcess *procs = new BenchProcess[count];
+    u64 best = ~0ULL;
+
+    for (Size r = 0; r < BenchRepeat; r++)
+    {
+        BenchQueue queue;
+
+        for (Size i = 0; i < count; i++)
+        {
+            procs[i].m_priority = procs[i].m_level = i % (Process::MaximumPriority + 1);
+            queue.insert(&procs[i]);
+        }
+
+        // Select a process to run, let it block and wake up again
+        const u64 t1 = benchTime();
+        for (Size i = 0; i < BenchRounds; i++)
+        {
+            BenchProcess *p = queue.select();
+            queue.remove(p);
+            queue.insert(p);
+        }
+        const u64 t2 = benchTime();
+
+        if ((t2 - t1) / BenchRounds < best)
+            best = (t2 - t1) / BenchRounds;
+
+        for (Size i = 0; i < count; i++)
+            queue.remove(&procs[i]);
+    }
+
+    printf("RunQueueBench: %4u processes: %3u ns per select/remove/insert\n",
+           count, (uint) best);
+
+    delete[] procs;
+    return best;
+}
+
+TestCase(RunQueueBenchmark)
+{
+    const u64 small = benchQueue(8);
+
+    for (Size count = 64; count < MAX_PROCS; count *= 4)
+        benchQueue(count);
+
+    // The cost must stay flat up to the maximum number of processes
+    testAssert(benchQueue(MAX_PROCS) <= (small * 2) + 50);
+    return OK;
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <ProcessManager.h>
+#include <RunQueue.h>
+
+/**
+ * Process with only the members needed by the RunQueue.
+ */
+struct DummyProcess
+{
+    DummyProcess(const uint priority = Process::DefaultPriority)
+        : m_priority(priority)
+        , m_level(priority)
+        , m_schedulePrev(ZERO)
+        , m_scheduleNext(ZERO)
+        , m_scheduled(false)
+    {
+    }
+
+    uint m_priority;
+    uint m_level;
+    DummyProcess *m_schedulePrev;
+    DummyProcess *m_scheduleNext;
+    bool m_scheduled;
+};
+
+typedef RunQueue<DummyProcess, Process::MaximumPriority + 1> DummyQueue;
+
+TestCase(RunQueueEmpty)
+{
+    DummyQueue queue;
+
+    testAssert(queue.count() == 0);
+    testAssert(queue.select() == ZERO);
+    return OK;
+}
+
+TestCase(RunQueueSelectPriority)
+{
+    DummyQueue queue;
+    DummyProcess low(1), high(5);
+
+    queue.insert(&low);
+    queue.insert(&high);
+    testAssert(queue.count() == 2);
+    testAssert(low.m_scheduled);
+    testAssert(high.m_scheduled);
+
+    // The highest priority runs first
+    testAssert(queue.select() == &high);
+    return OK;
+}
+
+TestCase(RunQueueRoundRobin)
+{
+    DummyQueue queue;
+    DummyProcess a, b, c;
+
+    queue.insert(&a);
+    queue.insert(&b);
+    queue.insert(&c);
+
+    // Equal priorities take turns
+    testAssert(queue.select() == &a);
+    testAssert(queue.select() == &b);
+    testAssert(queue.select() == &c);
+    testAssert(queue.select() == &a);
+    testAssert(queue.count() == 3);
+    return OK;
+}
+
+TestCase(RunQueueRemove)
+{
+    DummyQueue queue;
+    DummyProcess a, b, c;
+
+    queue.insert(&a);
+    queue.insert(&b);
+    queue.insert(&c);
+
+    // Remove from the middle
+    testAssert(queue.select() == &a);
+    queue.remove(&b);
+    testAssert(!b.m_scheduled);
+    testAssert(b.m_schedulePrev == ZERO);
+    testAssert(b.m_scheduleNext == ZERO);
+    testAssert(queue.count() == 2);
+
+    // Removing restores the demoted level
+    queue.remove(&a);
+    testAssert(a.m_level == a.m_priority);
+    testAssert(queue.select() == &c);
+    queue.remove(&c);
+    testAssert(queue.count() == 0);
+    testAssert(queue.select() == ZERO);
+    return OK;
+}
+
+TestCase(RunQueueDemotion)
+{
+    DummyQueue queue;
+    DummyProcess busy(Process::MaximumPriority), consumer(Process::DefaultPriority);
+    Size selects = 0;
+
+    queue.insert(&busy);
+    queue.insert(&consumer);
+
+    // A busy process cannot keep the consumer from running
+    while (queue.select() != &consumer)
+    {
+        selects++;
+        testAssert(selects <= Process::MaximumPriority);
+    }
+    testAssert(busy.m_level < Process::MaximumPriority);
+
+    // Blocking restores the priority of the busy process
+    queue.remove(&busy);
+    queue.insert(&busy);
+    testAssert(busy.m_level == Process::MaximumPriority);
+    testAssert(queue.select() == &busy);
+    return OK;
+}
+
+TestCase(RunQueueAging)
+{
+    DummyQueue queue;
+    DummyProcess a(Process::MaximumPriority), b(Process::MaximumPriority);
+    DummyProcess low(Process::MinimumPriority);
+    bool ran = false;
+
+    queue.insert(&a);
+    queue.insert(&b);
+    queue.insert(&low);
+
+    // High priority processes which block after each time slice
+    for (Size i = 0; i < DummyQueue::AgingPeriod * 2 && !ran; i++)
+    {
+        DummyProcess *p = queue.select();
+
+        if (p == &low)
+            ran = true;
+        else
+        {
+            queue.remove(p);
+            queue.insert(p);
+        }
+    }
+
+    // The low priority process eventually runs
+    testAssert(ran);
+    return OK;
+}
+
+TestCase(RunQueueSetPriority)
+{
+    DummyQueue queue;
+    DummyProcess a, b;
+
+    queue.insert(&a);
+    queue.insert(&b);
+
+    // Raise a queued process
+    queue.setPriority(&b, Process::MaximumPriority);
+    testAssert(b.m_priority == Process::MaximumPriority);
+    testAssert(b.m_level == Process::MaximumPriority);
+    testAssert(b.m_scheduled);
+    testAssert(queue.count() == 2);
+    testAssert(queue.select() == &b);
+
+    // Change a process which is not queued
+    queue.remove(&a);
+    queue.setPriority(&a, Process::MinimumPriority);
+    testAssert(!a.m_scheduled);
+    testAssert(queue.count() == 1);
+    return OK;
+}
+
+TestCase(RunQueueMaxProcs)
+{
+    DummyQueue queue;
+    DummyProcess *procs = new DummyProcess[MAX_PROCS];
+
+    // Fill the queue with processes of all priorities
+    for (Size i = 0; i < MAX_PROCS; i++)
+    {
+        procs[i].m_priority = procs[i].m_level = i % (Process::MaximumPriority + 1);
+        queue.insert(&procs[i]);
+    }
+    testAssert(queue.count() == MAX_PROCS);
+
+    // Every process runs within a bounded number of selections
+    bool *ran = new bool[MAX_PROCS];
+    for (Size i = 0; i < MAX_PROCS; i++)
+        ran[i] = false;
+
+    for (Size i = 0; i < MAX_PROCS * (Process::MaximumPriority + 1); i++)
+        ran[queue.select() - procs] = true;
+
+    for (Size i = 0; i < MAX_PROCS; i++)
+        testAssert(ran[i]);
+    delete[] ran;
+
+    // Remove all in reverse order
+    for (Size i = MAX_PROCS; i > 0; i--)
+        queue.remove(&procs[i - 1]);
+
+    testAssert(queue.count() == 0);
+    testAssert(queue.select() == ZERO);
+    delete[] procs;
+    return OK;
+}
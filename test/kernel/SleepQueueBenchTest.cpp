@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <ProcessManager.h>
+#include <SleepQueue.h>
+#include <Queue.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+/**
+ * Process with only the members needed by the SleepQueue.
+ */
+struct BenchSleeper
+{
+    ProcessID getID() const
+    {
+        return m_id;
+    }
+
+    const Timer::Info & getSleepTimer() const
+    {
+        return m_timer;
+    }
+
+    ProcessID m_id;
+    Timer::Info m_timer;
+};
+
+/**
+ * Reference copy of the previous sleep timer queue.
+ *
+ * Every timer tick pops and pushes back all sleepers.
+ */
+class LinearSleepQueue
+{
+  public:
+
+    bool insert(BenchSleeper *obj)
+    {
+        return m_queue.push(obj);
+    }
+
+    BenchSleeper * expire(const Timer *timer)
+    {
+        const Size count = m_queue.count();
+        BenchSleeper *found = ZERO;
+
+        for (Size i = 0; i < count; i++)
+        {
+            BenchSleeper *obj = m_queue.pop();
+
+            if (!found && timer->isExpired(obj->getSleepTimer()))
+                found = obj;
+            else
+                m_queue.push(obj);
+        }
+
+        return found;
+    }
+
+  private:
+
+    Queue<BenchSleeper *, MAX_PROCS> m_queue;
+};
+
+/** Number of timer ticks measured per number of sleepers. */
+static const Size BenchTicks = 100000;
+
+/** Number of measurements of which the fastest is taken. */
+static const Size BenchRepeat = 5;
+
+/**
+ * Get the current time in nanoseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (((u64) tv.tv_sec * 1000000) + tv.tv_usec) * 1000;
+}
+
+/**
+ * Measure the sleep timer work of schedule() on each timer tick.
+ *
+ * One sleeper expires on every tick and sleeps again, behind all other sleepers.
+ *
+ * @return Nanoseconds per timer tick.
+ */
+template <class Q> static u64 benchQueue(const char *name, const Size count, const Size ticks)
+{
+    BenchSleeper *sleepers = new BenchSleeper[count];
+    u64 best = ~0ULL;
+
+    for (Size r = 0; r < BenchRepeat; r++)
+    {
+        Q *queue = new Q;
+        Timer timer;
+        Timer::Info now;
+
+        timer.setFrequency(100);
+
+        for (Size i = 0; i < count; i++)
+        {
+            sleepers[i].m_id = i;
+            sleepers[i].m_timer.frequency = 100;
+            sleepers[i].m_timer.ticks = i + 1;
+            queue->insert(&sleepers[i]);
+        }
+
+        const u64 t1 = benchTime();
+        for (Size i = 0; i < ticks; i++)
+        {
+            BenchSleeper *s;
+
+            timer.tick();
+            timer.getCurrent(&now);
+
+            while ((s = queue->expire(&timer)) != ZERO)
+            {
+                s->m_timer.ticks = now.ticks + count;
+                queue->insert(s);
+            }
+        }
+        const u64 t2 = benchTime();
+
+        if ((t2 - t1) / ticks < best)
+            best = (t2 - t1) / ticks;
+
+        delete queue;
+    }
+
+    printf("SleepQueueBench: %-6s %4u sleepers: %6u ns per tick\n",
+           name, count, (uint) best);
+
+    delete[] sleepers;
+    return best;
+}
+
+TestCase(SleepQueueBenchmark)
+{
+    const Size counts[] = { 10, 100, 1000 };
+    u64 heap[3], linear[3];
+
+    for (Size i = 0; i < 3; i++)
+    {
+        heap[i] = benchQueue<SleepQueue<BenchSleeper, MAX_PROCS> >("heap", counts[i], BenchTicks);
+        linear[i] = benchQueue<LinearSleepQueue>("linear", counts[i], BenchTicks / counts[i]);
+    }
+
+    // The cost per tick must stay flat, up to the logarithmic insert of the woken sleeper
+    testAssert(heap[2] <= (heap[0] * 4) + 100);
+    testAssert(heap[2] < linear[2]);
+    return OK;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <ProcessManager.h>
+#include <SleepQueue.h>
+
+/**
+ * Process with only the members needed by the SleepQueue.
+ */
+struct DummySleeper
+{
+    DummySleeper(const ProcessID id = 0, const u32 ticks = 0)
+        : m_id(id)
+    {
+        m_timer.frequency = 100;
+        m_timer.ticks = ticks;
+    }
+
+    ProcessID getID() const
+    {
+        return m_id;
+    }
+
+    const Timer::Info & getSleepTimer() const
+    {
+        return m_timer;
+    }
+
+    ProcessID m_id;
+    Timer::Info m_timer;
+};
+
+typedef SleepQueue<DummySleeper, MAX_PROCS> DummyQueue;
+
+/**
+ * Advance the timer to the given ticks and collect the expired sleepers.
+ *
+ * @return Number of sleepers written to the woken array.
+ */
+static Size wakeupUntil(DummyQueue & queue, Timer & timer, const u32 ticks,
+                        DummySleeper **woken, const Size max)
+{
+    Size count = 0;
+    DummySleeper *s;
+
+    while (true)
+    {
+        while ((s = queue.expire(&timer)) != ZERO)
+        {
+            if (count < max)
+                woken[count] = s;
+            count++;
+        }
+
+        Timer::Info info;
+        timer.getCurrent(&info);
+        if (info.ticks >= ticks)
+            break;
+
+        timer.tick();
+    }
+
+    return count;
+}
+
+TestCase(SleepQueueEmpty)
+{
+    DummyQueue queue;
+    Timer timer;
+
+    timer.setFrequency(100);
+    testAssert(queue.count() == 0);
+    testAssert(queue.expire(&timer) == ZERO);
+    return OK;
+}
+
+TestCase(SleepQueueDeadlineOrder)
+{
+    DummyQueue queue;
+    Timer timer;
+    DummySleeper sleepers[] = {
+        DummySleeper(7, 30), DummySleeper(3, 10), DummySleeper(12, 50),
+        DummySleeper(1, 20), DummySleeper(9, 40), DummySleeper(4, 20)
+    };
+    DummySleeper *woken[6];
+
+    timer.setFrequency(100);
+
+    for (Size i = 0; i < 6; i++)
+        testAssert(queue.insert(&sleepers[i]));
+
+    testAssert(queue.count() == 6);
+    testAssert(!queue.insert(&sleepers[0]));
+
+    // Nothing expires before the earliest deadline
+    testAssert(wakeupUntil(queue, timer, 9, woken, 6) == 0);
+
+    // Sleepers wake up in deadline order, and only once
+    testAssert(wakeupUntil(queue, timer, 10, woken, 6) == 1);
+    testAssert(woken[0] == &sleepers[1]);
+    testAssert(wakeupUntil(queue, timer, 20, woken, 6) == 2);
+    testAssert(woken[0]->m_timer.ticks == 20);
+    testAssert(woken[1]->m_timer.ticks == 20);
+    testAssert(wakeupUntil(queue, timer, 45, woken, 6) == 2);
+    testAssert(woken[0] == &sleepers[0]);
+    testAssert(woken[1] == &sleepers[4]);
+    testAssert(wakeupUntil(queue, timer, 100, woken, 6) == 1);
+    testAssert(woken[0] == &sleepers[2]);
+    testAssert(queue.count() == 0);
+    return OK;
+}
+
+TestCase(SleepQueueRemove)
+{
+    DummyQueue queue;
+    Timer timer;
+    DummySleeper sleepers[64];
+    DummySleeper *woken[64];
+
+    timer.setFrequency(100);
+
+    // Deadlines in a scrambled order
+    for (Size i = 0; i < 64; i++)
+    {
+        sleepers[i] = DummySleeper(i + 1, 100 + ((i * 37) % 64));
+        testAssert(queue.insert(&sleepers[i]));
+    }
+
+    // Wake up sleepers which are not at the top early
+    for (Size i = 0; i < 64; i += 3)
+    {
+        if (sleepers[i].m_timer.ticks != 100)
+        {
+            testAssert(queue.remove(&sleepers[i]));
+            testAssert(!queue.contains(&sleepers[i]));
+            testAssert(!queue.remove(&sleepers[i]));
+        }
+    }
+
+    // Sleep again on a later deadline
+    sleepers[3].m_timer.ticks = 500;
+    testAssert(queue.insert(&sleepers[3]));
+
+    // The remaining sleepers still wake up in deadline order
+    const Size count = queue.count();
+    testAssert(wakeupUntil(queue, timer, 1000, woken, 64) == count);
+
+    for (Size i = 1; i < count; i++)
+        testAssert(woken[i - 1]->m_timer.ticks <= woken[i]->m_timer.ticks);
+
+    testAssert(woken[count - 1] == &sleepers[3]);
+    testAssert(queue.count() == 0);
+    return OK;
+}
@@ -129,10 +129,11 @@ TestCase(PoolAllocate)
         }
 
         // Calculate the expected address
-        const Address payloadBase = bubbleBase + sizeof(PoolAllocator::Pool) + pa.m_pools[7]->bitmapSize;
-        const Address objectOffset = (i * pa.m_pools[7]->m_chunkSize) + sizeof(PoolAllocator::ObjectPrefix);
+        const Address payloadBase = pa.m_pools[7]->base();
+        const Address objectOffset = (i * pa.m_pools[7]->m_chunkSize) + PoolAllocator::ObjectPrefixSize;
 
         // Verify the returned address is correct
+        testAssert(payloadBase >= bubbleBase + sizeof(PoolAllocator::Pool) + pa.m_pools[7]->bitmapSize);
         testAssert(args.address >= payloadBase);
         testAssert(args.address < bubbleBase + bubbleSize);
         testAssert(args.address == payloadBase + objectOffset);
@@ -160,6 +161,7 @@ TestCase(PoolRelease)
         testAssert(pa.allocate(args) == Allocator::Success);
         testAssert(args.address != ZERO);
         testAssert(args.size == objectSize);
+        testAssert(args.address % PoolAllocator::ObjectAlignment == 0);
 
         objects.insert((u8 *)(args.address));
     }
@@ -180,6 +182,44 @@ TestCase(PoolRelease)
     return OK;
 }
 
+TestCase(PoolAlignment)
+{
+    DummyParent parent;
+    PoolAllocator pa(&parent);
+    Vector<u8 *> objects;
+
+    // The prefix must keep objects aligned for any fundamental type
+    testAssert(PoolAllocator::ObjectAlignment >= sizeof(u64));
+    testAssert(PoolAllocator::ObjectPrefixSize % PoolAllocator::ObjectAlignment == 0);
+
+    // Every object size returns aligned objects
+    for (Size size = 1; size <= 1024; size++)
+    {
+        Allocator::Range args = { 0, size, 0 };
+
+        testAssert(pa.allocate(args) == Allocator::Success);
+        testAssert(args.address % PoolAllocator::ObjectAlignment == 0);
+        objects.insert((u8 *)(args.address));
+    }
+
+    // Released objects are reused aligned as well
+    for (Size size = 1; size <= 1024; size += 2)
+    {
+        Allocator::Range args = { 0, size, 0 };
+
+        testAssert(pa.release((Address) objects[size - 1]) == Allocator::Success);
+        testAssert(pa.allocate(args) == Allocator::Success);
+        testAssert(args.address % PoolAllocator::ObjectAlignment == 0);
+        objects[size - 1] = (u8 *)(args.address);
+    }
+
+    for (Size i = 0; i < objects.count(); i++)
+        testAssert(pa.release((Address) objects[i]) == Allocator::Success);
+
+    testAssert(pa.size() == 0);
+    return OK;
+}
+
 TestCase(PoolIndex)
 {
     DummyParent parent;
@@ -193,7 +233,7 @@ TestCase(PoolIndex)
     for (Size i = 2; i < 22; i++)
     {
         const Size objectSize = 1U << i;
-        const Size actualSize = sizeof(PoolAllocator::ObjectPrefix) +
+        const Size actualSize = PoolAllocator::ObjectPrefixSize +
                                 sizeof(PoolAllocator::ObjectPostfix) +
                                 objectSize;
         Size index = 2;
@@ -210,7 +250,7 @@ TestCase(PoolIndex)
 
         // Verify the correct Pool is used
         const PoolAllocator::ObjectPrefix *prefix =
-            (const PoolAllocator::ObjectPrefix *) (args.address - sizeof(PoolAllocator::ObjectPrefix));
+            (const PoolAllocator::ObjectPrefix *) (args.address - PoolAllocator::ObjectPrefixSize);
 
         testAssert(pa.m_pools[index] != ZERO);
         testAssert(prefix->pool->index == index);
@@ -288,6 +328,57 @@ TestCase(PoolPrevNext)
     return OK;
 }
 
+TestCase(PoolPartial)
+{
+    DummyParent parent;
+    PoolAllocator pa(&parent);
+    Allocator::Range args = { 0, 64, 0 };
+    Vector<u8 *> objects;
+
+    // Fillup the first Pool. It must be removed from the partial list.
+    for (Size i = 0; i < 128; i++)
+    {
+        testAssert(pa.allocate(args) == Allocator::Success);
+        objects.insert((u8 *)(args.address));
+    }
+    PoolAllocator::Pool *firstPool = pa.m_pools[7];
+    testAssert(pa.m_partial[7] == ZERO);
+    testAssert(pa.m_poolCount[7] == 1);
+
+    // Allocate once more. The second Pool is partially used.
+    testAssert(pa.allocate(args) == Allocator::Success);
+    const Address extra = args.address;
+    testAssert(pa.m_poolCount[7] == 2);
+    testAssert(pa.m_partial[7] == pa.m_pools[7]);
+    testAssert(pa.m_partial[7] != firstPool);
+
+    // Release an object in the first Pool. It must become partial again.
+    testAssert(pa.release((Address) objects[10]) == Allocator::Success);
+    testAssert(pa.m_partial[7] == firstPool);
+    testAssert(firstPool->partialNext == pa.m_pools[7]);
+
+    // The next allocation must re-use the released object
+    testAssert(pa.allocate(args) == Allocator::Success);
+    testAssert(args.address == (Address) objects[10]);
+    testAssert(pa.m_partial[7] == pa.m_pools[7]);
+    testAssert(firstPool->partialNext == ZERO);
+
+    // Release all objects
+    testAssert(pa.release(extra) == Allocator::Success);
+    testAssert(pa.m_poolCount[7] == 1);
+
+    for (Size i = 0; i < objects.count(); i++)
+    {
+        testAssert(pa.release((Address) objects[i]) == Allocator::Success);
+    }
+
+    testAssert(pa.m_pools[7] == ZERO);
+    testAssert(pa.m_partial[7] == ZERO);
+    testAssert(pa.m_poolCount[7] == 0);
+
+    return OK;
+}
+
 TestCase(PoolObjectSize)
 {
     DummyParent parent;
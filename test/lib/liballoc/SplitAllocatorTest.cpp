@@ -169,3 +169,29 @@ TestCase(SplitAllocateRelease)
     testAssert(args.address == physBase + allocSize - PAGESIZE);
     return OK;
 }
+
+TestCase(SplitIsMapped)
+{
+    TestInt<uint> physAddresses((UINT_MAX/2) + 1, UINT_MAX/4*3);
+    TestInt<uint> virtAddresses(UINT_MAX/4, UINT_MAX/2);
+    const Address physBase = physAddresses.random() & PAGEMASK;
+    const Address virtBase = virtAddresses.random() & PAGEMASK;
+    const Size allocSize = 16 * PAGESIZE;
+
+    // Only the first half of the physical memory has a virtual mapping
+    const Allocator::Range physRange = { physBase, allocSize, PAGESIZE };
+    const Allocator::Range virtRange = { virtBase, allocSize / 2, PAGESIZE };
+    SplitAllocator sa(physRange, virtRange, PAGESIZE);
+
+    testAssert(sa.isMapped(physBase, PAGESIZE));
+    testAssert(sa.isMapped(physBase, allocSize / 2));
+    testAssert(sa.isMapped(physBase + PAGESIZE + 100, PAGESIZE));
+    testAssert(sa.isMapped(physBase + (allocSize / 2) - PAGESIZE, PAGESIZE));
+
+    // Ranges that leave the virtual mapping
+    testAssert(!sa.isMapped(physBase - PAGESIZE, PAGESIZE));
+    testAssert(!sa.isMapped(physBase, (allocSize / 2) + 1));
+    testAssert(!sa.isMapped(physBase + (allocSize / 2), PAGESIZE));
+    testAssert(!sa.isMapped(physBase + allocSize, PAGESIZE));
+    return OK;
+}
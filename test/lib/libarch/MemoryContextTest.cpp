@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <HashTable.h>
+#include <MemoryMap.h>
+#include <MemoryContext.h>
+#include <MemoryBlock.h>
+#include <Allocator.h>
+#include <SplitAllocator.h>
+#include <stdio.h>
+#include <sys/time.h>
+#ifdef __HOST__
+#include <stdlib.h>
+#include <new>
+#endif /* __HOST__ */
+
+/** Virtual address of the memory region used in the tests */
+static const Address RegionBase = 0x80000000;
+
+/** Size of the memory region used in the tests */
+static const Size RegionSize = MegaByte(64);
+
+/**
+ * MemoryContext which keeps its page mappings in a HashTable.
+ */
+class DummyMemoryContext : public MemoryContext
+{
+  public:
+
+    DummyMemoryContext(MemoryMap *map, SplitAllocator *alloc = ZERO) : MemoryContext(map, alloc)
+    {
+    }
+
+    virtual Result activate(bool initializeMMU = false)
+    {
+        return Success;
+    }
+
+    virtual Result map(Address virt, Address phys, Memory::Access access)
+    {
+        if (m_pages.contains(virt))
+            return AlreadyExists;
+
+        m_pages.insert(virt, phys);
+        trackRange(virt, PAGESIZE, true);
+        return Success;
+    }
+
+    virtual Result unmap(Address virt)
+    {
+        if (!m_pages.remove(virt))
+            return InvalidAddress;
+
+        trackRange(virt, PAGESIZE, false);
+        return Success;
+    }
+
+    virtual Result lookup(Address virt, Address *phys) const
+    {
+        const Address *p = m_pages.get(virt & PAGEMASK);
+
+        if (!p)
+            return InvalidAddress;
+
+        *phys = *p;
+        return Success;
+    }
+
+    virtual Result access(Address addr, Memory::Access *access) const
+    {
+        return m_pages.contains(addr & PAGEMASK) ? Success : InvalidAddress;
+    }
+
+    virtual Result releaseRange(Memory::Range *range, bool tablesOnly = false)
+    {
+        for (Size i = 0; i < range->size; i += PAGESIZE)
+            unmap(range->virt + i);
+
+        return Success;
+    }
+
+    virtual Result releaseRegion(MemoryMap::Region region, bool tablesOnly = false)
+    {
+        Memory::Range range = m_map->range(region);
+        return releaseRange(&range);
+    }
+
+    /**
+     * Change the page tables without updating the administration of findFree().
+     */
+    void setUntracked(const Address virt, const bool mapped)
+    {
+        if (mapped)
+            m_pages.insert(virt, virt);
+        else
+            m_pages.remove(virt);
+    }
+
+    /**
+     * Find unused memory by looking up every page in the region.
+     *
+     * This is the page-by-page scan which findFree() used before, as a reference.
+     */
+    Result findFreeScan(Size size, MemoryMap::Region region, Address *virt) const
+    {
+        const Memory::Range r = m_map->range(region);
+        Size currentSize = 0;
+        Address addr = r.virt, currentAddr = r.virt, tmp;
+
+        while (addr < r.virt + r.size && currentSize < size)
+        {
+            if (lookup(addr, &tmp) == InvalidAddress)
+            {
+                currentSize += PAGESIZE;
+            }
+            else
+            {
+                currentSize = 0;
+                currentAddr = addr + PAGESIZE;
+            }
+            addr += PAGESIZE;
+        }
+
+        if (currentSize >= size)
+        {
+            *virt = currentAddr;
+            return Success;
+        }
+        else
+            return OutOfMemory;
+    }
+
+  private:
+
+    HashTable<Address, Address> m_pages;
+};
+
+/**
+ * Create a MemoryMap with only the UserPrivate region set.
+ */
+static MemoryMap createMap()
+{
+    MemoryMap map;
+    const Memory::Range range = { RegionBase, 0, RegionSize, Memory::Readable };
+
+    map.setRange(MemoryMap::UserPrivate, range);
+    return map;
+}
+
+/**
+ * Get the current time in microseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return ((u64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+#ifdef __HOST__
+
+/** Number of bytes currently allocated with new on the host. */
+static Size heapBytes = 0;
+
+/** Bytes in front of each allocation to store its size, keeps malloc() alignment. */
+static const Size HeapHeaderSize = sizeof(Size) * 2;
+
+void * operator new(size_t size) throw (std::bad_alloc)
+{
+    u8 *ptr = (u8 *) malloc(HeapHeaderSize + size);
+    if (!ptr)
+        throw std::bad_alloc();
+
+    *(Size *) ptr = size;
+    heapBytes += size;
+    return ptr + HeapHeaderSize;
+}
+
+void operator delete(void *mem) throw ()
+{
+    if (mem)
+    {
+        u8 *ptr = ((u8 *) mem) - HeapHeaderSize;
+        heapBytes -= *(Size *) ptr;
+        free(ptr);
+    }
+}
+
+void * operator new[](size_t size) throw (std::bad_alloc)
+{
+    return operator new(size);
+}
+
+void operator delete[](void *mem) throw ()
+{
+    operator delete(mem);
+}
+
+#endif /* __HOST__ */
+
+/**
+ * Get the number of bytes currently allocated from the heap.
+ */
+static Size heapUsage()
+{
+#ifdef __HOST__
+    return heapBytes;
+#else
+    const Allocator *alloc = Allocator::getDefault();
+    return alloc->size() - alloc->available();
+#endif /* __HOST__ */
+}
+
+TestCase(MemoryContextFindFree)
+{
+    MemoryMap map = createMap();
+    DummyMemoryContext ctx(&map);
+    Address virt = 0;
+
+    // Empty region gives the first pages
+    testAssert(ctx.findFree(PAGESIZE * 4, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase);
+
+    // Map a few pages with a hole of two pages in between
+    for (Size i = 0; i < 8; i++)
+        if (i != 3 && i != 4)
+            testAssert(ctx.map(RegionBase + (i * PAGESIZE), i * PAGESIZE, Memory::Readable) == MemoryContext::Success);
+
+    // Small blocks fit in the hole, larger blocks come after the mapped pages
+    testAssert(ctx.findFree(PAGESIZE, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase + (PAGESIZE * 3));
+    testAssert(ctx.findFree(PAGESIZE * 2, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase + (PAGESIZE * 3));
+    testAssert(ctx.findFree((PAGESIZE * 2) + 1, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase + (PAGESIZE * 8));
+
+    // Unmapping makes the pages available again
+    testAssert(ctx.unmap(RegionBase + (PAGESIZE * 2)) == MemoryContext::Success);
+    testAssert(ctx.findFree(PAGESIZE * 3, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase + (PAGESIZE * 2));
+
+    // Whole region
+    testAssert(ctx.findFree(RegionSize, MemoryMap::UserPrivate, &virt) == MemoryContext::OutOfMemory);
+    testAssert(ctx.releaseRegion(MemoryMap::UserPrivate) == MemoryContext::Success);
+    testAssert(ctx.findFree(RegionSize, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase);
+    return OK;
+}
+
+TestCase(MemoryContextFindFreeUntracked)
+{
+    MemoryMap map = createMap();
+    DummyMemoryContext ctx(&map);
+    Address virt = 0;
+
+    // Create the administration first
+    testAssert(ctx.findFree(PAGESIZE, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase);
+
+    // Pages mapped without notice are found by verifying the candidate block
+    ctx.setUntracked(RegionBase + PAGESIZE, true);
+    testAssert(ctx.findFree(PAGESIZE * 2, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase + (PAGESIZE * 2));
+    testAssert(ctx.findFree(PAGESIZE, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase);
+
+    // Fill the region and release a block without notice: found by a rescan
+    for (Size i = 0; i < RegionSize; i += PAGESIZE)
+        ctx.map(RegionBase + i, i, Memory::Readable);
+
+    testAssert(ctx.findFree(PAGESIZE, MemoryMap::UserPrivate, &virt) == MemoryContext::OutOfMemory);
+    ctx.setUntracked(RegionBase + MegaByte(1), false);
+    ctx.setUntracked(RegionBase + MegaByte(1) + PAGESIZE, false);
+    testAssert(ctx.findFree(PAGESIZE * 2, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase + MegaByte(1));
+    testAssert(ctx.findFree(PAGESIZE * 3, MemoryMap::UserPrivate, &virt) == MemoryContext::OutOfMemory);
+    return OK;
+}
+
+TestCase(MemoryContextHeapUsage)
+{
+    MemoryMap map = createMap();
+    static const Size NumContexts = 100;
+    DummyMemoryContext *contexts[NumContexts];
+    Size findFreeUsage = 0;
+    Address virt = 0;
+
+    for (Size round = 0; round < 2; round++)
+    {
+        const Size before = heapUsage();
+
+        // Each context uses a few pages, like a freshly created process
+        for (Size i = 0; i < NumContexts; i++)
+        {
+            contexts[i] = new DummyMemoryContext(&map);
+
+            const Size usage = heapUsage();
+            testAssert(contexts[i]->findFree(PAGESIZE * 4, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+            testAssert(virt == RegionBase);
+            findFreeUsage += heapUsage() - usage;
+
+            for (Size j = 0; j < 4; j++)
+                testAssert(contexts[i]->map(virt + (j * PAGESIZE), j * PAGESIZE,
+                                            Memory::Readable) == MemoryContext::Success);
+        }
+
+        // The administration must not cover the whole region up front
+        testAssert(findFreeUsage / NumContexts < (RegionSize / PAGESIZE / 8) / 4);
+
+        // Destroying the contexts releases everything
+        for (Size i = 0; i < NumContexts; i++)
+            delete contexts[i];
+
+        testAssert(heapUsage() == before);
+        findFreeUsage = 0;
+    }
+
+    // The administration grows when the start of the region is in use
+    DummyMemoryContext ctx(&map);
+    for (Size i = 0; i < 1024; i++)
+    {
+        testAssert(ctx.findFree(PAGESIZE, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+        testAssert(virt == RegionBase + (i * PAGESIZE));
+        testAssert(ctx.map(virt, 0, Memory::Readable) == MemoryContext::Success);
+    }
+    testAssert(ctx.unmap(RegionBase + (PAGESIZE * 10)) == MemoryContext::Success);
+    testAssert(ctx.findFree(PAGESIZE, MemoryMap::UserPrivate, &virt) == MemoryContext::Success);
+    testAssert(virt == RegionBase + (PAGESIZE * 10));
+
+    return OK;
+}
+
+TestCase(MemoryContextMapLazy)
+{
+    static u8 memory[PAGESIZE * 4] __attribute__((aligned(PAGESIZE)));
+    const Allocator::Range range = { (Address) memory, sizeof(memory), PAGESIZE };
+    const Memory::Access access = Memory::User | Memory::Readable | Memory::Writable;
+    const Memory::Range bss = { RegionBase + PAGESIZE, 0, PAGESIZE * 2, access };
+    const Memory::Range unaligned = { RegionBase + 1, 0, PAGESIZE, access };
+    const Memory::Range overlap = { RegionBase, 0, PAGESIZE * 2, access };
+    SplitAllocator alloc(range, range, PAGESIZE);
+    MemoryMap map = createMap();
+    DummyMemoryContext ctx(&map, &alloc);
+    Address phys = 0, again = 0;
+
+    // Pages are zeroed when they are mapped, not before
+    MemoryBlock::set(memory, 0xff, sizeof(memory));
+
+    // Ranges are page aligned and do not overlap
+    testAssert(ctx.mapRangeLazy(&unaligned) == MemoryContext::InvalidAddress);
+    testAssert(ctx.mapRangeLazy(&bss) == MemoryContext::Success);
+    testAssert(ctx.mapRangeLazy(&overlap) == MemoryContext::AlreadyExists);
+
+    // Nothing is allocated up front
+    testAssert(alloc.available() == sizeof(memory));
+    testAssert(ctx.lookup(bss.virt, &phys) == MemoryContext::InvalidAddress);
+    testAssert(ctx.touch(bss.virt - 1, &phys) == MemoryContext::InvalidAddress);
+    testAssert(ctx.touch(bss.virt + bss.size, &phys) == MemoryContext::InvalidAddress);
+
+    // The first access maps a zeroed page
+    testAssert(ctx.touch(bss.virt + PAGESIZE + 123, &phys) == MemoryContext::Success);
+    testAssert(alloc.available() == sizeof(memory) - PAGESIZE);
+    testAssert(ctx.lookup(bss.virt + PAGESIZE, &again) == MemoryContext::Success);
+    testAssert(again == phys);
+
+    const u8 *page = (const u8 *) alloc.toVirtual(phys);
+    for (Size i = 0; i < PAGESIZE; i++)
+    {
+        testAssert(page[i] == 0);
+    }
+
+    // Later accesses use the same page
+    testAssert(ctx.touch(bss.virt + PAGESIZE, &again) == MemoryContext::Success);
+    testAssert(again == phys);
+    testAssert(alloc.available() == sizeof(memory) - PAGESIZE);
+
+    // Other pages of the range stay unmapped until used
+    testAssert(ctx.lookup(bss.virt, &phys) == MemoryContext::InvalidAddress);
+    return OK;
+}
+
+TestCase(MemoryContextFindFreeBench)
+{
+    MemoryMap map = createMap();
+    DummyMemoryContext ctx(&map);
+    const Size rounds = 64;
+    const Size freePages = 16;
+    Address scanVirt = 0, virt = 0;
+    bool equal = true;
+    u64 t1, t2, t3;
+
+    // Fill the region except for the last pages
+    for (Size i = 0; i < RegionSize - (freePages * PAGESIZE); i += PAGESIZE)
+        testAssert(ctx.map(RegionBase + i, i, Memory::Readable) == MemoryContext::Success);
+
+    // Page-by-page scan
+    t1 = benchTime();
+    for (Size i = 0; i < rounds; i++)
+        equal = equal && ctx.findFreeScan(PAGESIZE * ((i % freePages) + 1), MemoryMap::UserPrivate,
+                                          &scanVirt) == MemoryContext::Success;
+
+    // Mapped pages administration
+    t2 = benchTime();
+    for (Size i = 0; i < rounds; i++)
+        equal = equal && ctx.findFree(PAGESIZE * ((i % freePages) + 1), MemoryMap::UserPrivate,
+                                      &virt) == MemoryContext::Success;
+    t3 = benchTime();
+
+    testAssert(equal);
+    testAssert(virt == scanVirt);
+    testAssert(virt == RegionBase + RegionSize - (freePages * PAGESIZE));
+
+    printf("findFree %u pages: scan %u usec, bitmap %u usec (per call)\n",
+           RegionSize / PAGESIZE, (uint) ((t2 - t1) / rounds), (uint) ((t3 - t2) / rounds));
+    return OK;
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <BlockCache.h>
+
+/**
+ * Storage in memory which counts read requests
+ */
+class DummyStorage : public Storage
+{
+  public:
+
+    DummyStorage(const Size size)
+        : m_size(size)
+        , m_reads(0)
+    {
+        m_data = new u8[size];
+        for (Size i = 0; i < size; i++)
+            m_data[i] = i * 7;
+    }
+
+    virtual ~DummyStorage()
+    {
+        delete[] m_data;
+    }
+
+    virtual FileSystem::Result initialize()
+    {
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result read(const u64 offset, void *buffer, const Size size) const
+    {
+        if (offset + size > m_size)
+            return FileSystem::IOError;
+
+        MemoryBlock::copy(buffer, m_data + offset, size);
+        m_reads++;
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result write(const u64 offset, void *buffer, const Size size)
+    {
+        if (offset + size > m_size)
+            return FileSystem::IOError;
+
+        MemoryBlock::copy(m_data + offset, buffer, size);
+        return FileSystem::Success;
+    }
+
+    virtual u64 capacity() const
+    {
+        return m_size;
+    }
+
+    u8 *m_data;
+    Size m_size;
+    mutable Size m_reads;
+};
+
+/**
+ * Storage in memory which gives direct access to its contents
+ */
+class MappedStorage : public DummyStorage
+{
+  public:
+
+    MappedStorage(const Size size)
+        : DummyStorage(size)
+    {
+    }
+
+    virtual const u8 * map(const u64 offset, const Size size) const
+    {
+        return offset + size <= m_size ? m_data + offset : ZERO;
+    }
+};
+
+/**
+ * Compare a buffer with the contents of storage
+ */
+static bool equalsStorage(const u8 *buffer, const DummyStorage & storage,
+                          const Size offset, const Size size)
+{
+    for (Size i = 0; i < size; i++)
+        if (buffer[i] != storage.m_data[offset + i])
+            return false;
+
+    return true;
+}
+
+TestCase(BlockCacheReadHit)
+{
+    DummyStorage storage(1024 * 16);
+    BlockCache cache(&storage, 1024, 4);
+    u8 buf[100];
+
+    // The first read loads the block from storage
+    testAssert(cache.read(1030, buf, sizeof(buf)) == FileSystem::Success);
+    testAssert(equalsStorage(buf, storage, 1030, sizeof(buf)));
+    testAssert(storage.m_reads == 1);
+    testAssert(cache.getMisses() == 1);
+    testAssert(cache.getHits() == 0);
+
+    // Reading the same block again is served from the cache
+    testAssert(cache.read(1500, buf, sizeof(buf)) == FileSystem::Success);
+    testAssert(equalsStorage(buf, storage, 1500, sizeof(buf)));
+    testAssert(storage.m_reads == 1);
+    testAssert(cache.getMisses() == 1);
+    testAssert(cache.getHits() == 1);
+
+    // Reading beyond the end of storage fails
+    testAssert(cache.read(1024 * 16, buf, sizeof(buf)) == FileSystem::IOError);
+    return OK;
+}
+
+TestCase(BlockCacheReadMultiple)
+{
+    DummyStorage storage(1024 * 16);
+    BlockCache cache(&storage, 1024, 8);
+    u8 buf[1024 * 3];
+
+    // Missing blocks of one request are read from storage at once
+    testAssert(cache.read(512, buf, sizeof(buf)) == FileSystem::Success);
+    testAssert(equalsStorage(buf, storage, 512, sizeof(buf)));
+    testAssert(storage.m_reads == 1);
+    testAssert(cache.getMisses() == 4);
+
+    // Overlapping request only reads the blocks which are missing
+    testAssert(cache.read(1024 * 3, buf, sizeof(buf)) == FileSystem::Success);
+    testAssert(equalsStorage(buf, storage, (1024 * 3), sizeof(buf)));
+    testAssert(storage.m_reads == 2);
+    testAssert(cache.getMisses() == 6);
+    testAssert(cache.getHits() == 1);
+    return OK;
+}
+
+TestCase(BlockCacheEvictLeastRecentlyUsed)
+{
+    DummyStorage storage(1024 * 16);
+    BlockCache cache(&storage, 1024, 3);
+    u8 byte;
+
+    // Fill the cache with blocks 0, 1 and 2
+    for (Size i = 0; i < 3; i++)
+        testAssert(cache.read(i * 1024, &byte, 1) == FileSystem::Success);
+    testAssert(storage.m_reads == 3);
+
+    // Use block 0, which makes block 1 the least recently used
+    testAssert(cache.read(0, &byte, 1) == FileSystem::Success);
+    testAssert(storage.m_reads == 3);
+
+    // Block 3 replaces block 1
+    testAssert(cache.read(3 * 1024, &byte, 1) == FileSystem::Success);
+    testAssert(byte == storage.m_data[3 * 1024]);
+    testAssert(storage.m_reads == 4);
+    testAssert(cache.getEvictions() == 1);
+
+    testAssert(cache.read(0, &byte, 1) == FileSystem::Success);
+    testAssert(cache.read(2 * 1024, &byte, 1) == FileSystem::Success);
+    testAssert(storage.m_reads == 4);
+    testAssert(cache.read(1024, &byte, 1) == FileSystem::Success);
+    testAssert(storage.m_reads == 5);
+    return OK;
+}
+
+TestCase(BlockCachePrefetch)
+{
+    DummyStorage storage(1024 * 16 + 100);
+    BlockCache cache(&storage, 1024, 32);
+    u8 buf[1024 * 4];
+
+    // Prefetch loads all blocks with a single read
+    testAssert(cache.prefetch(1024 * 2, 1024 * 6) == FileSystem::Success);
+    testAssert(storage.m_reads == 1);
+    testAssert(cache.getPrefetched() == 6);
+
+    testAssert(cache.read(1024 * 3, buf, sizeof(buf)) == FileSystem::Success);
+    testAssert(equalsStorage(buf, storage, (1024 * 3), sizeof(buf)));
+    testAssert(storage.m_reads == 1);
+    testAssert(cache.getHits() == 4);
+    testAssert(cache.getMisses() == 0);
+
+    // Prefetch stops at the partial last block of storage
+    testAssert(cache.prefetch(1024 * 15, 1024 * 8) == FileSystem::Success);
+    testAssert(storage.m_reads == 2);
+    testAssert(cache.getPrefetched() == 8);
+    testAssert(cache.read(1024 * 16, buf, 100) == FileSystem::Success);
+    testAssert(equalsStorage(buf, storage, (1024 * 16), 100));
+    testAssert(cache.read(1024 * 16, buf, 101) == FileSystem::IOError);
+    testAssert(storage.m_reads == 2);
+    return OK;
+}
+
+TestCase(BlockCacheWrite)
+{
+    DummyStorage storage(1024 * 16);
+    BlockCache cache(&storage, 1024, 4);
+    u8 buf[1024];
+
+    testAssert(cache.read(0, buf, sizeof(buf)) == FileSystem::Success);
+
+    // Writes go to storage and update the cached block
+    MemoryBlock::set(buf, 0xab, sizeof(buf));
+    testAssert(cache.write(1000, buf, 100) == FileSystem::Success);
+    testAssert(storage.m_data[1000] == 0xab);
+    testAssert(storage.m_data[1099] == 0xab);
+
+    MemoryBlock::set(buf, 0, sizeof(buf));
+    testAssert(cache.read(990, buf, 120) == FileSystem::Success);
+    testAssert(equalsStorage(buf, storage, 990, 120));
+    testAssert(storage.m_reads == 2);
+    return OK;
+}
+
+TestCase(BlockCacheMapped)
+{
+    MappedStorage storage(1024 * 16);
+    BlockCache cache(&storage, 1024, 4);
+    u8 buf[1024 * 2];
+
+    // Memory-resident storage is accessed directly
+    testAssert(cache.map(1030, 100) == storage.m_data + 1030);
+    testAssert(cache.map(1024 * 16, 1) == ZERO);
+
+    // Reads copy from storage without filling the cache
+    testAssert(cache.read(512, buf, sizeof(buf)) == FileSystem::Success);
+    testAssert(equalsStorage(buf, storage, 512, sizeof(buf)));
+    testAssert(cache.prefetch(0, 1024 * 4) == FileSystem::Success);
+    testAssert(storage.m_reads == 0);
+    testAssert(cache.getMisses() == 0);
+    testAssert(cache.getPrefetched() == 0);
+
+    // Storage without direct access is not mapped
+    DummyStorage plain(1024);
+    BlockCache plainCache(&plain, 1024, 4);
+    testAssert(plainCache.map(0, 1) == ZERO);
+    return OK;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/API/ProcessID.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <PseudoFile.h>
+#include <ChunkFile.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+/** Number of bytes written at once. */
+static const Size BenchWriteSize = 512;
+
+/** Largest file for which PseudoFile is measured, as it is quadratic. */
+static const Size BenchPseudoMaximum = 256 * 1024;
+
+/**
+ * Get the current time in microseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return ((u64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+/**
+ * Append to a file in small writes and read it back.
+ *
+ * @return True if all bytes were written and read back.
+ */
+static bool benchFile(const char *name, File *file, const Size total)
+{
+    u8 data[BenchWriteSize], buf[BenchWriteSize];
+    FileSystemMessage msg;
+    bool success = true;
+    u64 t1, t2, t3;
+
+    msg.from   = SELF;
+    msg.size   = BenchWriteSize;
+    msg.offset = 0;
+
+    t1 = benchTime();
+    msg.action = FileSystem::WriteFile;
+    msg.buffer = (char *) data;
+
+    for (Size offset = 0; offset < total; offset += BenchWriteSize)
+    {
+        IOBuffer io(&msg);
+        data[0] = offset / BenchWriteSize;
+        success = success && file->write(io, BenchWriteSize, offset) == (FileSystem::Error) BenchWriteSize;
+    }
+
+    t2 = benchTime();
+    msg.action = FileSystem::ReadFile;
+    msg.buffer = (char *) buf;
+
+    for (Size offset = 0; offset < total; offset += BenchWriteSize)
+    {
+        IOBuffer io(&msg);
+        success = success && file->read(io, BenchWriteSize, offset) == (FileSystem::Error) BenchWriteSize &&
+                  buf[0] == (u8) (offset / BenchWriteSize);
+    }
+    t3 = benchTime();
+
+    printf("ChunkFileBench: %-8s %6u KB in %u byte writes: append %8u us, read %7u us\n",
+           name, total / 1024, BenchWriteSize, (uint) (t2 - t1), (uint) (t3 - t2));
+
+    delete file;
+    return success;
+}
+
+TestCase(ChunkFileBenchmark)
+{
+    for (Size total = 64 * 1024; total <= 10 * 1024 * 1024; total *= 4)
+    {
+        if (total <= BenchPseudoMaximum)
+            testAssert(benchFile("pseudo", new PseudoFile(), total));
+
+        testAssert(benchFile("chunk", new ChunkFile(), total));
+    }
+
+    // Append 10MB
+    testAssert(benchFile("chunk", new ChunkFile(), 10 * 1024 * 1024));
+    return OK;
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/API/ProcessID.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <ChunkFile.h>
+
+/**
+ * Prepare a message for I/O on local memory.
+ */
+static void prepareMessage(FileSystemMessage *msg, const FileSystem::Action action,
+                           void *buffer, const Size size)
+{
+    msg->from   = SELF;
+    msg->action = action;
+    msg->buffer = (char *) buffer;
+    msg->size   = size;
+    msg->offset = 0;
+}
+
+/**
+ * Write local memory to the file.
+ */
+static FileSystem::Error writeFile(File & file, void *buffer, const Size size, const Size offset)
+{
+    FileSystemMessage msg;
+    prepareMessage(&msg, FileSystem::WriteFile, buffer, size);
+
+    IOBuffer io(&msg);
+    return file.write(io, size, offset);
+}
+
+/**
+ * Read the file into local memory.
+ */
+static FileSystem::Error readFile(File & file, void *buffer, const Size size, const Size offset)
+{
+    FileSystemMessage msg;
+    prepareMessage(&msg, FileSystem::ReadFile, buffer, size);
+
+    IOBuffer io(&msg);
+    return file.read(io, size, offset);
+}
+
+/**
+ * Retrieve the size of the file.
+ */
+static Size fileSize(File & file)
+{
+    FileSystem::FileStat st;
+    FileSystemMessage msg;
+    prepareMessage(&msg, FileSystem::StatFile, ZERO, 0);
+    msg.stat = &st;
+
+    return file.status(&msg) == FileSystem::Success ? st.size : ~0U;
+}
+
+/**
+ * Compare the contents of two buffers.
+ */
+static bool equalBuffers(const u8 *a, const u8 *b, const Size size)
+{
+    for (Size i = 0; i < size; i++)
+        if (a[i] != b[i])
+            return false;
+
+    return true;
+}
+
+TestCase(ChunkFileReadWrite)
+{
+    ChunkFile file;
+    char data[] = "testing 123 abc";
+    char buf[64];
+
+    // New file is empty
+    testAssert(fileSize(file) == 0);
+    testAssert(readFile(file, buf, sizeof(buf), 0) == 0);
+    testAssert(file.getChunk(0) == ZERO);
+
+    // Write and read back
+    testAssert(writeFile(file, data, sizeof(data), 0) == sizeof(data));
+    testAssert(fileSize(file) == sizeof(data));
+    testAssert(readFile(file, buf, sizeof(buf), 0) == sizeof(data));
+    testString(buf, data);
+
+    // Read beyond the end
+    testAssert(readFile(file, buf, sizeof(buf), sizeof(data)) == 0);
+
+    // Overwrite without changing the size
+    testAssert(writeFile(file, data, 3, 8) == 3);
+    testAssert(fileSize(file) == sizeof(data));
+    testAssert(readFile(file, buf, sizeof(buf), 0) == sizeof(data));
+    testString(buf, "testing tes abc");
+    return OK;
+}
+
+TestCase(ChunkFileMultipleChunks)
+{
+    ChunkFile file;
+    const Size size = (ChunkFile::ChunkSize * 3) + 100;
+    const Size offset = ChunkFile::ChunkSize - 10;
+    u8 *data = new u8[size];
+    u8 *buf = new u8[size];
+
+    for (Size i = 0; i < size; i++)
+        data[i] = i * 7;
+
+    // Write across chunk boundaries
+    testAssert(writeFile(file, data, size, offset) == (FileSystem::Error) size);
+    testAssert(fileSize(file) == offset + size);
+    testAssert(file.getChunk(offset) != ZERO);
+    testAssert(file.getChunk(offset + size - 1) != ZERO);
+    testAssert(file.getChunk(offset + size) == ZERO);
+
+    // Read back at once
+    MemoryBlock::set(buf, 0, size);
+    testAssert(readFile(file, buf, size, offset) == (FileSystem::Error) size);
+    testAssert(equalBuffers(buf, data, size));
+
+    // Read back a range in the middle
+    MemoryBlock::set(buf, 0, size);
+    testAssert(readFile(file, buf, ChunkFile::ChunkSize, offset + 100) == (FileSystem::Error) ChunkFile::ChunkSize);
+    testAssert(equalBuffers(buf, data + 100, ChunkFile::ChunkSize));
+
+    delete[] data;
+    delete[] buf;
+    return OK;
+}
+
+TestCase(ChunkFileHoles)
+{
+    ChunkFile file;
+    const Size offset = ChunkFile::ChunkSize * 5;
+    char data[] = "hole";
+    u8 *buf = new u8[offset + sizeof(data)];
+
+    // Write beyond the end of an empty file
+    testAssert(writeFile(file, data, sizeof(data), offset) == sizeof(data));
+    testAssert(fileSize(file) == offset + sizeof(data));
+
+    // Only the written chunk is allocated
+    for (Size i = 0; i < 5; i++)
+        testAssert(file.getChunk(i * ChunkFile::ChunkSize) == ZERO);
+    testAssert(file.getChunk(offset) != ZERO);
+
+    // The hole reads as zeroes
+    MemoryBlock::set(buf, 0xff, offset + sizeof(data));
+    testAssert(readFile(file, buf, offset + sizeof(data), 0) == (FileSystem::Error) (offset + sizeof(data)));
+
+    for (Size i = 0; i < offset; i++)
+        testAssert(buf[i] == 0);
+
+    testString((char *) buf + offset, data);
+
+    delete[] buf;
+    return OK;
+}
+
+TestCase(ChunkFileAppend)
+{
+    ChunkFile file;
+    const Size count = 100;
+    u8 data[512], buf[512];
+
+    // Append a number of small writes
+    for (Size i = 0; i < count; i++)
+    {
+        MemoryBlock::set(data, i, sizeof(data));
+        testAssert(writeFile(file, data, sizeof(data), fileSize(file)) == sizeof(data));
+    }
+    testAssert(fileSize(file) == count * sizeof(data));
+
+    // Verify each write
+    for (Size i = 0; i < count; i++)
+    {
+        testAssert(readFile(file, buf, sizeof(buf), i * sizeof(buf)) == sizeof(buf));
+        testAssert(buf[0] == (u8) i);
+        testAssert(buf[sizeof(buf) - 1] == (u8) i);
+    }
+
+    return OK;
+}
+
+TestCase(ChunkFileMaximumSize)
+{
+    ChunkFile file;
+    const Size size = ChunkFile::ChunkSize + 123;
+    const Size offset = ~0U - size;
+    u8 data[ChunkFile::ChunkSize + 123], buf[ChunkFile::ChunkSize + 123];
+
+    // Write the last bytes below the maximum file size, across two chunks
+    for (Size i = 0; i < size; i++)
+        data[i] = i * 3;
+
+    testAssert(writeFile(file, data, size, offset) == (FileSystem::Error) size);
+    testAssert(readFile(file, buf, size, offset) == (FileSystem::Error) size);
+    testAssert(equalBuffers(data, buf, size));
+    testAssert(readFile(file, buf, 1, offset + size) == 0);
+
+    // Writes which end beyond the maximum file size are rejected
+    testAssert(writeFile(file, data, 1, offset + size) == FileSystem::InvalidArgument);
+    testAssert(writeFile(file, data, size, offset + 1) == FileSystem::InvalidArgument);
+    testAssert(readFile(file, buf, 1, offset + size) == 0);
+    return OK;
+}
@@ -89,6 +89,39 @@ class DummyFileSystem : public FileSystemServer
 
 u8 DummyFileSystem::m_pages[PAGESIZE * 2 * 4];
 
+/**
+ * File which has data to read only after it is made available.
+ */
+class WaitFile : public File
+{
+  public:
+
+    WaitFile() : m_available(false), m_reads(0)
+    {
+        m_readyEvents = true;
+    }
+
+    virtual FileSystem::Error read(IOBuffer & buffer, Size size, Size offset)
+    {
+        m_reads++;
+
+        if (!m_available)
+            return FileSystem::RetryAgain;
+
+        m_available = false;
+        return 0;
+    }
+
+    void makeAvailable()
+    {
+        m_available = true;
+        signalReady();
+    }
+
+    bool m_available;
+    Size m_reads;
+};
+
 TestCase(FileSystemServerConstruct)
 {
     Directory *root = new Directory();
@@ -223,6 +256,101 @@ TestCase(FileSystemServerReadFile)
     return OK;
 }
 
+TestCase(FileSystemServerReadFileBulk)
+{
+    DummyFileSystem fs(new Directory(), "/mnt");
+    File *file = new PseudoFile("mydata");
+    testAssert(fs.registerFile(file, "myfile.txt") == FileSystem::Success);
+
+    // Mask error output
+    Log::instance()->setMinimumLogLevel(Log::Critical);
+
+    // Prepare bulk message without a bulk I/O share with the client
+    String path("/mnt/myfile.txt");
+    char buf[128];
+    FileSystemMessage msg;
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::ReadFileBulk;
+    msg.path   = *path;
+    msg.buffer = buf;
+    msg.size   = sizeof(buf);
+    msg.offset = 0;
+
+    // Process the message
+    fs.pathHandler(&msg);
+
+    // Without the share the request must fail
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.action == FileSystem::ReadFileBulk);
+    testAssert(msg.result == FileSystem::IOError);
+
+    return OK;
+}
+
+TestCase(FileSystemServerBulkShare)
+{
+    DummyFileSystem fs(new Directory(), "/mnt");
+    File *file = new PseudoFile("mydata");
+    testAssert(fs.registerFile(file, "myfile.txt") == FileSystem::Success);
+
+    // Create the bulk I/O share, as the client would do
+    const SystemInformation info;
+    ProcessShares::MemoryShare share;
+    share.pid    = fs.m_pid;
+    share.coreId = info.coreId;
+    share.tagId  = FileSystem::BulkShareTag;
+    share.range.virt   = 0;
+    share.range.phys   = 0;
+    share.range.size   = FileSystem::BulkShareSize;
+    share.range.access = Memory::User | Memory::Readable | Memory::Writable;
+    testAssert(VMShare(fs.m_pid, API::Create, &share) == API::Success);
+    testAssert(share.range.virt != 0);
+    testAssert(share.range.size == FileSystem::BulkShareSize);
+
+    // Write new content via the share
+    String path("/mnt/myfile.txt");
+    FileSystemMessage msg;
+    MemoryBlock::copy((void *) share.range.virt, "bulkdata", 9);
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::WriteFileBulk;
+    msg.path   = *path;
+    msg.buffer = ZERO;
+    msg.size   = 8;
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.size == 8);
+
+    // Read it back via the share
+    MemoryBlock::set((void *) share.range.virt, 0, FileSystem::BulkShareSize);
+    msg.action = FileSystem::ReadFileBulk;
+    msg.size   = 64;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.size == 8);
+    testString((const char *) share.range.virt, "bulkdata");
+
+    // Requests beyond the share size are rejected
+    Log::instance()->setMinimumLogLevel(Log::Critical);
+    msg.size = FileSystem::BulkShareSize + 1;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::IOError);
+
+    // Release the share, as done on disconnect. Further requests must fail.
+    testAssert(VMShare(fs.m_pid, API::Delete, &share) == API::Success);
+    testAssert(VMShare(fs.m_pid, API::Delete, &share) == API::NotFound);
+    testAssert(VMShare(SELF, API::Read, &share) == API::NotFound);
+    msg.size = 64;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::IOError);
+
+    return OK;
+}
+
 TestCase(FileSystemServerWriteFile)
 {
     DummyFileSystem fs(new Directory(), "/mnt");
@@ -275,6 +403,58 @@ TestCase(FileSystemServerWriteFile)
     return OK;
 }
 
+TestCase(FileSystemServerModifiedFile)
+{
+    DummyFileSystem fs(new Directory(), "/mnt");
+    String path("/mnt/myfile.txt");
+    String buf("something");
+    FileSystem::FileStat st;
+    FileSystemMessage msg;
+
+    // Add two files
+    File *file = new PseudoFile();
+    testAssert(fs.registerFile(file, "myfile.txt") == FileSystem::Success);
+    testAssert(fs.registerFile(new PseudoFile(), "other.txt") == FileSystem::Success);
+
+    // Retrieve the initial identity
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::StatFile;
+    msg.path   = *path;
+    msg.stat   = &st;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+
+    const u32 inode = st.inode, modified = st.modified;
+
+    // Write to the file
+    msg.action = FileSystem::WriteFile;
+    msg.buffer = *buf;
+    msg.size   = buf.length();
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+
+    // The file keeps its inode, but has a new modification stamp
+    msg.action = FileSystem::StatFile;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(st.inode == inode);
+    testAssert(st.modified != modified);
+
+    // Other files have a different inode
+    path = "/mnt/other.txt";
+    msg.path = *path;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(st.inode != inode);
+
+    return OK;
+}
+
 TestCase(FileSystemServerDeleteFile)
 {
     DummyFileSystem fs(new Directory(), "/mnt");
@@ -317,3 +497,218 @@ TestCase(FileSystemServerDeleteFile)
 
     return OK;
 }
+
+TestCase(FileSystemServerOpenFile)
+{
+    DummyFileSystem fs(new Directory(), "/mnt");
+
+    // Add the file
+    File *file = new PseudoFile("mydata");
+    testAssert(fs.registerFile(file, "myfile.txt") == FileSystem::Success);
+
+    // Open the file
+    String path("/mnt/myfile.txt");
+    char buf[128];
+    FileSystemMessage msg;
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::OpenFile;
+    msg.path   = *path;
+    msg.handle = 0;
+    fs.pathHandler(&msg);
+
+    // Receive response
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.handle != 0);
+    testAssert(fs.findHandle(msg.handle) == file);
+
+    // Opening again gives the same handle
+    const FileSystem::Handle handle = msg.handle;
+    msg.action = FileSystem::OpenFile;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.handle == handle);
+
+    // Read using the handle
+    msg.action = FileSystem::ReadFile;
+    msg.path   = ZERO;
+    msg.buffer = buf;
+    msg.size   = sizeof(buf);
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+
+    // Verify content
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.size == 6);
+    buf[msg.size] = 0;
+    testString(buf, "mydata");
+
+    // Unknown handles are stale
+    msg.handle = handle + 1;
+    msg.size   = sizeof(buf);
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::StaleHandle);
+
+    // Delete the file
+    msg.action = FileSystem::DeleteFile;
+    msg.path   = *path;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+
+    // The handle of the removed file is stale
+    msg.action = FileSystem::ReadFile;
+    msg.path   = ZERO;
+    msg.handle = handle;
+    msg.size   = sizeof(buf);
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::StaleHandle);
+
+    return OK;
+}
+
+TestCase(FileSystemServerRestartStaleHandle)
+{
+    String path("/mnt/myfile.txt");
+    FileSystem::Handle handle;
+    FileSystemMessage msg;
+    char buf[128];
+
+    // Open a file on the first instance of the file system
+    {
+        DummyFileSystem fs(new Directory(), "/mnt");
+        testAssert(fs.registerFile(new PseudoFile("mydata"), "myfile.txt") == FileSystem::Success);
+
+        msg.from   = fs.m_pid;
+        msg.action = FileSystem::OpenFile;
+        msg.path   = *path;
+        msg.handle = 0;
+        fs.pathHandler(&msg);
+        testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+        testAssert(msg.result == FileSystem::Success);
+        handle = msg.handle;
+    }
+
+    // A new instance hands out other generations for the same entries
+    DummyFileSystem fs(new Directory(), "/mnt");
+    testAssert(fs.registerFile(new PseudoFile("other"), "myfile.txt") == FileSystem::Success);
+
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::OpenFile;
+    msg.path   = *path;
+    msg.handle = 0;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.handle != handle);
+
+    // The handle of the previous instance is stale
+    msg.action = FileSystem::ReadFile;
+    msg.path   = ZERO;
+    msg.handle = handle;
+    msg.buffer = buf;
+    msg.size   = sizeof(buf);
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::StaleHandle);
+    return OK;
+}
+
+TestCase(FileSystemServerOpenFileReuse)
+{
+    FileSystemServer fs(new Directory(), "/mnt");
+    File *files[FileSystemServer::MaximumOpenFiles + 1];
+    FileSystem::Handle handles[FileSystemServer::MaximumOpenFiles + 1];
+
+    // Fill the open files table
+    for (Size i = 0; i < FileSystemServer::MaximumOpenFiles; i++)
+    {
+        files[i] = new File();
+        handles[i] = fs.openHandle(files[i]);
+        testAssert(handles[i] != 0);
+    }
+
+    for (Size i = 0; i < FileSystemServer::MaximumOpenFiles; i++)
+        testAssert(fs.findHandle(handles[i]) == files[i]);
+
+    // Opening one more file makes the oldest handle stale
+    files[FileSystemServer::MaximumOpenFiles] = new File();
+    handles[FileSystemServer::MaximumOpenFiles] = fs.openHandle(files[FileSystemServer::MaximumOpenFiles]);
+    testAssert(fs.findHandle(handles[FileSystemServer::MaximumOpenFiles]) == files[FileSystemServer::MaximumOpenFiles]);
+    testAssert(fs.findHandle(handles[0]) == ZERO);
+    testAssert(fs.findHandle(handles[1]) == files[1]);
+
+    // Closing the handles of a file makes them stale
+    fs.closeHandles(files[1]);
+    testAssert(fs.findHandle(handles[1]) == ZERO);
+
+    for (Size i = 0; i < FileSystemServer::MaximumOpenFiles + 1; i++)
+        delete files[i];
+
+    return OK;
+}
+
+TestCase(FileSystemServerWaitFile)
+{
+    DummyFileSystem fs(new Directory(), "/mnt");
+    WaitFile *file = new WaitFile();
+    testAssert(fs.registerFile(file, "wait") == FileSystem::Success);
+
+    // Read the file, which must wait
+    String path("/mnt/wait");
+    char buf[16];
+    FileSystemMessage msg;
+    msg.from   = fs.m_pid;
+    msg.action = FileSystem::ReadFile;
+    msg.path   = *path;
+    msg.buffer = buf;
+    msg.size   = sizeof(buf);
+    msg.offset = 0;
+    fs.pathHandler(&msg);
+
+    // The request is parked on the File
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::NotFound);
+    testAssert(file->m_reads == 1);
+    testAssert(file->getWaitQueue().count() == 1);
+    testAssert(fs.m_waitFiles.count() == 1);
+    testAssert(fs.m_requests->count() == 0);
+
+    // Without a signal the request is not retried
+    testAssert(!fs.retryRequests());
+    testAssert(file->m_reads == 1);
+
+    // Retried once the File is ready
+    file->makeAvailable();
+    testAssert(fs.retryRequests());
+    testAssert(file->m_reads == 2);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(msg.size == 0);
+    testAssert(file->getWaitQueue().count() == 0);
+    testAssert(fs.m_waitFiles.count() == 0);
+
+    // Removing the File fails waiting requests
+    msg.type   = ChannelMessage::Request;
+    msg.action = FileSystem::ReadFile;
+    msg.size   = sizeof(buf);
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::NotFound);
+    testAssert(fs.m_waitFiles.count() == 1);
+
+    msg.action = FileSystem::DeleteFile;
+    fs.pathHandler(&msg);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.action == FileSystem::ReadFile);
+    testAssert(msg.result == FileSystem::NotFound);
+    testAssert(fs.m_clientConsumer->read(&msg) == Channel::Success);
+    testAssert(msg.action == FileSystem::DeleteFile);
+    testAssert(msg.result == FileSystem::Success);
+    testAssert(fs.m_waitFiles.count() == 0);
+
+    return OK;
+}
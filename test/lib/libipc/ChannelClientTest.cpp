@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <FreeNOS/User.h>
+#include <ChannelClient.h>
+#include <ChannelMessage.h>
+#include <MemoryChannel.h>
+
+class DummyMessage : public ChannelMessage
+{
+  public:
+    u32 value;
+};
+
+class DummyCallback : public CallbackFunction
+{
+  public:
+    virtual void execute(void *parameter)
+    {
+    }
+};
+
+/**
+ * Get the ring size of the producer to a process and disconnect.
+ *
+ * @return Ring size in bytes or ZERO if not connected.
+ */
+static Size disconnect(const ProcessID pid)
+{
+    ChannelRegistry & registry = ChannelClient::instance()->getRegistry();
+    MemoryChannel *prod = (MemoryChannel *) registry.getProducer(pid);
+    MemoryChannel *cons = (MemoryChannel *) registry.getConsumer(pid);
+    const Size ringSize = prod ? prod->m_ringSize : ZERO;
+
+    if (!prod || !cons || cons->m_ringSize != ringSize)
+        return ZERO;
+
+    registry.unregisterProducer(pid);
+    registry.unregisterConsumer(pid);
+    return ringSize;
+}
+
+// The host shares memory with the own process, without a remote process to notify
+TestCase(ChannelClientConnectRingSize)
+{
+    ChannelClient *client = ChannelClient::instance();
+    const ProcessID self = ProcessCtl(SELF, GetPID, 0);
+
+    // Ring sizes must be a non-zero multiple of PAGESIZE
+    testAssert(client->connect(self, sizeof(DummyMessage), 0) == ChannelClient::InvalidSize);
+    testAssert(client->connect(self, sizeof(DummyMessage), PAGESIZE + 1) == ChannelClient::InvalidSize);
+    testAssert(client->connect(self, sizeof(DummyMessage), PAGESIZE / 2) == ChannelClient::InvalidSize);
+    testAssert(client->getRegistry().getProducer(self) == ZERO);
+
+    // Both rings have the requested size
+    testAssert(client->connect(self, sizeof(DummyMessage), PAGESIZE * 3) == ChannelClient::Success);
+    testAssert(disconnect(self) == PAGESIZE * 3);
+
+    // One page by default
+    testAssert(client->connect(self, sizeof(DummyMessage)) == ChannelClient::Success);
+    testAssert(disconnect(self) == PAGESIZE);
+    return OK;
+}
+
+TestCase(ChannelClientRequestRingSize)
+{
+    ChannelClient *client = ChannelClient::instance();
+    const ProcessID self = ProcessCtl(SELF, GetPID, 0);
+    DummyMessage msg[4];
+    DummyCallback callback;
+
+    MemoryBlock::set(msg, 0, sizeof(msg));
+
+    // Synchronous messages connect with a single page
+    testAssert(client->syncSendTo(&msg[0], sizeof(DummyMessage), self) == ChannelClient::Success);
+    testAssert(disconnect(self) == PAGESIZE);
+
+    // Batches and asynchronous requests connect with larger rings
+    testAssert(client->syncSendBatch(msg, sizeof(DummyMessage), 4, self) == ChannelClient::Success);
+    testAssert(disconnect(self) == ChannelClient::BatchRingSize);
+    testAssert(client->sendRequest(self, &msg[0], sizeof(DummyMessage), &callback) == ChannelClient::Success);
+    testAssert(disconnect(self) == ChannelClient::BatchRingSize);
+    return OK;
+}
@@ -192,7 +192,9 @@ TestCase(ChannelServerReadChannels)
     ProcessEvent event;
     event.type = ShareCreated;
     event.share.pid = pid;
+    event.share.tagId = 0;
     event.share.range.virt = (Address) &pages;
+    event.share.range.size = sizeof(pages);
     testAssert(server.m_kernelProducer.write(&event) == MemoryChannel::Success);
     testAssert(server.m_kernelProducer.flush() == MemoryChannel::Success);
     testAssert(server.m_msgCount == 0);
@@ -237,6 +239,33 @@ TestCase(ChannelServerReadChannels)
     // Only one response message must be send
     testAssert(clientConsumer.read(&msg) == MemoryChannel::NotFound);
 
+    // Send more messages than fit in a single batch, with an invalid action in between
+    const Size batchMessages = DummyServer::MaximumBatchCount + 4U;
+    for (Size i = 0; i < batchMessages; i++)
+    {
+        msg.action = i == 3 ? 123U : DummyServer::DummyIpcAction;
+        msg.value  = i;
+        msg.result = 0;
+        testAssert(clientProducer.write(&msg) == MemoryChannel::Success);
+    }
+
+    // Process all messages. Every valid message must be handled.
+    server.processAll();
+    testAssert(server.m_msgCount == batchMessages);
+    testAssert(server.m_msgValue == batchMessages - 1);
+
+    // Verify the responses are sent in order, except for the invalid action
+    for (Size i = 0; i < batchMessages; i++)
+    {
+        if (i == 3)
+            continue;
+
+        testAssert(clientConsumer.read(&msg) == MemoryChannel::Success);
+        testAssert(msg.value == i);
+        testAssert(msg.result == DummyServer::DummyIpcResult);
+    }
+    testAssert(clientConsumer.read(&msg) == MemoryChannel::NotFound);
+
     // Raise event of process being terminated
     event.type   = ProcessTerminated;
     event.number = pid;
@@ -274,7 +303,20 @@ TestCase(ChannelServerShareCreated)
     ProcessEvent event;
     event.type = ShareCreated;
     event.share.pid = pid;
+    event.share.tagId = 0;
     event.share.range.virt = addr;
+    event.share.range.size = PAGESIZE * 4;
+
+    // Shares with a tag are not used for channels
+    event.share.tagId = 1;
+    testAssert(server.m_kernelProducer.write(&event) == MemoryChannel::Success);
+    testAssert(server.m_kernelProducer.flush() == MemoryChannel::Success);
+    server.readKernelEvents();
+    testAssert(ChannelClient::instance()->getRegistry().getConsumer(pid) == ZERO);
+    testAssert(ChannelClient::instance()->getRegistry().getProducer(pid) == ZERO);
+
+    // Raise event with the untagged share
+    event.share.tagId = 0;
     testAssert(server.m_kernelProducer.write(&event) == MemoryChannel::Success);
     testAssert(server.m_kernelProducer.flush() == MemoryChannel::Success);
 
@@ -307,6 +349,64 @@ TestCase(ChannelServerShareCreated)
     return OK;
 }
 
+TestCase(ChannelServerAcceptRingSize)
+{
+    DummyServer server;
+    const ProcessID pid = MAX_PROCS + 1234u;
+    const Address addr  = 0x12340000;
+    const Size ringSize = PAGESIZE * 3;
+    Memory::Range range;
+
+    // Mask error output
+    Log::instance()->setMinimumLogLevel(Log::Critical);
+
+    // Share sizes which cannot hold two rings with feedback pages are rejected
+    range.virt = addr;
+    range.size = PAGESIZE * 2;
+    testAssert(server.accept(pid, range) == DummyServer::InvalidSize);
+    range.size = PAGESIZE * 5;
+    testAssert(server.accept(pid, range) == DummyServer::InvalidSize);
+    testAssert(ChannelClient::instance()->getRegistry().getConsumer(pid) == ZERO);
+    testAssert(ChannelClient::instance()->getRegistry().getProducer(pid) == ZERO);
+
+    // The ring size is derived from the share size
+    range.size = (ringSize + PAGESIZE) * 2;
+    testAssert(server.accept(pid, range) == DummyServer::Success);
+
+    // Determine producer/consumer rings by the PIDs
+    Address prodAddr, consAddr;
+    if (server.m_self < pid)
+    {
+        prodAddr = addr;
+        consAddr = addr + ringSize + PAGESIZE;
+    }
+    else
+    {
+        prodAddr = addr + ringSize + PAGESIZE;
+        consAddr = addr;
+    }
+
+    // Verify consumer channel
+    MemoryChannel *cons = (MemoryChannel *) ChannelClient::instance()->getRegistry().getConsumer(pid);
+    testAssert(cons != ZERO);
+    testAssert(cons->m_ringSize == ringSize);
+    testAssert(cons->m_data.m_base == consAddr);
+    testAssert(cons->m_feedback.m_base == consAddr + ringSize);
+
+    // Verify producer channel
+    MemoryChannel *prod = (MemoryChannel *) ChannelClient::instance()->getRegistry().getProducer(pid);
+    testAssert(prod != ZERO);
+    testAssert(prod->m_ringSize == ringSize);
+    testAssert(prod->m_data.m_base == prodAddr);
+    testAssert(prod->m_feedback.m_base == prodAddr + ringSize);
+
+    // Cleanup
+    testAssert(ChannelClient::instance()->getRegistry().unregisterConsumer(pid) == ChannelRegistry::Success);
+    testAssert(ChannelClient::instance()->getRegistry().unregisterProducer(pid) == ChannelRegistry::Success);
+
+    return OK;
+}
+
 TestCase(ChannelServerInterruptEvent)
 {
     DummyServer server;
@@ -364,7 +464,9 @@ TestCase(ChannelServerProcessTerminated)
     ProcessEvent event;
     event.type = ShareCreated;
     event.share.pid = pid;
+    event.share.tagId = 0;
     event.share.range.virt = addr;
+    event.share.range.size = PAGESIZE * 4;
     testAssert(server.m_kernelProducer.write(&event) == MemoryChannel::Success);
     testAssert(server.m_kernelProducer.flush() == MemoryChannel::Success);
 
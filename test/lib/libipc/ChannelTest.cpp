@@ -39,3 +39,17 @@ TestCase(ChannelMessageSize)
 
     return OK;
 }
+
+TestCase(ChannelBatchNotSupported)
+{
+    Channel ch(Channel::Consumer, sizeof(u32));
+    u32 buffer[4];
+    Size count = 1;
+
+    testAssert(ch.readBatch(buffer, 4, &count) == Channel::NotSupported);
+    testAssert(count == 0);
+    testAssert(ch.writeBatch(buffer, 4, &count) == Channel::NotSupported);
+    testAssert(count == 0);
+
+    return OK;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <TestRunner.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <MemoryChannel.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+/** Number of messages transferred for each ring size. */
+static const Size StressMessages = 200000U;
+
+/** Maximum number of messages per batch. */
+static const Size StressBatch = 32U;
+
+/**
+ * Message used for the stress test
+ */
+typedef struct StressMessage
+{
+    u32 sequence;
+    u32 payload[15];
+}
+StressMessage;
+
+/**
+ * Producer side of the stress test, runs in a child process.
+ */
+static void stressProducer(const Address data, const Address feedback, const Size ringSize)
+{
+    StressMessage batch[StressBatch];
+    MemoryChannel prod(Channel::Producer, sizeof(StressMessage), ringSize);
+    Size sent = 0, written;
+
+    prod.setVirtual(data, feedback, false);
+
+    while (sent < StressMessages)
+    {
+        const Size count = StressMessages - sent < StressBatch ? StressMessages - sent : StressBatch;
+
+        for (Size i = 0; i < count; i++)
+            batch[i].sequence = sent + i;
+
+        if (prod.writeBatch(batch, count, &written) != MemoryChannel::Success)
+            sched_yield();
+
+        sent += written;
+    }
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * Transfer messages between two processes for the given ring size.
+ *
+ * @return Number of messages per second, or zero on failure
+ */
+static double stressTransfer(const Size ringSize)
+{
+    const Size mapSize = ringSize + PAGESIZE;
+    StressMessage batch[StressBatch];
+    struct timespec start, end;
+    Size received = 0, count;
+    int status;
+
+    u8 *pages = (u8 *) mmap(0, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (pages == (u8 *) MAP_FAILED)
+        return 0;
+
+    const Address data = (Address) pages;
+    const Address feedback = data + ringSize;
+    MemoryChannel cons(Channel::Consumer, sizeof(StressMessage), ringSize);
+    cons.setVirtual(data, feedback);
+
+    fflush(stdout);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    const pid_t pid = fork();
+    if (pid == 0)
+        stressProducer(data, feedback, ringSize);
+    else if (pid < 0)
+        return 0;
+
+    // Receive all messages, which must arrive in order
+    while (received < StressMessages)
+    {
+        if (cons.readBatch(batch, StressBatch, &count) != MemoryChannel::Success)
+        {
+            sched_yield();
+            continue;
+        }
+
+        for (Size i = 0; i < count; i++)
+        {
+            if (batch[i].sequence != received + i)
+            {
+                kill(pid, SIGKILL);
+                waitpid(pid, &status, 0);
+                return 0;
+            }
+        }
+        received += count;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    munmap(pages, mapSize);
+
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+        return 0;
+
+    const double seconds = (end.tv_sec - start.tv_sec) + ((end.tv_nsec - start.tv_nsec) / 1000000000.0);
+    return StressMessages / seconds;
+}
+
+TestCase(MemoryChannelStressRingSize)
+{
+    for (Size pages = 1; pages <= 16; pages *= 2)
+    {
+        const double rate = stressTransfer(pages * PAGESIZE);
+        testAssert(rate > 0);
+
+        printf("MemoryChannelStress: %2u page ring: %u messages/sec\n", pages, (uint) rate);
+    }
+
+    return OK;
+}
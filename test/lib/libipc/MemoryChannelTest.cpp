@@ -20,6 +20,7 @@
 #include <TestInt.h>
 #include <TestCase.h>
 #include <TestMain.h>
+#include <MemoryBlock.h>
 #include <MemoryChannel.h>
 
 TestCase(MemoryChannelConstruct)
@@ -87,15 +88,16 @@ TestCase(MemoryChannelReadWriteSingle)
     // Write a single message
     testAssert(prod.write(&writeVal) == MemoryChannel::Success);
 
-    // Verify data page contents. First slot has the RingHead.
+    // Verify data page contents. First cache line has the RingHead.
     const MemoryChannel::RingHead *dataHead = (const MemoryChannel::RingHead *) &dataPage[0];
+    const Size firstSlot = MemoryChannel::RingHeadSize / sizeof(u32);
     testAssert(dataHead->index == 1);
 
-    // Actual message is saved starting at position 1.
-    testAssert(dataPage[1] == writeVal);
+    // Actual message is saved directly after the RingHead.
+    testAssert(dataPage[firstSlot] == writeVal);
 
     // Rest of the data page is still zero
-    for (Size i = 2; i < sizeof(dataPage) / sizeof(u32); i++)
+    for (Size i = firstSlot + 1; i < sizeof(dataPage) / sizeof(u32); i++)
     {
         testAssert(dataPage[i] == 0);
     }
@@ -189,8 +191,9 @@ TestCase(MemoryChannelReadWriteFull)
     MemoryChannel prod(Channel::Producer, sizeof(u32));
     MemoryChannel cons(Channel::Consumer, sizeof(u32));
 
-    // Maximum messages is minus 2, for the ringhead and index mechanism
-    const Size maxMessages = (sizeof(dataPage) / sizeof(u32)) - 2U;
+    // Maximum messages excludes the ringhead and one slot for the index mechanism
+    const Size firstSlot = MemoryChannel::RingHeadSize / sizeof(u32);
+    const Size maxMessages = (sizeof(dataPage) / sizeof(u32)) - firstSlot - 1U;
 
     // First assign pages
     testAssert(prod.setVirtual((const Address) &dataPage, (const Address) &feedbackPage) == MemoryChannel::Success);
@@ -206,9 +209,9 @@ TestCase(MemoryChannelReadWriteFull)
         u32 writeVal = writeValues.random();
         testAssert(prod.write(&writeVal) == MemoryChannel::Success);
 
-        // Verify data page contents. First slot has the RingHead.
+        // Verify data page contents. First cache line has the RingHead.
         testAssert(dataHead->index == i + 1);
-        testAssert(dataPage[i + 1] == writeVal);
+        testAssert(dataPage[firstSlot + i] == writeVal);
     }
 
     // Attempt to write another message (must fail)
@@ -249,3 +252,135 @@ TestCase(MemoryChannelFlush)
     testAssert(prod.flush() == MemoryChannel::Success);
     return OK;
 }
+
+TestCase(MemoryChannelReadWriteBatch)
+{
+    static u32 dataPage[PAGESIZE / sizeof(u32)] = { 0 };
+    static u32 feedbackPage[PAGESIZE / sizeof(u32)] = { 0 };
+    static u32 writeBuf[PAGESIZE / sizeof(u32)];
+    static u32 readBuf[PAGESIZE / sizeof(u32)];
+    TestInt<uint> writeValues(UINT_MIN, UINT_MAX);
+    TestInt<uint> countValues(1, 300);
+    Size written, count, idx = 0;
+
+    MemoryChannel prod(Channel::Producer, sizeof(u32));
+    MemoryChannel cons(Channel::Consumer, sizeof(u32));
+
+    // Maximum messages excludes the ringhead and one slot for the index mechanism
+    const Size maxMessages = ((sizeof(dataPage) - MemoryChannel::RingHeadSize) / sizeof(u32)) - 1U;
+
+    // First assign pages
+    testAssert(prod.setVirtual((const Address) &dataPage, (const Address) &feedbackPage) == MemoryChannel::Success);
+    testAssert(cons.setVirtual((const Address) &dataPage, (const Address) &feedbackPage) == MemoryChannel::Success);
+
+    // Get ring header pointers
+    const MemoryChannel::RingHead *dataHead = (const MemoryChannel::RingHead *) &dataPage[0];
+    const MemoryChannel::RingHead *feedbackHead = (const MemoryChannel::RingHead *) &feedbackPage[0];
+
+    // Empty channel gives no messages
+    testAssert(cons.readBatch(readBuf, maxMessages, &count) == MemoryChannel::NotFound);
+    testAssert(count == 0);
+
+    // Move random sized batches through the ring, such that it wraps multiple times
+    for (Size i = 0; i < 32; i++)
+    {
+        const Size numMessages = countValues.random();
+
+        for (Size j = 0; j < numMessages; j++)
+            writeBuf[j] = writeValues.random();
+
+        testAssert(prod.writeBatch(writeBuf, numMessages, &written) == MemoryChannel::Success);
+        testAssert(written == numMessages);
+
+        // Read back in two parts, the first part is limited by the maximum
+        testAssert(cons.readBatch(readBuf, numMessages / 2, &count) == (numMessages / 2 ?
+                   MemoryChannel::Success : MemoryChannel::NotFound));
+        testAssert(count == numMessages / 2);
+        testAssert(cons.readBatch(readBuf + count, maxMessages, &count) == MemoryChannel::Success);
+        testAssert(count == numMessages - (numMessages / 2));
+
+        for (Size j = 0; j < numMessages; j++)
+        {
+            testAssert(readBuf[j] == writeValues[idx++]);
+        }
+
+        // Channel is now empty again
+        testAssert(feedbackHead->index == dataHead->index);
+        testAssert(cons.readBatch(readBuf, maxMessages, &count) == MemoryChannel::NotFound);
+    }
+
+    // Overfilling the channel writes only what fits
+    for (Size i = 0; i < maxMessages; i++)
+        writeBuf[i] = i;
+
+    testAssert(prod.writeBatch(writeBuf, maxMessages, &written) == MemoryChannel::Success);
+    testAssert(written == maxMessages);
+    testAssert(prod.writeBatch(writeBuf, 10, &written) == MemoryChannel::ChannelFull);
+    testAssert(written == 0);
+
+    // Partially drain the channel, then overfill again
+    testAssert(cons.readBatch(readBuf, 5, &count) == MemoryChannel::Success);
+    testAssert(count == 5);
+    testAssert(prod.writeBatch(writeBuf, 10, &written) == MemoryChannel::ChannelFull);
+    testAssert(written == 5);
+
+    // Everything written must come out in order
+    testAssert(cons.readBatch(readBuf + 5, maxMessages, &count) == MemoryChannel::Success);
+    testAssert(count == maxMessages);
+
+    for (Size i = 0; i < maxMessages + 5; i++)
+    {
+        testAssert(readBuf[i] == (i < maxMessages ? i : i - maxMessages));
+    }
+
+    return OK;
+}
+
+TestCase(MemoryChannelMultiPage)
+{
+    static u32 dataPages[(PAGESIZE * 4) / sizeof(u32)] = { 0 };
+    static u32 feedbackPage[PAGESIZE / sizeof(u32)] = { 0 };
+    static u32 buffer[(PAGESIZE * 4) / sizeof(u32)];
+    Size written, count;
+
+    MemoryChannel prod(Channel::Producer, sizeof(u32), sizeof(dataPages));
+    MemoryChannel cons(Channel::Consumer, sizeof(u32), sizeof(dataPages));
+
+    // Maximum messages excludes the ringhead and one slot for the index mechanism
+    const Size maxMessages = ((sizeof(dataPages) - MemoryChannel::RingHeadSize) / sizeof(u32)) - 1U;
+    testAssert(maxMessages > (PAGESIZE * 3) / sizeof(u32));
+
+    // First assign pages
+    testAssert(prod.setVirtual((const Address) &dataPages, (const Address) &feedbackPage) == MemoryChannel::Success);
+    testAssert(cons.setVirtual((const Address) &dataPages, (const Address) &feedbackPage) == MemoryChannel::Success);
+
+    // Fill the ring across all pages, several times
+    for (Size i = 0; i < 3; i++)
+    {
+        for (Size j = 0; j < maxMessages; j++)
+            buffer[j] = (i * maxMessages) + j;
+
+        testAssert(prod.writeBatch(buffer, maxMessages + 1, &written) == MemoryChannel::ChannelFull);
+        testAssert(written == maxMessages);
+
+        // The last message must be stored on the last page
+        if (i == 0)
+        {
+            testAssert(dataPages[(MemoryChannel::RingHeadSize / sizeof(u32)) + maxMessages - 1] ==
+                       maxMessages - 1);
+        }
+
+        // Read all back out
+        MemoryBlock::set(buffer, 0, sizeof(buffer));
+        testAssert(cons.readBatch(buffer, maxMessages + 1, &count) == MemoryChannel::Success);
+        testAssert(count == maxMessages);
+
+        for (Size j = 0; j < maxMessages; j++)
+        {
+            testAssert(buffer[j] == (i * maxMessages) + j);
+        }
+        testAssert(cons.read(buffer) == MemoryChannel::NotFound);
+    }
+
+    return OK;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Constant.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestCase.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <MemoryChannel.h>
+#include <Index.h>
+#include "mpi.h"
+#include "MPIMessage.h"
+#include "MPIProgress.h"
+
+/*
+ * Normally set up by MPI_Init(). Here rank 0 talks to rank 1 over a
+ * loopback channel, such that everything sent to rank 1 is received
+ * back from rank 1 in the same order.
+ */
+Size coreCount = 0;
+Index<MemoryChannel, MPI_MAX_CHANNELS> *readChannel  = 0;
+Index<MemoryChannel, MPI_MAX_CHANNELS> *writeChannel = 0;
+
+/** Peer rank of the loopback channel */
+static const int Peer = 1;
+
+/**
+ * Reset the loopback channel and the progress engine.
+ */
+static void setupLoopback()
+{
+    static u8 dataPage[PAGESIZE];
+    static u8 feedbackPage[PAGESIZE];
+    static u32 sleepFlags[PAGESIZE / sizeof(u32)];
+    static MemoryChannel producer(Channel::Producer, sizeof(MPIMessage));
+    static MemoryChannel consumer(Channel::Consumer, sizeof(MPIMessage));
+    static Index<MemoryChannel, MPI_MAX_CHANNELS> reads, writes;
+
+    MemoryBlock::set(dataPage, 0, sizeof(dataPage));
+    MemoryBlock::set(feedbackPage, 0, sizeof(feedbackPage));
+    MemoryBlock::set(sleepFlags, 0, sizeof(sleepFlags));
+    producer.setVirtual((const Address) dataPage, (const Address) feedbackPage);
+    consumer.setVirtual((const Address) dataPage, (const Address) feedbackPage);
+
+    reads.insertAt(Peer, &consumer);
+    writes.insertAt(Peer, &producer);
+
+    coreCount    = Peer + 1;
+    readChannel  = &reads;
+    writeChannel = &writes;
+
+    // Initialize by hand, there is no shared sleep flags page to map
+    if (!MPIProgress::m_sendQueue)
+    {
+        MPIProgress::m_sendQueue = new List<MPIRequest *>[coreCount];
+        MPIProgress::m_receiveQueue = new List<MPIRequest *>[coreCount];
+    }
+    MPIProgress::m_rank = 0;
+    MPIProgress::m_sleepFlags.m_base = (Address) sleepFlags;
+}
+
+TestCase(MPIRecvMatchingTag)
+{
+    TestInt<int> values(INT_MIN, INT_MAX);
+    const int sent = values.random();
+    MPI_Status status;
+    int received = 0;
+
+    setupLoopback();
+
+    testAssert(MPI_Send(&sent, 1, MPI_INT, Peer, 7, MPI_COMM_WORLD) == MPI_SUCCESS);
+    testAssert(MPI_Recv(&received, 1, MPI_INT, Peer, 7, MPI_COMM_WORLD, &status) == MPI_SUCCESS);
+    testAssert(received == sent);
+    testAssert(status.MPI_SOURCE == Peer);
+    testAssert(status.MPI_TAG == 7);
+    testAssert(status.MPI_ERROR == MPI_SUCCESS);
+    testAssert(status.count == sizeof(int));
+
+    return OK;
+}
+
+TestCase(MPIRecvAnyTag)
+{
+    const int sent = 1234;
+    MPI_Status status;
+    int received = 0;
+
+    setupLoopback();
+
+    testAssert(MPI_Send(&sent, 1, MPI_INT, Peer, 5, MPI_COMM_WORLD) == MPI_SUCCESS);
+    testAssert(MPI_Recv(&received, 1, MPI_INT, Peer, MPI_ANY_TAG, MPI_COMM_WORLD, &status) == MPI_SUCCESS);
+    testAssert(received == sent);
+    testAssert(status.MPI_TAG == 5);
+
+    return OK;
+}
+
+TestCase(MPIRecvMismatchingTag)
+{
+    static u8 unexpected[sizeof(MPIMessage) * 3 + 7];
+    static u8 expected[sizeof(MPIMessage) + 1];
+    static u8 buffer[sizeof(unexpected)];
+    MPI_Status status;
+
+    setupLoopback();
+    MemoryBlock::set(unexpected, 0xaa, sizeof(unexpected));
+    MemoryBlock::set(expected, 0x55, sizeof(expected));
+    MemoryBlock::set(buffer, 0, sizeof(buffer));
+
+    // Messages are not reordered: the first one has the wrong tag
+    testAssert(MPI_Send(unexpected, sizeof(unexpected), MPI_BYTE, Peer, 1, MPI_COMM_WORLD) == MPI_SUCCESS);
+    testAssert(MPI_Send(expected, sizeof(expected), MPI_BYTE, Peer, 2, MPI_COMM_WORLD) == MPI_SUCCESS);
+
+    // The receive fails without touching the buffer
+    testAssert(MPI_Recv(buffer, sizeof(buffer), MPI_BYTE, Peer, 2, MPI_COMM_WORLD, &status) == MPI_ERR_TAG);
+    testAssert(status.MPI_TAG == 1);
+    testAssert(status.MPI_ERROR == MPI_ERR_TAG);
+    testAssert(status.count == 0);
+
+    for (Size i = 0; i < sizeof(buffer); i++)
+    {
+        testAssert(buffer[i] == 0);
+    }
+
+    // The mismatching message is consumed entirely, so the next one follows
+    testAssert(MPI_Recv(buffer, sizeof(buffer), MPI_BYTE, Peer, 2, MPI_COMM_WORLD, &status) == MPI_SUCCESS);
+    testAssert(status.MPI_TAG == 2);
+    testAssert(status.count == sizeof(expected));
+
+    for (Size i = 0; i < sizeof(expected); i++)
+    {
+        testAssert(buffer[i] == expected[i]);
+    }
+
+    return OK;
+}
+
+TestCase(MPIInvalidTag)
+{
+    const int value = 1;
+    int received;
+
+    setupLoopback();
+
+    // Negative tags cannot be sent and only MPI_ANY_TAG can be received
+    testAssert(MPI_Send(&value, 1, MPI_INT, Peer, MPI_ANY_TAG, MPI_COMM_WORLD) == MPI_ERR_TAG);
+    testAssert(MPI_Recv(&received, 1, MPI_INT, Peer, -2, MPI_COMM_WORLD, MPI_STATUS_IGNORE) == MPI_ERR_TAG);
+
+    return OK;
+}
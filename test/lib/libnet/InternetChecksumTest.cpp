@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <InternetChecksum.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+/** Size of the random test buffers */
+static const Size TestBufferSize = 4096;
+
+/** Number of random buffers checked per test */
+static const Size TestIterations = 256;
+
+/**
+ * Calculate the checksum bytes by adding big endian words (RFC 1071).
+ *
+ * @return Checksum in network byte order as an integer
+ */
+static u16 scalarChecksum(const u8 *buffer, Size length)
+{
+    u32 sum = 0;
+
+    for (Size i = 0; i + 1 < length; i += 2)
+        sum += (buffer[i] << 8) | buffer[i + 1];
+
+    if (length & 1)
+        sum += buffer[length - 1] << 8;
+
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+
+    return ~sum;
+}
+
+/**
+ * Convert a checksum as stored in a header to an integer in network byte order.
+ */
+static u16 storedChecksum(const u16 checksum)
+{
+    const u8 *bytes = (const u8 *) &checksum;
+    return (bytes[0] << 8) | bytes[1];
+}
+
+/**
+ * Fill a buffer with random bytes.
+ */
+static void fillRandom(u8 *buffer, Size length)
+{
+    for (Size i = 0; i < length; i++)
+        buffer[i] = random();
+}
+
+TestCase(InternetChecksumKnownValue)
+{
+    // Example from RFC 1071 section 3: the sum is 0xddf2
+    const u8 data[] = { 0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7 };
+
+    testAssert(storedChecksum(InternetChecksum::checksum(data, sizeof(data))) == 0x220d);
+    testAssert(scalarChecksum(data, sizeof(data)) == 0x220d);
+    return OK;
+}
+
+TestCase(InternetChecksumMethods)
+{
+    TestInt<uint> offsets(0, 15);
+    TestInt<uint> lengths(0, TestBufferSize - 16);
+    static u8 buffer[TestBufferSize];
+    const InternetChecksum::Method methods[] = {
+        InternetChecksum::Reference, InternetChecksum::Wide, InternetChecksum::Vector
+    };
+
+    // All methods must match the scalar reference at any offset and length
+    for (Size i = 0; i < TestIterations; i++)
+    {
+        const Size offset = offsets.random();
+        const Size length = lengths.random();
+
+        fillRandom(buffer, sizeof(buffer));
+        const u16 reference = scalarChecksum(buffer + offset, length);
+
+        for (Size j = 0; j < sizeof(methods) / sizeof(methods[0]); j++)
+        {
+            const u32 sum = InternetChecksum::sum(methods[j], buffer + offset, length);
+            testAssert(storedChecksum(InternetChecksum::finish(sum)) == reference);
+        }
+    }
+    return OK;
+}
+
+TestCase(InternetChecksumPartial)
+{
+    TestInt<uint> splits(0, (TestBufferSize / 2) - 1);
+    static u8 buffer[TestBufferSize];
+
+    // Summing two parts split at an even offset gives the same checksum
+    for (Size i = 0; i < TestIterations; i++)
+    {
+        const Size split = splits.random() * 2;
+        fillRandom(buffer, sizeof(buffer));
+
+        u32 sum = InternetChecksum::sum(buffer, split);
+        sum = InternetChecksum::sum(buffer + split, sizeof(buffer) - split, sum);
+
+        testAssert(storedChecksum(InternetChecksum::finish(sum)) ==
+                   scalarChecksum(buffer, sizeof(buffer)));
+    }
+    return OK;
+}
+
+TestCase(InternetChecksumUpdate)
+{
+    TestInt<uint> words(0, (TestBufferSize / 4) - 1);
+    static u32 buffer[TestBufferSize / 4];
+
+    // Incremental updates must match a full calculation
+    for (Size i = 0; i < TestIterations; i++)
+    {
+        const Size index = words.random();
+        fillRandom((u8 *) buffer, sizeof(buffer));
+
+        u16 checksum = InternetChecksum::checksum(buffer, sizeof(buffer));
+        u16 *halves = (u16 *) &buffer[index];
+
+        // Change a 16-bit field
+        const u16 old16 = halves[1];
+        halves[1] = random();
+        checksum = InternetChecksum::update(checksum, old16, halves[1]);
+        testAssert(storedChecksum(checksum) == scalarChecksum((u8 *) buffer, sizeof(buffer)));
+
+        // Change a 32-bit field
+        const u32 old32 = buffer[index];
+        buffer[index] = random();
+        checksum = InternetChecksum::update32(checksum, old32, buffer[index]);
+        testAssert(storedChecksum(checksum) == scalarChecksum((u8 *) buffer, sizeof(buffer)));
+    }
+    return OK;
+}
+
+TestCase(InternetChecksumPseudoHeader)
+{
+    TestInt<uint> lengths(0, 0xffff);
+    u32 addresses[2];
+    u8 header[12];
+
+    for (Size i = 0; i < TestIterations; i++)
+    {
+        const u16 length = lengths.random();
+        const u8 protocol = random();
+        fillRandom((u8 *) addresses, sizeof(addresses));
+
+        // Build the pseudo header in network byte order
+        for (Size j = 0; j < 8; j++)
+            header[j] = ((u8 *) addresses)[j];
+
+        header[8]  = 0;
+        header[9]  = protocol;
+        header[10] = length >> 8;
+        header[11] = length & 0xff;
+
+        const u32 sum = InternetChecksum::pseudoHeader(addresses[0], addresses[1],
+                                                       protocol, length);
+        testAssert(storedChecksum(InternetChecksum::finish(sum)) ==
+                   scalarChecksum(header, sizeof(header)));
+    }
+    return OK;
+}
+
+/**
+ * Get the current time in microseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return ((u64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+/**
+ * Measure the throughput of one method.
+ *
+ * @return Sum of all calculated checksums, to keep the work from being optimized away.
+ */
+static u32 benchMethod(const char *name, const InternetChecksum::Method method,
+                       const u8 *buffer, const Size length, const Size repeat)
+{
+    u32 total = 0;
+    const u64 t1 = benchTime();
+
+    for (Size i = 0; i < repeat; i++)
+        total += InternetChecksum::sum(method, buffer, length);
+
+    const u64 usec = benchTime() - t1;
+    const double gbps = usec ? ((double) length * repeat / usec) / 1000.0 : 0.0;
+
+    printf("InternetChecksumBench: %-9s %6u bytes: %7u us, %.2f GB/s\n",
+           name, length, (uint) usec, gbps);
+    return total;
+}
+
+TestCase(InternetChecksumBenchmark)
+{
+    static u8 buffer[65536 + 2];
+    const Size sizes[] = { 1500, 65536 };
+    const Size bytes = 64 * 1024 * 1024;
+
+    fillRandom(buffer, sizeof(buffer));
+
+    // Use a two byte offset, like an UDP payload after the Ethernet and IP headers
+    for (Size i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        const Size repeat = bytes / sizes[i];
+        const u32 reference = benchMethod("reference", InternetChecksum::Reference,
+                                          buffer + 2, sizes[i], repeat);
+        const u32 wide = benchMethod("wide", InternetChecksum::Wide,
+                                     buffer + 2, sizes[i], repeat);
+        const u32 vector = benchMethod("vector", InternetChecksum::Vector, buffer + 2, sizes[i], repeat);
+
+        testAssert(reference == wide);
+        testAssert(reference == vector);
+    }
+    return OK;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <Callback.h>
+#include <NetworkQueue.h>
+
+/**
+ * Counts packets which return to the pool of a NetworkQueue.
+ */
+class ReleaseCounter
+{
+  public:
+
+    ReleaseCounter() : m_count(0), m_last(ZERO)
+    {
+    }
+
+    void released(NetworkQueue::Packet *packet)
+    {
+        m_count++;
+        m_last = packet;
+    }
+
+    Size m_count;
+    NetworkQueue::Packet *m_last;
+};
+
+TestCase(NetworkQueueRing)
+{
+    NetworkQueue queue(64, 0, 4);
+    NetworkQueue::Packet *packets[4];
+
+    // All packets come from the pool, until it is empty
+    for (Size i = 0; i < 4; i++)
+    {
+        packets[i] = queue.get();
+        testAssert(packets[i] != ZERO);
+        testAssert(queue.push(packets[i]));
+    }
+    testAssert(queue.get() == ZERO);
+    testAssert(!queue.push(packets[0]));
+    testAssert(queue.count() == 4);
+
+    // Packets are popped in order
+    for (Size i = 0; i < 4; i++)
+    {
+        testAssert(queue.pop() == packets[i]);
+        queue.release(packets[i]);
+    }
+    testAssert(queue.pop() == ZERO);
+    testAssert(queue.count() == 0);
+    testAssert(queue.get() != ZERO);
+    return OK;
+}
+
+TestCase(NetworkQueueHeldPacket)
+{
+    NetworkQueue device(64, 0, 2);
+    NetworkQueue socket(0, 0, 4);
+    ReleaseCounter counter;
+    Callback<ReleaseCounter, NetworkQueue::Packet> callback(&counter, &ReleaseCounter::released);
+    device.setReleaseCallback(&callback);
+
+    // Socket holds a device packet, which keeps it out of the pool
+    NetworkQueue::Packet *pkt = device.get();
+    testAssert(pkt != ZERO);
+    testAssert(pkt->pool == &device);
+    testAssert(socket.push(pkt));
+    socket.retain(pkt);
+    device.release(pkt);
+    testAssert(counter.m_count == 0);
+
+    // The other packet is used and released by the device
+    NetworkQueue::Packet *other = device.get();
+    testAssert(other != ZERO);
+    testAssert(device.get() == ZERO);
+    device.release(other);
+    testAssert(counter.m_count == 1);
+    testAssert(counter.m_last == other);
+    testAssert(device.get() == other);
+
+    // Releasing the held packet returns it to the device pool
+    testAssert(socket.pop() == pkt);
+    socket.release(pkt);
+    testAssert(counter.m_count == 2);
+    testAssert(counter.m_last == pkt);
+    testAssert(device.get() == pkt);
+
+    // Without callback nothing is invoked
+    device.setReleaseCallback(ZERO);
+    device.release(pkt);
+    testAssert(counter.m_count == 2);
+    return OK;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/User.h>
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+
+/** Number of times each program is started */
+#define SPAWN_COUNT 16
+
+/** Number of instances running concurrently when measuring memory usage */
+#define INSTANCE_COUNT 8
+
+/** Programs of increasing size to start */
+static const char * programs[] = {
+    "/bin/echo", "/bin/ls", "/bin/sh", "/bin/netctl", "/bin/mpiprime"
+};
+
+/**
+ * Start a program.
+ *
+ * @param path Program to start
+ * @param args Argument list for the program
+ * @param fromMemory True to read the whole program and use spawn(),
+ *                   false to load the program from file with forkexec()
+ *
+ * @return Process identifier of the program or -1 on failure
+ */
+static int startProgram(const char *path, const char **args, const bool fromMemory)
+{
+    Memory::Range range;
+    struct stat st;
+    int pid, fd;
+
+    if (!fromMemory)
+        return forkexec(path, args);
+
+    // Read the whole program to a buffer first
+    if (stat(path, &st) != 0 || (fd = open(path, O_RDONLY)) < 0)
+        return -1;
+
+    range.virt   = ZERO;
+    range.phys   = ZERO;
+    range.size   = st.st_size;
+    range.access = Memory::User | Memory::Readable | Memory::Writable;
+
+    if (VMCtl(SELF, MapContiguous, &range) != API::Success)
+    {
+        close(fd);
+        return -1;
+    }
+
+    if (read(fd, (void *) range.virt, st.st_size) == st.st_size)
+        pid = spawn(range.virt, st.st_size, args);
+    else
+        pid = -1;
+
+    close(fd);
+    VMCtl(SELF, Release, &range);
+    return pid;
+}
+
+/**
+ * Start a program and wait until it terminates.
+ *
+ * @param path Program to start
+ * @param fromMemory True to read the whole program and use spawn(),
+ *                   false to load the program from file with forkexec()
+ *
+ * @return True on success
+ */
+static bool runProgram(const char *path, const bool fromMemory)
+{
+    const char *args[] = { path, "--version", (const char *) NULL };
+    int pid, status;
+
+    if ((pid = startProgram(path, args, fromMemory)) == -1)
+        return false;
+
+    return waitpid(pid, &status, 0) == (pid_t) pid;
+}
+
+TestCase(SpawnLatency)
+{
+    struct timeval t1, t2;
+    struct stat st;
+
+    // Compare loading from file against the whole in-memory image
+    for (Size i = 0; i < sizeof(programs) / sizeof(programs[0]); i++)
+    {
+        if (stat(programs[i], &st) != 0)
+            continue;
+
+        for (int fromMemory = 0; fromMemory < 2; fromMemory++)
+        {
+            gettimeofday(&t1, 0);
+
+            for (Size j = 0; j < SPAWN_COUNT; j++)
+                testAssert(runProgram(programs[i], fromMemory));
+
+            gettimeofday(&t2, 0);
+            printf("%s: %d bytes: %s: %d runs: ", programs[i], (int) st.st_size,
+                   fromMemory ? "spawn" : "forkexec", SPAWN_COUNT);
+            printtimediff(&t1, &t2);
+            printf("\r\n");
+        }
+    }
+
+    return OK;
+}
+
+TestCase(SpawnMemory)
+{
+    const char *path = "/bin/sleep";
+    const char *args[] = { path, "1", (const char *) NULL };
+    int pids[INSTANCE_COUNT], status;
+    struct stat st;
+
+    if (stat(path, &st) != 0)
+        return SKIP;
+
+    // Program text started with forkexec() is shared, with spawn() it is not
+    for (int fromMemory = 0; fromMemory < 2; fromMemory++)
+    {
+        const SystemInformation before;
+
+        for (Size i = 0; i < INSTANCE_COUNT; i++)
+        {
+            pids[i] = startProgram(path, args, fromMemory);
+            testAssert(pids[i] != -1);
+        }
+
+        const SystemInformation after;
+        printf("%s: %d bytes: %s: %d instances: %d KiB used\r\n", path, (int) st.st_size,
+               fromMemory ? "spawn" : "forkexec", INSTANCE_COUNT,
+               (int) ((before.memoryAvail - after.memoryAvail) / 1024));
+
+        for (Size i = 0; i < INSTANCE_COUNT; i++)
+            testAssert(waitpid(pids[i], &status, 0) == (pid_t) pids[i]);
+    }
+
+    return OK;
+}
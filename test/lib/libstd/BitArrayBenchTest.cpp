@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <MemoryBlock.h>
+#include <BitArray.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+/**
+ * BitArray which searches and sets one bit at a time, as a reference for benchmarking.
+ *
+ * This is the previous implementation of setNext() and setRange().
+ */
+class ReferenceBitArray
+{
+  public:
+
+    ReferenceBitArray(const Size bitCount)
+        : m_array(new u8[(bitCount + 7) / 8])
+        , m_bitCount(bitCount)
+        , m_set(0)
+    {
+        MemoryBlock::set(m_array, 0, (bitCount + 7) / 8);
+    }
+
+    ~ReferenceBitArray()
+    {
+        delete[] m_array;
+    }
+
+    Size count(const bool on) const
+    {
+        return on ? m_set : m_bitCount - m_set;
+    }
+
+    void set(const Size bit, const bool value)
+    {
+        if (bit >= m_bitCount)
+            return;
+
+        bool current = m_array[bit / 8] & (1 << (bit % 8));
+
+        if (current != value)
+        {
+            if (value)
+            {
+                m_array[bit / 8] |= 1 << (bit % 8);
+                m_set++;
+            }
+            else
+            {
+                m_array[bit / 8] &= ~(1 << (bit % 8));
+                m_set--;
+            }
+        }
+    }
+
+    bool isSet(const Size bit) const
+    {
+        return m_array[bit / 8] & (1 << (bit % 8));
+    }
+
+    void setRange(const Size from, const Size to)
+    {
+        for (Size i = from; i <= to; i++)
+            set(i, true);
+    }
+
+    BitArray::Result setNext(Size *bit, const Size count, const Size start, const Size boundary)
+    {
+        Size from = 0, found = 0;
+
+        for (Size i = start; i < m_bitCount;)
+        {
+            // Try to fast-forward 32 bits to search
+            if (m_bitCount > 32 && i < m_bitCount - 32 && ((u32 *)m_array)[i / 32] == 0xffffffff)
+            {
+                from = found = 0;
+
+                if (i & 31)
+                    i += (32 - (i % 32));
+                else
+                    i += 32;
+                continue;
+            }
+            // Try to fast-forward 8 bits to search
+            else if (m_bitCount > 8 && i < m_bitCount - 8 && m_array[i / 8] == 0xff)
+            {
+                from = found = 0;
+
+                if (i & 7)
+                    i += (8 - (i % 8));
+                else
+                    i += 8;
+                continue;
+            }
+            else if (!isSet(i))
+            {
+                if (!found)
+                {
+                    if (!(i % boundary))
+                    {
+                        from  = i;
+                        found = 1;
+                    }
+                }
+                else
+                {
+                    found++;
+                }
+
+                if (found >= count)
+                {
+                    setRange(from, i);
+                    *bit = from;
+                    return BitArray::Success;
+                }
+            }
+            else
+            {
+                from = found = 0;
+            }
+
+            i++;
+        }
+
+        return BitArray::OutOfMemory;
+    }
+
+  private:
+
+    u8 *m_array;
+    Size m_bitCount;
+    Size m_set;
+};
+
+/** Number of bits in the benchmarked maps. */
+static const Size BenchBits = 1024 * 1024;
+
+/**
+ * Get the current time in nanoseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (((u64) tv.tv_sec * 1000000) + tv.tv_usec) * 1000;
+}
+
+/**
+ * Fragment a map with used ranges of varying length.
+ *
+ * @param bits Map to fragment.
+ * @param gap Distance between the start of each used range.
+ * @param modulo Used ranges have a length between 1 and modulo bits.
+ */
+template <class B> static void fragment(B & bits, const Size gap, const Size modulo)
+{
+    for (Size i = 0; i < BenchBits; i += gap)
+    {
+        Size end = i + (i % modulo);
+
+        if (end >= BenchBits)
+            end = BenchBits - 1;
+
+        bits.setRange(i, end);
+    }
+}
+
+/**
+ * Allocate ranges from a fragmented map until it is full.
+ *
+ * @param found Receives the first bit of every allocated range.
+ * @param max Maximum number of ranges to store.
+ *
+ * @return Nanoseconds taken.
+ */
+template <class B> static u64 benchSearch(const Size gap, const Size modulo,
+                                         const Size count, const Size boundary,
+                                         Size *found, const Size max, Size *total)
+{
+    B bits(BenchBits);
+    Size bit, n = 0;
+
+    fragment(bits, gap, modulo);
+
+    const u64 t1 = benchTime();
+    for (Size last = 0; bits.setNext(&bit, count, last, boundary) == BitArray::Success; last = bit)
+    {
+        if (n < max)
+            found[n] = bit;
+        n++;
+    }
+    const u64 t2 = benchTime();
+
+    *total = n;
+    return t2 - t1;
+}
+
+/**
+ * Compare the search of both implementations on the same fragmented map.
+ *
+ * @return True if both allocated the same ranges and the new search is faster.
+ */
+static bool benchCompare(const char *name, const Size gap, const Size modulo,
+                         const Size count, const Size boundary)
+{
+    const Size max = BenchBits / count;
+    Size *oldFound = new Size[max], *newFound = new Size[max];
+    Size oldTotal, newTotal;
+    bool equal = true;
+
+    const u64 oldTime = benchSearch<ReferenceBitArray>(gap, modulo, count, boundary,
+                                                       oldFound, max, &oldTotal);
+    const u64 newTime = benchSearch<BitArray>(gap, modulo, count, boundary,
+                                              newFound, max, &newTotal);
+
+    equal = oldTotal == newTotal;
+    for (Size i = 0; i < newTotal && i < max && equal; i++)
+        equal = oldFound[i] == newFound[i];
+
+    printf("BitArrayBench: %-10s %6u ranges of %3u bits: old %8u us, new %8u us\n",
+           name, (uint) newTotal, (uint) count,
+           (uint) (oldTime / 1000), (uint) (newTime / 1000));
+
+    delete[] oldFound;
+    delete[] newFound;
+    return equal && newTime < oldTime;
+}
+
+/**
+ * Measure setRange() over the whole map in ranges of the given length.
+ *
+ * @return Nanoseconds taken.
+ */
+template <class B> static u64 benchRange(const Size length)
+{
+    B bits(BenchBits);
+
+    const u64 t1 = benchTime();
+    for (Size i = 0; i + length <= BenchBits; i += length)
+        bits.setRange(i, i + length - 1);
+    const u64 t2 = benchTime();
+
+    return bits.count(true) == BenchBits ? t2 - t1 : 0;
+}
+
+TestCase(BitArraySetNextBenchmark)
+{
+    // The pattern of the bench program, small ranges and large aligned ranges
+    testAssert(benchCompare("bench", 96, 61, 32, 8));
+    testAssert(benchCompare("sparse", 40, 3, 16, 1));
+    testAssert(benchCompare("aligned", 512, 200, 256, 64));
+    return OK;
+}
+
+TestCase(BitArraySetRangeBenchmark)
+{
+    const Size lengths[] = { 8, 64, 1024 };
+
+    for (Size i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        const u64 oldTime = benchRange<ReferenceBitArray>(lengths[i]);
+        const u64 newTime = benchRange<BitArray>(lengths[i]);
+
+        printf("BitArrayBench: setRange() of %4u bits: old %6u us, new %6u us\n",
+               (uint) lengths[i], (uint) (oldTime / 1000), (uint) (newTime / 1000));
+
+        testAssert(oldTime != 0 && newTime != 0);
+
+        // Ranges within a single word gain little from filling whole words
+        testAssert(lengths[i] < 64 ? newTime < oldTime * 2 : newTime < oldTime);
+    }
+
+    return OK;
+}
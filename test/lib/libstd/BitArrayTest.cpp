@@ -282,6 +282,97 @@ TestCase(BitArraySetNextOutOfMemory)
     return OK;
 }
 
+TestCase(BitArraySetNextAligned)
+{
+    BitArray ba(300);
+    Size bit;
+
+    // Fragment the array: set every 7th bit
+    for (Size i = 0; i < 300; i += 7)
+        ba.set(i, true);
+
+    // The first free pair of bits on a boundary of 4 is 4 and 5
+    testAssert(ba.setNext(&bit, 2, 0, 4) == BitArray::Success);
+    testAssert(bit == 4);
+    testAssert(ba[4] && ba[5]);
+
+    // Six unset bits are only found between two set bits
+    testAssert(ba.setNext(&bit, 6) == BitArray::Success);
+    testAssert(bit == 8);
+
+    // Seven unset bits never exist
+    testAssert(ba.setNext(&bit, 7) == BitArray::OutOfMemory);
+
+    // Clear a range which spans multiple words and find it on a boundary of 32
+    for (Size i = 100; i < 250; i++)
+        ba.set(i, false);
+
+    testAssert(ba.setNext(&bit, 100, 0, 32) == BitArray::Success);
+    testAssert(bit == 128);
+
+    for (Size i = 100; i < 250; i++)
+    {
+        testAssert(ba[i] == (i >= 128 && i < 228));
+    }
+    return OK;
+}
+
+TestCase(BitArrayFindNext)
+{
+    BitArray ba(300);
+    Size bit;
+
+    // Fragment the array: set every 7th bit
+    for (Size i = 0; i < 300; i += 7)
+        ba.set(i, true);
+
+    // Finding bits does not modify the array
+    testAssert(ba.findNext(&bit, 6) == BitArray::Success);
+    testAssert(bit == 1);
+    testAssert(ba.findNext(&bit, 6) == BitArray::Success);
+    testAssert(bit == 1);
+    testAssert(ba.count(true) == 43);
+
+    // Search from an offset and on a boundary
+    testAssert(ba.findNext(&bit, 2, 10, 4) == BitArray::Success);
+    testAssert(bit == 12);
+    testAssert(ba.findNext(&bit, 7) == BitArray::OutOfMemory);
+    testAssert(ba.findNext(&bit, 1, 300) == BitArray::OutOfMemory);
+    return OK;
+}
+
+TestCase(BitArraySetRangeWords)
+{
+    BitArray ba(1000);
+
+    // Set a range which covers partial and whole words
+    ba.setRange(3, 900);
+    testAssert(ba.count(true) == 898);
+
+    for (Size i = 0; i < 1000; i++)
+    {
+        testAssert(ba[i] == (i >= 3 && i <= 900));
+    }
+
+    // Overlapping range only counts newly set bits
+    ba.setRange(0, 999);
+    testAssert(ba.count(true) == 1000);
+    testAssert(ba.count(false) == 0);
+
+    // Range beyond the end of the array is ignored
+    ba.clear();
+    ba.setRange(990, 2000);
+    testAssert(ba.count(true) == 10);
+    testAssert(ba[999]);
+
+    // Searching ends at the last bit
+    Size bit;
+    testAssert(ba.setNext(&bit, 10, 985) == BitArray::OutOfMemory);
+    testAssert(ba.setNext(&bit, 5, 985) == BitArray::Success);
+    testAssert(bit == 985);
+    return OK;
+}
+
 TestCase(BitArrayClear)
 {
     TestInt<Size> indexes(0, 127);
@@ -327,5 +418,11 @@ TestCase(BitArraySetArray)
     testAssert(ba2.m_set   == ba.m_set);
     testAssert(ba2.m_bitCount  == ba.m_bitCount);
     testAssert(!ba2.m_allocated);
+
+    // Bits beyond the given count are not counted
+    ba.setRange(0, 127);
+    ba2.setArray(ba.m_array, 100);
+    testAssert(ba2.m_set == 100);
+    testAssert(ba2.m_bitCount == 100);
     return OK;
 }
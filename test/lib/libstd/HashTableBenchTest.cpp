@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <List.h>
+#include <ListIterator.h>
+#include <HashTable.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+/**
+ * Fixed size HashTable with a List per bucket, as a reference for benchmarking.
+ */
+template <class K, class V> class ChainedHashTable
+{
+  public:
+
+    struct Bucket
+    {
+        Bucket() {}
+        Bucket(const K & k, const V & v) : key(k), value(v) {}
+        bool operator == (const Bucket & b) const { return key == b.key && value == b.value; }
+        bool operator != (const Bucket & b) const { return !(*this == b); }
+        K key;
+        V value;
+    };
+
+    bool insert(const K & key, const V & value)
+    {
+        List<Bucket> & lst = m_table[hash(key, HASHTABLE_DEFAULT_SIZE)];
+
+        for (ListIterator<Bucket> i(lst); i.hasCurrent(); i++)
+        {
+            if (i.current().key == key)
+            {
+                i.current().value = value;
+                return true;
+            }
+        }
+        lst.append(Bucket(key, value));
+        return true;
+    }
+
+    const V * get(const K & key) const
+    {
+        const List<Bucket> & lst = m_table[hash(key, HASHTABLE_DEFAULT_SIZE)];
+
+        for (ListIterator<Bucket> i(lst); i.hasCurrent(); i++)
+            if (i.current().key == key)
+                return &i.current().value;
+
+        return ZERO;
+    }
+
+    int remove(const K & key)
+    {
+        int removed = 0;
+
+        for (ListIterator<Bucket> i(m_table[hash(key, HASHTABLE_DEFAULT_SIZE)]); i.hasCurrent(); )
+        {
+            if (i.current().key == key)
+            {
+                i.remove();
+                removed++;
+            }
+            else
+                i++;
+        }
+        return removed;
+    }
+
+    List<K> keys() const
+    {
+        List<K> lst;
+
+        for (Size i = 0; i < HASHTABLE_DEFAULT_SIZE; i++)
+            for (ListIterator<Bucket> j(m_table[i]); j.hasCurrent(); j++)
+                if (!lst.contains(j.current().key))
+                    lst << j.current().key;
+
+        return lst;
+    }
+
+  private:
+
+    List<Bucket> m_table[HASHTABLE_DEFAULT_SIZE];
+};
+
+/** Largest table for which keys() of the chained reference is measured, as it is quadratic. */
+static const Size BenchKeysMaximum = 1000;
+
+/**
+ * Get the current time in microseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return ((u64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+/**
+ * Insert, lookup, list and remove a number of keys.
+ *
+ * @param keysMaximum Largest table for which keys() is measured.
+ *
+ * @return True if all values were found.
+ */
+template <class Table> static bool benchTable(const char *name, const Size count,
+                                              const Size keysMaximum)
+{
+    Table *table = new Table();
+    bool found = true;
+    u64 t1, t2, t3, t4, t5;
+
+    t1 = benchTime();
+    for (Size i = 0; i < count; i++)
+        table->insert(i * 7, i);
+
+    t2 = benchTime();
+    for (Size i = 0; i < count; i++)
+        found = found && table->get(i * 7) != ZERO && *table->get(i * 7) == (int) i;
+
+    t3 = benchTime();
+    if (count <= keysMaximum)
+        found = found && table->keys().count() == count;
+
+    t4 = benchTime();
+    for (Size i = 0; i < count; i++)
+        found = found && table->remove(i * 7) == 1;
+    t5 = benchTime();
+
+    printf("HashTableBench: %-8s %6u keys: insert %7u us, lookup %7u us, keys %7u us, remove %7u us\n",
+           name, count, (uint) (t2 - t1), (uint) (t3 - t2), (uint) (t4 - t3), (uint) (t5 - t4));
+
+    delete table;
+    return found;
+}
+
+TestCase(HashTableBenchmark)
+{
+    for (Size count = 10; count <= 100000; count *= 100)
+    {
+        const bool chained = benchTable<ChainedHashTable<int, int> >("chained", count, BenchKeysMaximum);
+        const bool open = benchTable<HashTable<int, int> >("open", count, count);
+
+        testAssert(chained);
+        testAssert(open);
+    }
+
+    return OK;
+}
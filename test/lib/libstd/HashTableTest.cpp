@@ -151,7 +151,7 @@ TestCase(HashTableAppend)
     }
     // Check administration
     testAssert(h.count() == size);
-    testAssert(h.size() == HASHTABLE_DEFAULT_SIZE);
+    testAssert(h.count() * 100 <= h.size() * HASHTABLE_LOAD_FACTOR);
     return OK;
 }
 
@@ -192,7 +192,7 @@ TestCase(HashTableRemove)
 
     // Check administration
     testAssert(h.count() == size - 1);
-    testAssert(h.size() == HASHTABLE_DEFAULT_SIZE);
+    testAssert(h.count() * 100 <= h.size() * HASHTABLE_LOAD_FACTOR);
     testAssert(!h.keys().contains(strings.get(0)));
     testAssert(h.get(strings.get(0)) == ZERO);
     return OK;
@@ -239,7 +239,7 @@ TestCase(HashTableRemoveMultiple)
 
     // Check administration
     testAssert(h.count() == size - 1);
-    testAssert(h.size() == HASHTABLE_DEFAULT_SIZE);
+    testAssert(h.count() * 100 <= h.size() * HASHTABLE_LOAD_FACTOR);
     testAssert(!h.keys().contains(strings.get(0)));
     testAssert(h.get(strings.get(0)) == ZERO);
     return OK;
@@ -292,3 +292,115 @@ TestCase(HashTableIterate)
     }
     return OK;
 }
+
+TestCase(HashTableGrow)
+{
+    HashTable<int, int> h;
+    const Size size = 1000;
+
+    // Insert many more values than fit in the initial table
+    for (Size i = 0; i < size; i++)
+        testAssert(h.insert(i * 3, i));
+
+    // The table grows, keeping all values
+    testAssert(h.count() == size);
+    testAssert(h.size() > HASHTABLE_DEFAULT_SIZE);
+    testAssert(h.count() * 100 <= h.size() * HASHTABLE_LOAD_FACTOR);
+    testAssert(h.keys().count() == size);
+    testAssert(h.values().count() == size);
+
+    for (Size i = 0; i < size; i++)
+    {
+        testAssert(h.get(i * 3) != ZERO);
+        testAssert(*h.get(i * 3) == (int) i);
+        testAssert(!h.contains((i * 3) + 1));
+    }
+    return OK;
+}
+
+TestCase(HashTableAppendGrow)
+{
+    HashTable<int, int> h;
+    const Size size = 200;
+
+    // Append values for a few keys, causing the table to grow
+    for (Size i = 0; i < size; i++)
+        testAssert(h.append(i % 4, i));
+
+    testAssert(h.count() == size);
+    testAssert(h.keys().count() == 4);
+
+    // Values of each key are kept in order of appending
+    for (Size k = 0; k < 4; k++)
+    {
+        List<int> lst = h.values(k);
+        Size expect = k;
+
+        testAssert(lst.count() == size / 4);
+        testAssert(h[k] == (int) k);
+
+        for (ListIterator<int> i(lst); i.hasCurrent(); i++)
+        {
+            testAssert(i.current() == (int) expect);
+            expect += 4;
+        }
+    }
+    return OK;
+}
+
+TestCase(HashTableReuseRemoved)
+{
+    HashTable<int, int> h;
+
+    // Repeatedly inserting and removing does not grow the table
+    for (Size i = 0; i < 1000; i++)
+    {
+        testAssert(h.insert(i, i));
+        testAssert(h.insert(i + 1000000, i));
+        testAssert(h.remove(i) == 1);
+        testAssert(h.remove(i + 1000000) == 1);
+        testAssert(h.count() == 0);
+    }
+    testAssert(h.size() == HASHTABLE_DEFAULT_SIZE);
+
+    // Removed slots do not hide other values
+    for (Size i = 0; i < 40; i++)
+        testAssert(h.insert(i, i));
+    for (Size i = 0; i < 40; i += 2)
+        testAssert(h.remove(i) == 1);
+    for (Size i = 1; i < 40; i += 2)
+        testAssert(h.value(i, -1) == (int) i);
+
+    // Inserting an existing key after a removed slot overwrites it
+    testAssert(h.insert(1, 100));
+    testAssert(h.values(1).count() == 1);
+    testAssert(h[1] == 100);
+    testAssert(h.count() == 20);
+    return OK;
+}
+
+TestCase(HashTableCopyClear)
+{
+    HashTable<String, int> h;
+
+    testAssert(h.insert("one", 1));
+    testAssert(h.insert("two", 2));
+    testAssert(h.append("two", 3));
+
+    // Copies are independent of the original
+    HashTable<String, int> copy(h);
+    testAssert(h.remove("one") == 1);
+    testAssert(copy.count() == 3);
+    testAssert(copy["one"] == 1);
+    testAssert(copy.values("two").count() == 2);
+
+    HashTable<String, int> assigned;
+    assigned = copy;
+    copy.clear();
+    testAssert(copy.count() == 0);
+    testAssert(!copy.contains("two"));
+    testAssert(assigned.count() == 3);
+    testAssert(assigned.keys(3).contains("two"));
+    testAssert(assigned.keys(3).count() == 1);
+    return OK;
+}
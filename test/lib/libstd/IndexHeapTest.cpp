@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <IndexHeap.h>
+
+TestCase(IndexHeapConstruct)
+{
+    IndexHeap<uint, 64> heap;
+
+    // Heap must be empty after construction
+    testAssert(heap.size() == 64);
+    testAssert(heap.count() == 0);
+
+    for (Size i = 0; i < 64; i++)
+    {
+        testAssert(!heap.contains(i));
+    }
+
+    return OK;
+}
+
+TestCase(IndexHeapInsert)
+{
+    IndexHeap<uint, 64> heap;
+
+    // Index must be in range
+    testAssert(!heap.insert(64, 1));
+    testAssert(!heap.insert(65, 1));
+
+    // Insert a few indexes
+    testAssert(heap.insert(10, 500));
+    testAssert(heap.insert(20, 100));
+    testAssert(heap.insert(30, 300));
+    testAssert(heap.count() == 3);
+    testAssert(heap.contains(10));
+    testAssert(heap.contains(20));
+    testAssert(heap.contains(30));
+    testAssert(!heap.contains(40));
+
+    // Duplicate index is not allowed
+    testAssert(!heap.insert(20, 1));
+    testAssert(heap.count() == 3);
+    testAssert(heap.key(20) == 100);
+
+    // Smallest key must be on top
+    testAssert(heap.top() == 20);
+    testAssert(heap.topKey() == 100);
+
+    return OK;
+}
+
+TestCase(IndexHeapOrder)
+{
+    IndexHeap<uint, 1024> heap;
+    TestInt<uint> keys(0, UINT_MAX);
+    uint previous = 0;
+
+    // Fill the heap with random keys
+    for (Size i = 0; i < 1024; i++)
+    {
+        testAssert(heap.insert(i, keys.random()));
+        testAssert(heap.count() == i + 1);
+    }
+
+    // Indexes must come out in order of increasing key
+    for (Size i = 0; i < 1024; i++)
+    {
+        const Size index = heap.top();
+        const uint key = heap.topKey();
+
+        testAssert(key >= previous);
+        testAssert(key == keys[index]);
+        testAssert(heap.pop() == index);
+        testAssert(!heap.contains(index));
+        testAssert(heap.count() == 1024 - i - 1);
+        previous = key;
+    }
+
+    return OK;
+}
+
+TestCase(IndexHeapEqualKeys)
+{
+    IndexHeap<uint, 64> heap;
+
+    // Equal keys are all returned before larger keys
+    for (Size i = 0; i < 32; i++)
+    {
+        testAssert(heap.insert(i, i < 16 ? 5 : 10));
+    }
+
+    for (Size i = 0; i < 16; i++)
+    {
+        testAssert(heap.topKey() == 5);
+        testAssert(heap.pop() < 16);
+    }
+
+    for (Size i = 0; i < 16; i++)
+    {
+        testAssert(heap.topKey() == 10);
+        testAssert(heap.pop() >= 16);
+    }
+
+    testAssert(heap.count() == 0);
+    return OK;
+}
+
+TestCase(IndexHeapRemove)
+{
+    IndexHeap<uint, 512> heap;
+    TestInt<uint> keys(0, UINT_MAX);
+    uint previous = 0;
+
+    // Fill the heap with random keys
+    for (Size i = 0; i < 512; i++)
+    {
+        testAssert(heap.insert(i, keys.random()));
+    }
+
+    // Remove every odd index
+    for (Size i = 1; i < 512; i += 2)
+    {
+        testAssert(heap.remove(i));
+        testAssert(!heap.contains(i));
+    }
+    testAssert(heap.count() == 256);
+
+    // Cannot remove twice
+    testAssert(!heap.remove(1));
+    testAssert(!heap.remove(512));
+    testAssert(heap.count() == 256);
+
+    // Remaining even indexes must come out in order of increasing key
+    for (Size i = 0; i < 256; i++)
+    {
+        const Size index = heap.pop();
+
+        testAssert((index % 2) == 0);
+        testAssert(keys[index] >= previous);
+        previous = keys[index];
+    }
+
+    testAssert(heap.count() == 0);
+    return OK;
+}
+
+TestCase(IndexHeapReinsert)
+{
+    IndexHeap<uint, 64> heap;
+
+    // Insert, remove and insert again with a different key
+    testAssert(heap.insert(1, 100));
+    testAssert(heap.insert(2, 200));
+    testAssert(heap.remove(1));
+    testAssert(heap.top() == 2);
+    testAssert(heap.insert(1, 300));
+    testAssert(heap.top() == 2);
+    testAssert(heap.pop() == 2);
+    testAssert(heap.top() == 1);
+    testAssert(heap.topKey() == 300);
+
+    return OK;
+}
+
+TestCase(IndexHeapClear)
+{
+    IndexHeap<uint, 64> heap;
+
+    // Fill the heap
+    for (Size i = 0; i < 64; i++)
+    {
+        testAssert(heap.insert(i, 64 - i));
+    }
+    testAssert(heap.count() == 64);
+
+    // Clear it
+    heap.clear();
+    testAssert(heap.count() == 0);
+    testAssert(heap.size() == 64);
+
+    for (Size i = 0; i < 64; i++)
+    {
+        testAssert(!heap.contains(i));
+    }
+
+    // Can be filled again
+    testAssert(heap.insert(5, 1));
+    testAssert(heap.top() == 5);
+
+    return OK;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <LinnFileSystem.h>
+#include <LinnDirectory.h>
+#include <LinnFile.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include "LinnTestImage.h"
+
+/** Size of the test file in bytes. */
+static const Size FileSize = 5000;
+
+/** Size of the file which takes long enough to copy for interrupting LinnCreate. */
+static const Size LargeFileSize = 32 * 1024 * 1024;
+
+/** Block size of the test images. */
+static const Size BlockSize = 4096;
+
+/** Number of blocks in the test images. */
+static const Size BlockNum = 16384;
+
+/**
+ * Compare the contents of a file in the image.
+ *
+ * @param image Image to mount.
+ * @param size Size of the file in bytes.
+ * @param fill Expected value of every byte, or -1 for LinnTestImage::contents().
+ *
+ * @return True if the image is valid and the contents are equal.
+ */
+static bool compareFile(LinnTestImage *image, const Size size, const int fill)
+{
+    LinnFileSystem fs("/", image);
+    LinnDirectory root(&fs, fs.getInode(LINN_INODE_ROOT));
+    File *file = root.lookup("file");
+    bool equal = fs.getSuperBlock()->state == LINN_SUPER_VALID && file != ZERO;
+    u64 offset = 0;
+
+    for (Size i = 0; i < size && equal; i++)
+    {
+        if (i % BlockSize == 0)
+            offset = fs.getOffset(static_cast<LinnFile *>(file)->inode, i / BlockSize);
+
+        const u8 expect = fill < 0 ? LinnTestImage::contents(i) : fill;
+        equal = offset != 0 && image->getData()[offset + (i % BlockSize)] == expect;
+    }
+
+    delete file;
+    return equal;
+}
+
+/**
+ * Set the modification time of a local file.
+ *
+ * @param path Path to the local file.
+ * @param seconds Seconds relative to the current time.
+ *
+ * @return True on success.
+ */
+static bool setModified(const char *path, const int seconds)
+{
+    struct timeval times[2];
+
+    gettimeofday(&times[0], ZERO);
+    times[0].tv_sec += seconds;
+    times[1] = times[0];
+    return utimes(path, times) == 0;
+}
+
+/**
+ * Create an image in a child process, and kill it once the superblock is written.
+ *
+ * @param image Image to create.
+ *
+ * @return True if the child was started.
+ */
+static bool createInterrupted(LinnTestImage *image)
+{
+    LinnSuperBlock super;
+    const pid_t pid = fork();
+    int status, fd;
+
+    if (pid < 0)
+        return false;
+
+    if (pid == 0)
+        _exit(image->create(true, BlockSize, BlockNum, 128) ? EXIT_SUCCESS : EXIT_FAILURE);
+
+    while (waitpid(pid, &status, WNOHANG) == 0)
+    {
+        if ((fd = open(image->getImage(), O_RDONLY)) >= 0)
+        {
+            const bool written = pread(fd, &super, sizeof(super), LINN_SUPER_OFFSET) == sizeof(super) &&
+                                 super.magic0 == LINN_SUPER_MAGIC0;
+            close(fd);
+
+            if (written)
+            {
+                kill(pid, SIGKILL);
+                waitpid(pid, &status, 0);
+                break;
+            }
+        }
+        usleep(100);
+    }
+
+    return true;
+}
+
+TestCase(LinnCreateUpdateInterrupted)
+{
+    LinnTestImage image;
+    char path[128];
+
+    snprintf(path, sizeof(path), "%s/file", image.getInput());
+    testAssert(image.addFile("file", LargeFileSize));
+    testAssert(setModified(path, -3600));
+
+    // A valid image must contain all files, also if it was not written completely
+    testAssert(createInterrupted(&image));
+    testAssert(image.load());
+    testAssert(image.capacity() > LINN_SUPER_OFFSET + sizeof(LinnSuperBlock));
+
+    const LinnSuperBlock *super = (const LinnSuperBlock *) (image.getData() + LINN_SUPER_OFFSET);
+    testAssert(super->state != LINN_SUPER_VALID || compareFile(&image, LargeFileSize, -1));
+
+    // The input file is older than the image, but the image must be written again
+    testAssert(setModified(image.getImage(), 60));
+    testAssert(image.create(true, BlockSize, BlockNum, 128, true));
+    testAssert(compareFile(&image, LargeFileSize, -1));
+    return OK;
+}
+
+TestCase(LinnCreateUpdateReplaced)
+{
+    LinnTestImage image;
+    char path[128];
+    u8 buf[FileSize];
+
+    testAssert(image.addFile("file", FileSize));
+    testAssert(image.create(true, BlockSize, BlockNum, 128));
+    testAssert(compareFile(&image, FileSize, -1));
+
+    // Replace the file with one of equal size, which keeps an older modification time
+    snprintf(path, sizeof(path), "%s/file", image.getInput());
+    MemoryBlock::set(buf, 0x5a, sizeof(buf));
+
+    const int fd = open(path, O_WRONLY | O_TRUNC);
+    testAssert(fd >= 0);
+    testAssert(::write(fd, buf, sizeof(buf)) == sizeof(buf));
+    close(fd);
+    testAssert(setModified(path, -3600));
+
+    // The update finds the file by its status change time
+    testAssert(image.create(true, BlockSize, BlockNum, 128, true));
+    testAssert(compareFile(&image, FileSize, 0x5a));
+
+    // Unchanged files are kept by a second update
+    testAssert(image.create(true, BlockSize, BlockNum, 128, true));
+    testAssert(compareFile(&image, FileSize, 0x5a));
+    return OK;
+}
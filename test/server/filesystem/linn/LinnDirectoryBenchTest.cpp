@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <LinnFileSystem.h>
+#include <LinnDirectory.h>
+#include <sys/time.h>
+#include "LinnTestImage.h"
+
+/** Number of files in the benchmarked directory. */
+static const Size BenchFiles = 10000;
+
+/**
+ * Get the current time in microseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return ((u64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+/**
+ * Lookup files in the directory.
+ *
+ * @param image Image to mount.
+ * @param name Name of the measurement.
+ * @param step Lookup every step'th file.
+ *
+ * @return True if all files were found.
+ */
+static bool benchLookup(LinnTestImage *image, const char *name, const Size step)
+{
+    LinnFileSystem fs("/", image);
+    LinnDirectory root(&fs, fs.getInode(LINN_INODE_ROOT));
+    LinnDirectory *dir = static_cast<LinnDirectory *>(root.lookup("dir"));
+    const Size reads = image->getReads();
+    bool found = dir != ZERO;
+    Size count = 0;
+    char file[32];
+    u64 t1, t2;
+
+    t1 = benchTime();
+    for (Size i = 0; i < BenchFiles && found; i += step, count++)
+    {
+        snprintf(file, sizeof(file), "file%u", (uint) i);
+        File *f = dir->lookup(file);
+        found = f != ZERO;
+        delete f;
+    }
+    t2 = benchTime();
+
+    printf("LinnDirectoryBench: %-7s %u of %u files: %8u us, %6u ns per lookup, %u storage reads\n",
+           name, (uint) count, (uint) BenchFiles, (uint) (t2 - t1),
+           (uint) ((t2 - t1) * 1000 / count), (uint) (image->getReads() - reads));
+
+    delete dir;
+    return found;
+}
+
+TestCase(LinnDirectoryBenchmark)
+{
+    LinnTestImage image;
+    char name[32];
+
+    testAssert(image.addDirectory("dir"));
+
+    for (Size i = 0; i < BenchFiles; i++)
+    {
+        snprintf(name, sizeof(name), "dir/file%u", (uint) i);
+        testAssert(image.addFile(name, 0));
+    }
+    testAssert(image.create(true, 2048, 16384, BenchFiles + 64));
+
+    // Lookup with the directory index
+    testAssert(benchLookup(&image, "indexed", 1));
+
+    // Lookup by scanning all entries. Slow, so only a part of the files.
+    LinnSuperBlock *super = (LinnSuperBlock *) (image.getData() + LINN_SUPER_OFFSET);
+    super->minorRevision = 0;
+    testAssert(benchLookup(&image, "linear", 10));
+
+    return OK;
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <LinnFileSystem.h>
+#include <LinnDirectory.h>
+#include "LinnTestImage.h"
+
+/** Number of files in the test directory. Uses more than the direct blocks of the inode. */
+static const Size DirectoryFiles = 300;
+
+/**
+ * Create an image with a directory of many files.
+ */
+static bool createImage(LinnTestImage *image, const bool extents)
+{
+    char name[32];
+
+    if (!image->addDirectory("dir"))
+        return false;
+
+    for (Size i = 0; i < DirectoryFiles; i++)
+    {
+        snprintf(name, sizeof(name), "dir/file%u", (uint) i);
+
+        if (!image->addFile(name, i % 3))
+            return false;
+    }
+
+    return image->create(extents, 1024, 8192, 1024);
+}
+
+/**
+ * Get the test directory from a mounted image.
+ */
+static LinnDirectory * getDirectory(LinnFileSystem *fs)
+{
+    LinnDirectory root(fs, fs->getInode(LINN_INODE_ROOT));
+    File *dir = root.lookup("dir");
+
+    if (!dir || dir->getType() != FileSystem::DirectoryFile)
+    {
+        delete dir;
+        return ZERO;
+    }
+
+    return static_cast<LinnDirectory *>(dir);
+}
+
+/**
+ * Lookup all files and some missing names in the test directory.
+ *
+ * @return True if all files are found and no missing names.
+ */
+static bool lookupAll(LinnDirectory *dir)
+{
+    const char *missing[] = { "file", "file300", "File0", "dir", "" };
+    char name[32];
+
+    for (Size i = 0; i < DirectoryFiles; i++)
+    {
+        snprintf(name, sizeof(name), "file%u", (uint) i);
+        File *file = dir->lookup(name);
+
+        if (!file || file->getType() != FileSystem::RegularFile)
+            return false;
+
+        delete file;
+    }
+
+    for (Size i = 0; i < sizeof(missing) / sizeof(missing[0]); i++)
+    {
+        if (dir->lookup(missing[i]) != ZERO)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Get the offset in the image of the index of the test directory.
+ */
+static u64 getIndexOffset(LinnTestImage *image)
+{
+    LinnFileSystem fs("/", image);
+    LinnDirectory *dir = getDirectory(&fs);
+    const u64 offset = dir ? fs.getOffset(dir->inode, LINN_INODE_NUM_BLOCKS(fs.getSuperBlock(), dir->inode)) : 0;
+
+    delete dir;
+    return offset;
+}
+
+TestCase(LinnDirectoryIndexLookup)
+{
+    LinnTestImage image;
+    testAssert(createImage(&image, true));
+
+    LinnFileSystem fs("/", &image);
+    LinnDirectory *dir = getDirectory(&fs);
+    testAssert(dir != ZERO);
+
+    // The index has at least two buckets per entry
+    testAssert(dir->indexBuckets >= (DirectoryFiles + 2) * 2);
+    testAssert(lookupAll(dir));
+
+    delete dir;
+    return OK;
+}
+
+TestCase(LinnDirectoryRevisionFallback)
+{
+    LinnTestImage image;
+    testAssert(createImage(&image, true));
+
+    // Images of the previous revision have no index
+    LinnSuperBlock *super = (LinnSuperBlock *) (image.getData() + LINN_SUPER_OFFSET);
+    super->minorRevision = 0;
+
+    LinnFileSystem fs("/", &image);
+    LinnDirectory *dir = getDirectory(&fs);
+    testAssert(dir != ZERO);
+    testAssert(dir->indexBuckets == 0);
+    testAssert(lookupAll(dir));
+
+    delete dir;
+    return OK;
+}
+
+TestCase(LinnDirectoryInvalidIndex)
+{
+    LinnTestImage image;
+    testAssert(createImage(&image, true));
+
+    const u64 offset = getIndexOffset(&image);
+    testAssert(offset != 0);
+
+    LinnDirectoryIndex *index = (LinnDirectoryIndex *) (image.getData() + offset);
+    testAssert(index->magic == LINN_DIRINDEX_MAGIC);
+
+    const LinnDirectoryIndex valid = *index;
+    const le32 magics[] = { 0, 0xdeadbeef, LINN_DIRINDEX_MAGIC, LINN_DIRINDEX_MAGIC };
+    const le32 buckets[] = { valid.buckets, valid.buckets, 0, valid.buckets - 1 };
+
+    // Corrupt or absent indexes are ignored
+    for (Size i = 0; i < sizeof(magics) / sizeof(magics[0]); i++)
+    {
+        index->magic   = magics[i];
+        index->buckets = buckets[i];
+
+        LinnFileSystem fs("/", &image);
+        LinnDirectory *dir = getDirectory(&fs);
+        testAssert(dir != ZERO);
+        testAssert(dir->indexBuckets == 0);
+        testAssert(lookupAll(dir));
+        delete dir;
+    }
+
+    return OK;
+}
+
+TestCase(LinnDirectoryIndirectBlocks)
+{
+    LinnTestImage image;
+    testAssert(createImage(&image, false));
+
+    LinnSuperBlock *super = (LinnSuperBlock *) (image.getData() + LINN_SUPER_OFFSET);
+    testAssert(!(super->features & LINN_SUPER_FEATURE_EXTENTS));
+
+    // The entries and the index use indirect blocks
+    {
+        LinnFileSystem fs("/", &image);
+        LinnDirectory *dir = getDirectory(&fs);
+        testAssert(dir != ZERO);
+        testAssert(LINN_INODE_NUM_BLOCKS(fs.getSuperBlock(), dir->inode) > LINN_INODE_DIR_BLOCKS);
+        testAssert(dir->indexBuckets != 0);
+        testAssert(lookupAll(dir));
+        delete dir;
+    }
+
+    // Scanning all entries also follows the indirect blocks
+    super->minorRevision = 0;
+    {
+        LinnFileSystem fs("/", &image);
+        LinnDirectory *dir = getDirectory(&fs);
+        testAssert(dir != ZERO);
+        testAssert(dir->indexBuckets == 0);
+        testAssert(lookupAll(dir));
+        delete dir;
+    }
+
+    return OK;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <IOBuffer.h>
+#include <LinnFileSystem.h>
+#include <LinnDirectory.h>
+#include <LinnFile.h>
+#include <sys/time.h>
+#include "LinnTestImage.h"
+
+/** Size of the large file. */
+static const Size BenchLargeSize = 16 * 1024 * 1024;
+
+/** Number of small files. */
+static const Size BenchSmallFiles = 500;
+
+/** Size of each small file. */
+static const Size BenchSmallSize = 5000;
+
+/** Number of bytes per read request. */
+static const Size BenchReadSize = 64 * 1024;
+
+/**
+ * Get the current time in microseconds.
+ */
+static u64 benchTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return ((u64) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+/**
+ * Read a whole file and compare its contents.
+ *
+ * @return Number of bytes read, or zero if the contents differ.
+ */
+static Size readFile(LinnDirectory *root, const char *name, u8 *buf)
+{
+    File *file = root->lookup(name);
+    Size offset = 0;
+    FileSystem::Error result;
+    FileSystemMessage msg;
+
+    if (!file)
+        return 0;
+
+    msg.from   = SELF;
+    msg.action = FileSystem::ReadFile;
+    msg.buffer = (char *) buf;
+    msg.size   = BenchReadSize;
+
+    while (true)
+    {
+        msg.offset = offset;
+        IOBuffer io(&msg);
+
+        if ((result = file->read(io, BenchReadSize, offset)) <= 0)
+            break;
+
+        for (Size i = 0; i < (Size) result; i += 509)
+        {
+            if (buf[i] != LinnTestImage::contents(offset + i))
+            {
+                delete file;
+                return 0;
+            }
+        }
+        offset += result;
+    }
+
+    delete file;
+    return result == 0 ? offset : 0;
+}
+
+/**
+ * Read all files from an image.
+ *
+ * @return True if all contents are equal.
+ */
+static bool benchRead(LinnTestImage *image, const char *name)
+{
+    LinnFileSystem fs("/", image);
+    LinnDirectory root(&fs, fs.getInode(LINN_INODE_ROOT));
+    u8 *buf = new u8[BenchReadSize];
+    Size reads = image->getReads();
+    Size total = 0, bytes;
+    char file[32];
+    bool equal = true;
+    u64 t1, t2, t3;
+
+    // Read the large file
+    t1 = benchTime();
+    bytes = readFile(&root, "large", buf);
+    equal = bytes == BenchLargeSize;
+    t2 = benchTime();
+
+    printf("LinnFileBench: %-8s large: %6u us, %4u MB/s, %u storage reads\n",
+           name, (uint) (t2 - t1), (uint) (bytes / ((t2 - t1) ? (t2 - t1) : 1)),
+           (uint) (image->getReads() - reads));
+
+    // Read the small files
+    reads = image->getReads();
+    for (Size i = 0; i < BenchSmallFiles && equal; i++)
+    {
+        snprintf(file, sizeof(file), "small%u", (uint) i);
+        bytes = readFile(&root, file, buf);
+        equal = bytes == BenchSmallSize;
+        total += bytes;
+    }
+    t3 = benchTime();
+
+    printf("LinnFileBench: %-8s small: %6u us, %4u MB/s, %u storage reads\n",
+           name, (uint) (t3 - t2), (uint) (total / ((t3 - t2) ? (t3 - t2) : 1)),
+           (uint) (image->getReads() - reads));
+
+    // Map every block of the large file
+    File *large = root.lookup("large");
+    LinnInode *inode = large ? static_cast<LinnFile *>(large)->inode : ZERO;
+    const u32 blocks = inode ? LINN_INODE_NUM_BLOCKS(fs.getSuperBlock(), inode) : 0;
+
+    reads = image->getReads();
+    t1 = benchTime();
+    for (u32 i = 0; i < blocks && equal; i++)
+        equal = fs.getOffset(inode, i) != 0;
+    t2 = benchTime();
+
+    printf("LinnFileBench: %-8s map:   %6u us for %u blocks, %u storage reads\n",
+           name, (uint) (t2 - t1), blocks, (uint) (image->getReads() - reads));
+
+    delete large;
+    delete[] buf;
+    return equal && blocks != 0;
+}
+
+/**
+ * Create an image and measure reading it.
+ */
+static bool benchImage(const char *name, const bool extents)
+{
+    LinnTestImage image;
+    char file[32];
+
+    if (!image.addFile("large", BenchLargeSize))
+        return false;
+
+    for (Size i = 0; i < BenchSmallFiles; i++)
+    {
+        snprintf(file, sizeof(file), "small%u", (uint) i);
+
+        if (!image.addFile(file, BenchSmallSize))
+            return false;
+    }
+
+    return image.create(extents, 2048, 16384, 1024) && benchRead(&image, name);
+}
+
+TestCase(LinnFileBenchmark)
+{
+    testAssert(benchImage("extents", true));
+    testAssert(benchImage("indirect", false));
+    return OK;
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestMain.h>
+#include <IOBuffer.h>
+#include <LinnFileSystem.h>
+#include <LinnDirectory.h>
+#include <LinnFile.h>
+#include <sys/wait.h>
+#include "LinnTestImage.h"
+
+/** Sizes of the test files. The largest needs double indirect blocks with -m. */
+static const Size FileSizes[] = { 0, 1, 1023, 1024, 1025, 4096 * 3 + 17, 300 * 1024 };
+
+/** Number of files in the directory which needs a chain of extent blocks. */
+static const Size ChainFiles = 2400;
+
+/**
+ * Add the test files to an image.
+ */
+static bool addFiles(LinnTestImage *image)
+{
+    char name[32];
+
+    for (Size i = 0; i < sizeof(FileSizes) / sizeof(FileSizes[0]); i++)
+    {
+        snprintf(name, sizeof(name), "file%u", (uint) i);
+
+        if (!image->addFile(name, FileSizes[i]))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Read a file into local memory.
+ */
+static FileSystem::Error readFile(File *file, void *buffer, const Size size, const Size offset)
+{
+    FileSystemMessage msg;
+    msg.from   = SELF;
+    msg.action = FileSystem::ReadFile;
+    msg.buffer = (char *) buffer;
+    msg.size   = size;
+    msg.offset = offset;
+
+    IOBuffer io(&msg);
+    return file->read(io, size, offset);
+}
+
+/**
+ * Read all test files in pieces and compare their contents.
+ *
+ * @return True if all contents are equal.
+ */
+static bool readFiles(LinnFileSystem *fs, const Size piece)
+{
+    LinnDirectory root(fs, fs->getInode(LINN_INODE_ROOT));
+    u8 *buf = new u8[piece];
+    bool equal = true;
+    char name[32];
+
+    for (Size i = 0; i < sizeof(FileSizes) / sizeof(FileSizes[0]) && equal; i++)
+    {
+        snprintf(name, sizeof(name), "file%u", (uint) i);
+        File *file = root.lookup(name);
+        Size offset = 0;
+
+        if (!file)
+            return false;
+
+        while (equal)
+        {
+            const FileSystem::Error result = readFile(file, buf, piece, offset);
+
+            if (result < 0)
+                equal = false;
+            else if (result == 0)
+                break;
+
+            for (Size j = 0; j < (Size) result && equal; j++)
+                equal = buf[j] == LinnTestImage::contents(offset + j);
+
+            offset += result;
+        }
+
+        equal = equal && offset == FileSizes[i];
+        delete file;
+    }
+
+    delete[] buf;
+    return equal;
+}
+
+TestCase(LinnFileSystemInodeExtents)
+{
+    LinnTestImage image;
+    testAssert(addFiles(&image));
+    testAssert(image.create(true, 1024, 8192, 1024));
+
+    LinnFileSystem fs("/", &image);
+    testAssert(fs.getSuperBlock()->features & LINN_SUPER_FEATURE_EXTENTS);
+
+    // Each file is one extent inside its inode
+    LinnDirectory root(&fs, fs.getInode(LINN_INODE_ROOT));
+    File *file = root.lookup("file6");
+    testAssert(file != ZERO);
+
+    LinnInode *inode = static_cast<LinnFile *>(file)->inode;
+    const LinnExtent *extent = (const LinnExtent *) inode->block;
+    testAssert(extent[0].length == 300);
+    testAssert(extent[1].length == 0);
+    testAssert(inode->block[LINN_INODE_EXTENT_BLOCK] == 0);
+
+    // Blocks beyond the last extent are not mapped
+    testAssert(fs.getOffset(inode, 299) == ((u64) extent[0].start + 299) * 1024);
+    testAssert(fs.getOffset(inode, 300) == 0);
+    delete file;
+
+    // Read with pieces smaller and larger than a block
+    testAssert(readFiles(&fs, 100));
+    testAssert(readFiles(&fs, 64 * 1024));
+    return OK;
+}
+
+TestCase(LinnFileSystemExtentBlocks)
+{
+    LinnTestImage image;
+    char name[32];
+
+    // Blocks of the directory are interleaved with the file contents,
+    // which gives one extent per directory block
+    testAssert(image.addDirectory("dir"));
+
+    for (Size i = 0; i < ChainFiles; i++)
+    {
+        snprintf(name, sizeof(name), "dir/file%u", (uint) i);
+        testAssert(image.addFile(name, 1));
+    }
+    testAssert(image.create(true, 1024, 16384, ChainFiles + 64));
+
+    LinnFileSystem fs("/", &image);
+    LinnSuperBlock *super = fs.getSuperBlock();
+    LinnDirectory root(&fs, fs.getInode(LINN_INODE_ROOT));
+    LinnDirectory *dir = static_cast<LinnDirectory *>(root.lookup("dir"));
+    testAssert(dir != ZERO);
+
+    // The extents continue in a chain of two extent blocks
+    const u32 blocks = LINN_INODE_NUM_BLOCKS(super, dir->inode);
+    const LinnExtent *first = (const LinnExtent *)
+        (image.getData() + ((u64) dir->inode->block[LINN_INODE_EXTENT_BLOCK] * 1024));
+    testAssert(blocks > LINN_INODE_EXTENTS + LINN_EXTENTS_PER_BLOCK(super));
+    testAssert(dir->inode->block[LINN_INODE_EXTENT_BLOCK] != 0);
+    testAssert(first[LINN_EXTENTS_PER_BLOCK(super)].start != 0);
+
+    // Every block is mapped to a distinct offset
+    for (u32 i = 0; i < blocks; i++)
+    {
+        const u64 offset = fs.getOffset(dir->inode, i);
+        testAssert(offset != 0);
+        testAssert(i == 0 || offset != fs.getOffset(dir->inode, i - 1));
+    }
+
+    // All entries are found through the index and by scanning
+    for (Size pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+            dir->indexBuckets = 0;
+
+        for (Size i = 0; i < ChainFiles; i += 7)
+        {
+            snprintf(name, sizeof(name), "file%u", (uint) i);
+            File *file = dir->lookup(name);
+            testAssert(file != ZERO);
+            delete file;
+        }
+    }
+
+    delete dir;
+    return OK;
+}
+
+TestCase(LinnFileSystemIndirectBlocks)
+{
+    LinnTestImage image;
+    testAssert(addFiles(&image));
+    testAssert(image.create(false, 1024, 8192, 1024));
+
+    LinnFileSystem fs("/", &image);
+    testAssert(!(fs.getSuperBlock()->features & LINN_SUPER_FEATURE_EXTENTS));
+
+    // The largest file uses double indirect blocks
+    LinnDirectory root(&fs, fs.getInode(LINN_INODE_ROOT));
+    File *file = root.lookup("file6");
+    testAssert(file != ZERO);
+
+    LinnInode *inode = static_cast<LinnFile *>(file)->inode;
+    testAssert(inode->block[LINN_INODE_DIR_BLOCKS + 1] != 0);
+    delete file;
+
+    testAssert(readFiles(&fs, 100));
+    testAssert(readFiles(&fs, 64 * 1024));
+    return OK;
+}
+
+/**
+ * Mount an image in a child process.
+ *
+ * @return Exit status of the child.
+ */
+static int mountChild(LinnTestImage *image)
+{
+    int status;
+    const pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        LinnFileSystem fs("/", image);
+        exit(EXIT_SUCCESS);
+    }
+
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+        return -1;
+
+    return WEXITSTATUS(status);
+}
+
+TestCase(LinnFileSystemUnknownFeatures)
+{
+    LinnTestImage image;
+    testAssert(addFiles(&image));
+    testAssert(image.create(true, 1024, 8192, 1024));
+
+    LinnSuperBlock *super = (LinnSuperBlock *) (image.getData() + LINN_SUPER_OFFSET);
+    testAssert(mountChild(&image) == EXIT_SUCCESS);
+
+    // Mounting fails on features which are not known
+    super->features |= (1 << 7);
+    testAssert(mountChild(&image) == EXIT_FAILURE);
+    return OK;
+}
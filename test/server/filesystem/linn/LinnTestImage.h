@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TEST_SERVER_FILESYSTEM_LINN_LINNTESTIMAGE_H
+#define __TEST_SERVER_FILESYSTEM_LINN_LINNTESTIMAGE_H
+
+#include <Types.h>
+#include <MemoryBlock.h>
+#include <Storage.h>
+#include <String.h>
+#include <List.h>
+#include <ListIterator.h>
+#include <LinnCreate.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+/**
+ * LinnFS image in memory, created with LinnCreate from a temporary input directory.
+ */
+class LinnTestImage : public Storage
+{
+  public:
+
+    /**
+     * Constructor.
+     */
+    LinnTestImage()
+        : m_data(ZERO)
+        , m_size(0)
+        , m_reads(0)
+    {
+        snprintf(m_input, sizeof(m_input), "/tmp/linntest.XXXXXX");
+        snprintf(m_image, sizeof(m_image), "%s.img", mkdtemp(m_input));
+    }
+
+    /**
+     * Destructor. Removes the input directory and the image file.
+     */
+    virtual ~LinnTestImage()
+    {
+        for (ListIterator<String> i(m_paths); i.hasCurrent(); i++)
+        {
+            if (unlink(*i.current()) != 0)
+                rmdir(*i.current());
+        }
+        rmdir(m_input);
+        unlink(m_image);
+        delete[] m_data;
+    }
+
+    /**
+     * Add a directory to the input directory.
+     *
+     * @param path Path relative to the input directory.
+     *
+     * @return True on success.
+     */
+    bool addDirectory(const char *path)
+    {
+        char full[256];
+
+        snprintf(full, sizeof(full), "%s/%s", m_input, path);
+        m_paths.prepend(full);
+        return mkdir(full, 0755) == 0;
+    }
+
+    /**
+     * Add a file to the input directory.
+     *
+     * @param path Path relative to the input directory.
+     * @param size Number of bytes. The contents are given by contents().
+     *
+     * @return True on success.
+     */
+    bool addFile(const char *path, const Size size)
+    {
+        char full[256];
+        u8 buf[4096];
+        Size written = 0;
+        int fd;
+
+        snprintf(full, sizeof(full), "%s/%s", m_input, path);
+        m_paths.prepend(full);
+
+        if ((fd = open(full, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+            return false;
+
+        while (written < size)
+        {
+            const Size bytes = size - written < sizeof(buf) ? size - written : sizeof(buf);
+
+            for (Size i = 0; i < bytes; i++)
+                buf[i] = contents(written + i);
+
+            if (::write(fd, buf, bytes) != (ssize_t) bytes)
+                break;
+
+            written += bytes;
+        }
+        close(fd);
+        return written == size;
+    }
+
+    /**
+     * Get the expected contents of a file added with addFile().
+     *
+     * @param offset Offset in the file.
+     *
+     * @return Byte value at the offset.
+     */
+    static u8 contents(const Size offset)
+    {
+        return (offset * 7) + (offset / 4093);
+    }
+
+    /**
+     * Create the image with LinnCreate and load it in memory.
+     *
+     * @param extents True to map blocks with extents, false for (in)direct blocks.
+     * @param blockSize Size of each block in bytes.
+     * @param blockNum Maximum number of blocks.
+     * @param inodeNum Number of inodes.
+     * @param update True to update the image of a previous create().
+     *
+     * @return True on success.
+     */
+    bool create(const bool extents, const Size blockSize,
+                const Size blockNum, const Size inodeNum,
+                const bool update = false)
+    {
+        LinnCreate linn;
+
+        linn.setProgram((char *) "LinnTestImage");
+        linn.setImage(m_image);
+        linn.setInput(m_input);
+        linn.setExtents(extents);
+        linn.setUpdate(update);
+
+        if (linn.create(blockSize, blockNum, inodeNum) != EXIT_SUCCESS)
+            return false;
+
+        return load();
+    }
+
+    /**
+     * Load the image file in memory.
+     *
+     * @return True on success.
+     */
+    bool load()
+    {
+        struct stat st;
+        int fd;
+
+        if ((fd = open(m_image, O_RDONLY)) < 0)
+            return false;
+
+        delete[] m_data;
+        m_size = fstat(fd, &st) == 0 ? st.st_size : 0;
+        m_data = new u8[m_size];
+
+        const bool loaded = ::read(fd, m_data, m_size) == (ssize_t) m_size;
+        close(fd);
+        return loaded;
+    }
+
+    /**
+     * Get the path of the input directory.
+     *
+     * @return Path of the input directory.
+     */
+    const char * getInput() const
+    {
+        return m_input;
+    }
+
+    /**
+     * Get the path of the image file.
+     *
+     * @return Path of the image file.
+     */
+    const char * getImage() const
+    {
+        return m_image;
+    }
+
+    /**
+     * Get the image contents, for modifying the image.
+     *
+     * @return Pointer to the image in memory.
+     */
+    u8 * getData()
+    {
+        return m_data;
+    }
+
+    /**
+     * Get the number of read() calls.
+     *
+     * @return Number of reads.
+     */
+    Size getReads() const
+    {
+        return m_reads;
+    }
+
+    virtual FileSystem::Result initialize()
+    {
+        return FileSystem::Success;
+    }
+
+    virtual FileSystem::Result read(const u64 offset, void *buffer, const Size size) const
+    {
+        if (offset + size > m_size)
+            return FileSystem::IOError;
+
+        MemoryBlock::copy(buffer, m_data + offset, size);
+        m_reads++;
+        return FileSystem::Success;
+    }
+
+    virtual u64 capacity() const
+    {
+        return m_size;
+    }
+
+  private:
+
+    /** Temporary input directory. */
+    char m_input[64];
+
+    /** Path of the image file. */
+    char m_image[64];
+
+    /** Files and directories added to the input directory, most recent first. */
+    List<String> m_paths;
+
+    /** Image contents. */
+    u8 *m_data;
+
+    /** Size of the image in bytes. */
+    Size m_size;
+
+    /** Number of read() calls. */
+    mutable Size m_reads;
+};
+
+#endif /* __TEST_SERVER_FILESYSTEM_LINN_LINNTESTIMAGE_H */
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <TestCase.h>
+#include <TestRunner.h>
+#include <TestInt.h>
+#include <TestMain.h>
+#include <NetworkClient.h>
+#include <IPV4.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+/** UDP port used by the receiving socket */
+#define LOOPBACK_PORT    9000
+
+/**
+ * Number of datagrams sent before reading them back.
+ * Must fit in the receive queue of a UDP socket.
+ */
+#define LOOPBACK_WINDOW  8
+
+/** Total number of datagrams to push through the loopback device */
+#define LOOPBACK_COUNT   4096
+
+/** Payload size of each datagram in bytes */
+#define LOOPBACK_PAYLOAD 1024
+
+TestCase(LoopbackUDPThroughput)
+{
+    NetworkClient client("loopback");
+    struct sockaddr addr;
+    struct timeval t1, t2;
+    char addrText[32];
+    u32 payload[LOOPBACK_PAYLOAD / sizeof(u32)];
+    int sender, receiver, fd;
+    Size bytes = 0;
+
+    // The loopback server is not started on every configuration
+    if (client.initialize() != NetworkClient::Success)
+        return SKIP;
+
+    // Retrieve the IPV4 address of the loopback device
+    fd = open("/network/loopback/ipv4/address", O_RDONLY);
+    testAssert(fd >= 0);
+    const int len = read(fd, addrText, sizeof(addrText) - 1);
+    testAssert(len >= 0);
+    addrText[len] = ZERO;
+    close(fd);
+
+    // Create and bind both UDP sockets
+    testAssert(client.createSocket(NetworkClient::UDP, &receiver) == NetworkClient::Success);
+    testAssert(client.bindSocket(receiver, 0, LOOPBACK_PORT) == NetworkClient::Success);
+    testAssert(client.createSocket(NetworkClient::UDP, &sender) == NetworkClient::Success);
+    testAssert(client.bindSocket(sender, 0, 0) == NetworkClient::Success);
+
+    addr.addr = IPV4::toAddress(addrText);
+    addr.port = LOOPBACK_PORT;
+    gettimeofday(&t1, ZERO);
+
+    // Send datagrams in windows and verify they arrive complete and in order
+    for (Size i = 0; i < LOOPBACK_COUNT; i += LOOPBACK_WINDOW)
+    {
+        for (Size j = 0; j < LOOPBACK_WINDOW; j++)
+        {
+            payload[0] = i + j;
+            const int r = sendto(sender, payload, sizeof(payload), 0, &addr, sizeof(addr));
+            testAssert(r > 0);
+        }
+
+        for (Size j = 0; j < LOOPBACK_WINDOW; j++)
+        {
+            struct sockaddr from;
+
+            const int r = recvfrom(receiver, payload, sizeof(payload), 0, &from, sizeof(from));
+            testAssert(r == sizeof(payload));
+            testAssert(payload[0] == i + j);
+            bytes += r;
+        }
+    }
+    gettimeofday(&t2, ZERO);
+
+    // Report throughput
+    const u64 usec = ((u64) (t2.tv_sec - t1.tv_sec) * 1000000) + t2.tv_usec - t1.tv_usec;
+    printf("%s: %u datagrams, %u bytes in %u usec (%u KiB/s)\n",
+           __FUNCTION__, LOOPBACK_COUNT, bytes, (u32) usec,
+           usec ? (u32) (((u64) bytes * 1000000 / usec) / 1024) : 0);
+
+    close(sender);
+    close(receiver);
+    return OK;
+}